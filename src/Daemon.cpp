@@ -7,11 +7,16 @@
 //
 
 #include "Daemon.h"
+#include "GatewayConfigCache.h"
+#include "OUIServer.h"
 #include "StatsSvr.h"
 #include "StorageService.h"
 #include "SubscriberCache.h"
+#include "VenueContextCache.h"
 
 #include "Poco/Net/SSLManager.h"
+#include "framework/AuthClient.h"
+#include "framework/KafkaManager.h"
 #include "framework/UI_WebSocketClientServer.h"
 
 namespace OpenWifi {
@@ -21,13 +26,27 @@ namespace OpenWifi {
 		if (instance_ == nullptr) {
 			instance_ = new Daemon(vDAEMON_PROPERTIES_FILENAME, vDAEMON_ROOT_ENV_VAR,
 								   vDAEMON_CONFIG_ENV_VAR, vDAEMON_APP_NAME, vDAEMON_BUS_TIMER,
-								   SubSystemVec{StorageService(), SubscriberCache()});
+								   SubSystemVec{StorageService(), SubscriberCache(),
+												 VenueContextCache(), GatewayConfigCache(),
+												 OUIServer(), StatsSvr()});
 		}
 		return instance_;
 	}
 
 	void Daemon::PostInitialization([[maybe_unused]] Poco::Util::Application &self) {}
 
+	void Daemon::GetExtraResources(Poco::JSON::Object &Answer) {
+		Poco::JSON::Object Stats;
+		StatsSvr()->GetStats(Stats);
+		Answer.set("statsCache", Stats);
+		Poco::JSON::Object Kafka;
+		KafkaManager()->GetStats(Kafka);
+		Answer.set("kafka", Kafka);
+		Poco::JSON::Object Authentication;
+		AuthClient()->GetStats(Authentication);
+		Answer.set("authentication", Authentication);
+	}
+
 	void DaemonPostInitialization(Poco::Util::Application &self) {
 		Daemon()->PostInitialization(self);
 	}
@@ -34,6 +34,7 @@ namespace OpenWifi {
 			: MicroService(PropFile, RootEnv, ConfigEnv, AppName, BusTimer, SubSystems){};
 
 		void PostInitialization(Poco::Util::Application &self);
+		void GetExtraResources(Poco::JSON::Object &Answer) override;
 		static Daemon *instance();
 		inline OpenWifi::SubDashboard &GetDashboard() { return DB_; }
 		Poco::Logger &Log() { return Poco::Logger::get(AppName()); }
@@ -0,0 +1,224 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#include "GatewayConfigCache.h"
+
+#include <cctype>
+#include <mutex>
+#include <string_view>
+
+#include "Poco/JSON/Array.h"
+
+#include "fmt/format.h"
+#include "framework/KafkaManager.h"
+#include "framework/KafkaTopics.h"
+#include "framework/MicroServiceFuncs.h"
+
+namespace OpenWifi {
+
+	namespace {
+		Poco::Dynamic::Var DeepCopy(const Poco::Dynamic::Var &Value) {
+			if (Value.type() == typeid(Poco::JSON::Object::Ptr)) {
+				return GatewayConfigCache::Clone(Value.extract<Poco::JSON::Object::Ptr>());
+			}
+			if (Value.type() == typeid(Poco::JSON::Array::Ptr)) {
+				const auto &Source = Value.extract<Poco::JSON::Array::Ptr>();
+				if (!Source)
+					return Value;
+				auto Copy = Poco::makeShared<Poco::JSON::Array>(*Source);
+				for (std::size_t i = 0; i < Source->size(); ++i)
+					Copy->set(i, DeepCopy(Source->get(i)));
+				return Copy;
+			}
+			return Value;
+		}
+
+		//	State messages are large and StatsSvr already parses them: scan for the "uuid" key of
+		//	the message, or of its "payload" object, instead of parsing the whole document again.
+		//	Keys of the same name deeper in the state are skipped.
+		bool FindUuid(const std::string &Payload, uint64_t &Uuid) {
+			const auto Size = Payload.size();
+			auto SkipSpaces = [&](std::size_t Pos) {
+				while (Pos < Size && std::isspace(static_cast<unsigned char>(Payload[Pos])))
+					++Pos;
+				return Pos;
+			};
+			int Depth = 0;
+			bool InPayload = false;
+			std::string_view LastKey;
+			for (std::size_t Pos = 0; Pos < Size; ++Pos) {
+				const char C = Payload[Pos];
+				if (C == '{' || C == '[') {
+					if (++Depth == 2)
+						InPayload = C == '{' && LastKey == "payload";
+					continue;
+				}
+				if (C == '}' || C == ']') {
+					--Depth;
+					continue;
+				}
+				if (C != '"')
+					continue;
+				auto End = Pos + 1;
+				while (End < Size && Payload[End] != '"')
+					End += Payload[End] == '\\' ? 2 : 1;
+				if (End >= Size)
+					return false;
+				const std::string_view Name(Payload.data() + Pos + 1, End - Pos - 1);
+				Pos = End;
+				auto Next = SkipSpaces(End + 1);
+				if (Next >= Size || Payload[Next] != ':' || !(Depth == 1 || (Depth == 2 && InPayload)))
+					continue;
+				if (Depth == 1)
+					LastKey = Name;
+				if (Name != "uuid")
+					continue;
+				Next = SkipSpaces(Next + 1);
+				if (Next >= Size || !std::isdigit(static_cast<unsigned char>(Payload[Next])))
+					return false;
+				Uuid = 0;
+				while (Next < Size && std::isdigit(static_cast<unsigned char>(Payload[Next])))
+					Uuid = Uuid * 10 + (Payload[Next++] - '0');
+				return true;
+			}
+			return false;
+		}
+	} // namespace
+
+	int GatewayConfigCache::Start() {
+		MaxEntries_ = MicroServiceConfigGetInt("gwconfigcache.size", 4096);
+		TTL_ = std::chrono::seconds(MicroServiceConfigGetInt("gwconfigcache.ttl", 60));
+		poco_information(Logger(),
+						 fmt::format("Starting: size={} ttl={}s", MaxEntries_, TTL_.count()));
+
+		Types::TopicNotifyFunction C = [this](const std::string &Key, const std::string &Payload) {
+			this->ConnectionEvent(Key, Payload);
+		};
+		ConnectionWatcherId_ = KafkaManager()->RegisterTopicWatcher(KafkaTopics::CONNECTION, C);
+		Types::TopicNotifyFunction S = [this](const std::string &Key, const std::string &Payload) {
+			this->StateEvent(Key, Payload);
+		};
+		StateWatcherId_ = KafkaManager()->RegisterTopicWatcher(KafkaTopics::STATE, S);
+		Enabled_ = MaxEntries_ > 0 && TTL_.count() > 0;
+		return 0;
+	}
+
+	void GatewayConfigCache::Stop() {
+		poco_information(Logger(), "Stopping...");
+		Enabled_ = false;
+		KafkaManager()->UnregisterTopicWatcher(KafkaTopics::CONNECTION, ConnectionWatcherId_);
+		KafkaManager()->UnregisterTopicWatcher(KafkaTopics::STATE, StateWatcherId_);
+		Clear();
+		poco_information(Logger(), "Stopped...");
+	}
+
+	bool GatewayConfigCache::Get(const std::string &SerialNumber, Poco::JSON::Object::Ptr &Device) {
+		if (!Enabled_)
+			return false;
+		std::shared_lock G(CacheMutex_);
+		auto It = Entries_.find(SerialNumber);
+		if (It == Entries_.end() || It->second.Expires <= std::chrono::steady_clock::now())
+			return false;
+		Device = It->second.Device;
+		return true;
+	}
+
+	void GatewayConfigCache::Update(const std::string &SerialNumber,
+									const Poco::JSON::Object::Ptr &Device, uint64_t Generation) {
+		if (!Enabled_ || !Device)
+			return;
+		auto Now = std::chrono::steady_clock::now();
+		std::unique_lock G(CacheMutex_);
+		if (Generation != Generation_)
+			return;
+		if (Entries_.size() >= MaxEntries_ && Entries_.find(SerialNumber) == Entries_.end()) {
+			for (auto It = Entries_.begin(); It != Entries_.end();) {
+				if (It->second.Expires <= Now)
+					It = Entries_.erase(It);
+				else
+					++It;
+			}
+			if (Entries_.size() >= MaxEntries_) {
+				auto Oldest = Entries_.begin();
+				for (auto It = Entries_.begin(); It != Entries_.end(); ++It) {
+					if (It->second.Expires < Oldest->second.Expires)
+						Oldest = It;
+				}
+				Entries_.erase(Oldest);
+			}
+		}
+		Entries_[SerialNumber] = Entry{Device, ConfigUuid(Device), Now + TTL_};
+	}
+
+	void GatewayConfigCache::Invalidate(const std::string &SerialNumber) {
+		std::unique_lock G(CacheMutex_);
+		++Generation_;
+		Entries_.erase(SerialNumber);
+	}
+
+	void GatewayConfigCache::Clear() {
+		std::unique_lock G(CacheMutex_);
+		++Generation_;
+		Entries_.clear();
+	}
+
+	void GatewayConfigCache::ConnectionEvent(const std::string &Key, const std::string &Payload) {
+		//	Pings are periodic and say nothing about the configuration.
+		if (Key.empty() || Payload.find("\"ping\"") != std::string::npos)
+			return;
+		{
+			std::shared_lock G(CacheMutex_);
+			if (Entries_.find(Key) == Entries_.end())
+				return;
+		}
+		poco_debug(Logger(), fmt::format("{}: connection event, dropping cached configuration.", Key));
+		Invalidate(Key);
+	}
+
+	void GatewayConfigCache::StateEvent(const std::string &Key, const std::string &Payload) {
+		uint64_t CachedUuid = 0;
+		{
+			std::shared_lock G(CacheMutex_);
+			auto It = Entries_.find(Key);
+			if (It == Entries_.end())
+				return;
+			CachedUuid = It->second.Uuid;
+		}
+		uint64_t ReportedUuid = 0;
+		if (FindUuid(Payload, ReportedUuid) && ReportedUuid != 0 && ReportedUuid != CachedUuid) {
+			poco_debug(Logger(), fmt::format("{}: device reports configuration {} (cached {}).", Key,
+											 ReportedUuid, CachedUuid));
+			Invalidate(Key);
+		}
+	}
+
+	Poco::JSON::Object::Ptr GatewayConfigCache::Clone(const Poco::JSON::Object::Ptr &Obj) {
+		if (!Obj)
+			return Obj;
+		auto Copy = Poco::makeShared<Poco::JSON::Object>(*Obj);
+		for (const auto &[Name, Value] : *Obj) {
+			if (Value.type() == typeid(Poco::JSON::Object::Ptr) ||
+				Value.type() == typeid(Poco::JSON::Array::Ptr))
+				Copy->set(Name, DeepCopy(Value));
+		}
+		return Copy;
+	}
+
+	uint64_t GatewayConfigCache::ConfigUuid(const Poco::JSON::Object::Ptr &Device) {
+		try {
+			if (Device->isObject("configuration")) {
+				auto Configuration = Device->getObject("configuration");
+				if (Configuration->has("uuid"))
+					return Configuration->get("uuid").convert<uint64_t>();
+			}
+			if (Device->has("UUID"))
+				return Device->get("UUID").convert<uint64_t>();
+		} catch (...) {
+		}
+		return 0;
+	}
+
+} // namespace OpenWifi
@@ -0,0 +1,79 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <shared_mutex>
+#include <string>
+
+#include "Poco/JSON/Object.h"
+
+#include "framework/SubSystemServer.h"
+
+namespace OpenWifi {
+
+	//
+	// Caches the device object (including "configuration") returned by the gateway controller,
+	// keyed by serial number. Cached objects are shared between readers and must never be
+	// modified: callers that need to change a configuration work on a Clone().
+	// Entries are dropped after a TTL, after our own Configure() calls, when the device
+	// (re)connects, and when a state message reports a different configuration uuid.
+	//
+	class GatewayConfigCache : public SubSystemServer {
+	  public:
+		static auto instance() {
+			static auto instance_ = new GatewayConfigCache;
+			return instance_;
+		}
+
+		int Start() override;
+		void Stop() override;
+
+		// Returns the cached, read-only device object of a gateway.
+		bool Get(const std::string &SerialNumber, Poco::JSON::Object::Ptr &Device);
+		// Generation to pass to Update() once a fetch started now has completed.
+		[[nodiscard]] inline uint64_t Generation() const { return Generation_.load(); }
+		// Stores a freshly fetched device object, unless an invalidation happened since
+		// Generation was read: the fetched object could predate our own Configure().
+		void Update(const std::string &SerialNumber, const Poco::JSON::Object::Ptr &Device,
+					uint64_t Generation);
+		void Invalidate(const std::string &SerialNumber);
+		void Clear();
+
+		void ConnectionEvent(const std::string &Key, const std::string &Payload);
+		void StateEvent(const std::string &Key, const std::string &Payload);
+
+		// Deep copy of a JSON object, for callers that need to modify a cached object.
+		static Poco::JSON::Object::Ptr Clone(const Poco::JSON::Object::Ptr &Obj);
+		// Configuration uuid of a device object, 0 when it has none.
+		static uint64_t ConfigUuid(const Poco::JSON::Object::Ptr &Device);
+
+	  private:
+		struct Entry {
+			Poco::JSON::Object::Ptr Device;
+			uint64_t Uuid = 0;
+			std::chrono::steady_clock::time_point Expires;
+		};
+
+		std::shared_mutex CacheMutex_;
+		std::map<std::string, Entry> Entries_;
+		std::atomic_uint64_t Generation_{0};
+		std::atomic_bool Enabled_{false};
+		uint64_t ConnectionWatcherId_ = 0;
+		uint64_t StateWatcherId_ = 0;
+		uint64_t MaxEntries_ = 4096;
+		std::chrono::seconds TTL_{60};
+
+		GatewayConfigCache() noexcept
+			: SubSystemServer("GatewayConfigCache", "GW-CONFIG-CACHE", "gwconfigcache") {}
+	};
+
+	inline auto GatewayConfigCache() { return GatewayConfigCache::instance(); }
+
+} // namespace OpenWifi
@@ -0,0 +1,386 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#include "OUIServer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+
+#include "Poco/File.h"
+
+#include "fmt/format.h"
+#include "framework/MicroServiceFuncs.h"
+#include "framework/utils.h"
+#include "sdks/SDK_gw.h"
+
+namespace OpenWifi {
+
+	namespace {
+		constexpr char OUI_MAGIC[4] = {'O', 'U', 'I', 'X'};
+		constexpr uint32_t OUI_VERSION = 1;
+		constexpr uint32_t OCCUPIED = 0x01000000;
+
+		struct OUIHeader {
+			char Magic[4];
+			uint32_t Version;
+			uint32_t Capacity;
+			uint32_t VendorCount;
+			uint32_t Count;
+			uint32_t StringBytes;
+		};
+
+		inline uint32_t Slot(uint32_t Prefix, uint32_t Capacity) {
+			uint32_t H = Prefix * 0x9E3779B1u;
+			return (H ^ (H >> 16)) & (Capacity - 1);
+		}
+
+		inline std::string PrefixToMac(uint32_t Prefix) {
+			return fmt::format("{:02x}:{:02x}:{:02x}:00:00:00", (Prefix >> 16) & 0xff,
+							   (Prefix >> 8) & 0xff, Prefix & 0xff);
+		}
+	} // namespace
+
+	std::string OUIIndex::Serialize(const std::map<uint32_t, std::string> &Entries) {
+		uint32_t Capacity = 16;
+		while (Capacity < 2 * Entries.size())
+			Capacity <<= 1;
+
+		std::map<std::string, uint32_t> VendorIds;
+		std::vector<uint32_t> Offsets{0};
+		std::string Strings;
+		std::vector<uint32_t> Keys(Capacity, 0), Vendors(Capacity, 0);
+		for (const auto &[Prefix, Vendor] : Entries) {
+			auto [It, Inserted] = VendorIds.emplace(Vendor, static_cast<uint32_t>(VendorIds.size()));
+			if (Inserted) {
+				Strings += Vendor;
+				Offsets.push_back(static_cast<uint32_t>(Strings.size()));
+			}
+			auto S = Slot(Prefix, Capacity);
+			while (Keys[S] != 0)
+				S = (S + 1) & (Capacity - 1);
+			Keys[S] = (Prefix & 0xffffff) | OCCUPIED;
+			Vendors[S] = It->second;
+		}
+
+		OUIHeader H{};
+		std::memcpy(H.Magic, OUI_MAGIC, sizeof(H.Magic));
+		H.Version = OUI_VERSION;
+		H.Capacity = Capacity;
+		H.VendorCount = static_cast<uint32_t>(VendorIds.size());
+		H.Count = static_cast<uint32_t>(Entries.size());
+		H.StringBytes = static_cast<uint32_t>(Strings.size());
+
+		std::string Image;
+		Image.reserve(sizeof(H) + 2 * Capacity * sizeof(uint32_t) + Offsets.size() * sizeof(uint32_t) +
+					  Strings.size());
+		Image.append(reinterpret_cast<const char *>(&H), sizeof(H));
+		Image.append(reinterpret_cast<const char *>(Keys.data()), Keys.size() * sizeof(uint32_t));
+		Image.append(reinterpret_cast<const char *>(Vendors.data()), Vendors.size() * sizeof(uint32_t));
+		Image.append(reinterpret_cast<const char *>(Offsets.data()), Offsets.size() * sizeof(uint32_t));
+		Image += Strings;
+		return Image;
+	}
+
+	bool OUIIndex::Attach(const char *Data, std::size_t Size) {
+		OUIHeader H{};
+		if (Data == nullptr || Size < sizeof(H))
+			return false;
+		std::memcpy(&H, Data, sizeof(H));
+		if (std::memcmp(H.Magic, OUI_MAGIC, sizeof(H.Magic)) != 0 || H.Version != OUI_VERSION ||
+			H.Capacity == 0 || (H.Capacity & (H.Capacity - 1)) != 0 || H.Count >= H.Capacity)
+			return false;
+		const uint64_t Expected = sizeof(H) + 2 * uint64_t{H.Capacity} * sizeof(uint32_t) +
+								  (uint64_t{H.VendorCount} + 1) * sizeof(uint32_t) + H.StringBytes;
+		if (Expected != Size)
+			return false;
+
+		Keys_ = reinterpret_cast<const uint32_t *>(Data + sizeof(H));
+		Vendors_ = Keys_ + H.Capacity;
+		Offsets_ = Vendors_ + H.Capacity;
+		Strings_ = reinterpret_cast<const char *>(Offsets_ + H.VendorCount + 1);
+		if (Offsets_[0] != 0 || Offsets_[H.VendorCount] != H.StringBytes)
+			return false;
+		for (uint32_t i = 0; i < H.VendorCount; ++i) {
+			if (Offsets_[i] > Offsets_[i + 1])
+				return false;
+		}
+		//	Lookups stop at the first free slot: a table without one would never terminate.
+		uint32_t Occupied = 0;
+		for (uint32_t i = 0; i < H.Capacity; ++i) {
+			if (Keys_[i] == 0)
+				continue;
+			if ((Keys_[i] & ~0xffffffu) != OCCUPIED || Vendors_[i] >= H.VendorCount)
+				return false;
+			++Occupied;
+		}
+		if (Occupied != H.Count)
+			return false;
+		Capacity_ = H.Capacity;
+		VendorCount_ = H.VendorCount;
+		Count_ = H.Count;
+		return true;
+	}
+
+	std::shared_ptr<const OUIIndex> OUIIndex::FromImage(std::string Image) {
+		auto Index = std::make_shared<OUIIndex>();
+		Index->Image_ = std::move(Image);
+		if (!Index->Attach(Index->Image_.data(), Index->Image_.size()))
+			return nullptr;
+		return Index;
+	}
+
+	std::shared_ptr<const OUIIndex> OUIIndex::FromFile(const std::string &FileName) {
+		try {
+			Poco::File F(FileName);
+			if (!F.exists() || F.getSize() == 0)
+				return nullptr;
+			auto Index = std::make_shared<OUIIndex>();
+			Index->Map_ = std::make_unique<Poco::SharedMemory>(F, Poco::SharedMemory::AM_READ);
+			if (!Index->Attach(Index->Map_->begin(),
+							   static_cast<std::size_t>(Index->Map_->end() - Index->Map_->begin())))
+				return nullptr;
+			return Index;
+		} catch (...) {
+		}
+		return nullptr;
+	}
+
+	bool OUIIndex::Lookup(uint32_t Prefix, std::string_view &Vendor) const {
+		const uint32_t Key = (Prefix & 0xffffff) | OCCUPIED;
+		for (auto S = Slot(Prefix & 0xffffff, Capacity_); Keys_[S] != 0; S = (S + 1) & (Capacity_ - 1)) {
+			if (Keys_[S] == Key) {
+				const auto Id = Vendors_[S];
+				Vendor = std::string_view(Strings_ + Offsets_[Id], Offsets_[Id + 1] - Offsets_[Id]);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void OUIIndex::Entries(std::map<uint32_t, std::string> &Entries) const {
+		for (uint32_t S = 0; S < Capacity_; ++S) {
+			if (Keys_[S] != 0) {
+				const auto Id = Vendors_[S];
+				Entries[Keys_[S] & 0xffffff] =
+					std::string(Strings_ + Offsets_[Id], Offsets_[Id + 1] - Offsets_[Id]);
+			}
+		}
+	}
+
+	bool OUIIndex::MacToPrefix(const std::string &Mac, uint32_t &Prefix) {
+		Prefix = 0;
+		int Digits = 0;
+		for (auto c : Mac) {
+			if (c == ':' || c == '-' || c == '.')
+				continue;
+			if (!std::isxdigit(static_cast<unsigned char>(c)))
+				return false;
+			Prefix = (Prefix << 4) | static_cast<uint32_t>(
+										 std::isdigit(static_cast<unsigned char>(c))
+											 ? c - '0'
+											 : std::tolower(static_cast<unsigned char>(c)) - 'a' + 10);
+			if (++Digits == 6)
+				return true;
+		}
+		return false;
+	}
+
+	int OUIServer::Start() {
+		FileName_ = MicroServiceConfigPath("oui.file", MicroServiceDataDirectory() + "/oui.bin");
+		RefreshInterval_ = MicroServiceConfigGetInt("oui.refresh", 86400);
+		BatchSize_ = std::max<uint64_t>(1, MicroServiceConfigGetInt("oui.refresh.batch", 100));
+
+		if (auto Loaded = OUIIndex::FromFile(FileName_)) {
+			std::unique_lock G(IndexMutex_);
+			Index_ = Loaded;
+		} else if (Poco::File(FileName_).exists()) {
+			poco_warning(Logger(), fmt::format("Ignoring unreadable OUI table {}.", FileName_));
+		}
+		poco_information(Logger(), fmt::format("Starting: {} prefixes from {}, refresh={}s",
+												Index()->Size(), FileName_, RefreshInterval_));
+
+		Running_ = true;
+		Worker_.start(*this);
+		return 0;
+	}
+
+	void OUIServer::Stop() {
+		poco_information(Logger(), "Stopping...");
+		Running_ = false;
+		Wake_.set();
+		Worker_.join();
+		poco_information(Logger(), "Stopped...");
+	}
+
+	void OUIServer::run() {
+		Utils::SetThreadName("oui-svr");
+		auto NextRefresh = Utils::Now() + RefreshInterval_;
+		while (Running_) {
+			Wake_.tryWait(60000);
+			if (!Running_)
+				break;
+			ResolveUnknown();
+			ApplyLearned();
+			if (RefreshInterval_ > 0 && Utils::Now() >= NextRefresh) {
+				RefreshAll();
+				NextRefresh = Utils::Now() + RefreshInterval_;
+			}
+		}
+	}
+
+	std::shared_ptr<const OUIIndex> OUIServer::Index() {
+		std::shared_lock G(IndexMutex_);
+		return Index_;
+	}
+
+	void OUIServer::SetManufacturers(
+		const std::vector<std::pair<const std::string *, std::string *>> &Clients) {
+		auto Table = Index();
+		std::map<uint32_t, std::string> Missing;
+		for (const auto &[Mac, Manufacturer] : Clients) {
+			uint32_t Prefix = 0;
+			std::string_view Vendor;
+			if (!OUIIndex::MacToPrefix(*Mac, Prefix))
+				continue;
+			if (Table->Lookup(Prefix, Vendor))
+				*Manufacturer = Vendor;
+			else
+				Missing.emplace(Prefix, *Mac);
+		}
+		if (Missing.empty())
+			return;
+		{
+			std::lock_guard G(LearnMutex_);
+			Unknown_.merge(Missing);
+		}
+		Wake_.set();
+	}
+
+	bool OUIServer::ResolveUnknown() {
+		std::map<uint32_t, std::string> Unknown;
+		{
+			std::lock_guard G(LearnMutex_);
+			Unknown.swap(Unknown_);
+		}
+		auto It = Unknown.begin();
+		while (It != Unknown.end()) {
+			Types::StringPairVec MacList;
+			for (; It != Unknown.end() && MacList.size() < BatchSize_; ++It)
+				MacList.emplace_back(It->second, "");
+			if (!SDK::GW::Device::GetOUIs(nullptr, MacList)) {
+				poco_warning(Logger(), fmt::format("OUI lookup of {} prefixes failed.", MacList.size()));
+				return false;
+			}
+			Learn(MacList);
+		}
+		return true;
+	}
+
+	void OUIServer::Learn(const Types::StringPairVec &MacList) {
+		{
+			std::lock_guard G(LearnMutex_);
+			for (const auto &[Mac, Vendor] : MacList) {
+				uint32_t Prefix = 0;
+				if (OUIIndex::MacToPrefix(Mac, Prefix))
+					Learned_[Prefix] = Vendor;
+			}
+		}
+		Wake_.set();
+	}
+
+	bool OUIServer::ApplyLearned() {
+		std::map<uint32_t, std::string> Learned;
+		{
+			std::lock_guard G(LearnMutex_);
+			Learned.swap(Learned_);
+		}
+		if (Learned.empty())
+			return false;
+
+		std::map<uint32_t, std::string> Entries;
+		Index()->Entries(Entries);
+		bool Changed = false;
+		for (auto &[Prefix, Vendor] : Learned) {
+			auto [It, Inserted] = Entries.emplace(Prefix, Vendor);
+			if (!Inserted && It->second != Vendor) {
+				It->second = std::move(Vendor);
+				Changed = true;
+			}
+			Changed |= Inserted;
+		}
+		if (!Changed)
+			return false;
+		Publish(Entries);
+		return true;
+	}
+
+	bool OUIServer::RefreshAll() {
+		std::map<uint32_t, std::string> Entries;
+		Index()->Entries(Entries);
+		if (Entries.empty())
+			return false;
+
+		auto Refreshed = Entries;
+		auto It = Entries.begin();
+		while (It != Entries.end()) {
+			Types::StringPairVec MacList;
+			for (; It != Entries.end() && MacList.size() < BatchSize_; ++It)
+				MacList.emplace_back(PrefixToMac(It->first), "");
+			if (!SDK::GW::Device::GetOUIs(nullptr, MacList)) {
+				poco_warning(Logger(), "OUI refresh failed, keeping the current table.");
+				return false;
+			}
+			for (const auto &[Mac, Vendor] : MacList) {
+				uint32_t Prefix = 0;
+				if (OUIIndex::MacToPrefix(Mac, Prefix))
+					Refreshed[Prefix] = Vendor;
+			}
+		}
+		if (Refreshed == Entries)
+			return false;
+		Publish(Refreshed);
+		return true;
+	}
+
+	void OUIServer::Publish(const std::map<uint32_t, std::string> &Entries) {
+		auto Image = OUIIndex::Serialize(Entries);
+		std::shared_ptr<const OUIIndex> Table;
+		if (Save(Image))
+			Table = OUIIndex::FromFile(FileName_);
+		if (!Table)
+			Table = OUIIndex::FromImage(std::move(Image));
+		if (!Table)
+			return;
+		poco_debug(Logger(), fmt::format("OUI table now has {} prefixes.", Table->Size()));
+		std::unique_lock G(IndexMutex_);
+		Index_ = Table;
+	}
+
+	bool OUIServer::Save(const std::string &Image) {
+		if (FileName_.empty())
+			return false;
+		//	Write aside and rename: readers keep their mapping of the previous file.
+		const auto TempName = FileName_ + ".tmp";
+		try {
+			{
+				std::ofstream Out(TempName, std::ios::binary | std::ios::trunc);
+				Out.write(Image.data(), static_cast<std::streamsize>(Image.size()));
+				if (!Out.good()) {
+					poco_warning(Logger(), fmt::format("Cannot write OUI table {}.", TempName));
+					return false;
+				}
+			}
+			Poco::File(TempName).renameTo(FileName_);
+			return true;
+		} catch (const Poco::Exception &E) {
+			Logger().log(E);
+		}
+		return false;
+	}
+
+} // namespace OpenWifi
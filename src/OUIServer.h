@@ -0,0 +1,120 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Poco/Event.h"
+#include "Poco/Runnable.h"
+#include "Poco/SharedMemory.h"
+#include "Poco/Thread.h"
+
+#include "framework/OpenWifiTypes.h"
+#include "framework/SubSystemServer.h"
+
+namespace OpenWifi {
+
+	//
+	// Read-only OUI -> manufacturer table, stored in the same compact binary layout in memory
+	// and on disk so the file can be mapped as is:
+	//	header, an open-addressing table of 24-bit prefixes with their vendor ids, the vendor
+	//	string offsets and the interned vendor strings.
+	//
+	class OUIIndex {
+	  public:
+		// Builds the binary image of a table. An empty vendor records a prefix the gateway
+		// service has no manufacturer for.
+		static std::string Serialize(const std::map<uint32_t, std::string> &Entries);
+		// Validates and adopts a binary image, from memory or from a mapped file.
+		static std::shared_ptr<const OUIIndex> FromImage(std::string Image);
+		static std::shared_ptr<const OUIIndex> FromFile(const std::string &FileName);
+
+		// Returns false when the prefix is not in the table.
+		bool Lookup(uint32_t Prefix, std::string_view &Vendor) const;
+		void Entries(std::map<uint32_t, std::string> &Entries) const;
+		[[nodiscard]] inline uint32_t Size() const { return Count_; }
+
+		// First three bytes of a MAC address in any usual notation.
+		static bool MacToPrefix(const std::string &Mac, uint32_t &Prefix);
+
+	  private:
+		std::string Image_;
+		std::unique_ptr<Poco::SharedMemory> Map_;
+		const uint32_t *Keys_ = nullptr;
+		const uint32_t *Vendors_ = nullptr;
+		const uint32_t *Offsets_ = nullptr;
+		const char *Strings_ = nullptr;
+		uint32_t Capacity_ = 0;
+		uint32_t VendorCount_ = 0;
+		uint32_t Count_ = 0;
+
+		bool Attach(const char *Data, std::size_t Size);
+	};
+
+	//
+	// Resolves client manufacturers from a local OUI table instead of asking the gateway
+	// service on every client list. Prefixes missing from the table are asked for and added
+	// in the background, so a client list never waits for the gateway service; the whole
+	// table is refreshed from the gateway service periodically and persisted so it is
+	// available again after a restart.
+	//
+	class OUIServer : public SubSystemServer, Poco::Runnable {
+	  public:
+		static auto instance() {
+			static auto instance_ = new OUIServer;
+			return instance_;
+		}
+
+		int Start() override;
+		void Stop() override;
+		void run() override;
+
+		std::shared_ptr<const OUIIndex> Index();
+		// Sets the manufacturer of each (MAC, manufacturer) pair found in the table. Prefixes
+		// the table does not know yet are left empty and queued for ResolveUnknown().
+		void SetManufacturers(const std::vector<std::pair<const std::string *, std::string *>> &Clients);
+		// Queues vendors returned by the gateway service for inclusion in the table.
+		void Learn(const Types::StringPairVec &MacList);
+
+		// Asks the gateway service for the queued unknown prefixes and learns their vendors.
+		// Returns false when a request failed: those prefixes are queued again when seen.
+		bool ResolveUnknown();
+		// Adds the learned vendors to the table. Returns true when the table changed.
+		bool ApplyLearned();
+		// Asks the gateway service again for every known prefix.
+		bool RefreshAll();
+
+	  private:
+		std::shared_mutex IndexMutex_;
+		std::shared_ptr<const OUIIndex> Index_ = OUIIndex::FromImage(OUIIndex::Serialize({}));
+		std::mutex LearnMutex_;
+		std::map<uint32_t, std::string> Learned_;
+		std::map<uint32_t, std::string> Unknown_; //	prefix -> a MAC to ask for it
+		std::string FileName_;
+		uint64_t RefreshInterval_ = 86400;
+		uint64_t BatchSize_ = 100;
+		Poco::Thread Worker_;
+		Poco::Event Wake_;
+		std::atomic_bool Running_ = false;
+
+		void Publish(const std::map<uint32_t, std::string> &Entries);
+		bool Save(const std::string &Image);
+
+		OUIServer() noexcept : SubSystemServer("OUIServer", "OUI-SVR", "oui") {}
+	};
+
+	inline auto OUIServer() { return OUIServer::instance(); }
+
+} // namespace OpenWifi
@@ -0,0 +1,361 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#include "RESTAPI_parental_control_batch_handler.h"
+#include "RESTAPI_parental_control_utils.h"
+#include "fmt/format.h"
+#include "framework/utils.h"
+#include "sdks/SDK_parental_control.h"
+#include <set>
+
+namespace OpenWifi {
+
+	namespace {
+		constexpr std::size_t MAX_BATCH_OPERATIONS = 100;
+
+		enum class BatchOp {
+			AddGroupDevice,
+			RemoveGroupDevice,
+			AddGroupSchedule,
+			RemoveGroupSchedule,
+			ReplaceGroupSchedules,
+			CreateSchedule,
+			UpdateSchedule,
+			DeleteSchedule,
+			DeleteGroup
+		};
+
+		struct BatchOpInfo {
+			const char *name;
+			BatchOp op;
+			std::set<std::string> fields;
+			bool configRawRequired;
+			const char *objectType;
+		};
+
+		// Fields and config-raw expectations mirror the single-object handlers.
+		const std::vector<BatchOpInfo> &BatchOps() {
+			static const std::vector<BatchOpInfo> ops{
+				{"add_group_device", BatchOp::AddGroupDevice, {"group_id", "client_mac"}, true, "group_device"},
+				{"remove_group_device", BatchOp::RemoveGroupDevice, {"group_id", "client_mac"}, true, "group_device"},
+				{"add_group_schedule", BatchOp::AddGroupSchedule, {"group_id", "schedule_id"}, true, "group_schedule"},
+				{"remove_group_schedule", BatchOp::RemoveGroupSchedule, {"group_id", "schedule_id"}, true, "group_schedule"},
+				{"replace_group_schedules", BatchOp::ReplaceGroupSchedules, {"group_id", "schedule_ids"}, true, "group_schedule"},
+				{"create_schedule", BatchOp::CreateSchedule, {"schedule"}, false, "schedule"},
+				{"update_schedule", BatchOp::UpdateSchedule, {"schedule_id", "schedule"}, false, "schedule"},
+				{"delete_schedule", BatchOp::DeleteSchedule, {"schedule_id"}, false, "schedule"},
+				{"delete_group", BatchOp::DeleteGroup, {"group_id"}, false, "group"}};
+			return ops;
+		}
+
+		struct BatchOperation {
+			const BatchOpInfo *info = nullptr;
+			std::string groupId;
+			std::string clientMac;
+			std::string scheduleId;
+			Poco::JSON::Array::Ptr scheduleIds;
+			RESTAPI::ParentalControl::ParsedScheduleRequest schedule;
+		};
+
+		bool GetUuidField(const Poco::JSON::Object::Ptr &entry, const std::string &name,
+						  std::string &value, std::string &error) {
+			if (!entry->has(name) || entry->isNull(name) || !entry->get(name).isString()) {
+				error = name + " is required and must be a string";
+				return false;
+			}
+			value = entry->getValue<std::string>(name);
+			if (!Utils::ValidUUID(value)) {
+				error = name + " is not a valid UUID";
+				return false;
+			}
+			return true;
+		}
+
+		bool ParseBatchOperation(const Poco::JSON::Object::Ptr &entry, BatchOperation &out,
+								 std::string &error) {
+			if (!entry->has("op") || entry->isNull("op") || !entry->get("op").isString()) {
+				error = "op is required and must be a string";
+				return false;
+			}
+			const auto opName = entry->getValue<std::string>("op");
+			for (const auto &info : BatchOps()) {
+				if (opName == info.name) {
+					out.info = &info;
+					break;
+				}
+			}
+			if (!out.info) {
+				error = "Unknown op: " + opName;
+				return false;
+			}
+
+			std::vector<std::string> names;
+			entry->getNames(names);
+			for (const auto &name : names) {
+				if (name != "op" && out.info->fields.count(name) == 0) {
+					error = "Unknown field: " + name;
+					return false;
+				}
+			}
+
+			if (out.info->fields.count("group_id") && !GetUuidField(entry, "group_id", out.groupId, error)) {
+				return false;
+			}
+			if (out.info->fields.count("schedule_id") && !GetUuidField(entry, "schedule_id", out.scheduleId, error)) {
+				return false;
+			}
+
+			if (out.info->fields.count("client_mac")) {
+				if (!entry->has("client_mac") || entry->isNull("client_mac") || !entry->get("client_mac").isString()) {
+					error = "client_mac is required and must be a string";
+					return false;
+				}
+				std::string clientMac = entry->getValue<std::string>("client_mac");
+				if (!Utils::NormalizeMac(clientMac)) {
+					error = "client_mac is not a valid MAC address";
+					return false;
+				}
+				out.clientMac = Utils::SerialToMAC(clientMac);
+			}
+
+			if (out.info->fields.count("schedule_ids")) {
+				if (!entry->has("schedule_ids") || entry->isNull("schedule_ids") || !entry->isArray("schedule_ids") ||
+					!entry->getArray("schedule_ids")) {
+					error = "schedule_ids is required and must be an array";
+					return false;
+				}
+				out.scheduleIds = entry->getArray("schedule_ids");
+				std::set<std::string> uniqueIds;
+				for (std::size_t i = 0; i < out.scheduleIds->size(); ++i) {
+					if (!out.scheduleIds->get(i).isString()) {
+						error = "schedule_ids entries must be strings";
+						return false;
+					}
+					const auto id = out.scheduleIds->getElement<std::string>(i);
+					if (!Utils::ValidUUID(id)) {
+						error = "invalid UUID in schedule_ids";
+						return false;
+					}
+					if (!uniqueIds.insert(id).second) {
+						error = "duplicate UUID in schedule_ids";
+						return false;
+					}
+				}
+			}
+
+			if (out.info->fields.count("schedule")) {
+				if (!entry->has("schedule") || entry->isNull("schedule") || !entry->isObject("schedule")) {
+					error = "schedule is required and must be an object";
+					return false;
+				}
+				std::string scheduleError;
+				if (!RESTAPI::ParentalControl::ParseScheduleRequest(
+						entry->getObject("schedule"),
+						/*enabledRequired=*/out.info->op == BatchOp::UpdateSchedule, out.schedule,
+						scheduleError)) {
+					error = "schedule: " + scheduleError;
+					return false;
+				}
+			}
+			return true;
+		}
+
+		bool RunBatchOperation(RESTAPIHandler *handler, const std::string &subscriberId,
+							   const BatchOperation &operation,
+							   RESTAPI::ParentalControl::MutationCallResult &mutation) {
+			std::string rawResponseBody;
+			switch (operation.info->op) {
+			case BatchOp::AddGroupDevice: {
+				Poco::JSON::Object body;
+				body.set("client_mac", operation.clientMac);
+				return SDK::ParentalControl::CreateGroupDevice(handler, subscriberId, operation.groupId, body,
+															   mutation.status, mutation.response);
+			}
+			case BatchOp::RemoveGroupDevice:
+				return SDK::ParentalControl::DeleteGroupDevice(handler, subscriberId, operation.groupId,
+															   operation.clientMac, mutation.status,
+															   mutation.response, rawResponseBody);
+			case BatchOp::AddGroupSchedule: {
+				Poco::JSON::Object body;
+				body.set("schedule_id", operation.scheduleId);
+				return SDK::ParentalControl::CreateGroupSchedule(handler, subscriberId, operation.groupId, body,
+																 mutation.status, mutation.response);
+			}
+			case BatchOp::RemoveGroupSchedule:
+				return SDK::ParentalControl::DeleteGroupSchedule(handler, subscriberId, operation.groupId,
+																 operation.scheduleId, mutation.status,
+																 mutation.response, rawResponseBody);
+			case BatchOp::ReplaceGroupSchedules: {
+				Poco::JSON::Object body;
+				body.set("schedule_ids", operation.scheduleIds);
+				return SDK::ParentalControl::ReplaceGroupSchedules(handler, subscriberId, operation.groupId, body,
+																   mutation.status, mutation.response);
+			}
+			case BatchOp::CreateSchedule:
+				return SDK::ParentalControl::CreateSchedule(
+					handler, subscriberId, RESTAPI::ParentalControl::BuildScheduleRequestBody(operation.schedule),
+					mutation.status, mutation.response);
+			case BatchOp::UpdateSchedule:
+				return SDK::ParentalControl::UpdateSchedule(
+					handler, subscriberId, operation.scheduleId,
+					RESTAPI::ParentalControl::BuildScheduleRequestBody(operation.schedule), mutation.status,
+					mutation.response);
+			case BatchOp::DeleteSchedule:
+				return SDK::ParentalControl::DeleteSchedule(handler, subscriberId, operation.scheduleId,
+															mutation.status, mutation.response, rawResponseBody);
+			case BatchOp::DeleteGroup:
+				return SDK::ParentalControl::DeleteGroup(handler, subscriberId, operation.groupId,
+														 mutation.status, mutation.response, rawResponseBody);
+			}
+			return false;
+		}
+	} // namespace
+
+	void RESTAPI_parental_control_batch_handler::DoPost() {
+		const auto &subscriberId = UserInfo_.userinfo.id;
+		const auto &operatorId = UserInfo_.userinfo.owner;
+		if (!RESTAPI::ParentalControl::ValidateAuthPreconditions(*this, subscriberId, operatorId, true)) {
+			return;
+		}
+
+		if (!ParsedBody_) {
+			return BadRequest(RESTAPI::Errors::InvalidJSONDocument);
+		}
+
+		std::vector<std::string> names;
+		ParsedBody_->getNames(names);
+		for (const auto &name : names) {
+			if (name != "operations") {
+				return BadRequest(RESTAPI::Errors::MissingOrInvalidParameters, "Unknown field: " + name);
+			}
+		}
+
+		if (!ParsedBody_->has("operations") || ParsedBody_->isNull("operations") || !ParsedBody_->isArray("operations") ||
+			!ParsedBody_->getArray("operations")) {
+			return BadRequest(RESTAPI::Errors::MissingOrInvalidParameters, "operations is required and must be an array");
+		}
+		auto operationsArray = ParsedBody_->getArray("operations");
+		if (operationsArray->size() == 0 || operationsArray->size() > MAX_BATCH_OPERATIONS) {
+			return BadRequest(RESTAPI::Errors::MissingOrInvalidParameters,
+							  fmt::format("operations must contain between 1 and {} entries", MAX_BATCH_OPERATIONS));
+		}
+
+		//	Reject the whole batch before anything is changed downstream.
+		std::vector<BatchOperation> operations(operationsArray->size());
+		bool hasSchedules = false;
+		for (std::size_t i = 0; i < operationsArray->size(); ++i) {
+			std::string error;
+			if (!operationsArray->isObject(i)) {
+				error = "entry must be an object";
+			} else {
+				ParseBatchOperation(operationsArray->getObject(i), operations[i], error);
+			}
+			if (!error.empty()) {
+				return BadRequest(RESTAPI::Errors::MissingOrInvalidParameters,
+								  fmt::format("operations[{}]: {}", i, error));
+			}
+			hasSchedules |= operations[i].info->fields.count("schedule") > 0;
+		}
+
+		std::string timezone;
+		if (hasSchedules) {
+			if (!RESTAPI::ParentalControl::ResolveSubscriberTimezone(*this, subscriberId, timezone)) {
+				return; // Response already sent inside resolver
+			}
+			for (auto &operation : operations) {
+				if (operation.info->fields.count("schedule") &&
+					!RESTAPI::ParentalControl::ConvertScheduleTimesToUtc(timezone, operation.schedule)) {
+					return InternalError(RESTAPI::Errors::InternalError);
+				}
+			}
+		}
+
+		//	Operations run in order and the batch stops at the first failure. Every successful
+		//	mutation returns the subscriber's complete config-raw, so only the last one is applied.
+		Poco::JSON::Array results;
+		Poco::JSON::Array::Ptr latestConfigRaw;
+		bool failed = false;
+		for (std::size_t i = 0; i < operations.size(); ++i) {
+			const auto &operation = operations[i];
+			Poco::JSON::Object result;
+			result.set("index", i);
+			result.set("op", operation.info->name);
+
+			if (failed) {
+				result.set("success", false);
+				result.set("skipped", true);
+				results.add(result);
+				continue;
+			}
+
+			RESTAPI::ParentalControl::MutationCallResult mutation;
+			mutation.success = RunBatchOperation(this, subscriberId, operation, mutation);
+
+			Poco::JSON::Array::Ptr configRaw;
+			if (mutation.success &&
+				!RESTAPI::ParentalControl::ExtractConfigRawSnapshot(mutation.response, configRaw,
+																	operation.info->configRawRequired)) {
+				Logger().error(fmt::format("DoPost: invalid parental-control {} payload (subscriber={} batch index={})",
+										   operation.info->objectType, subscriberId, i));
+				mutation.success = false;
+				mutation.status = Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR;
+				mutation.response = nullptr;
+			}
+			if (mutation.success && mutation.response && operation.info->fields.count("schedule")) {
+				if (!RESTAPI::ParentalControl::NormalizeScheduleResponse(mutation.response, timezone)) {
+					mutation.success = false;
+					mutation.status = Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR;
+					mutation.response = nullptr;
+				}
+			}
+			if (configRaw) {
+				//	The mutation went through downstream even if its response could not be
+				//	normalized: its snapshot still has to reach the gateway.
+				latestConfigRaw = configRaw;
+			}
+
+			result.set("success", mutation.success);
+			result.set("status", static_cast<int>(mutation.status));
+			if (mutation.success) {
+				RESTAPI::ParentalControl::StripConfigRawFromMutationResponse(mutation.response);
+				if (mutation.response) {
+					result.set("response", mutation.response);
+				}
+			} else {
+				failed = true;
+				result.set("error", RESTAPI::ParentalControl::ParentalControlErrorBody(mutation.status, mutation.response));
+			}
+			results.add(result);
+		}
+
+		Poco::JSON::Object answer;
+		answer.set("success", !failed);
+		answer.set("results", results);
+
+		//	The mutations above are committed whatever happens to the gateway: a failed apply is
+		//	reported with its usual status and error, along with their results.
+		Poco::Net::HTTPResponse::HTTPStatus applyStatus;
+		RESTAPI::Errors::msg applyError;
+		if (latestConfigRaw &&
+			RESTAPI::ParentalControl::ApplyConfigRawError(
+				RESTAPI::ParentalControl::ApplyConfigRaw(*this, Logger(), subscriberId, operatorId, "batch",
+														 latestConfigRaw, "DoPost", "batch"),
+				applyStatus, applyError)) {
+			answer.set("success", false);
+			answer.set("ErrorCode", applyStatus == Poco::Net::HTTPResponse::HTTP_FORBIDDEN
+										? applyError.err_num
+										: static_cast<uint64_t>(applyStatus));
+			answer.set("ErrorDetails", Request->getMethod());
+			answer.set("ErrorDescription", fmt::format("{}: {}", applyError.err_num, applyError.err_txt));
+			PrepareResponse(applyStatus);
+			std::ostream &Answer = Response->send();
+			Poco::JSON::Stringifier::stringify(answer, Answer);
+			return;
+		}
+		return ReturnObject(answer);
+	}
+
+} // namespace OpenWifi
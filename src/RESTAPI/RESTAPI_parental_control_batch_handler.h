@@ -0,0 +1,33 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#pragma once
+
+#include "framework/RESTAPI_Handler.h"
+
+namespace OpenWifi {
+	//
+	// Runs an ordered list of parental-control mutations and pushes only the last config-raw
+	// snapshot to the gateway, so a bulk change costs one gateway reconfiguration.
+	//
+	class RESTAPI_parental_control_batch_handler : public RESTAPIHandler {
+	  public:
+		RESTAPI_parental_control_batch_handler(const RESTAPIHandler::BindingMap &bindings, Poco::Logger &L,
+											   RESTAPI_GenericServerAccounting &Server, uint64_t TransactionId,
+											   bool Internal)
+			: RESTAPIHandler(bindings, L,
+							 std::vector<std::string>{Poco::Net::HTTPRequest::HTTP_POST,
+													  Poco::Net::HTTPRequest::HTTP_OPTIONS},
+							 Server, TransactionId, Internal, true, false, RESTAPIHandler::RateLimit{.Interval = 1000, .MaxCalls = 100}, true) {}
+
+		static auto PathName() { return std::list<std::string>{"/api/v1/parental-control/batch"}; }
+
+		void DoGet() override {}
+		void DoDelete() override {}
+		void DoPost() override;
+		void DoPut() override {}
+	};
+} // namespace OpenWifi
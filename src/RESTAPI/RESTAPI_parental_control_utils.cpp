@@ -5,23 +5,31 @@
  */
 
 #include "RESTAPI_parental_control_utils.h"
+#include "VenueContextCache.h"
 #include "Poco/Exception.h"
 #include "Poco/Format.h"
 #include "Poco/DateTime.h"
 #include "Poco/DateTimeFormatter.h"
-#include "Poco/DateTimeParser.h"
 #include "Poco/String.h"
+#include "Poco/Timestamp.h"
 #include "fmt/format.h"
 #include "sdks/SDK_gw.h"
 #include "sdks/SDK_prov.h"
+#include "framework/MicroServiceFuncs.h"
 #include "framework/utils.h"
 #include "framework/ow_constants.h"
 #include <date/tz.h>
 #include <cctype>
 #include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <future>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <shared_mutex>
 #include <sstream>
 #include <vector>
 
@@ -217,7 +225,7 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 				return false;
 			}
 
-			const auto *zone = date::locate_zone(timezoneStr);
+			const auto *zone = VenueContextCache()->LocateZone(timezoneStr);
 
 			auto sysNow = std::chrono::system_clock::now();
 			auto zonedNow = date::make_zoned(zone, sysNow);
@@ -319,77 +327,66 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 	}
 
 	// Parse and validate schedule POST/PUT JSON request body against schema rules.
-	// On validation failure, sets HTTP 400 Bad Request error on handler and returns false.
-	bool ParseAndValidateScheduleRequest(RESTAPIHandler &handler,
-
-										  const Poco::JSON::Object::Ptr &body,
-										  bool enabledRequired,
-										  ParsedScheduleRequest &out) {
+	// On validation failure, sets error to the reason and returns false.
+	bool ParseScheduleRequest(const Poco::JSON::Object::Ptr &body, bool enabledRequired,
+							  ParsedScheduleRequest &out, std::string &error) {
 		std::vector<std::string> names;
 		body->getNames(names);
 		for (const auto &name : names) {
 			if (name != "name" && name != "description" && name != "enabled" &&
 				name != "action_type" && name != "target_kind" && name != "target_value" &&
 				name != "start_time" && name != "stop_time" && name != "weekdays") {
-				handler.BadRequest(RESTAPI::Errors::MissingOrInvalidParameters,
-								   "Unknown field: " + name);
+				error = "Unknown field: " + name;
 				return false;
 			}
 		}
 
 		if (!body->has("name") || body->isNull("name") || !body->get("name").isString()) {
-			handler.BadRequest(RESTAPI::Errors::MissingOrInvalidParameters, "name is required");
+			error = "name is required";
 			return false;
 		}
 		out.name = body->getValue<std::string>("name");
 		Poco::trimInPlace(out.name);
 		if (out.name.empty()) {
-			handler.BadRequest(RESTAPI::Errors::MissingOrInvalidParameters,
-							   "name must be non-empty");
+			error = "name must be non-empty";
 			return false;
 		}
 
 		if (!body->has("action_type") || body->isNull("action_type") ||
 			!body->get("action_type").isString() ||
 			body->getValue<std::string>("action_type") != "BLOCK") {
-			handler.BadRequest(RESTAPI::Errors::MissingOrInvalidParameters,
-							   "action_type must be BLOCK");
+			error = "action_type must be BLOCK";
 			return false;
 		}
 
 		if (!body->has("target_kind") || body->isNull("target_kind") ||
 			!body->get("target_kind").isString()) {
-			handler.BadRequest(RESTAPI::Errors::MissingOrInvalidParameters,
-							   "target_kind is required");
+			error = "target_kind is required";
 			return false;
 		}
 		out.targetKind = body->getValue<std::string>("target_kind");
 		if (out.targetKind != "INTERNET" && out.targetKind != "APP") {
-			handler.BadRequest(RESTAPI::Errors::MissingOrInvalidParameters,
-							   "target_kind must be INTERNET or APP");
+			error = "target_kind must be INTERNET or APP";
 			return false;
 		}
 
 		if (out.targetKind == "APP") {
 			out.has_target_value = true;
 			if (!body->has("target_value") || body->isNull("target_value") || !body->get("target_value").isString()) {
-				handler.BadRequest(RESTAPI::Errors::MissingOrInvalidParameters,
-								   "APP schedules require a non-empty target_value");
+				error = "APP schedules require a non-empty target_value";
 				return false;
 			}
 			out.targetValue = body->getValue<std::string>("target_value");
 			Poco::trimInPlace(out.targetValue);
 			if (out.targetValue.empty()) {
-				handler.BadRequest(RESTAPI::Errors::MissingOrInvalidParameters,
-								   "APP schedules require a non-empty target_value");
+				error = "APP schedules require a non-empty target_value";
 				return false;
 			}
 		} else {
 			if (body->has("target_value")) {
 				out.has_target_value = true;
 				if (!body->isNull("target_value")) {
-					handler.BadRequest(RESTAPI::Errors::MissingOrInvalidParameters,
-									   "INTERNET schedules require target_value to be null");
+					error = "INTERNET schedules require target_value to be null";
 					return false;
 				}
 			} else {
@@ -400,26 +397,22 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 
 		if (!body->has("start_time") ||
 			!ParseTimeString(body->get("start_time"), out.startMinute)) {
-			handler.BadRequest(RESTAPI::Errors::MissingOrInvalidParameters,
-							   "start_time must use HH:MM format");
+			error = "start_time must use HH:MM format";
 			return false;
 		}
 		if (!body->has("stop_time") ||
 			!ParseTimeString(body->get("stop_time"), out.stopMinute)) {
-			handler.BadRequest(RESTAPI::Errors::MissingOrInvalidParameters,
-							   "stop_time must use HH:MM format");
+			error = "stop_time must use HH:MM format";
 			return false;
 		}
 		if (out.startMinute == out.stopMinute) {
-			handler.BadRequest(RESTAPI::Errors::MissingOrInvalidParameters,
-							   "start_time and stop_time must not represent the same minute");
+			error = "start_time and stop_time must not represent the same minute";
 			return false;
 		}
 
 		if (!body->has("weekdays") || !body->isArray("weekdays") ||
 			!ValidateWeekdays(body->getArray("weekdays"))) {
-			handler.BadRequest(RESTAPI::Errors::MissingOrInvalidParameters,
-							   "weekdays must contain distinct values in the range 0..6");
+			error = "weekdays must contain distinct values in the range 0..6";
 			return false;
 		}
 		out.weekdays = body->getArray("weekdays");
@@ -427,16 +420,14 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 		if (enabledRequired) {
 			if (!body->has("enabled") || body->isNull("enabled") ||
 				body->get("enabled").type() != typeid(bool)) {
-				handler.BadRequest(RESTAPI::Errors::MissingOrInvalidParameters,
-								   "enabled is required and must be a boolean");
+				error = "enabled is required and must be a boolean";
 				return false;
 			}
 			out.enabled = body->getValue<bool>("enabled");
 		} else {
 			if (body->has("enabled")) {
 				if (body->isNull("enabled") || body->get("enabled").type() != typeid(bool)) {
-					handler.BadRequest(RESTAPI::Errors::MissingOrInvalidParameters,
-									   "enabled must be a boolean");
+					error = "enabled must be a boolean";
 					return false;
 				}
 				out.enabled = body->getValue<bool>("enabled");
@@ -451,8 +442,7 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 				out.description = std::nullopt;
 			} else {
 				if (!body->get("description").isString()) {
-					handler.BadRequest(RESTAPI::Errors::MissingOrInvalidParameters,
-									   "description must be a string or null");
+					error = "description must be a string or null";
 					return false;
 				}
 				std::string desc = body->getValue<std::string>("description");
@@ -467,6 +457,18 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 		return true;
 	}
 
+	bool ParseAndValidateScheduleRequest(RESTAPIHandler &handler,
+										  const Poco::JSON::Object::Ptr &body,
+										  bool enabledRequired,
+										  ParsedScheduleRequest &out) {
+		std::string error;
+		if (!ParseScheduleRequest(body, enabledRequired, out, error)) {
+			handler.BadRequest(RESTAPI::Errors::MissingOrInvalidParameters, error);
+			return false;
+		}
+		return true;
+	}
+
 	// Build the backend JSON request payload for mango-parental-control from a parsed schedule.
 	Poco::JSON::Object BuildScheduleRequestBody(const ParsedScheduleRequest &req) {
 
@@ -496,8 +498,21 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 	}
 
 	// Resolve the IANA timezone string for a subscriber by fetching venue and location from OWProv.
+	// Results, including "no timezone configured", are kept in the VenueContextCache.
 	// On failure, sets the appropriate HTTP error on handler and returns false.
 	bool ResolveSubscriberTimezone(RESTAPIHandler &handler, const std::string &subscriberId, std::string &timezone) {
+		VenueContext cached;
+		switch (VenueContextCache()->GetBySubscriber(subscriberId, cached)) {
+		case VenueContextLookup::Found:
+			timezone = cached.timezone;
+			return true;
+		case VenueContextLookup::NoTimezone:
+			handler.BadRequest(RESTAPI::Errors::TimezoneRequired);
+			return false;
+		case VenueContextLookup::Miss:
+			break;
+		}
+
 		Poco::Net::HTTPServerResponse::HTTPStatus callStatus =
 			Poco::Net::HTTPServerResponse::HTTP_INTERNAL_SERVER_ERROR;
 		auto callResponse = Poco::makeShared<Poco::JSON::Object>();
@@ -513,12 +528,15 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 		}
 
 		if (venueList.venues.empty()) {
+			VenueContextCache()->UpdateBySubscriber(subscriberId, cached, true);
 			handler.BadRequest(RESTAPI::Errors::TimezoneRequired);
 			return false;
 		}
 
 		const auto &venue = venueList.venues[0];
+		cached.venueId = venue.info.id;
 		if (venue.location.empty()) {
+			VenueContextCache()->UpdateBySubscriber(subscriberId, cached, true);
 			handler.BadRequest(RESTAPI::Errors::TimezoneRequired);
 			return false;
 		}
@@ -536,19 +554,23 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 			return false;
 		}
 
+		cached.locationId = venue.location;
 		if (location.timezone.empty()) {
+			VenueContextCache()->UpdateBySubscriber(subscriberId, cached, true);
 			handler.BadRequest(RESTAPI::Errors::TimezoneRequired);
 			return false;
 		}
 
 		try {
-			date::locate_zone(location.timezone);
+			cached.zone = VenueContextCache()->LocateZone(location.timezone);
 		} catch (...) {
 			handler.InternalError(RESTAPI::Errors::InternalError);
 			return false;
 		}
 
 		timezone = location.timezone;
+		cached.timezone = location.timezone;
+		VenueContextCache()->UpdateBySubscriber(subscriberId, cached);
 		auto &logger = Poco::Logger::get("ParentalControl");
 		logger.information(fmt::format("Resolved subscriber [{}] venue location timezone: [{}]", subscriberId, timezone));
 		return true;
@@ -567,7 +589,7 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 		const int originalStopMinute = request.stopMinute;
 
 		try {
-			const auto *zone = date::locate_zone(timezoneStr);
+			const auto *zone = VenueContextCache()->LocateZone(timezoneStr);
 
 			// Resolve current calendar date in the subscriber's local timezone.
 			auto sysNow = std::chrono::system_clock::now();
@@ -669,6 +691,128 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 		return true;
 	}
 
+	namespace {
+		//	Pushes a config-raw snapshot to a gateway: fetch its configuration, replace config-raw
+		//	and configure the device.
+		ApplyConfigRawResult PushConfigRaw(RESTAPIHandler &handler, Poco::Logger &logger,
+										   const std::string &serialNumber,
+										   const Poco::JSON::Array::Ptr &configRaw,
+										   const std::string &operationName) {
+			Poco::JSON::Object::Ptr gwResponse;
+			Poco::Net::HTTPResponse::HTTPStatus gwStatus;
+			if (!SDK::GW::Device::GetConfig(&handler, serialNumber, gwStatus, gwResponse)) {
+				if (gwStatus == Poco::Net::HTTPResponse::HTTP_OK) {
+					logger.error(fmt::format("{}: gateway config malformed (serial={})", operationName,
+											 serialNumber));
+				} else {
+					logger.error(fmt::format("{}: gateway config load failed (serial={})",
+											 operationName, serialNumber));
+				}
+				return ApplyConfigRawResult::GatewayConfigLoadFailed;
+			}
+
+			if (!gwResponse || !gwResponse->has("configuration") ||
+				!gwResponse->isObject("configuration")) {
+				logger.error(fmt::format("{}: gateway config malformed (serial={})", operationName,
+										 serialNumber));
+				return ApplyConfigRawResult::GatewayConfigMalformed;
+			}
+
+			auto gatewayConfig = gwResponse->getObject("configuration");
+			// Replacing the full config-raw section is intentional because parental-control is
+			// currently the only service producing config-raw, and the gateway-fetched config-raw
+			// doesn't include a reliable ownership marker to enable selective merging.
+			gatewayConfig->set("config-raw", configRaw);
+
+			Poco::JSON::Object::Ptr configureResponse;
+			Poco::Net::HTTPResponse::HTTPStatus configureStatus;
+			if (!SDK::GW::Device::Configure(&handler, serialNumber, gatewayConfig, configureStatus,
+											configureResponse)) {
+				logger.error(fmt::format("{}: gateway configure failed (serial={})", operationName,
+										 serialNumber));
+				return ApplyConfigRawResult::GatewayConfigureFailed;
+			}
+			return ApplyConfigRawResult::Applied;
+		}
+
+		//	Every parental-control mutation returns the complete config-raw of the subscriber, so
+		//	only the latest snapshot needs to reach the gateway. A request for an idle gateway
+		//	pushes at once. While a push is in progress, later requests for that gateway join one
+		//	pending batch; when the push is done, the request that opened the batch pushes the latest
+		//	snapshot with its own credentials and completes every request of the batch with the
+		//	same result.
+		struct ConfigRawBatch {
+			Poco::JSON::Array::Ptr configRaw;
+			std::promise<ApplyConfigRawResult> promise;
+			std::shared_future<ApplyConfigRawResult> result;
+			std::size_t requests = 0;
+		};
+
+		struct GatewayApplyState {
+			std::condition_variable changed;
+			std::shared_ptr<ConfigRawBatch> pending;
+			bool pushing = false;
+		};
+
+		std::mutex ApplyMutex;
+		std::map<std::string, GatewayApplyState> ApplyByGateway;
+
+		ApplyConfigRawResult CoalescedPushConfigRaw(RESTAPIHandler &handler, Poco::Logger &logger,
+													const std::string &serialNumber,
+													const Poco::JSON::Array::Ptr &configRaw,
+													const std::string &operationName) {
+			std::unique_lock lock(ApplyMutex);
+			auto &gateway = ApplyByGateway[serialNumber];
+			if (gateway.pending) {
+				auto batch = gateway.pending;
+				batch->configRaw = configRaw;
+				++batch->requests;
+				lock.unlock();
+				return batch->result.get();
+			}
+
+			auto batch = std::make_shared<ConfigRawBatch>();
+			batch->configRaw = configRaw;
+			batch->result = batch->promise.get_future().share();
+			batch->requests = 1;
+			if (gateway.pushing) {
+				gateway.pending = batch;
+				gateway.changed.wait(lock, [&gateway] { return !gateway.pushing; });
+				gateway.pending.reset();
+			}
+			gateway.pushing = true;
+			const auto snapshot = batch->configRaw;
+			const auto requests = batch->requests;
+			lock.unlock();
+
+			if (requests > 1) {
+				logger.debug(fmt::format("{}: pushing one config-raw for {} requests (serial={})",
+										 operationName, requests, serialNumber));
+			}
+			auto result = ApplyConfigRawResult::GatewayConfigureFailed;
+			try {
+				result = PushConfigRaw(handler, logger, serialNumber, snapshot, operationName);
+			} catch (const std::exception &e) {
+				logger.error(fmt::format("{}: gateway apply failed (serial={}): {}", operationName,
+										 serialNumber, e.what()));
+			} catch (...) {
+				logger.error(fmt::format("{}: gateway apply failed (serial={})", operationName,
+										 serialNumber));
+			}
+
+			lock.lock();
+			gateway.pushing = false;
+			if (gateway.pending) {
+				gateway.changed.notify_all();
+			} else {
+				ApplyByGateway.erase(serialNumber);
+			}
+			lock.unlock();
+			batch->promise.set_value(result);
+			return result;
+		}
+	} // namespace
+
 	ApplyConfigRawResult ApplyConfigRaw(RESTAPIHandler &handler, Poco::Logger &logger,
 										const std::string &subscriberId,
 										const std::string &operatorId, const std::string &objectId,
@@ -713,42 +857,7 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 			return ApplyConfigRawResult::MissingGatewaySerial;
 		}
 
-		Poco::JSON::Object::Ptr gwResponse;
-		Poco::Net::HTTPResponse::HTTPStatus gwStatus;
-		if (!SDK::GW::Device::GetConfig(&handler, resolvedSerial, gwStatus, gwResponse)) {
-			if (gwStatus == Poco::Net::HTTPResponse::HTTP_OK) {
-				logger.error(fmt::format("{}: gateway config malformed (serial={})", operationName,
-										 resolvedSerial));
-			} else {
-				logger.error(fmt::format("{}: gateway config load failed (serial={})",
-										 operationName, resolvedSerial));
-			}
-			return ApplyConfigRawResult::GatewayConfigLoadFailed;
-		}
-
-		if (!gwResponse || !gwResponse->has("configuration") ||
-			!gwResponse->isObject("configuration")) {
-			logger.error(fmt::format("{}: gateway config malformed (serial={})", operationName,
-									 resolvedSerial));
-			return ApplyConfigRawResult::GatewayConfigMalformed;
-		}
-
-		auto gatewayConfig = gwResponse->getObject("configuration");
-		// Replacing the full config-raw section is intentional because parental-control is
-		// currently the only service producing config-raw, and the gateway-fetched config-raw
-		// doesn't include a reliable ownership marker to enable selective merging.
-		gatewayConfig->set("config-raw", configRaw);
-
-		Poco::JSON::Object::Ptr configureResponse;
-		Poco::Net::HTTPResponse::HTTPStatus configureStatus;
-		if (!SDK::GW::Device::Configure(&handler, resolvedSerial, gatewayConfig, configureStatus,
-										configureResponse)) {
-			logger.error(fmt::format("{}: gateway configure failed (serial={})", operationName,
-									 resolvedSerial));
-			return ApplyConfigRawResult::GatewayConfigureFailed;
-		}
-
-		return ApplyConfigRawResult::Applied;
+		return CoalescedPushConfigRaw(handler, logger, resolvedSerial, configRaw, operationName);
 	}
 
 	void ForwardParentalControlErrorResponse(
@@ -765,25 +874,51 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 		return handler->ForwardErrorResponse(handler, status, downstreamResponse);
 	}
 
-	bool HandleApplyConfigRawResult(RESTAPIHandler &handler, ApplyConfigRawResult result) {
+	Poco::JSON::Object::Ptr ParentalControlErrorBody(
+		Poco::Net::HTTPResponse::HTTPStatus status,
+		const Poco::JSON::Object::Ptr &downstreamResponse) {
+		auto normalized = NormalizeParentalControlErrorResponse(status, downstreamResponse);
+		if (normalized) {
+			return normalized;
+		}
+		return downstreamResponse ? downstreamResponse : Poco::makeShared<Poco::JSON::Object>();
+	}
+
+	bool ApplyConfigRawError(ApplyConfigRawResult result, Poco::Net::HTTPResponse::HTTPStatus &status,
+							 RESTAPI::Errors::msg &error) {
+		status = Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR;
+		error = RESTAPI::Errors::InternalError;
 		switch (result) {
 		case ApplyConfigRawResult::NoConfigApplyNeeded:
 		case ApplyConfigRawResult::Applied:
-			return true;
-		case ApplyConfigRawResult::MissingOperatorId:
-			handler.UnAuthorized(RESTAPI::Errors::OperatorIdMustExist);
 			return false;
+		case ApplyConfigRawResult::MissingOperatorId:
+			status = Poco::Net::HTTPResponse::HTTP_FORBIDDEN;
+			error = RESTAPI::Errors::OperatorIdMustExist;
+			return true;
 		case ApplyConfigRawResult::MissingGatewaySerial:
-			handler.InternalError(RESTAPI::Errors::MissingSerialNumber);
-			return false;
+			error = RESTAPI::Errors::MissingSerialNumber;
+			return true;
 		case ApplyConfigRawResult::ProvisioningLookupFailed:
 		case ApplyConfigRawResult::GatewayConfigLoadFailed:
 		case ApplyConfigRawResult::GatewayConfigMalformed:
 		case ApplyConfigRawResult::GatewayConfigureFailed:
-			handler.InternalError(RESTAPI::Errors::InternalError);
-			return false;
+			return true;
+		}
+		return true;
+	}
+
+	bool HandleApplyConfigRawResult(RESTAPIHandler &handler, ApplyConfigRawResult result) {
+		Poco::Net::HTTPResponse::HTTPStatus status;
+		RESTAPI::Errors::msg error;
+		if (!ApplyConfigRawError(result, status, error)) {
+			return true;
+		}
+		if (status == Poco::Net::HTTPResponse::HTTP_FORBIDDEN) {
+			handler.UnAuthorized(error);
+		} else {
+			handler.InternalError(error);
 		}
-		handler.InternalError(RESTAPI::Errors::InternalError);
 		return false;
 	}
 
@@ -887,7 +1022,11 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 	namespace {
 		constexpr const char *CLIENT_ACCESS_PREFIX = "firewall.pc_client_access_";
 		constexpr const char *SCHEDULE_PREFIX = "firewall.pc_rule_g";
+		constexpr int64_t SECONDS_PER_DAY = 86400;
+		constexpr std::size_t MAX_COMPILED_RULE_SETS = 4096;
 
+		// One firewall section as found in config-raw. Dates are days since the epoch and
+		// times seconds of the day; the has* flags are only set for well-formed values.
 		struct FirewallRuleInfo {
 			bool enabled = false;
 			bool hasSection = false;
@@ -899,81 +1038,172 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 			bool hasWeekdays = false;
 			bool isClientAccessRule = false;
 			bool hasClientAccessBoundary = false;
-			std::string startDate;
-			std::string stopDate;
-			std::string startTime;
-			std::string stopTime;
-			std::set<int> weekdays;
-			std::vector<std::string> macs;
+			int64_t startDay = 0;
+			int64_t stopDay = 0;
+			int32_t startSecond = 0;
+			int32_t stopSecond = 0;
+			uint8_t weekdays = 0;
+			std::vector<uint64_t> macs;
 		};
 
-		bool IsValidDate(const std::string &date) {
-			if (date.size() != 10) return false;
-			Poco::DateTime dt;
-			int tz = 0;
-			return Poco::DateTimeParser::tryParse("%Y-%m-%d", date, dt, tz);
+		bool Digits(const std::string &s, std::size_t pos, std::size_t count, int &value) {
+			value = 0;
+			for (std::size_t i = pos; i < pos + count; ++i) {
+				if (!std::isdigit(static_cast<unsigned char>(s[i])))
+					return false;
+				value = value * 10 + (s[i] - '0');
+			}
+			return true;
 		}
 
-		bool IsValidTime(const std::string &time) {
-			if (time.size() != 8) return false;
-			Poco::DateTime dt;
-			int tz = 0;
-			return Poco::DateTimeParser::tryParse("%H:%M:%S", time, dt, tz);
+		// "YYYY-MM-DD" -> days since 1970-01-01
+		bool ParseRuleDate(const std::string &date, int64_t &day) {
+			int y = 0, m = 0, d = 0;
+			if (date.size() != 10 || date[4] != '-' || date[7] != '-' || !Digits(date, 0, 4, y) ||
+				!Digits(date, 5, 2, m) || !Digits(date, 8, 2, d))
+				return false;
+			date::year_month_day ymd{date::year{y}, date::month{static_cast<unsigned>(m)},
+									 date::day{static_cast<unsigned>(d)}};
+			if (!ymd.ok())
+				return false;
+			day = date::sys_days(ymd).time_since_epoch().count();
+			return true;
 		}
 
-		// Evaluates both date-bounded client-access rules and recurring UTC schedule
-		// rules. Schedule start is inclusive and stop is exclusive. Overnight
-		// schedules (startTime > stopTime) continue into the following weekday.
-		bool IsRuleActive(int nowUtcWeekday, const std::string &nowDateStr, const std::string &nowTimeStr, const FirewallRuleInfo &rule, const Poco::DateTime &nowUtc, int64_t &outStopEpochSec) {
-			outStopEpochSec = 0;
-			if (!rule.hasSection || !rule.hasEnabled || !rule.enabled) {
+		// "HH:MM:SS" -> second of the day
+		bool ParseRuleTime(const std::string &time, int32_t &second) {
+			int h = 0, m = 0, s = 0;
+			if (time.size() != 8 || time[2] != ':' || time[5] != ':' || !Digits(time, 0, 2, h) ||
+				!Digits(time, 3, 2, m) || !Digits(time, 6, 2, s) || h > 23 || m > 59 || s > 59)
 				return false;
+			second = h * 3600 + m * 60 + s;
+			return true;
+		}
+
+		bool ParseRuleWeekdays(std::string val, uint8_t &mask) {
+			static const char *names[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+			if (val.size() >= 2 && val.front() == '\'' && val.back() == '\'') {
+				val = val.substr(1, val.size() - 2);
 			}
-			if (rule.macs.empty()) {
-				return false;
+			std::istringstream stream(val);
+			std::string token;
+			mask = 0;
+			while (stream >> token) {
+				int day = 0;
+				while (day < 7 && token != names[day])
+					++day;
+				if (day == 7)
+					return false;
+				mask |= static_cast<uint8_t>(1u << day);
 			}
+			return mask != 0;
+		}
 
-			if (rule.hasWeekdays) {
-				if (!rule.hasStartTime || !rule.hasStopTime) {
-					return false;
-				}
-				const std::string &start = rule.startTime;
-				const std::string &stop = rule.stopTime;
-				if (start == stop) {
-					return false;
-				}
-				bool active = false;
-				std::string stopStr;
-				if (start < stop) {
-					if (rule.weekdays.count(nowUtcWeekday) && nowTimeStr >= start && nowTimeStr < stop) {
-						active = true;
-						stopStr = nowDateStr + " " + stop;
+		// Normalized (12 lowercase hex digits) MAC <-> packed integer.
+		uint64_t PackMac(const std::string &mac) {
+			uint64_t packed = 0;
+			for (const auto c : mac)
+				packed = (packed << 4) | static_cast<uint64_t>(c <= '9' ? c - '0' : c - 'a' + 10);
+			return packed;
+		}
+
+		std::string UnpackMac(uint64_t packed) {
+			static const char hex[] = "0123456789abcdef";
+			std::string mac(12, '0');
+			for (int i = 11; i >= 0; --i, packed >>= 4)
+				mac[i] = hex[packed & 0x0f];
+			return mac;
+		}
+
+		void ParseFirewallRules(const Poco::JSON::Array::Ptr &configRaw,
+								std::map<std::string, FirewallRuleInfo> &rules) {
+			for (std::size_t i = 0; i < configRaw->size(); ++i) {
+				try {
+					auto cmd = configRaw->getArray(i);
+					if (!cmd || cmd->size() != 3)
+						continue;
+
+					auto op = cmd->getElement<std::string>(0);
+					auto key = cmd->getElement<std::string>(1);
+					auto val = cmd->getElement<std::string>(2);
+
+					const bool isClientAccessRule = key.rfind(CLIENT_ACCESS_PREFIX, 0) == 0;
+					const bool isScheduleRule = key.rfind(SCHEDULE_PREFIX, 0) == 0;
+
+					if (!isClientAccessRule && !isScheduleRule) {
+						continue;
 					}
-				} else {
-					const int previousWeekday = (nowUtcWeekday + 6) % 7;
-					if (rule.weekdays.count(nowUtcWeekday) && nowTimeStr >= start) {
-						active = true;
-						Poco::DateTime nextDay = nowUtc + Poco::Timespan(86400, 0);
-						stopStr = Poco::DateTimeFormatter::format(nextDay, "%Y-%m-%d") + " " + stop;
-					} else if (rule.weekdays.count(previousWeekday) && nowTimeStr < stop) {
-						active = true;
-						stopStr = nowDateStr + " " + stop;
+
+					const std::size_t prefixLength = isClientAccessRule ? std::strlen(CLIENT_ACCESS_PREFIX) : std::strlen(SCHEDULE_PREFIX);
+					const auto nextDot = key.find('.', prefixLength);
+					auto &rule = rules[nextDot == std::string::npos ? key : key.substr(0, nextDot)];
+
+					if (isClientAccessRule) {
+						rule.isClientAccessRule = true;
 					}
-				}
-				if (!active) {
-					return false;
-				}
 
-				Poco::DateTime stopDt;
-				int tz = 0;
-				if (!Poco::DateTimeParser::tryParse("%Y-%m-%d %H:%M:%S", stopStr, stopDt, tz)) {
-					return false;
+					if (nextDot == std::string::npos) {
+						if (op == "set" && val == "rule") {
+							rule.hasSection = true;
+						}
+						continue;
+					}
+
+					const std::string param = key.substr(nextDot + 1);
+
+					if (op == "set") {
+						if (param == "enabled") {
+							rule.enabled = (val == "1");
+							rule.hasEnabled = true;
+						} else if (param == "start_time") {
+							if (isClientAccessRule) {
+								rule.hasClientAccessBoundary = true;
+							}
+							rule.hasStartTime = ParseRuleTime(val, rule.startSecond);
+						} else if (param == "stop_time") {
+							if (isClientAccessRule) {
+								rule.hasClientAccessBoundary = true;
+							}
+							rule.hasStopTime = ParseRuleTime(val, rule.stopSecond);
+						} else if (isClientAccessRule && param == "start_date") {
+							rule.hasClientAccessBoundary = true;
+							rule.hasStartDate = ParseRuleDate(val, rule.startDay);
+						} else if (isClientAccessRule && param == "stop_date") {
+							rule.hasClientAccessBoundary = true;
+							rule.hasStopDate = ParseRuleDate(val, rule.stopDay);
+						} else if (isScheduleRule && param == "weekdays") {
+							rule.hasWeekdays = ParseRuleWeekdays(val, rule.weekdays);
+							if (!rule.hasWeekdays) {
+								rule.weekdays = 0;
+							}
+						}
+					} else if (op == "add_list" && param == "src_mac") {
+						std::string normalizedMac = val;
+						if (Utils::NormalizeMac(normalizedMac)) {
+							rule.macs.push_back(PackMac(normalizedMac));
+						}
+					}
+				} catch (...) {
+					continue;
 				}
+			}
+		}
+
+		// Turns a parsed section into its compiled form. Returns false for sections that can
+		// never be active: disabled, incomplete, malformed or without any valid MAC.
+		bool CompileRule(const FirewallRuleInfo &rule, CompiledBlockRule &compiled) {
+			if (!rule.hasSection || !rule.hasEnabled || !rule.enabled || rule.macs.empty()) {
+				return false;
+			}
 
-				if (stopDt <= nowUtc) {
+			if (rule.hasWeekdays) {
+				if (!rule.hasStartTime || !rule.hasStopTime || rule.startSecond == rule.stopSecond) {
 					return false;
 				}
-				outStopEpochSec = stopDt.timestamp().epochTime();
+				compiled.kind = CompiledBlockRule::Kind::Schedule;
+				compiled.weekdays = rule.weekdays;
+				compiled.startSecond = rule.startSecond;
+				compiled.stopSecond = rule.stopSecond;
 				return true;
 			}
 
@@ -982,7 +1212,7 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 			}
 
 			if (!rule.hasClientAccessBoundary) {
-				outStopEpochSec = -1; // Permanent block
+				compiled.kind = CompiledBlockRule::Kind::Permanent;
 				return true;
 			}
 
@@ -990,195 +1220,253 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 				return false;
 			}
 
-			const std::string nowStr = nowDateStr + " " + nowTimeStr;
-			const std::string startStr = rule.startDate + " " + rule.startTime;
-			if (nowStr < startStr) {
-				return false;
-			}
-
 			// For same-day time windows (stopTime >= startTime), the daily stop
 			// threshold uses startDate because stop_date is intentionally set to
 			// the next calendar date by mango-parental-control.
-			std::string stopDate = rule.stopDate;
-			if (rule.stopTime >= rule.startTime) {
-				stopDate = rule.startDate;
+			const int64_t stopDay = rule.stopSecond >= rule.startSecond ? rule.startDay : rule.stopDay;
+			compiled.kind = CompiledBlockRule::Kind::Window;
+			compiled.startEpoch = rule.startDay * SECONDS_PER_DAY + rule.startSecond;
+			compiled.stopEpoch = stopDay * SECONDS_PER_DAY + rule.stopSecond;
+			return compiled.stopEpoch > compiled.startEpoch;
+		}
+
+		uint64_t ConfigUuid(const Poco::JSON::Object::Ptr &config) {
+			try {
+				if (config->has("uuid"))
+					return config->get("uuid").convert<uint64_t>();
+			} catch (...) {
 			}
+			return 0;
+		}
 
-			const std::string stopStr = stopDate + " " + rule.stopTime;
-			if (nowStr >= stopStr) {
-				return false;
+		int64_t DayOf(int64_t epochSec) {
+			int64_t day = epochSec / SECONDS_PER_DAY;
+			if (epochSec % SECONDS_PER_DAY < 0) {
+				--day;
 			}
+			return day;
+		}
 
-			Poco::DateTime stopDt;
-			int tz = 0;
-			if (!Poco::DateTimeParser::tryParse("%Y-%m-%d %H:%M:%S", stopStr, stopDt, tz)) {
-				return false;
+		int WeekdayOf(int64_t day) {
+			return static_cast<int>(((day + 4) % 7 + 7) % 7); // 1970-01-01 was a Thursday
+		}
+
+		// First start or stop of the rule strictly after nowEpochSec, -1 if there is none.
+		int64_t NextRuleTransition(const CompiledBlockRule &rule, int64_t nowEpochSec) {
+			switch (rule.kind) {
+			case CompiledBlockRule::Kind::Permanent:
+				return -1;
+			case CompiledBlockRule::Kind::Window:
+				if (nowEpochSec < rule.startEpoch)
+					return rule.startEpoch;
+				return nowEpochSec < rule.stopEpoch ? rule.stopEpoch : -1;
+			case CompiledBlockRule::Kind::Schedule:
+				break;
 			}
 
-			if (stopDt <= nowUtc) {
-				return false;
+			// An overnight occurrence that started yesterday may still have its stop ahead.
+			const int64_t today = DayOf(nowEpochSec);
+			const int64_t overnight = rule.startSecond > rule.stopSecond ? SECONDS_PER_DAY : 0;
+			int64_t next = -1;
+			for (int64_t day = today - 1; day <= today + 7; ++day) {
+				if (!(rule.weekdays & (1u << WeekdayOf(day))))
+					continue;
+				const int64_t midnight = day * SECONDS_PER_DAY;
+				for (const int64_t t : {midnight + rule.startSecond, midnight + overnight + rule.stopSecond}) {
+					if (t > nowEpochSec && (next == -1 || t < next))
+						next = t;
+				}
 			}
-			outStopEpochSec = stopDt.timestamp().epochTime();
-			return true;
+			return next;
 		}
-	} // namespace
 
-	bool GetBlockedClients(const Poco::JSON::Object::Ptr &config,
-						   std::map<std::string, std::string> &blockedMacsWithUntil,
-						   const std::string &timezoneStr) {
-		blockedMacsWithUntil.clear();
-		if (!config || !config->has("config-raw") || !config->isArray("config-raw")) {
-			return config != nullptr;
-		}
+		std::shared_mutex TimelinesMutex;
+		std::map<std::string, std::shared_ptr<BlockTimeline>> TimelinesByGateway;
+	} // namespace
 
-		auto configRaw = config->getArray("config-raw");
+	std::shared_ptr<const CompiledBlockRules> CompileBlockRules(const Poco::JSON::Array::Ptr &configRaw,
+																  uint64_t uuid) {
+		auto compiled = std::make_shared<CompiledBlockRules>();
+		compiled->uuid = uuid;
 		if (!configRaw) {
-			return true;
+			return compiled;
 		}
 
-		Poco::DateTime nowUtc;
-		const std::string nowDateStr = Poco::DateTimeFormatter::format(nowUtc, "%Y-%m-%d");
-		const std::string nowTimeStr = Poco::DateTimeFormatter::format(nowUtc, "%H:%M:%S");
-		const int nowUtcWeekday = nowUtc.dayOfWeek();
-
 		std::map<std::string, FirewallRuleInfo> rules;
-		for (std::size_t i = 0; i < configRaw->size(); ++i) {
-			try {
-				auto cmd = configRaw->getArray(i);
-				if (!cmd || cmd->size() != 3)
-					continue;
+		ParseFirewallRules(configRaw, rules);
 
-				auto op = cmd->getElement<std::string>(0);
-				auto key = cmd->getElement<std::string>(1);
-				auto val = cmd->getElement<std::string>(2);
-
-				const bool isClientAccessRule = key.rfind(CLIENT_ACCESS_PREFIX, 0) == 0;
-				const bool isScheduleRule = key.rfind(SCHEDULE_PREFIX, 0) == 0;
+		for (const auto &[section, rule] : rules) {
+			CompiledBlockRule entry;
+			if (!CompileRule(rule, entry)) {
+				continue;
+			}
+			entry.firstMac = static_cast<uint32_t>(compiled->macs.size());
+			entry.macCount = static_cast<uint32_t>(rule.macs.size());
+			compiled->macs.insert(compiled->macs.end(), rule.macs.begin(), rule.macs.end());
+			compiled->rules.push_back(entry);
+		}
+		return compiled;
+	}
 
-				if (!isClientAccessRule && !isScheduleRule) {
+	// Schedule start is inclusive and stop is exclusive. Overnight schedules
+	// (start > stop) continue into the following weekday. All times are UTC.
+	void EvaluateBlockRules(const CompiledBlockRules &rules, int64_t nowEpochSec,
+							std::map<uint64_t, int64_t> &macStopEpochMap) {
+		const int64_t midnight = DayOf(nowEpochSec) * SECONDS_PER_DAY;
+		const int32_t secondOfDay = static_cast<int32_t>(nowEpochSec - midnight);
+		const int weekday = WeekdayOf(DayOf(nowEpochSec));
+		const uint8_t today = static_cast<uint8_t>(1u << weekday);
+		const uint8_t yesterday = static_cast<uint8_t>(1u << ((weekday + 6) % 7));
+
+		for (const auto &rule : rules.rules) {
+			int64_t stopEpoch = 0;
+			switch (rule.kind) {
+			case CompiledBlockRule::Kind::Permanent:
+				stopEpoch = -1;
+				break;
+			case CompiledBlockRule::Kind::Window:
+				if (nowEpochSec < rule.startEpoch || nowEpochSec >= rule.stopEpoch)
+					continue;
+				stopEpoch = rule.stopEpoch;
+				break;
+			case CompiledBlockRule::Kind::Schedule:
+				if (rule.startSecond < rule.stopSecond) {
+					if (!(rule.weekdays & today) || secondOfDay < rule.startSecond ||
+						secondOfDay >= rule.stopSecond)
+						continue;
+					stopEpoch = midnight + rule.stopSecond;
+				} else if ((rule.weekdays & today) && secondOfDay >= rule.startSecond) {
+					stopEpoch = midnight + SECONDS_PER_DAY + rule.stopSecond;
+				} else if ((rule.weekdays & yesterday) && secondOfDay < rule.stopSecond) {
+					stopEpoch = midnight + rule.stopSecond;
+				} else {
 					continue;
 				}
+				break;
+			}
 
-				const std::size_t prefixLength = isClientAccessRule ? std::string(CLIENT_ACCESS_PREFIX).size() : std::string(SCHEDULE_PREFIX).size();
-				const auto nextDot = key.find('.', prefixLength);
-
-				if (isClientAccessRule) {
-					if (nextDot == std::string::npos) {
-						rules[key].isClientAccessRule = true;
-					} else {
-						rules[key.substr(0, nextDot)].isClientAccessRule = true;
-					}
-				}
-
-				if (nextDot == std::string::npos) {
-					if (op == "set" && val == "rule") {
-						rules[key].hasSection = true;
-					}
-					continue;
+			const auto *mac = rules.macs.data() + rule.firstMac;
+			for (const auto *end = mac + rule.macCount; mac != end; ++mac) {
+				auto [it, inserted] = macStopEpochMap.emplace(*mac, stopEpoch);
+				if (!inserted && it->second != -1 && (stopEpoch == -1 || stopEpoch > it->second)) {
+					it->second = stopEpoch;
 				}
+			}
+		}
+	}
 
-				const std::string section = key.substr(0, nextDot);
-				const std::string param = key.substr(nextDot + 1);
+	BlockTimeline::BlockTimeline(std::shared_ptr<const CompiledBlockRules> rules)
+		: Rules_(std::move(rules)) {}
 
-				if (op == "set") {
-					if (param == "enabled") {
-						rules[section].enabled = (val == "1");
-						rules[section].hasEnabled = true;
-					} else if (param == "start_time") {
-						if (isClientAccessRule) {
-							rules[section].hasClientAccessBoundary = true;
-						}
-						rules[section].startTime = val;
-						rules[section].hasStartTime = IsValidTime(val);
-					} else if (param == "stop_time") {
-						if (isClientAccessRule) {
-							rules[section].hasClientAccessBoundary = true;
-						}
-						rules[section].stopTime = val;
-						rules[section].hasStopTime = IsValidTime(val);
-					} else if (isClientAccessRule && param == "start_date") {
-						rules[section].hasClientAccessBoundary = true;
-						rules[section].startDate = val;
-						rules[section].hasStartDate = IsValidDate(val);
-					} else if (isClientAccessRule && param == "stop_date") {
-						rules[section].hasClientAccessBoundary = true;
-						rules[section].stopDate = val;
-						rules[section].hasStopDate = IsValidDate(val);
-					} else if (isScheduleRule && param == "weekdays") {
-						std::string weekdaysVal = val;
-						if (weekdaysVal.size() >= 2 && weekdaysVal.front() == '\'' && weekdaysVal.back() == '\'') {
-							weekdaysVal = weekdaysVal.substr(1, weekdaysVal.size() - 2);
-						}
-						std::istringstream stream(weekdaysVal);
-						std::string token;
-						std::set<int> parsedWeekdays;
-						bool validWeekdays = true;
-
-						rules[section].weekdays.clear();
-						rules[section].hasWeekdays = false;
-
-						while (stream >> token) {
-							if (token == "Sun") {
-								parsedWeekdays.insert(0);
-							} else if (token == "Mon") {
-								parsedWeekdays.insert(1);
-							} else if (token == "Tue") {
-								parsedWeekdays.insert(2);
-							} else if (token == "Wed") {
-								parsedWeekdays.insert(3);
-							} else if (token == "Thu") {
-								parsedWeekdays.insert(4);
-							} else if (token == "Fri") {
-								parsedWeekdays.insert(5);
-							} else if (token == "Sat") {
-								parsedWeekdays.insert(6);
-							} else {
-								validWeekdays = false;
-								break;
-							}
-						}
+	void BlockTimeline::Advance(int64_t nowEpochSec) {
+		if (Evaluated_ && nowEpochSec >= EvaluatedAt_ &&
+			(Transitions_.empty() || Transitions_.top().first > nowEpochSec)) {
+			return;
+		}
 
-						if (validWeekdays && !parsedWeekdays.empty()) {
-							rules[section].weekdays = parsedWeekdays;
-							rules[section].hasWeekdays = true;
-						}
-					}
-				} else if (op == "add_list" && param == "src_mac") {
-					std::string normalizedMac = val;
-					if (Utils::NormalizeMac(normalizedMac)) {
-						rules[section].macs.push_back(normalizedMac);
-					}
-				}
-			} catch (...) {
-				continue;
+		if (!Evaluated_ || nowEpochSec < EvaluatedAt_) {
+			// First use, or the clock went backwards: schedule every rule from scratch.
+			Transitions_ = decltype(Transitions_)();
+			for (uint32_t i = 0; i < Rules_->rules.size(); ++i) {
+				const auto next = NextRuleTransition(Rules_->rules[i], nowEpochSec);
+				if (next != -1)
+					Transitions_.emplace(next, i);
+			}
+		} else {
+			while (!Transitions_.empty() && Transitions_.top().first <= nowEpochSec) {
+				const auto rule = Transitions_.top().second;
+				Transitions_.pop();
+				const auto next = NextRuleTransition(Rules_->rules[rule], nowEpochSec);
+				if (next != -1)
+					Transitions_.emplace(next, rule);
 			}
 		}
 
-		std::map<std::string, int64_t> macStopEpochMap;
-		for (const auto &[section, rule] : rules) {
-			int64_t stopEpoch = 0;
-			if (IsRuleActive(nowUtcWeekday, nowDateStr, nowTimeStr, rule, nowUtc, stopEpoch)) {
-				for (const auto &mac : rule.macs) {
-					auto it = macStopEpochMap.find(mac);
-					if (it == macStopEpochMap.end()) {
-						macStopEpochMap[mac] = stopEpoch;
-					} else if (stopEpoch == -1 || (it->second != -1 && stopEpoch > it->second)) {
-						macStopEpochMap[mac] = stopEpoch;
-					}
-				}
+		Blocked_.clear();
+		EvaluateBlockRules(*Rules_, nowEpochSec, Blocked_);
+		EvaluatedAt_ = nowEpochSec;
+		Evaluated_ = true;
+	}
+
+	void BlockTimeline::BlockedAt(int64_t nowEpochSec, std::map<uint64_t, int64_t> &macStopEpochMap) {
+		std::lock_guard lock(Mutex_);
+		Advance(nowEpochSec);
+		macStopEpochMap = Blocked_;
+	}
+
+	int64_t BlockTimeline::NextTransition() {
+		std::lock_guard lock(Mutex_);
+		return Transitions_.empty() ? -1 : Transitions_.top().first;
+	}
+
+	std::shared_ptr<BlockTimeline> GetBlockTimeline(const Poco::JSON::Object::Ptr &config,
+													const std::string &gatewaySerial) {
+		if (!config || !config->isArray("config-raw")) {
+			return nullptr;
+		}
+
+		const auto uuid = ConfigUuid(config);
+		if (gatewaySerial.empty() || uuid == 0) {
+			return std::make_shared<BlockTimeline>(CompileBlockRules(config->getArray("config-raw"), uuid));
+		}
+
+		{
+			std::shared_lock lock(TimelinesMutex);
+			auto it = TimelinesByGateway.find(gatewaySerial);
+			if (it != TimelinesByGateway.end() && it->second->Uuid() == uuid) {
+				return it->second;
 			}
 		}
 
+		auto timeline = std::make_shared<BlockTimeline>(CompileBlockRules(config->getArray("config-raw"), uuid));
+		std::unique_lock lock(TimelinesMutex);
+		if (TimelinesByGateway.size() >= MAX_COMPILED_RULE_SETS &&
+			TimelinesByGateway.find(gatewaySerial) == TimelinesByGateway.end()) {
+			TimelinesByGateway.erase(TimelinesByGateway.begin());
+		}
+		TimelinesByGateway[gatewaySerial] = timeline;
+		return timeline;
+	}
+
+	bool GetBlockedClients(const Poco::JSON::Object::Ptr &config,
+						   std::map<std::string, std::string> &blockedMacsWithUntil,
+						   const std::string &timezoneStr, const std::string &gatewaySerial) {
+		blockedMacsWithUntil.clear();
+		if (!config || !config->has("config-raw") || !config->isArray("config-raw")) {
+			return config != nullptr;
+		}
+
+		auto timeline = GetBlockTimeline(config, gatewaySerial);
+		if (!timeline) {
+			return true;
+		}
+
+		std::map<uint64_t, int64_t> macStopEpochMap;
+		timeline->BlockedAt(Poco::Timestamp().epochTime(), macStopEpochMap);
+		if (macStopEpochMap.empty()) {
+			return true;
+		}
+
 		auto &logger = Poco::Logger::get("ParentalControl");
-		for (const auto &[mac, stopEpoch] : macStopEpochMap) {
+		const date::time_zone *zone = nullptr;
+		if (!timezoneStr.empty()) {
+			try {
+				zone = VenueContextCache()->LocateZone(timezoneStr);
+			} catch (const std::exception &e) {
+				logger.warning(fmt::format("Failed to format blocked_until for timezone [{}]: {}", timezoneStr, e.what()));
+			} catch (...) {
+				logger.warning(fmt::format("Failed to format blocked_until for timezone [{}]: unknown error", timezoneStr));
+			}
+		}
+
+		for (const auto &[packedMac, stopEpoch] : macStopEpochMap) {
 			std::string untilStr;
 			if (stopEpoch == -1) {
 				untilStr = "indefinite";
 			} else {
 				bool converted = false;
-				if (!timezoneStr.empty()) {
+				if (zone) {
 					try {
-						const auto *zone = date::locate_zone(timezoneStr);
 						auto sysTp = std::chrono::system_clock::from_time_t(static_cast<std::time_t>(stopEpoch));
 						auto localTp = date::make_zoned(zone, sysTp).get_local_time();
 						auto localSec = date::floor<std::chrono::seconds>(localTp);
@@ -1186,8 +1474,6 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 						converted = true;
 					} catch (const std::exception &e) {
 						logger.warning(fmt::format("Failed to format blocked_until for timezone [{}]: {}", timezoneStr, e.what()));
-					} catch (...) {
-						logger.warning(fmt::format("Failed to format blocked_until for timezone [{}]: unknown error", timezoneStr));
 					}
 				}
 				if (!converted) {
@@ -1195,6 +1481,7 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 					untilStr = Poco::DateTimeFormatter::format(stopDt, "%Y-%m-%d %H:%M:%S");
 				}
 			}
+			const auto mac = UnpackMac(packedMac);
 			blockedMacsWithUntil[mac] = untilStr;
 			logger.debug(fmt::format("Active blocked client MAC found: {} (blocked_until={})", Utils::SerialToMAC(mac), untilStr));
 		}
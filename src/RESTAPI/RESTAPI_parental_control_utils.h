@@ -9,10 +9,17 @@
 #include "Poco/JSON/Array.h"
 #include "Poco/JSON/Object.h"
 #include "framework/RESTAPI_Handler.h"
+#include <cstdint>
 #include <list>
 #include <map>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <queue>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace OpenWifi::RESTAPI::ParentalControl {
 
@@ -20,8 +27,62 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 	// Blocked-Client Evaluation (used by topology response)
 	// =========================================================================
 
+	// Firewall rules from a gateway config-raw, compiled once per configuration UUID.
+	// Times are UTC: startSecond/stopSecond are seconds of the day (schedules), startEpoch/
+	// stopEpoch are epoch seconds (client-access windows). MACs are packed into integers.
+	struct CompiledBlockRule {
+		enum class Kind : uint8_t { Schedule, Window, Permanent };
+		Kind kind = Kind::Permanent;
+		uint8_t weekdays = 0; // bit N set: weekday N, 0 = Sunday
+		int32_t startSecond = 0;
+		int32_t stopSecond = 0;
+		int64_t startEpoch = 0;
+		int64_t stopEpoch = 0;
+		uint32_t firstMac = 0; // range in CompiledBlockRules::macs
+		uint32_t macCount = 0;
+	};
+
+	struct CompiledBlockRules {
+		uint64_t uuid = 0;
+		std::vector<CompiledBlockRule> rules;
+		std::vector<uint64_t> macs;
+	};
+
+	std::shared_ptr<const CompiledBlockRules> CompileBlockRules(const Poco::JSON::Array::Ptr &configRaw, uint64_t uuid = 0);
+	// Adds every MAC blocked at nowEpochSec with the epoch its block ends (-1: permanent).
+	void EvaluateBlockRules(const CompiledBlockRules &rules, int64_t nowEpochSec, std::map<uint64_t, int64_t> &macStopEpochMap);
+
+	// Blocked state of one gateway over time. Each rule's next start or stop sits in a
+	// min-heap; the rules are only evaluated again once the earliest transition has passed.
+	class BlockTimeline {
+	  public:
+		explicit BlockTimeline(std::shared_ptr<const CompiledBlockRules> rules);
+
+		[[nodiscard]] uint64_t Uuid() const { return Rules_->uuid; }
+		// Same result as EvaluateBlockRules(), served from the last evaluation when possible.
+		void BlockedAt(int64_t nowEpochSec, std::map<uint64_t, int64_t> &macStopEpochMap);
+		// Epoch of the next block or unblock after the last evaluation, -1 if none.
+		[[nodiscard]] int64_t NextTransition();
+
+	  private:
+		using Transition = std::pair<int64_t, uint32_t>; // epoch, rule index
+
+		std::mutex Mutex_;
+		std::shared_ptr<const CompiledBlockRules> Rules_;
+		std::priority_queue<Transition, std::vector<Transition>, std::greater<>> Transitions_;
+		std::map<uint64_t, int64_t> Blocked_;
+		int64_t EvaluatedAt_ = 0;
+		bool Evaluated_ = false;
+
+		void Advance(int64_t nowEpochSec);
+	};
+
+	// Returns the timeline of a gateway, reusing it while the configuration UUID is
+	// unchanged. Without a serial or a UUID a fresh, uncached timeline is returned.
+	std::shared_ptr<BlockTimeline> GetBlockTimeline(const Poco::JSON::Object::Ptr &config, const std::string &gatewaySerial);
+
 	bool GetBlockedClients(const Poco::JSON::Object::Ptr &config, std::list<std::string> &blockedMacs);
-	bool GetBlockedClients(const Poco::JSON::Object::Ptr &config, std::map<std::string, std::string> &blockedMacsWithUntil, const std::string &timezoneStr = "");
+	bool GetBlockedClients(const Poco::JSON::Object::Ptr &config, std::map<std::string, std::string> &blockedMacsWithUntil, const std::string &timezoneStr = "", const std::string &gatewaySerial = "");
 
 	// =========================================================================
 	// Schedule Helpers
@@ -52,7 +113,12 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 	bool ValidateWeekdays(const Poco::JSON::Array::Ptr &weekdays);
 
 	// Parse and validate schedule POST/PUT JSON request body against schema rules.
-	// On validation failure, sets HTTP 400 Bad Request error on handler and returns false.
+	// On validation failure, sets error to the reason and returns false.
+	bool ParseScheduleRequest(const Poco::JSON::Object::Ptr &body, bool enabledRequired,
+							  ParsedScheduleRequest &out, std::string &error);
+
+	// Same as ParseScheduleRequest, but on validation failure sets HTTP 400 Bad Request
+	// error on handler and returns false.
 	bool ParseAndValidateScheduleRequest(RESTAPIHandler &handler,
 										  const Poco::JSON::Object::Ptr &body,
 										  bool enabledRequired,
@@ -110,6 +176,17 @@ namespace OpenWifi::RESTAPI::ParentalControl {
 		Poco::Net::HTTPResponse::HTTPStatus status,
 		const Poco::JSON::Object::Ptr &downstreamResponse);
 
+	// Error body ForwardParentalControlErrorResponse would send, for callers that embed it in
+	// their own response.
+	Poco::JSON::Object::Ptr ParentalControlErrorBody(
+		Poco::Net::HTTPResponse::HTTPStatus status,
+		const Poco::JSON::Object::Ptr &downstreamResponse);
+
+	// Status and error a failed ApplyConfigRaw result is reported with. Returns false when the
+	// result is not a failure.
+	bool ApplyConfigRawError(ApplyConfigRawResult result, Poco::Net::HTTPResponse::HTTPStatus &status,
+							 RESTAPI::Errors::msg &error);
+
 	bool HandleApplyConfigRawResult(RESTAPIHandler &handler, ApplyConfigRawResult result);
 
 	// Validates the two standard parental-control preconditions that appear at the top of
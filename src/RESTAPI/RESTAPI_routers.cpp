@@ -26,6 +26,7 @@
 #include "RESTAPI/RESTAPI_group_schedules_list_handler.h"
 #include "RESTAPI/RESTAPI_group_schedules_handler.h"
 #include "RESTAPI/RESTAPI_subscriber_location_handler.h"
+#include "RESTAPI/RESTAPI_parental_control_batch_handler.h"
 
 #include "framework/RESTAPI_SystemCommand.h"
 #include "framework/RESTAPI_WebSocketServer.h"
@@ -45,7 +46,7 @@ namespace OpenWifi {
 							  RESTAPI_schedules_list_handler, RESTAPI_schedules_handler,
 							  RESTAPI_group_devices_list_handler, RESTAPI_group_devices_handler,
 							  RESTAPI_group_schedules_list_handler, RESTAPI_group_schedules_handler,
-							  RESTAPI_subscriber_location_handler>(Path, Bindings, L, S, TransactionId);
+							  RESTAPI_subscriber_location_handler, RESTAPI_parental_control_batch_handler>(Path, Bindings, L, S, TransactionId);
 	}
 
 	Poco::Net::HTTPRequestHandler *
@@ -60,7 +61,7 @@ namespace OpenWifi {
 								RESTAPI_schedules_list_handler, RESTAPI_schedules_handler,
 								RESTAPI_group_devices_list_handler, RESTAPI_group_devices_handler,
 								RESTAPI_group_schedules_list_handler, RESTAPI_group_schedules_handler,
-								RESTAPI_subscriber_location_handler>(Path, Bindings, L, S, TransactionId);
+								RESTAPI_subscriber_location_handler, RESTAPI_parental_control_batch_handler>(Path, Bindings, L, S, TransactionId);
 	}
 
 } // namespace OpenWifi
@@ -20,15 +20,34 @@ namespace OpenWifi {
 			return NotFound();
 		}
 
-		SubObjects::StatsBlock SB;
+		//	resolution selects a rollup tier instead of the raw samples.
+		auto Resolution = GetParameter("resolution", 0);
+		if (Resolution != 0 && !StatsSvr()->HasRollup(Resolution)) {
+			return BadRequest(RESTAPI::Errors::MissingOrInvalidParameters);
+		}
+
+		std::string SerialNumber;
 		for (const auto &device : SI.accessPoints.list) {
 			if (device.macAddress == MAC) {
-				StatsSvr()->Get(device.serialNumber, SB);
+				SerialNumber = device.serialNumber;
 				break;
 			}
 		}
+
 		Poco::JSON::Object Answer;
-		SB.to_json(Answer);
+		if (Resolution != 0) {
+			SubObjects::StatsRollupBlock RB;
+			if (SerialNumber.empty())
+				RB.resolution = Resolution;
+			else
+				StatsSvr()->GetRollup(SerialNumber, Resolution, RB);
+			RB.to_json(Answer);
+		} else {
+			SubObjects::StatsBlock SB;
+			if (!SerialNumber.empty())
+				StatsSvr()->Get(SerialNumber, SB);
+			SB.to_json(Answer);
+		}
 		return ReturnObject(Answer);
 	}
 } // namespace OpenWifi
@@ -155,7 +155,7 @@ namespace OpenWifi {
 		Poco::JSON::Object::Ptr config;
 		Poco::Net::HTTPResponse::HTTPStatus responseStatus =
 			Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR;
-		if (!SDK::GW::Device::GetConfig(nullptr, GatewayMac, responseStatus, config)) {
+		if (!SDK::GW::Device::GetConfigSnapshot(nullptr, GatewayMac, responseStatus, config)) {
 			Logger().error(fmt::format("Failed to fetch gateway [{}] configuration for mesh [{}].",
 									   GatewayMac, ctx.Mac));
 			InternalError(RESTAPI::Errors::AddDeviceFailed);
@@ -6,6 +6,7 @@
 
 #include "RESTAPI_subscriber_location_handler.h"
 #include "Poco/String.h"
+#include "VenueContextCache.h"
 #include "sdks/SDK_prov.h"
 #include <date/tz.h>
 #include <set>
@@ -142,6 +143,9 @@ namespace OpenWifi {
 		if (!SDK::Prov::Venue::CreateLocation(nullptr, venueId, locationBody, callStatus, callResponse)) {
 			return ForwardErrorResponse(this, callStatus, callResponse);
 		}
+		// The cached "no timezone" answers for this subscriber and venue are now wrong.
+		VenueContextCache()->Invalidate(UserInfo_.userinfo.id);
+		VenueContextCache()->Invalidate(venueId);
 		return OK();
 	}
 
@@ -207,6 +211,8 @@ namespace OpenWifi {
 		if (!SDK::Prov::Location::Put(nullptr, locationId, locationBody, callStatus, callResponse)) {
 			return ForwardErrorResponse(this, callStatus, callResponse);
 		}
+		VenueContextCache()->Invalidate(UserInfo_.userinfo.id);
+		VenueContextCache()->Invalidate(locationId);
 
 		return ReturnObject(*callResponse);
 	}
@@ -264,6 +270,8 @@ namespace OpenWifi {
 			return ForwardErrorResponse(this, deleteStatus, deleteResponse);
 		}
 
+		VenueContextCache()->Invalidate(UserInfo_.userinfo.id);
+		VenueContextCache()->Invalidate(venueId);
 		return OK();
 	}
 
@@ -3,14 +3,17 @@
  * Copyright (c) 2025 Infernet Systems Pvt Ltd
  * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
  */
+#include <chrono>
 #include <list>
 #include <unordered_map>
 #include <unordered_set>
+#include "framework/OpenAPIExecutor.h"
 #include "framework/utils.h"
 #include "sdks/SDK_gw.h"
 
 #include "RESTAPI_topology_handler.h"
 #include "RESTAPI_parental_control_utils.h"
+#include "VenueContextCache.h"
 
 #include "Poco/String.h"
 #include "framework/ow_constants.h"
@@ -19,6 +22,40 @@
 #include <date/tz.h>
 
 namespace OpenWifi {
+	namespace {
+		// Upper bound on how long the handler waits for the gateway configuration once the
+		// topology itself is ready. Past it, clients are reported as not blocked.
+		constexpr auto kGatewayConfigWait = std::chrono::milliseconds(3000);
+
+		struct GatewayConfigResult {
+			Poco::Net::HTTPServerResponse::HTTPStatus status =
+				Poco::Net::HTTPServerResponse::HTTP_INTERNAL_SERVER_ERROR;
+			Poco::JSON::Object::Ptr config;
+			uint64_t elapsedMs = 0;
+		};
+
+		inline uint64_t ElapsedMs(std::chrono::steady_clock::time_point start) {
+			return std::chrono::duration_cast<std::chrono::milliseconds>(
+					   std::chrono::steady_clock::now() - start)
+				.count();
+		}
+
+		// Runs on an OpenAPIExecutor worker, so it must not touch the handler: the handler may
+		// already have answered (and been destroyed) when this completes.
+		GatewayConfigResult FetchGatewayConfig(const std::string &gatewaySerial) {
+			GatewayConfigResult result;
+			const auto start = std::chrono::steady_clock::now();
+			Poco::JSON::Object::Ptr deviceObj;
+			if (SDK::GW::Device::GetConfigSnapshot(nullptr, gatewaySerial, result.status, deviceObj) &&
+				deviceObj && deviceObj->has("configuration") &&
+				deviceObj->isObject("configuration")) {
+				result.config = deviceObj->getObject("configuration");
+			}
+			result.elapsedMs = ElapsedMs(start);
+			return result;
+		}
+	} // namespace
+
 	bool RESTAPI_topology_handler::FetchSubscriberDevices(
 		ProvObjects::SubscriberDeviceList &subscriberDevices) {
 		Poco::Net::HTTPServerResponse::HTTPStatus callStatus =
@@ -86,6 +123,20 @@ namespace OpenWifi {
 			return false;
 		}
 
+		VenueContext cached;
+		switch (VenueContextCache()->GetByGateway(gatewaySerial, cached)) {
+		case VenueContextLookup::Found:
+			context.boardId = cached.boardId;
+			context.timezone = cached.timezone;
+			return true;
+		case VenueContextLookup::NoTimezone:
+			Logger().debug(fmt::format("[GET-TOPOLOGY] Cached: venue of {} has no timezone for subscriber {}.", gatewaySerial, UserInfo_.userinfo.id));
+			BadRequest(RESTAPI::Errors::TimezoneRequired);
+			return false;
+		case VenueContextLookup::Miss:
+			break;
+		}
+
 		ProvObjects::InventoryTag inventory;
 		if (!SDK::Prov::Device::Get(nullptr, gatewaySerial, inventory)) {
 			Logger().debug(fmt::format("[GET-TOPOLOGY] Inventory record missing for device: {}.",
@@ -133,8 +184,11 @@ namespace OpenWifi {
 			return false;
 		}
 
+		cached.venueId = inventory.venue;
+		cached.boardId = context.boardId;
 		if (venue.location.empty()) {
 			Logger().debug(fmt::format("[GET-TOPOLOGY] Venue {} has no location configured for subscriber {}.", inventory.venue, UserInfo_.userinfo.id));
+			VenueContextCache()->UpdateByGateway(gatewaySerial, cached, true);
 			BadRequest(RESTAPI::Errors::TimezoneRequired);
 			return false;
 		}
@@ -143,19 +197,24 @@ namespace OpenWifi {
 		callStatus = Poco::Net::HTTPServerResponse::HTTP_INTERNAL_SERVER_ERROR;
 		callResponse = Poco::makeShared<Poco::JSON::Object>();
 		if (SDK::Prov::Location::Get(nullptr, venue.location, location, callStatus, callResponse)) {
+			cached.locationId = venue.location;
 			if (location.timezone.empty()) {
 				Logger().debug(fmt::format("[GET-TOPOLOGY] Location {} has no timezone configured for subscriber {}.", venue.location, UserInfo_.userinfo.id));
+				VenueContextCache()->UpdateByGateway(gatewaySerial, cached, true);
 				BadRequest(RESTAPI::Errors::TimezoneRequired);
 				return false;
 			}
 			try {
-				date::locate_zone(location.timezone);
+				cached.zone = VenueContextCache()->LocateZone(location.timezone);
 			} catch (...) {
 				Logger().debug(fmt::format("[GET-TOPOLOGY] Location {} has invalid timezone [{}] for subscriber {}.", venue.location, location.timezone, UserInfo_.userinfo.id));
+				VenueContextCache()->UpdateByGateway(gatewaySerial, cached, true);
 				BadRequest(RESTAPI::Errors::TimezoneRequired);
 				return false;
 			}
 			context.timezone = location.timezone;
+			cached.timezone = location.timezone;
+			VenueContextCache()->UpdateByGateway(gatewaySerial, cached);
 			Logger().debug(fmt::format("[GET-TOPOLOGY] Resolved venue timezone [{}] for subscriber {}.", context.timezone, UserInfo_.userinfo.id));
 			return true;
 		}
@@ -196,18 +255,18 @@ namespace OpenWifi {
 	/*
 		FinalizeTopologyResponse:
 		1. Filter topology nodes based on subscriber devices.
-		2. Fetch blocked MACs from the gateway configuration.
+		2. Compute blocked MACs from the gateway configuration.
 		3. Attach a "blocked" flag to historical clients and live client entries in the topology.
 		4. Attach the venue timezone to the topology response.
 	*/
 	void RESTAPI_topology_handler::FinalizeTopologyResponse(const ProvObjects::SubscriberDeviceList &subscriberDevices,
-		const std::string &gatewaySerial, const VenueTopologyContext &context, Poco::JSON::Object::Ptr &topologyResponse) {
+		const std::string &gatewaySerial, const VenueTopologyContext &context, const Poco::JSON::Object::Ptr &gatewayConfig, Poco::JSON::Object::Ptr &topologyResponse) {
 		if (!topologyResponse)
 			return;
 
 		FilterTopologyNodes(subscriberDevices, topologyResponse);
 		FilterTopologyEdges(subscriberDevices, topologyResponse);
-		TagBlockedClients(gatewaySerial, topologyResponse, context.timezone);
+		TagBlockedClients(gatewaySerial, gatewayConfig, topologyResponse, context.timezone);
 		topologyResponse->set("timezone", context.timezone);
 	}
 
@@ -275,7 +334,7 @@ namespace OpenWifi {
 
 	/*
 		TagBlockedClients:
-		1. Fetch blocked MACs from the gateway configuration.
+		1. Compute blocked MACs from the gateway configuration fetched by DoGet.
 		2. Attach a "blocked" flag to historical clients and live client entries in the topology.
 
 		Required Topology Response:-
@@ -337,20 +396,9 @@ namespace OpenWifi {
 		]
 		}
 	*/
-	void RESTAPI_topology_handler::TagBlockedClients(const std::string &gatewaySerial, Poco::JSON::Object::Ptr &topologyResponse, const std::string &timezoneStr) {
-
-		Poco::JSON::Object::Ptr deviceObj;
-		Poco::Net::HTTPServerResponse::HTTPStatus status = Poco::Net::HTTPServerResponse::HTTP_INTERNAL_SERVER_ERROR;
-
-		const bool gotConfig = SDK::GW::Device::GetConfig(nullptr, gatewaySerial, status, deviceObj);
-
-		Poco::JSON::Object::Ptr config;
-		if (gotConfig && deviceObj && deviceObj->has("configuration") && deviceObj->isObject("configuration")) {
-			config = deviceObj->getObject("configuration");
-		}
-
+	void RESTAPI_topology_handler::TagBlockedClients(const std::string &gatewaySerial, const Poco::JSON::Object::Ptr &gatewayConfig, Poco::JSON::Object::Ptr &topologyResponse, const std::string &timezoneStr) {
 		std::map<std::string, std::string> blockedMacMap;
-		if (!config || !RESTAPI::ParentalControl::GetBlockedClients(config, blockedMacMap, timezoneStr)) {
+		if (!gatewayConfig || !RESTAPI::ParentalControl::GetBlockedClients(gatewayConfig, blockedMacMap, timezoneStr, gatewaySerial)) {
 			Logger().debug(fmt::format("[GET-TOPOLOGY] Failed to fetch config for {}.", gatewaySerial));
 		}
 
@@ -424,29 +472,67 @@ namespace OpenWifi {
 		}
 	}
 
+	/*
+		DoGet runs the request as a small stage graph:
+
+			devices -> gateway serial -+-> venue context -> topology -+-> finalize
+			                           +-> gateway config ------------+
+
+		The gateway configuration only needs the gateway serial, so it is fetched on an
+		OpenAPIExecutor worker while the venue and topology chain runs on this thread. Stage
+		durations are logged at debug level.
+	*/
 	void RESTAPI_topology_handler::DoGet() {
 		if (UserInfo_.userinfo.id.empty()) {
 			Logger().debug("[GET-TOPOLOGY] Received topology request without subscriber id.");
 			return NotFound();
 		}
 
+		const auto requestStart = std::chrono::steady_clock::now();
 		ProvObjects::SubscriberDeviceList subscriberDevices;
 		if (!FetchSubscriberDevices(subscriberDevices))
 			return;
+		const auto devicesMs = ElapsedMs(requestStart);
 
 		std::string gatewaySerial;
 		if (!FindGatewaySerial(subscriberDevices, gatewaySerial))
 			return;
 
+		auto gatewayConfigFuture =
+			OpenAPIExecutor()->Async([gatewaySerial]() { return FetchGatewayConfig(gatewaySerial); });
+
+		auto stageStart = std::chrono::steady_clock::now();
 		VenueTopologyContext context;
 		if (!ResolveVenueTopologyContext(gatewaySerial, context))
 			return;
+		const auto venueMs = ElapsedMs(stageStart);
 
+		stageStart = std::chrono::steady_clock::now();
 		Poco::JSON::Object::Ptr topologyResponse;
 		if (!FetchTopology(context.boardId, topologyResponse))
 			return;
+		const auto topologyMs = ElapsedMs(stageStart);
+
+		GatewayConfigResult gatewayConfig;
+		if (gatewayConfigFuture.wait_for(kGatewayConfigWait) == std::future_status::ready) {
+			gatewayConfig = gatewayConfigFuture.get();
+		} else {
+			Logger().debug(fmt::format("[GET-TOPOLOGY] Timed out waiting for config of {}.",
+									   gatewaySerial));
+			gatewayConfig.elapsedMs = ElapsedMs(requestStart) - devicesMs;
+		}
 
-		FinalizeTopologyResponse(subscriberDevices, gatewaySerial, context, topologyResponse);
+		stageStart = std::chrono::steady_clock::now();
+		FinalizeTopologyResponse(subscriberDevices, gatewaySerial, context, gatewayConfig.config,
+								 topologyResponse);
+		const auto finalizeMs = ElapsedMs(stageStart);
+		const auto totalMs = ElapsedMs(requestStart);
+
+		Logger().debug(fmt::format("[GET-TOPOLOGY] Subscriber {}: devices={}ms venue={}ms "
+								   "topology={}ms gatewayConfig={}ms (parallel) finalize={}ms "
+								   "total={}ms.",
+								   UserInfo_.userinfo.id, devicesMs, venueMs, topologyMs,
+								   gatewayConfig.elapsedMs, finalizeMs, totalMs));
 
 		return ReturnObject(*topologyResponse);
 	}
@@ -43,9 +43,9 @@ namespace OpenWifi {
 							   std::string &gatewaySerial);
 		bool ResolveVenueTopologyContext(const std::string &gatewaySerial, VenueTopologyContext &context);
 		bool FetchTopology(const std::string &boardId, Poco::JSON::Object::Ptr &topologyResponse);
-		void FinalizeTopologyResponse(const ProvObjects::SubscriberDeviceList &subscriberDevices, const std::string &gatewaySerial, const VenueTopologyContext &context, Poco::JSON::Object::Ptr &topologyResponse);
+		void FinalizeTopologyResponse(const ProvObjects::SubscriberDeviceList &subscriberDevices, const std::string &gatewaySerial, const VenueTopologyContext &context, const Poco::JSON::Object::Ptr &gatewayConfig, Poco::JSON::Object::Ptr &topologyResponse);
 		void FilterTopologyNodes(const ProvObjects::SubscriberDeviceList &subscriberDevices, Poco::JSON::Object::Ptr &topologyResponse);
 		void FilterTopologyEdges(const ProvObjects::SubscriberDeviceList &subscriberDevices, Poco::JSON::Object::Ptr &topologyResponse);
-		void TagBlockedClients(const std::string &gatewaySerial, Poco::JSON::Object::Ptr &topologyResponse, const std::string &timezoneStr = "");
+		void TagBlockedClients(const std::string &gatewaySerial, const Poco::JSON::Object::Ptr &gatewayConfig, Poco::JSON::Object::Ptr &topologyResponse, const std::string &timezoneStr = "");
 	};
 } // namespace OpenWifi
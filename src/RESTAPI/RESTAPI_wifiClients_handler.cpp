@@ -3,30 +3,23 @@
 //
 
 #include "RESTAPI_wifiClients_handler.h"
+#include "OUIServer.h"
 #include "RESTObjects/RESTAPI_SubObjects.h"
+#include "StatsSvr.h"
 #include "StorageService.h"
 #include "framework/utils.h"
-#include "nlohmann/json.hpp"
-#include "sdks/SDK_gw.h"
 
 // #define __DBG__ std::cout << __LINE__ << std::endl ;
 #define __DBG__
 namespace OpenWifi {
 
 	static void AddManufacturers(SubObjects::AssociationList &List) {
-		std::vector<std::pair<std::string, std::string>> MacList;
-		for (const auto &i : List.associations) {
-			MacList.push_back(std::make_pair(i.macAddress, ""));
-		}
-
-		if (SDK::GW::Device::GetOUIs(nullptr, MacList)) {
-			for (const auto &i : MacList)
-				for (auto &j : List.associations)
-					if (j.macAddress == i.first) {
-						// std::cout << i.first <<  " :: " << i.second << std::endl;
-						j.manufacturer = i.second;
-					}
+		std::vector<std::pair<const std::string *, std::string *>> Clients;
+		Clients.reserve(List.associations.size());
+		for (auto &i : List.associations) {
+			Clients.emplace_back(&i.macAddress, &i.manufacturer);
 		}
+		OUIServer()->SetManufacturers(Clients);
 	}
 
 	void RESTAPI_wifiClients_handler::DoGet() {
@@ -46,80 +39,35 @@ namespace OpenWifi {
 			if (i.macAddress.empty())
 				continue;
 			if (SerialNumber == i.macAddress) {
-				Poco::JSON::Object::Ptr LastStats;
 				Poco::JSON::Object Answer;
-				if (SDK::GW::Device::GetLastStats(nullptr, i.serialNumber, LastStats)) {
+				if (auto Stats = StatsSvr()->ClientStatistics(i.serialNumber)) {
 					uint64_t Now = Utils::Now();
 					SubObjects::AssociationList AssocList;
 					AssocList.modified = AssocList.created = Now;
-					std::stringstream SS;
-					LastStats->stringify(SS);
-					try {
-						auto stats = nlohmann::json::parse(SS.str());
-						if (stats.contains("interfaces") && stats["interfaces"].is_array()) {
-							auto ifs = stats["interfaces"];
-							for (const auto &cur_interface : ifs) {
-								//  create a map of MAC -> IP for clients
-								std::map<std::string, std::pair<std::string, std::string>> IPs;
-								if (cur_interface.contains("clients") &&
-									cur_interface["clients"].is_array()) {
-									auto clients = cur_interface["clients"];
-									for (const auto &cur_client : clients) {
-										if (cur_client.contains("mac")) {
-											std::string ipv4, ipv6;
-											if (cur_client.contains("ipv6_addresses") &&
-												cur_client["ipv6_addresses"].is_array() &&
-												!cur_client["ipv6_addresses"].empty()) {
-												ipv6 = cur_client["ipv6_addresses"][0]
-														   .get<std::string>();
-											}
-											if (cur_client.contains("ipv4_addresses") &&
-												cur_client["ipv4_addresses"].is_array() &&
-												!cur_client["ipv4_addresses"].empty()) {
-												ipv4 = cur_client["ipv4_addresses"][0]
-														   .get<std::string>();
-											}
-											IPs[cur_client["mac"].get<std::string>()] =
-												std::make_pair(ipv4, ipv6);
-										}
-									}
-								}
-
-								if (cur_interface.contains("ssids") &&
-									cur_interface["ssids"].is_array() &&
-									!cur_interface["ssids"].empty()) {
-									for (const auto &cur_ssid : cur_interface["ssids"]) {
-										if (cur_ssid.contains("associations") &&
-											cur_ssid["associations"].is_array() &&
-											!cur_ssid["associations"].empty()) {
-											for (const auto &cur_client :
-												 cur_ssid["associations"]) {
-												SubObjects::Association Assoc;
-												Assoc.ssid = cur_ssid["ssid"].get<std::string>();
-												Assoc.macAddress =
-													cur_client["station"].get<std::string>();
-												Assoc.rssi = cur_client["rssi"].get<int32_t>();
-												Assoc.rx = cur_client["rx_bytes"].get<uint64_t>();
-												Assoc.tx = cur_client["tx_bytes"].get<uint64_t>();
-												Assoc.power = 0;
-												Assoc.name =
-													cur_client["station"].get<std::string>();
-												auto which_ips = IPs.find(Assoc.macAddress);
-												if (which_ips != IPs.end()) {
-													Assoc.ipv4 = which_ips->second.first;
-													Assoc.ipv6 = which_ips->second.second;
-												}
-												AssocList.associations.push_back(Assoc);
-											}
-										}
-									}
-								}
-							}
+					//  map of (interface, MAC) -> client, for the client IPs
+					std::map<std::pair<uint32_t, std::string_view>, const StatsClient *> IPs;
+					for (const auto &cur_client : Stats->Clients) {
+						IPs[{cur_client.Interface, cur_client.Mac}] = &cur_client;
+					}
+					AssocList.associations.reserve(Stats->Associations.size());
+					for (const auto &cur_client : Stats->Associations) {
+						SubObjects::Association Assoc;
+						Assoc.ssid = Stats->SSIDs[cur_client.SSID].Name;
+						Assoc.macAddress = cur_client.Station;
+						Assoc.rssi = cur_client.RSSI;
+						Assoc.rx = cur_client.RxBytes;
+						Assoc.tx = cur_client.TxBytes;
+						Assoc.power = 0;
+						Assoc.name = cur_client.Station;
+						auto which_ips = IPs.find({cur_client.Interface, cur_client.Station});
+						if (which_ips != IPs.end()) {
+							Assoc.ipv4 = which_ips->second->IPv4;
+							Assoc.ipv6 = which_ips->second->IPv6;
 						}
-						AddManufacturers(AssocList);
-						AssocList.to_json(Answer);
-					} catch (...) {
+						AssocList.associations.push_back(std::move(Assoc));
 					}
+					AddManufacturers(AssocList);
+					AssocList.to_json(Answer);
 				}
 				return ReturnObject(Answer);
 			}
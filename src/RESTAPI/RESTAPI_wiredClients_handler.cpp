@@ -3,28 +3,21 @@
 //
 
 #include "RESTAPI_wiredClients_handler.h"
+#include "OUIServer.h"
 #include "RESTObjects/RESTAPI_SubObjects.h"
+#include "StatsSvr.h"
 #include "StorageService.h"
 #include "framework/utils.h"
-#include "nlohmann/json.hpp"
-#include "sdks/SDK_gw.h"
 
 namespace OpenWifi {
 
 	static void AddManufacturers(SubObjects::ClientList &List) {
-		std::vector<std::pair<std::string, std::string>> MacList;
-		for (const auto &i : List.clients) {
-			MacList.push_back(std::make_pair(i.macAddress, ""));
-		}
-
-		if (SDK::GW::Device::GetOUIs(nullptr, MacList)) {
-			for (const auto &i : MacList)
-				for (auto &j : List.clients)
-					if (j.macAddress == i.first) {
-						// std::cout << i.first <<  " :: " << i.second << std::endl;
-						j.manufacturer = i.second;
-					}
+		std::vector<std::pair<const std::string *, std::string *>> Clients;
+		Clients.reserve(List.clients.size());
+		for (auto &i : List.clients) {
+			Clients.emplace_back(&i.macAddress, &i.manufacturer);
 		}
+		OUIServer()->SetManufacturers(Clients);
 	}
 
 	void RESTAPI_wiredClients_handler::DoGet() {
@@ -49,78 +42,27 @@ namespace OpenWifi {
 				Answer.set("modified", Now);
 				SubObjects::ClientList CList;
 				CList.modified = CList.created = Now;
-				Poco::JSON::Object::Ptr LastStats;
-
-				if (SDK::GW::Device::GetLastStats(nullptr, i.serialNumber, LastStats)) {
-
-					SubObjects::AssociationList AssocList;
-					AssocList.modified = AssocList.created = Now;
-					std::stringstream SS;
-					LastStats->stringify(SS);
-					try {
-						auto Stats = nlohmann::json::parse(SS.str());
-						if (Stats.contains("interfaces") && Stats["interfaces"].is_array()) {
-							auto interfaces = Stats["interfaces"];
-							for (const auto &cur_interface : interfaces) {
-								std::set<std::string> WifiMacs;
-								if (cur_interface.contains("ssids") &&
-									cur_interface["ssids"].is_array() &&
-									!cur_interface["ssids"].empty()) {
-									for (const auto &cur_ssid : cur_interface["ssids"]) {
-										if (cur_ssid.contains("associations") &&
-											cur_ssid["associations"].is_array() &&
-											!cur_ssid["associations"].empty()) {
-											for (const auto &cur_client :
-												 cur_ssid["associations"]) {
-												WifiMacs.insert(
-													cur_client["station"].get<std::string>());
-											}
-										}
-									}
-								}
 
-								if (cur_interface.contains("clients") &&
-									cur_interface["clients"].is_array() &&
-									!cur_interface["clients"].empty()) {
-									auto clients = cur_interface["clients"];
-									for (const auto &cur_client : clients) {
-
-										std::string Mac = cur_client["mac"];
-										if (WifiMacs.find(Mac) == WifiMacs.end()) {
-
-											SubObjects::Client C;
-
-											C.macAddress = Mac;
-											if (cur_client.contains("ipv6_addresses") &&
-												cur_client["ipv6_addresses"].is_array() &&
-												!cur_client["ipv6_addresses"].empty()) {
-												auto ipv6addresses = cur_client["ipv6_addresses"];
-												for (const auto &cur_addr : ipv6addresses) {
-													C.ipv6 = cur_addr;
-													break;
-												}
-											}
-											if (cur_client.contains("ipv4_addresses") &&
-												cur_client["ipv4_addresses"].is_array() &&
-												!cur_client["ipv4_addresses"].empty()) {
-												auto ipv4addresses = cur_client["ipv4_addresses"];
-												for (const auto &cur_addr : ipv4addresses) {
-													C.ipv4 = cur_addr;
-												}
-											}
-											C.tx = C.rx = 0;
-											C.speed = "auto";
-											C.mode = "auto";
-											CList.clients.push_back(C);
-										}
-									}
-								}
-							}
-						}
-						AddManufacturers(CList);
-						CList.to_json(Answer);
-					} catch (...) {
+				if (auto Stats = StatsSvr()->ClientStatistics(i.serialNumber)) {
+					//  wireless stations, per interface, are not wired clients
+					std::set<std::pair<uint32_t, std::string_view>> WifiMacs;
+					for (const auto &cur_client : Stats->Associations) {
+						WifiMacs.emplace(cur_client.Interface, cur_client.Station);
+					}
+					for (const auto &cur_client : Stats->Clients) {
+						if (WifiMacs.find({cur_client.Interface, cur_client.Mac}) != WifiMacs.end())
+							continue;
+						SubObjects::Client C;
+						C.macAddress = cur_client.Mac;
+						C.ipv6 = cur_client.IPv6;
+						C.ipv4 = cur_client.LastIPv4.empty() ? cur_client.IPv4 : cur_client.LastIPv4;
+						C.tx = C.rx = 0;
+						C.speed = "auto";
+						C.mode = "auto";
+						CList.clients.push_back(std::move(C));
 					}
+					AddManufacturers(CList);
+					CList.to_json(Answer);
 				}
 				return ReturnObject(Answer);
 			}
@@ -356,4 +356,50 @@ namespace OpenWifi::SubObjects {
 		}
 		return false;
 	}
+
+	void StatsRollupEntry::to_json(Poco::JSON::Object &Obj) const {
+		field_to_json(Obj, "timestamp", timestamp);
+		field_to_json(Obj, "samples", samples);
+		field_to_json(Obj, "txMin", txMin);
+		field_to_json(Obj, "txMax", txMax);
+		field_to_json(Obj, "txSum", txSum);
+		field_to_json(Obj, "rxMin", rxMin);
+		field_to_json(Obj, "rxMax", rxMax);
+		field_to_json(Obj, "rxSum", rxSum);
+	}
+
+	bool StatsRollupEntry::from_json(const Poco::JSON::Object::Ptr &Obj) {
+		try {
+			field_from_json(Obj, "timestamp", timestamp);
+			field_from_json(Obj, "samples", samples);
+			field_from_json(Obj, "txMin", txMin);
+			field_from_json(Obj, "txMax", txMax);
+			field_from_json(Obj, "txSum", txSum);
+			field_from_json(Obj, "rxMin", rxMin);
+			field_from_json(Obj, "rxMax", rxMax);
+			field_from_json(Obj, "rxSum", rxSum);
+			return true;
+		} catch (...) {
+		}
+		return false;
+	}
+
+	void StatsRollupBlock::to_json(Poco::JSON::Object &Obj) const {
+		field_to_json(Obj, "modified", modified);
+		field_to_json(Obj, "resolution", resolution);
+		field_to_json(Obj, "external", external);
+		field_to_json(Obj, "internal", internal);
+	}
+
+	bool StatsRollupBlock::from_json(const Poco::JSON::Object::Ptr &Obj) {
+		try {
+			field_from_json(Obj, "modified", modified);
+			field_from_json(Obj, "resolution", resolution);
+			field_from_json(Obj, "external", external);
+			field_from_json(Obj, "internal", internal);
+			return true;
+		} catch (...) {
+		}
+		return false;
+	}
 } // namespace OpenWifi::SubObjects
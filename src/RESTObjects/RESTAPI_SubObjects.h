@@ -317,6 +317,29 @@ namespace OpenWifi::SubObjects {
 		void to_json(Poco::JSON::Object &Obj) const;
 		bool from_json(const Poco::JSON::Object::Ptr &Obj);
 	};
+
+	struct StatsRollupEntry {
+		uint64_t timestamp = 0;
+		uint64_t samples = 0;
+		uint64_t txMin = 0;
+		uint64_t txMax = 0;
+		uint64_t txSum = 0;
+		uint64_t rxMin = 0;
+		uint64_t rxMax = 0;
+		uint64_t rxSum = 0;
+
+		void to_json(Poco::JSON::Object &Obj) const;
+		bool from_json(const Poco::JSON::Object::Ptr &Obj);
+	};
+
+	struct StatsRollupBlock {
+		uint64_t modified = 0;
+		uint64_t resolution = 0;
+		std::vector<StatsRollupEntry> external, internal;
+
+		void to_json(Poco::JSON::Object &Obj) const;
+		bool from_json(const Poco::JSON::Object::Ptr &Obj);
+	};
 } // namespace OpenWifi::SubObjects
 
 #endif // OWSUB_RESTAPI_SUBOBJECTS_H
@@ -0,0 +1,523 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#include "StatsDecoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace OpenWifi {
+
+	bool StatsInterface::External() const {
+		if (std::count(Location.begin(), Location.end(), '/') != 2)
+			return true;
+		return Location.substr(Location.rfind('/') + 1) == "0";
+	}
+
+	namespace {
+
+		enum class Section : uint8_t {
+			Skip,
+			Message,
+			Payload,
+			State,
+			Unit,
+			Interfaces,
+			Interface,
+			Counters,
+			Clients,
+			Client,
+			IPv4,
+			IPv6,
+			SSIDs,
+			SSID,
+			Associations,
+			Association
+		};
+
+		//	Reads the JSON text in place: keys and string values are views into the input and
+		//	are only copied when they are kept. Escaped strings are decoded into a scratch
+		//	buffer. Any syntax error, or nesting deeper than MaxDepth, fails the whole report.
+		class StatsReader {
+		  public:
+			static constexpr uint32_t MaxDepth = 64;
+
+			StatsReader(std::string_view Json, DeviceStatistics &Stats, Section Top)
+				: P_(Json.data()), End_(Json.data() + Json.size()), Stats_(Stats), Top_(Top) {}
+
+			bool Parse() {
+				if (!Value(Section::Skip, true))
+					return false;
+				SkipSpace();
+				return P_ == End_;
+			}
+
+		  private:
+			const char *P_;
+			const char *End_;
+			DeviceStatistics &Stats_;
+			Section Top_;
+			uint32_t Depth_ = 0;
+			std::string_view Key_;
+			std::string KeyBuffer_;
+			std::string ValueBuffer_;
+
+			inline void SkipSpace() {
+				while (P_ != End_ && (*P_ == ' ' || *P_ == '\n' || *P_ == '\r' || *P_ == '\t'))
+					++P_;
+			}
+
+			inline bool Expect(char C) {
+				SkipSpace();
+				if (P_ == End_ || *P_ != C)
+					return false;
+				++P_;
+				return true;
+			}
+
+			inline bool Literal(std::string_view Text) {
+				if (static_cast<std::size_t>(End_ - P_) < Text.size() ||
+					std::memcmp(P_, Text.data(), Text.size()) != 0)
+					return false;
+				P_ += Text.size();
+				return true;
+			}
+
+			static int Hex(char C) {
+				if (C >= '0' && C <= '9')
+					return C - '0';
+				if (C >= 'a' && C <= 'f')
+					return C - 'a' + 10;
+				if (C >= 'A' && C <= 'F')
+					return C - 'A' + 10;
+				return -1;
+			}
+
+			bool CodeUnit(uint32_t &Unit) {
+				if (End_ - P_ < 4)
+					return false;
+				Unit = 0;
+				for (int i = 0; i < 4; ++i) {
+					auto D = Hex(*P_++);
+					if (D < 0)
+						return false;
+					Unit = (Unit << 4) | static_cast<uint32_t>(D);
+				}
+				return true;
+			}
+
+			static void AppendUTF8(std::string &Out, uint32_t C) {
+				if (C < 0x80) {
+					Out += static_cast<char>(C);
+				} else if (C < 0x800) {
+					Out += static_cast<char>(0xC0 | (C >> 6));
+					Out += static_cast<char>(0x80 | (C & 0x3F));
+				} else if (C < 0x10000) {
+					Out += static_cast<char>(0xE0 | (C >> 12));
+					Out += static_cast<char>(0x80 | ((C >> 6) & 0x3F));
+					Out += static_cast<char>(0x80 | (C & 0x3F));
+				} else {
+					Out += static_cast<char>(0xF0 | (C >> 18));
+					Out += static_cast<char>(0x80 | ((C >> 12) & 0x3F));
+					Out += static_cast<char>(0x80 | ((C >> 6) & 0x3F));
+					Out += static_cast<char>(0x80 | (C & 0x3F));
+				}
+			}
+
+			//	P_ is past the opening quote. Unescaped strings (nearly all of them) come back as
+			//	a view of the input.
+			bool String(std::string_view &Out, std::string &Buffer) {
+				auto Start = P_;
+				while (P_ != End_ && *P_ != '"' && *P_ != '\\') {
+					if (static_cast<unsigned char>(*P_) < 0x20)
+						return false;
+					++P_;
+				}
+				if (P_ == End_)
+					return false;
+				if (*P_ == '"') {
+					Out = std::string_view(Start, P_ - Start);
+					++P_;
+					return true;
+				}
+
+				Buffer.assign(Start, P_);
+				while (P_ != End_) {
+					auto C = *P_++;
+					if (C == '"') {
+						Out = Buffer;
+						return true;
+					}
+					if (static_cast<unsigned char>(C) < 0x20)
+						return false;
+					if (C != '\\') {
+						Buffer += C;
+						continue;
+					}
+					if (P_ == End_)
+						return false;
+					switch (*P_++) {
+					case '"':
+						Buffer += '"';
+						break;
+					case '\\':
+						Buffer += '\\';
+						break;
+					case '/':
+						Buffer += '/';
+						break;
+					case 'b':
+						Buffer += '\b';
+						break;
+					case 'f':
+						Buffer += '\f';
+						break;
+					case 'n':
+						Buffer += '\n';
+						break;
+					case 'r':
+						Buffer += '\r';
+						break;
+					case 't':
+						Buffer += '\t';
+						break;
+					case 'u': {
+						uint32_t Unit;
+						if (!CodeUnit(Unit))
+							return false;
+						if (Unit >= 0xD800 && Unit < 0xDC00) {
+							uint32_t Low;
+							if (!Literal("\\u") || !CodeUnit(Low) || Low < 0xDC00 || Low >= 0xE000)
+								return false;
+							Unit = 0x10000 + ((Unit - 0xD800) << 10) + (Low - 0xDC00);
+						} else if (Unit >= 0xDC00 && Unit < 0xE000) {
+							return false;
+						}
+						AppendUTF8(Buffer, Unit);
+					} break;
+					default:
+						return false;
+					}
+				}
+				return false;
+			}
+
+			//	Integers are converted directly; fractions, exponents and integers that do not
+			//	fit 64 bits go through strtod.
+			bool Number(Section S) {
+				auto Start = P_;
+				bool Negative = false;
+				if (*P_ == '-') {
+					Negative = true;
+					++P_;
+				}
+				if (P_ == End_ || *P_ < '0' || *P_ > '9')
+					return false;
+				bool Overflow = false;
+				uint64_t Magnitude = 0;
+				if (*P_ == '0') {
+					++P_;
+				} else {
+					while (P_ != End_ && *P_ >= '0' && *P_ <= '9') {
+						auto D = static_cast<uint64_t>(*P_++ - '0');
+						if (Magnitude > (UINT64_MAX - D) / 10)
+							Overflow = true;
+						else
+							Magnitude = Magnitude * 10 + D;
+					}
+				}
+				bool Float = Overflow || (Negative && Magnitude > uint64_t(INT64_MAX) + 1);
+				if (P_ != End_ && *P_ == '.') {
+					++P_;
+					if (P_ == End_ || *P_ < '0' || *P_ > '9')
+						return false;
+					while (P_ != End_ && *P_ >= '0' && *P_ <= '9')
+						++P_;
+					Float = true;
+				}
+				if (P_ != End_ && (*P_ == 'e' || *P_ == 'E')) {
+					++P_;
+					if (P_ != End_ && (*P_ == '+' || *P_ == '-'))
+						++P_;
+					if (P_ == End_ || *P_ < '0' || *P_ > '9')
+						return false;
+					while (P_ != End_ && *P_ >= '0' && *P_ <= '9')
+						++P_;
+					Float = true;
+				}
+
+				if (S != Section::State && S != Section::Unit && S != Section::Counters &&
+					S != Section::Association)
+					return true;
+
+				int64_t Signed;
+				uint64_t Unsigned;
+				if (Float) {
+					ValueBuffer_.assign(Start, P_);
+					auto V = std::strtod(ValueBuffer_.c_str(), nullptr);
+					if (!std::isfinite(V))
+						return false;
+					V = std::trunc(V);
+					Signed = V <= -0x1p63 ? INT64_MIN
+										  : (V >= 0x1p63 ? INT64_MAX : static_cast<int64_t>(V));
+					Unsigned = V <= 0 ? 0 : V >= 0x1p64 ? UINT64_MAX : static_cast<uint64_t>(V);
+				} else if (Negative) {
+					Signed = static_cast<int64_t>(0 - Magnitude);
+					Unsigned = static_cast<uint64_t>(Signed);
+				} else {
+					Signed = static_cast<int64_t>(Magnitude);
+					Unsigned = Magnitude;
+				}
+				OnNumber(S, Signed, Unsigned);
+				return true;
+			}
+
+			bool Object(Section S) {
+				++P_;
+				SkipSpace();
+				if (P_ != End_ && *P_ == '}') {
+					++P_;
+					return true;
+				}
+				for (;;) {
+					if (!Expect('"') || !String(Key_, KeyBuffer_) || !Expect(':') ||
+						!Value(S, false))
+						return false;
+					SkipSpace();
+					if (P_ == End_)
+						return false;
+					if (*P_ == '}') {
+						++P_;
+						return true;
+					}
+					if (*P_++ != ',')
+						return false;
+				}
+			}
+
+			bool Array(Section S) {
+				++P_;
+				SkipSpace();
+				if (P_ != End_ && *P_ == ']') {
+					++P_;
+					return true;
+				}
+				for (;;) {
+					if (!Value(S, false))
+						return false;
+					SkipSpace();
+					if (P_ == End_)
+						return false;
+					if (*P_ == ']') {
+						++P_;
+						return true;
+					}
+					if (*P_++ != ',')
+						return false;
+				}
+			}
+
+			//	S is the section of the enclosing container and Key_ the member name, if any.
+			bool Value(Section S, bool Root) {
+				SkipSpace();
+				if (P_ == End_)
+					return false;
+				if (S == Section::State && Key_ == "version")
+					Stats_.HasVersion = true;
+				switch (*P_) {
+				case '{':
+				case '[': {
+					if (++Depth_ > MaxDepth)
+						return false;
+					bool IsArray = *P_ == '[';
+					auto Inner = Root ? (IsArray ? Section::Skip : Top_) : Child(S, IsArray);
+					auto Ok = IsArray ? Array(Inner) : Object(Inner);
+					--Depth_;
+					return Ok;
+				}
+				case '"': {
+					++P_;
+					std::string_view V;
+					if (!String(V, ValueBuffer_))
+						return false;
+					OnString(S, V);
+					return true;
+				}
+				case 't':
+					return Literal("true");
+				case 'f':
+					return Literal("false");
+				case 'n':
+					return Literal("null");
+				default:
+					return Number(S);
+				}
+			}
+
+			void OnString(Section S, std::string_view V) {
+				switch (S) {
+				case Section::Payload:
+					if (Key_ == "serial")
+						Stats_.Serial.assign(V);
+					break;
+				case Section::Interface:
+					if (Key_ == "name")
+						Stats_.Interfaces.back().Name.assign(V);
+					else if (Key_ == "location")
+						Stats_.Interfaces.back().Location.assign(V);
+					break;
+				case Section::Client:
+					if (Key_ == "mac")
+						Stats_.Clients.back().Mac.assign(V);
+					break;
+				case Section::IPv4:
+					if (Stats_.Clients.back().IPv4.empty())
+						Stats_.Clients.back().IPv4.assign(V);
+					else
+						Stats_.Clients.back().LastIPv4.assign(V);
+					break;
+				case Section::IPv6:
+					if (Stats_.Clients.back().IPv6.empty())
+						Stats_.Clients.back().IPv6.assign(V);
+					break;
+				case Section::SSID:
+					if (Key_ == "ssid")
+						Stats_.SSIDs.back().Name.assign(V);
+					break;
+				case Section::Association:
+					if (Key_ == "station")
+						Stats_.Associations.back().Station.assign(V);
+					break;
+				default:
+					break;
+				}
+			}
+
+			void OnNumber(Section S, int64_t Signed, uint64_t Unsigned) {
+				switch (S) {
+				case Section::Unit:
+					if (Key_ == "localtime") {
+						Stats_.LocalTime = Unsigned;
+						Stats_.HasLocalTime = true;
+					}
+					break;
+				case Section::Counters: {
+					auto &I = Stats_.Interfaces.back();
+					if (Key_ == "rx_bytes") {
+						I.RxBytes = Unsigned;
+						I.HasRxBytes = true;
+					} else if (Key_ == "tx_bytes") {
+						I.TxBytes = Unsigned;
+						I.HasTxBytes = true;
+					}
+				} break;
+				case Section::Association: {
+					auto &A = Stats_.Associations.back();
+					if (Key_ == "rssi")
+						A.RSSI = static_cast<int32_t>(Signed);
+					else if (Key_ == "rx_bytes")
+						A.RxBytes = Unsigned;
+					else if (Key_ == "tx_bytes")
+						A.TxBytes = Unsigned;
+				} break;
+				default:
+					break;
+				}
+			}
+
+			[[nodiscard]] inline uint32_t LastInterface() const {
+				return static_cast<uint32_t>(Stats_.Interfaces.size() - 1);
+			}
+
+			Section Child(Section Parent, bool Array) {
+				switch (Parent) {
+				case Section::Message:
+					if (!Array && Key_ == "payload")
+						return Section::Payload;
+					break;
+				case Section::Payload:
+					if (!Array && Key_ == "state")
+						return Section::State;
+					break;
+				case Section::State:
+					if (!Array && Key_ == "unit")
+						return Section::Unit;
+					if (Array && Key_ == "interfaces") {
+						Stats_.HasInterfaces = true;
+						return Section::Interfaces;
+					}
+					break;
+				case Section::Interfaces:
+					if (!Array) {
+						Stats_.Interfaces.emplace_back();
+						return Section::Interface;
+					}
+					break;
+				case Section::Interface:
+					if (!Array && Key_ == "counters")
+						return Section::Counters;
+					if (Array && Key_ == "clients")
+						return Section::Clients;
+					if (Array && Key_ == "ssids")
+						return Section::SSIDs;
+					break;
+				case Section::Clients:
+					if (!Array) {
+						Stats_.Clients.emplace_back().Interface = LastInterface();
+						return Section::Client;
+					}
+					break;
+				case Section::Client:
+					if (Array && Key_ == "ipv4_addresses")
+						return Section::IPv4;
+					if (Array && Key_ == "ipv6_addresses")
+						return Section::IPv6;
+					break;
+				case Section::SSIDs:
+					if (!Array) {
+						Stats_.SSIDs.emplace_back().Interface = LastInterface();
+						return Section::SSID;
+					}
+					break;
+				case Section::SSID:
+					if (Array && Key_ == "associations")
+						return Section::Associations;
+					break;
+				case Section::Associations:
+					if (!Array) {
+						auto &A = Stats_.Associations.emplace_back();
+						A.Interface = LastInterface();
+						A.SSID = static_cast<uint32_t>(Stats_.SSIDs.size() - 1);
+						return Section::Association;
+					}
+					break;
+				default:
+					break;
+				}
+				return Section::Skip;
+			}
+		};
+
+		bool Decode(std::string_view Json, DeviceStatistics &Stats, Section Top) {
+			Stats = DeviceStatistics{};
+			return StatsReader(Json, Stats, Top).Parse();
+		}
+
+	} // namespace
+
+	namespace StatsDecoder {
+		bool DecodeState(std::string_view Json, DeviceStatistics &Stats) {
+			return Decode(Json, Stats, Section::State);
+		}
+
+		bool DecodeStateMessage(std::string_view Json, DeviceStatistics &Stats) {
+			return Decode(Json, Stats, Section::Message);
+		}
+	} // namespace StatsDecoder
+
+} // namespace OpenWifi
@@ -0,0 +1,81 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace OpenWifi {
+
+	//
+	// Flat view of a device statistics report. Clients, SSIDs and associations refer to
+	// their interface (and SSID) by index, so a report decodes into a handful of vectors.
+	//
+	struct StatsInterface {
+		std::string Name;
+		std::string Location;
+		bool HasRxBytes = false;
+		bool HasTxBytes = false;
+		uint64_t RxBytes = 0;
+		uint64_t TxBytes = 0;
+
+		[[nodiscard]] inline bool HasCounters() const { return HasRxBytes && HasTxBytes; }
+		// Interfaces are external unless their location is "/interfaces/<n>" with n != 0.
+		[[nodiscard]] bool External() const;
+	};
+
+	struct StatsClient {
+		uint32_t Interface = 0;
+		std::string Mac;
+		// First address of each family.
+		std::string IPv4;
+		std::string IPv6;
+		// Last IPv4 address, only when there are several: the wired client list reports it.
+		std::string LastIPv4;
+	};
+
+	struct StatsSSID {
+		uint32_t Interface = 0;
+		std::string Name;
+	};
+
+	struct StatsAssociation {
+		uint32_t Interface = 0;
+		uint32_t SSID = 0;
+		std::string Station;
+		int32_t RSSI = 0;
+		uint64_t RxBytes = 0;
+		uint64_t TxBytes = 0;
+	};
+
+	struct DeviceStatistics {
+		std::string Serial;
+		bool HasVersion = false;
+		bool HasLocalTime = false;
+		bool HasInterfaces = false;
+		uint64_t LocalTime = 0;
+		std::vector<StatsInterface> Interfaces;
+		std::vector<StatsClient> Clients;
+		std::vector<StatsSSID> SSIDs;
+		std::vector<StatsAssociation> Associations;
+	};
+
+	//
+	// Single-pass decoder for device statistics. The JSON text is scanned in place and only
+	// the fields above are copied out: no document tree is built and the rest of the report
+	// is validated and skipped. Malformed or truncated input makes the decode fail.
+	//
+	namespace StatsDecoder {
+		// A statistics report, as returned by the gateway service.
+		bool DecodeState(std::string_view Json, DeviceStatistics &Stats);
+		// A message from the state topic: serial and report are under "payload".
+		bool DecodeStateMessage(std::string_view Json, DeviceStatistics &Stats);
+	} // namespace StatsDecoder
+
+} // namespace OpenWifi
@@ -0,0 +1,134 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#include "StatsSnapshot.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Poco/Exception.h"
+#include "Poco/File.h"
+
+namespace OpenWifi {
+
+	namespace {
+		constexpr char SNAPSHOT_MAGIC[4] = {'O', 'W', 'S', 'T'};
+		constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+		//	64 bytes, so records stay aligned.
+		struct SnapshotHeader {
+			char Magic[4];
+			uint32_t Version;
+			uint32_t RecordWords;
+			uint32_t Reserved;
+			uint64_t LayoutHash;
+			uint64_t Capacity;
+			uint64_t Count;
+			uint64_t Padding[3];
+		};
+		static_assert(sizeof(SnapshotHeader) == 64);
+
+		inline SnapshotHeader *HeaderOf(const Poco::SharedMemory &Map) {
+			return reinterpret_cast<SnapshotHeader *>(Map.begin());
+		}
+
+		//	FNV-1a: the hash is stored in the file, it must not change between builds.
+		uint64_t LayoutHash(const std::string &Layout) {
+			uint64_t H = 0xcbf29ce484222325ull;
+			for (auto c : Layout) {
+				H ^= static_cast<unsigned char>(c);
+				H *= 0x100000001b3ull;
+			}
+			return H;
+		}
+	} // namespace
+
+	bool StatsSnapshot::Open(const std::string &FileName, const TrafficLayout &Layout,
+							 uint64_t InitialRecords) {
+		Close();
+		FileName_ = FileName;
+		RecordWords_ = 1 + TrafficHistory::RecordWords(Layout);
+		LayoutHash_ = LayoutHash(Layout.ToString());
+		try {
+			Poco::File F(FileName_);
+			if (F.exists() && F.getSize() >= sizeof(SnapshotHeader)) {
+				Map_ = std::make_unique<Poco::SharedMemory>(F, Poco::SharedMemory::AM_WRITE);
+				const auto *H = HeaderOf(*Map_);
+				if (std::memcmp(H->Magic, SNAPSHOT_MAGIC, sizeof(H->Magic)) == 0 &&
+					H->Version == SNAPSHOT_VERSION && H->RecordWords == RecordWords_ &&
+					H->LayoutHash == LayoutHash_ && H->Count <= H->Capacity &&
+					F.getSize() ==
+						sizeof(SnapshotHeader) + H->Capacity * RecordWords_ * sizeof(uint64_t)) {
+					Published();
+					return true;
+				}
+				Map_.reset();
+			}
+			return Map(std::max<uint64_t>(1, InitialRecords), true);
+		} catch (const Poco::Exception &) {
+			Map_.reset();
+			Published();
+		}
+		return false;
+	}
+
+	void StatsSnapshot::Close() {
+		Map_.reset();
+		Published();
+	}
+
+	void StatsSnapshot::Published() {
+		Count_ = Map_ ? HeaderOf(*Map_)->Count : 0;
+		FileBytes_ = Map_ ? static_cast<uint64_t>(Map_->end() - Map_->begin()) : 0;
+	}
+
+	bool StatsSnapshot::Map(uint64_t Capacity, bool Reset) {
+		Map_.reset();
+		Poco::File F(FileName_);
+		if (Reset) {
+			F.createFile();
+			F.setSize(0);
+		}
+		F.setSize(sizeof(SnapshotHeader) + Capacity * RecordWords_ * sizeof(uint64_t));
+		Map_ = std::make_unique<Poco::SharedMemory>(F, Poco::SharedMemory::AM_WRITE);
+		auto *H = HeaderOf(*Map_);
+		if (Reset) {
+			std::memset(H, 0, sizeof(*H));
+			std::memcpy(H->Magic, SNAPSHOT_MAGIC, sizeof(H->Magic));
+			H->Version = SNAPSHOT_VERSION;
+			H->RecordWords = RecordWords_;
+			H->LayoutHash = LayoutHash_;
+		}
+		H->Capacity = Capacity;
+		Published();
+		return true;
+	}
+
+	uint64_t *StatsSnapshot::Record(uint64_t Index) const {
+		return reinterpret_cast<uint64_t *>(Map_->begin() + sizeof(SnapshotHeader)) +
+			   Index * RecordWords_;
+	}
+
+	bool StatsSnapshot::Allocate(uint64_t &Index) {
+		if (!Map_)
+			return false;
+		auto *H = HeaderOf(*Map_);
+		if (H->Count == H->Capacity) {
+			try {
+				Map(H->Capacity * 2, false);
+			} catch (const Poco::Exception &) {
+				Map_.reset();
+				Published();
+				return false;
+			}
+			H = HeaderOf(*Map_);
+		}
+		Index = H->Count++;
+		Count_ = H->Count;
+		return true;
+	}
+
+} // namespace OpenWifi
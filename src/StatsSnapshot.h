@@ -0,0 +1,62 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "Poco/SharedMemory.h"
+
+#include "TrafficHistory.h"
+
+namespace OpenWifi {
+
+	//
+	// Traffic histories kept in a memory-mapped file of fixed-size records, so they survive a
+	// restart: a header, then one record per device (its serial number followed by the
+	// TrafficHistory image). Records are only ever appended and rewritten in place; the file
+	// grows by doubling. A file written under another traffic layout is discarded.
+	// Only Count() and FileBytes() may be called while another thread uses the snapshot.
+	//
+	class StatsSnapshot {
+	  public:
+		static constexpr uint64_t NoRecord = ~uint64_t{0};
+
+		~StatsSnapshot() { Close(); }
+
+		// Maps the file, creating it when missing or unusable. False when it cannot be mapped.
+		bool Open(const std::string &FileName, const TrafficLayout &Layout,
+				  uint64_t InitialRecords = 1024);
+		void Close();
+
+		[[nodiscard]] inline bool IsOpen() const { return Map_ != nullptr; }
+		[[nodiscard]] inline uint64_t Count() const { return Count_.load(); }
+		[[nodiscard]] inline uint64_t FileBytes() const { return FileBytes_.load(); }
+		[[nodiscard]] inline uint32_t RecordWords() const { return RecordWords_; }
+
+		// Record Index: word 0 is the serial number, then TrafficHistory::RecordWords words.
+		[[nodiscard]] uint64_t *Record(uint64_t Index) const;
+		// Reserves the next record. It stays empty until written. May remap the file.
+		bool Allocate(uint64_t &Index);
+
+	  private:
+		std::string FileName_;
+		std::unique_ptr<Poco::SharedMemory> Map_;
+		uint32_t RecordWords_ = 0;
+		uint64_t LayoutHash_ = 0;
+		//	Copies of the header count and of the mapping size: the mapping may be replaced
+		//	while they are read.
+		std::atomic_uint64_t Count_{0};
+		std::atomic_uint64_t FileBytes_{0};
+
+		bool Map(uint64_t Capacity, bool Reset);
+		void Published();
+	};
+
+} // namespace OpenWifi
@@ -3,129 +3,404 @@
 //
 
 #include "StatsSvr.h"
+#include "StatsDecoder.h"
 #include "framework/KafkaManager.h"
 #include "framework/KafkaTopics.h"
-#include "nlohmann/json.hpp"
+#include "framework/MicroServiceFuncs.h"
+#include "sdks/SDK_gw.h"
 #include <fmt/format.h>
 
-#define dbg std::cout << __LINE__ << std::endl
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <utility>
 
 namespace OpenWifi {
 
 	int StatsSvr::Start() {
-		Running_ = true;
+		MaxAge_ = MicroServiceConfigGetInt("statscache.clients.maxage", 180);
+		EnqueueWait_ = MicroServiceConfigGetInt("statscache.queue.wait", 100);
+		const auto Workers = std::max<uint64_t>(
+			1, MicroServiceConfigGetInt(
+				   "statscache.workers",
+				   std::min<uint64_t>(4, std::max(1u, std::thread::hardware_concurrency()))));
+		const auto QueueSize = std::max<uint64_t>(2, MicroServiceConfigGetInt("statscache.queue.size", 4096));
+		const auto BatchSize = std::max<uint64_t>(1, MicroServiceConfigGetInt("statscache.batch", 64));
+
+		std::string Rejected;
+		auto Layout = std::make_shared<const TrafficLayout>(
+			MicroServiceConfigGetInt("statscache.traffic.samples", 20),
+			MicroServiceConfigGetString("statscache.traffic.rollups", TrafficLayout::DefaultRollups),
+			&Rejected);
+		if (!Rejected.empty())
+			poco_warning(Logger(), fmt::format("Ignoring traffic rollups: {}", Rejected));
+		poco_information(Logger(), fmt::format("Traffic history {}: {} bytes per device.",
+												Layout->ToString(), Layout->DeviceBytes()));
+		Store_.SetLayout(std::move(Layout));
+
+		SnapshotInterval_ = MicroServiceConfigGetInt("statscache.snapshot.interval", 60);
+		if (SnapshotInterval_ > 0) {
+			auto FileName = MicroServiceConfigPath("statscache.snapshot.file",
+												   MicroServiceDataDirectory() + "/stats.bin");
+			if (Snapshot_.Open(FileName, Store_.Layout())) {
+				const auto Restored = Store_.Restore(Snapshot_);
+				poco_information(Logger(), fmt::format("Restored {} devices from {}.", Restored,
+														FileName));
+				Checkpointing_ = true;
+				Checkpointer_.start(*this);
+			} else {
+				poco_warning(Logger(), fmt::format("Cannot map {}: traffic history will not be kept.",
+												   FileName));
+			}
+		}
+
+		poco_information(Logger(), fmt::format("Starting: {} workers, queues of {} messages.",
+												Workers, QueueSize));
+		for (std::size_t i = 0; i < Workers; ++i) {
+			Workers_.push_back(std::make_unique<IngestWorker>(*this, i, QueueSize, BatchSize));
+			Workers_.back()->Start();
+		}
 		Types::TopicNotifyFunction F = [this](const std::string &Key, const std::string &Payload) {
 			this->StatsReceived(Key, Payload);
 		};
 		StatsWatcherId_ = KafkaManager()->RegisterTopicWatcher(KafkaTopics::STATE, F);
-		Worker_.start(*this);
+		KafkaManager()->RegisterQueueGauge(KafkaTopics::STATE, "statsCache", [this]() {
+			KafkaQueueGauge Gauge;
+			for (const auto &Worker : Workers_) {
+				Gauge.Depth += Worker->Queued();
+				Gauge.Capacity += Worker->Capacity();
+			}
+			Gauge.Dropped = Dropped_;
+			return Gauge;
+		});
 		return 0;
 	}
 
 	void StatsSvr::Stop() {
-		Running_ = false;
-		KafkaManager()->UnregisterTopicWatcher(KafkaTopics::CONNECTION, StatsWatcherId_);
-		Queue_.wakeUpAll();
-		Worker_.join();
+		poco_information(Logger(),
+						 fmt::format("Stopping: {} devices, {} bytes, {} messages dropped.",
+									 Store_.Devices(), Store_.MemoryUse(), Dropped_.load()));
+		KafkaManager()->UnregisterQueueGauge(KafkaTopics::STATE, "statsCache");
+		//	StatsReceived is no longer running once the watcher is gone.
+		KafkaManager()->UnregisterTopicWatcher(KafkaTopics::STATE, StatsWatcherId_);
+		for (auto &Worker : Workers_)
+			Worker->Stop();
+		Workers_.clear();
+
+		if (Checkpointing_) {
+			Checkpointing_ = false;
+			CheckpointWake_.set();
+			Checkpointer_.join();
+			Store_.Checkpoint(Snapshot_);
+		}
+		Snapshot_.Close();
 	}
 
 	void StatsSvr::run() {
-		Utils::SetThreadName("stats-svr");
-		Poco::AutoPtr<Poco::Notification> Note(Queue_.waitDequeueNotification());
-		while (Note && Running_) {
-			auto Msg = dynamic_cast<Stats_Msg *>(Note.get());
-			if (Msg != nullptr) {
+		Utils::SetThreadName("stats-snapshot");
+		while (Checkpointing_) {
+			CheckpointWake_.tryWait(SnapshotInterval_ * 1000);
+			if (!Checkpointing_)
+				break;
+			LastCheckpointRecords_ = Store_.Checkpoint(Snapshot_);
+			LastCheckpoint_ = Utils::Now();
+		}
+	}
+
+	void StatsSvr::StatsReceived(const std::string &Key, const std::string &Payload) {
+		++Received_;
+		if (Workers_.empty()) {
+			++Dropped_;
+			return;
+		}
+		auto &Worker = *Workers_[std::hash<std::string>{}(Key) % Workers_.size()];
+		std::string Message(Payload);
+		if (Worker.Enqueue(std::move(Message)))
+			return;
+
+		//	Back-pressure: hold the consumer until the worker catches up, then give up.
+		++Waited_;
+		const auto Deadline =
+			std::chrono::steady_clock::now() + std::chrono::milliseconds(EnqueueWait_);
+		while (std::chrono::steady_clock::now() < Deadline) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			if (Worker.Enqueue(std::move(Message)))
+				return;
+		}
+		if (++Dropped_ % 1000 == 1)
+			poco_warning(Logger(), fmt::format("State queue full: {} messages dropped so far.",
+												Dropped_.load()));
+	}
+
+	void StatsSvr::IngestWorker::Start() {
+		Running_ = true;
+		Thread_.start(*this);
+	}
+
+	void StatsSvr::IngestWorker::Stop() {
+		Running_ = false;
+		Wake_.set();
+		Thread_.join();
+	}
+
+	bool StatsSvr::IngestWorker::Enqueue(std::string &&Payload) {
+		if (!Queue_.Push(std::move(Payload)))
+			return false;
+		if (Sleeping_)
+			Wake_.set();
+		return true;
+	}
+
+	void StatsSvr::IngestWorker::run() {
+		Utils::SetThreadName(fmt::format("stats-svr-{}", Id_).c_str());
+		std::vector<std::string> Batch;
+		Batch.reserve(BatchSize_);
+		while (Running_) {
+			std::string Payload;
+			while (Batch.size() < BatchSize_ && Queue_.Pop(Payload))
+				Batch.push_back(std::move(Payload));
+
+			if (Batch.empty()) {
+				//	Producers only signal a sleeping worker: check again once Sleeping_ is
+				//	visible so a message pushed in between is not left waiting.
+				Sleeping_ = true;
+				if (Queue_.Size() == 0)
+					Wake_.tryWait(100);
+				Sleeping_ = false;
+				continue;
+			}
+
+			for (const auto &Message : Batch) {
 				try {
-					nlohmann::json msg = nlohmann::json::parse(Msg->Payload());
-					if (msg.contains(uCentralProtocol::PAYLOAD)) {
-						auto payload = msg[uCentralProtocol::PAYLOAD];
-						if (payload.contains("state") && payload.contains("serial")) {
-							auto serialNumber = payload["serial"].get<std::string>();
-							auto state = payload["state"];
-							if (state.contains("version")) {
-								if (state.contains("unit")) {
-									auto unit = state["unit"];
-									if (unit.contains("localtime")) {
-										uint64_t timestamp = unit["localtime"];
-										if (state.contains("interfaces")) {
-											if (state["interfaces"].is_array()) {
-												auto interfaces = state["interfaces"];
-												auto serial_int =
-													Utils::SerialNumberToInt(serialNumber);
-												uint64_t int_rx = 0, int_tx = 0, ext_rx = 0,
-														 ext_tx = 0;
-												for (const auto &cur_int : interfaces) {
-													bool external_stats = true;
-													if (cur_int.contains("location")) {
-														auto location =
-															cur_int["location"].get<std::string>();
-														auto parts =
-															Poco::StringTokenizer(location, "/");
-														if (parts.count() == 3) {
-															if (parts[2] == "0")
-																external_stats = true;
-															else
-																external_stats = false;
-														}
-													}
-
-													if (cur_int.contains("counters") &&
-														cur_int["counters"].contains("rx_bytes") &&
-														cur_int["counters"].contains("tx_bytes")) {
-														if (external_stats) {
-															ext_rx = cur_int["counters"]["rx_bytes"]
-																		 .get<uint64_t>();
-															ext_tx = cur_int["counters"]["tx_bytes"]
-																		 .get<uint64_t>();
-														} else {
-															int_rx = cur_int["counters"]["rx_bytes"]
-																		 .get<uint64_t>();
-															int_tx = cur_int["counters"]["tx_bytes"]
-																		 .get<uint64_t>();
-														}
-													}
-												}
-												{
-													std::lock_guard G(Mutex_);
-													auto it = DeviceStats_.find(serial_int);
-													if (it == end(DeviceStats_)) {
-														DeviceStats D;
-														D.AddValue(timestamp, ext_tx, ext_rx,
-																   int_tx, int_rx);
-														DeviceStats_[serial_int] = D;
-														poco_debug(
-															Logger(),
-															fmt::format("Creating statistics cache "
-																		"for device {}",
-																		serialNumber));
-													} else {
-														poco_debug(
-															Logger(),
-															fmt::format("Adding statistics cache "
-																		"for device {}",
-																		serialNumber));
-														it->second.AddValue(timestamp, ext_tx,
-																			ext_rx, int_tx, int_rx);
-														std::cout
-															<< "Adding device stats entries for "
-															<< serialNumber << std::endl;
-													}
-												}
-											}
-										}
-									}
-								}
-							}
-						}
-					}
+					Svr_.ProcessState(Message);
 				} catch (const Poco::Exception &E) {
-					Logger().log(E);
+					Svr_.Logger().log(E);
 				} catch (...) {
 				}
-			} else {
 			}
-			Note = Queue_.waitDequeueNotification();
+			Processed_ += Batch.size();
+			Batch.clear();
 		}
 	}
 
+	void StatsSvr::ProcessState(const std::string &Payload) {
+		DeviceStatistics Stats;
+		if (!StatsDecoder::DecodeStateMessage(Payload, Stats) || Stats.Serial.empty() ||
+			!Stats.HasInterfaces)
+			return;
+
+		auto serial_int = Utils::SerialNumberToInt(Stats.Serial);
+		if (Stats.HasVersion && Stats.HasLocalTime) {
+			uint64_t int_rx = 0, int_tx = 0, ext_rx = 0, ext_tx = 0;
+			for (const auto &cur_int : Stats.Interfaces) {
+				if (!cur_int.HasCounters())
+					continue;
+				if (cur_int.External()) {
+					ext_rx = cur_int.RxBytes;
+					ext_tx = cur_int.TxBytes;
+				} else {
+					int_rx = cur_int.RxBytes;
+					int_tx = cur_int.TxBytes;
+				}
+			}
+			Store_.AddTraffic(serial_int, Stats.LocalTime, ext_tx, ext_rx, int_tx, int_rx);
+		}
+
+		auto Snapshot = std::make_shared<const DeviceStatistics>(std::move(Stats));
+		Store_.SetClients(serial_int, std::move(Snapshot), Utils::Now());
+	}
+
+	std::shared_ptr<const DeviceStatistics>
+	StatsSvr::ClientStatistics(const std::string &SerialNumber) {
+		if (MaxAge_ > 0 && Utils::ValidSerialNumber(SerialNumber)) {
+			uint64_t Received = 0;
+			auto Stats = Store_.GetClients(Utils::SerialNumberToInt(SerialNumber), Received);
+			if (Stats && Utils::Now() - Received <= MaxAge_)
+				return Stats;
+		}
+
+		std::string LastStats;
+		auto Stats = std::make_shared<DeviceStatistics>();
+		if (SDK::GW::Device::GetLastStats(nullptr, SerialNumber, LastStats) &&
+			StatsDecoder::DecodeState(LastStats, *Stats))
+			return Stats;
+		return nullptr;
+	}
+
+	void StatsSvr::GetStats(Poco::JSON::Object &Answer) const {
+		Answer.set("devices", Store_.Devices());
+		Answer.set("memory", Store_.MemoryUse());
+		Answer.set("shards", DeviceStatsStore::ShardCount);
+		Answer.set("traffic", Store_.Layout().ToString());
+		Answer.set("trafficBytesPerDevice", Store_.Layout().DeviceBytes());
+
+		Poco::JSON::Object Ingest;
+		uint64_t Queued = 0, Processed = 0;
+		for (const auto &Worker : Workers_) {
+			Queued += Worker->Queued();
+			Processed += Worker->Processed();
+		}
+		Ingest.set("workers", Workers_.size());
+		Ingest.set("received", Received_.load());
+		Ingest.set("processed", Processed);
+		Ingest.set("queued", Queued);
+		Ingest.set("waited", Waited_.load());
+		Ingest.set("dropped", Dropped_.load());
+		Answer.set("ingest", Ingest);
+
+		Poco::JSON::Object Snapshot;
+		Snapshot.set("records", Snapshot_.Count());
+		Snapshot.set("bytes", Snapshot_.FileBytes());
+		Snapshot.set("lastCheckpoint", LastCheckpoint_.load());
+		Snapshot.set("lastCheckpointRecords", LastCheckpointRecords_.load());
+		Answer.set("snapshot", Snapshot);
+	}
+
+	DeviceStatsStore::Entry &DeviceStatsStore::Find(Shard &S, uint64_t Serial) {
+		auto [It, Inserted] = S.Devices.try_emplace(Serial);
+		if (Inserted)
+			S.Bytes += sizeof(Entry) + 4 * sizeof(void *);
+		return It->second;
+	}
+
+	void DeviceStatsStore::AddTraffic(uint64_t Serial, uint64_t TimeStamp, uint64_t ExtTx,
+									  uint64_t ExtRx, uint64_t IntTx, uint64_t IntRx) {
+		const auto Now = Utils::Now();
+		auto &S = ShardOf(Serial);
+		std::unique_lock G(S.Mutex);
+		auto &E = Find(S, Serial);
+		const auto Bytes = E.Traffic.Bytes();
+		E.Traffic.AddValue(Layout_, TimeStamp, ExtTx, ExtRx, IntTx, IntRx, Now);
+		E.Dirty = true;
+		S.Bytes = S.Bytes - Bytes + E.Traffic.Bytes();
+	}
+
+	void DeviceStatsStore::GetTraffic(uint64_t Serial, SubObjects::StatsBlock &Stats) const {
+		const auto &S = ShardOf(Serial);
+		std::shared_lock G(S.Mutex);
+		auto It = S.Devices.find(Serial);
+		if (It != S.Devices.end())
+			It->second.Traffic.Get(Stats);
+	}
+
+	bool DeviceStatsStore::GetTrafficRollup(uint64_t Serial, uint64_t Resolution,
+											SubObjects::StatsRollupBlock &Stats) const {
+		const auto &S = ShardOf(Serial);
+		std::shared_lock G(S.Mutex);
+		auto It = S.Devices.find(Serial);
+		if (It != S.Devices.end() && It->second.Traffic.GetRollup(Resolution, Stats))
+			return true;
+		if (Layout_->Find(Resolution) == nullptr)
+			return false;
+		Stats.resolution = Resolution;
+		return true;
+	}
+
+	void DeviceStatsStore::SetClients(uint64_t Serial, std::shared_ptr<const DeviceStatistics> Stats,
+									  uint64_t Received) {
+		const auto Bytes = Stats ? Footprint(*Stats) : 0;
+		std::shared_ptr<const DeviceStatistics> Previous;
+		{
+			auto &S = ShardOf(Serial);
+			std::unique_lock G(S.Mutex);
+			auto &E = Find(S, Serial);
+			S.Bytes = S.Bytes - E.ClientsBytes + Bytes;
+			E.ClientsBytes = Bytes;
+			E.Received = Received;
+			Previous = std::exchange(E.Clients, std::move(Stats));
+		}
+		//	Previous is released here, outside the shard lock.
+	}
+
+	std::shared_ptr<const DeviceStatistics> DeviceStatsStore::GetClients(uint64_t Serial,
+																		 uint64_t &Received) const {
+		const auto &S = ShardOf(Serial);
+		std::shared_lock G(S.Mutex);
+		auto It = S.Devices.find(Serial);
+		if (It == S.Devices.end())
+			return nullptr;
+		Received = It->second.Received;
+		return It->second.Clients;
+	}
+
+	uint64_t DeviceStatsStore::Checkpoint(StatsSnapshot &Snapshot) {
+		uint64_t Written = 0;
+		if (!Snapshot.IsOpen())
+			return Written;
+		for (auto &S : Shards_) {
+			//	Ingest waits for this shard only while its changed histories are copied.
+			std::shared_lock G(S.Mutex);
+			for (auto &[Serial, E] : S.Devices) {
+				if (!E.Dirty)
+					continue;
+				if (E.Record == StatsSnapshot::NoRecord && !Snapshot.Allocate(E.Record))
+					return Written;
+				auto *Record = Snapshot.Record(E.Record);
+				Record[0] = Serial;
+				E.Traffic.Save(Record + 1);
+				E.Dirty = false;
+				++Written;
+			}
+		}
+		return Written;
+	}
+
+	uint64_t DeviceStatsStore::Restore(const StatsSnapshot &Snapshot) {
+		uint64_t Restored = 0;
+		for (uint64_t i = 0; i < Snapshot.Count(); ++i) {
+			const auto *Record = Snapshot.Record(i);
+			auto &S = ShardOf(Record[0]);
+			std::unique_lock G(S.Mutex);
+			TrafficHistory Traffic;
+			if (!Traffic.Restore(Layout_, Record + 1))
+				continue;
+			auto &E = Find(S, Record[0]);
+			S.Bytes = S.Bytes - E.Traffic.Bytes() + Traffic.Bytes();
+			E.Traffic = std::move(Traffic);
+			E.Record = i;
+			++Restored;
+		}
+		return Restored;
+	}
+
+	uint64_t DeviceStatsStore::Devices() const {
+		uint64_t Count = 0;
+		for (const auto &S : Shards_) {
+			std::shared_lock G(S.Mutex);
+			Count += S.Devices.size();
+		}
+		return Count;
+	}
+
+	uint64_t DeviceStatsStore::MemoryUse() const {
+		uint64_t Bytes = 0;
+		for (const auto &S : Shards_) {
+			std::shared_lock G(S.Mutex);
+			Bytes += S.Bytes + S.Devices.bucket_count() * sizeof(void *);
+		}
+		return Bytes;
+	}
+
+	uint64_t DeviceStatsStore::Footprint(const DeviceStatistics &Stats) {
+		//	Only strings longer than the small string buffer own heap memory.
+		auto Heap = [](const std::string &S) -> uint64_t {
+			return S.capacity() > std::string().capacity() ? S.capacity() + 1 : 0;
+		};
+		uint64_t Bytes = sizeof(DeviceStatistics) + Heap(Stats.Serial);
+		Bytes += Stats.Interfaces.capacity() * sizeof(StatsInterface);
+		for (const auto &I : Stats.Interfaces)
+			Bytes += Heap(I.Name) + Heap(I.Location);
+		Bytes += Stats.Clients.capacity() * sizeof(StatsClient);
+		for (const auto &C : Stats.Clients)
+			Bytes += Heap(C.Mac) + Heap(C.IPv4) + Heap(C.IPv6) + Heap(C.LastIPv4);
+		Bytes += Stats.SSIDs.capacity() * sizeof(StatsSSID);
+		for (const auto &I : Stats.SSIDs)
+			Bytes += Heap(I.Name);
+		Bytes += Stats.Associations.capacity() * sizeof(StatsAssociation);
+		for (const auto &A : Stats.Associations)
+			Bytes += Heap(A.Station);
+		return Bytes;
+	}
+
 } // namespace OpenWifi
\ No newline at end of file
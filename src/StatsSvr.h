@@ -4,86 +4,99 @@
 
 #pragma once
 
-#include "Poco/Notification.h"
-#include "Poco/NotificationQueue.h"
+#include <array>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Poco/Event.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
 #include "RESTObjects/RESTAPI_SubObjects.h"
+#include "StatsDecoder.h"
+#include "StatsSnapshot.h"
+#include "TrafficHistory.h"
+#include "framework/BoundedQueue.h"
 #include "framework/SubSystemServer.h"
 #include "framework/utils.h"
 
 namespace OpenWifi {
 
-	class Stats_Msg : public Poco::Notification {
+	//
+	// Per-device statistics, sharded by serial number. Each shard has its own lock, held only
+	// to update or copy a single entry, so REST readers and the ingest thread only meet when
+	// they touch the same shard at the same time.
+	//
+	class DeviceStatsStore {
 	  public:
-		explicit Stats_Msg(std::string Key, std::string Payload)
-			: Key_(std::move(Key)), Payload_(std::move(Payload)) {}
-		const std::string &Key() { return Key_; }
-		const std::string &Payload() { return Payload_; }
+		static constexpr std::size_t ShardCount = 64;
+
+		void AddTraffic(uint64_t Serial, uint64_t TimeStamp, uint64_t ExtTx, uint64_t ExtRx,
+						uint64_t IntTx, uint64_t IntRx);
+		void GetTraffic(uint64_t Serial, SubObjects::StatsBlock &Stats) const;
+		bool GetTrafficRollup(uint64_t Serial, uint64_t Resolution,
+							  SubObjects::StatsRollupBlock &Stats) const;
+		void SetClients(uint64_t Serial, std::shared_ptr<const DeviceStatistics> Stats,
+						uint64_t Received);
+		std::shared_ptr<const DeviceStatistics> GetClients(uint64_t Serial,
+														   uint64_t &Received) const;
+
+		// Traffic histories follow this layout. Set it before any traffic is added: histories
+		// kept under another layout are restarted on their next sample.
+		inline void SetLayout(std::shared_ptr<const TrafficLayout> Layout) {
+			Layout_ = std::move(Layout);
+		}
+		[[nodiscard]] inline const TrafficLayout &Layout() const { return *Layout_; }
 
-	  private:
-		std::string Key_;
-		std::string Payload_;
-	};
+		// Copies the histories changed since the last checkpoint to the snapshot. Returns the
+		// number of records written.
+		uint64_t Checkpoint(StatsSnapshot &Snapshot);
+		// Adopts the histories of a snapshot. Call before any traffic is added.
+		uint64_t Restore(const StatsSnapshot &Snapshot);
 
-	struct DeviceStats {
-		uint64_t LastUpdate_ = 0;
-		constexpr static const size_t buffer_size = 20;
-		std::array<std::uint64_t, buffer_size> timestamps, ext_txs, ext_rxs, int_txs, int_rxs;
-		uint64_t base_int_tx = 0, base_int_rx = 0, base_ext_tx = 0, base_ext_rx = 0;
-
-		uint32_t index_ = 0;
-		bool no_base = true;
-		void AddValue(uint64_t ts, uint32_t ext_tx, uint32_t ext_rx, uint32_t int_tx,
-					  uint32_t int_rx) {
-			if (no_base) {
-				base_int_rx = int_rx;
-				base_int_tx = int_tx;
-				base_ext_rx = ext_rx;
-				base_ext_tx = ext_tx;
-				no_base = false;
-				return;
-			}
-
-			timestamps[index_] = ts;
-			int_txs[index_] = int_tx - base_int_tx;
-			base_int_tx = int_tx;
-			int_rxs[index_] = int_rx - base_int_rx;
-			base_int_rx = int_rx;
-			ext_txs[index_] = ext_tx - base_ext_tx;
-			base_ext_tx = ext_tx;
-			ext_rxs[index_] = ext_rx - base_ext_rx;
-			base_ext_rx = ext_rx;
-			index_++;
-
-			if (index_ == buffer_size) {
-				// move everything down by one...
-				std::memmove(&timestamps[0], &timestamps[1],
-							 sizeof(timestamps[1]) * buffer_size - 1);
-				std::memmove(&ext_txs[0], &ext_txs[1], sizeof(ext_txs[1]) * buffer_size - 1);
-				std::memmove(&ext_rxs[0], &ext_rxs[1], sizeof(ext_rxs[1]) * buffer_size - 1);
-				std::memmove(&int_txs[0], &int_txs[1], sizeof(int_txs[1]) * buffer_size - 1);
-				std::memmove(&int_rxs[0], &int_rxs[1], sizeof(int_rxs[1]) * buffer_size - 1);
-				index_--;
-			}
-			LastUpdate_ = Utils::Now();
-		}
+		[[nodiscard]] uint64_t Devices() const;
+		// Approximate number of bytes held by the entries and their client snapshots.
+		[[nodiscard]] uint64_t MemoryUse() const;
+		static uint64_t Footprint(const DeviceStatistics &Stats);
 
-		void print() {
-			for (size_t i = 0; i < index_; i++) {
-				std::cout << "TS: " << timestamps[i] << " ext_tx:" << ext_txs[i]
-						  << " ext_rx:" << ext_rxs[i] << " int_tx:" << int_txs[i]
-						  << " int_rx:" << int_rxs[i] << std::endl;
-			}
+	  private:
+		struct Entry {
+			TrafficHistory Traffic;
+			uint64_t Received = 0;
+			std::shared_ptr<const DeviceStatistics> Clients;
+			uint64_t ClientsBytes = 0;
+			//	Set by ingest, cleared by the checkpoint under the shared lock: readers never
+			//	touch them.
+			uint64_t Record = StatsSnapshot::NoRecord;
+			bool Dirty = false;
+		};
+
+		struct alignas(64) Shard {
+			mutable std::shared_mutex Mutex;
+			std::unordered_map<uint64_t, Entry> Devices;
+			uint64_t Bytes = 0;
+		};
+
+		std::array<Shard, ShardCount> Shards_;
+		std::shared_ptr<const TrafficLayout> Layout_ = std::make_shared<const TrafficLayout>();
+
+		//	Serial numbers share their OUI: mix the bits before picking a shard.
+		inline Shard &ShardOf(uint64_t Serial) {
+			return Shards_[(Serial * 0x9E3779B97F4A7C15ull) >> 58];
 		}
-
-		void Get(SubObjects::StatsBlock &Stats) {
-			Stats.modified = LastUpdate_;
-			for (size_t i = 0; i < index_; i++) {
-				Stats.external.push_back({timestamps[i], ext_txs[i], ext_rxs[i]});
-				Stats.internal.push_back({timestamps[i], int_txs[i], int_rxs[i]});
-			}
+		[[nodiscard]] inline const Shard &ShardOf(uint64_t Serial) const {
+			return Shards_[(Serial * 0x9E3779B97F4A7C15ull) >> 58];
 		}
+		Entry &Find(Shard &S, uint64_t Serial);
 	};
 
+	//
+	// State messages are decoded by a pool of workers. Each worker owns a bounded queue and
+	// messages are routed by a hash of their key (the device serial number), so the reports
+	// of a device are always applied in order. A full queue makes the caller wait up to
+	// statscache.queue.wait ms before the message is dropped.
+	//
 	class StatsSvr : public SubSystemServer, Poco::Runnable {
 	  public:
 		static auto instance() {
@@ -93,29 +106,71 @@ namespace OpenWifi {
 
 		int Start() override;
 		void Stop() override;
-		void run() override;
 
-		inline void StatsReceived(const std::string &Key, const std::string &Payload) {
-			std::lock_guard G(Mutex_);
-			// Logger().information(fmt::format("Device({}): Connection/Ping message.", Key));
-			Queue_.enqueueNotification(new Stats_Msg(Key, Payload));
-		}
+		void StatsReceived(const std::string &Key, const std::string &Payload);
 
 		inline void Get(const std::string &SerialNumber, SubObjects::StatsBlock &Stats) {
-			std::lock_guard G(Mutex_);
-
-			auto it = DeviceStats_.find(Utils::SerialNumberToInt(SerialNumber));
-			if (it == end(DeviceStats_))
-				return;
-			it->second.Get(Stats);
+			Store_.GetTraffic(Utils::SerialNumberToInt(SerialNumber), Stats);
+		}
+		[[nodiscard]] inline bool HasRollup(uint64_t Resolution) const {
+			return Store_.Layout().Find(Resolution) != nullptr;
+		}
+		inline bool GetRollup(const std::string &SerialNumber, uint64_t Resolution,
+							  SubObjects::StatsRollupBlock &Stats) {
+			return Store_.GetTrafficRollup(Utils::SerialNumberToInt(SerialNumber), Resolution,
+										   Stats);
 		}
 
+		// Latest clients and associations of a device: the last report seen on the state
+		// topic while it is fresh, otherwise the last statistics held by the gateway service.
+		std::shared_ptr<const DeviceStatistics> ClientStatistics(const std::string &SerialNumber);
+		void ProcessState(const std::string &Payload);
+		void GetStats(Poco::JSON::Object &Answer) const;
+		void run() override;
+
 	  private:
+		class IngestWorker : public Poco::Runnable {
+		  public:
+			IngestWorker(StatsSvr &Svr, std::size_t Id, std::size_t QueueSize,
+						 std::size_t BatchSize)
+				: Svr_(Svr), Id_(Id), Queue_(QueueSize), BatchSize_(BatchSize) {}
+
+			void Start();
+			void Stop();
+			void run() override;
+			bool Enqueue(std::string &&Payload);
+
+			[[nodiscard]] inline std::size_t Queued() const { return Queue_.Size(); }
+			[[nodiscard]] inline std::size_t Capacity() const { return Queue_.Capacity(); }
+			[[nodiscard]] inline uint64_t Processed() const { return Processed_; }
+
+		  private:
+			StatsSvr &Svr_;
+			std::size_t Id_;
+			BoundedQueue<std::string> Queue_;
+			std::size_t BatchSize_;
+			Poco::Thread Thread_;
+			Poco::Event Wake_;
+			std::atomic_bool Running_ = false;
+			std::atomic_bool Sleeping_ = false;
+			std::atomic_uint64_t Processed_ = 0;
+		};
+
 		uint64_t StatsWatcherId_ = 0;
-		Poco::NotificationQueue Queue_;
-		Poco::Thread Worker_;
-		std::atomic_bool Running_ = false;
-		std::map<std::uint64_t, DeviceStats> DeviceStats_;
+		std::vector<std::unique_ptr<IngestWorker>> Workers_;
+		uint64_t EnqueueWait_ = 100;
+		std::atomic_uint64_t Received_ = 0;
+		std::atomic_uint64_t Dropped_ = 0;
+		std::atomic_uint64_t Waited_ = 0;
+		DeviceStatsStore Store_;
+		uint64_t MaxAge_ = 180;
+		StatsSnapshot Snapshot_;
+		uint64_t SnapshotInterval_ = 60;
+		Poco::Thread Checkpointer_;
+		Poco::Event CheckpointWake_;
+		std::atomic_bool Checkpointing_ = false;
+		std::atomic_uint64_t LastCheckpoint_ = 0;
+		std::atomic_uint64_t LastCheckpointRecords_ = 0;
 
 		StatsSvr() noexcept : SubSystemServer("StateSvr", "STATS-SVR", "statscache") {}
 	};
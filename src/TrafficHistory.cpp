@@ -0,0 +1,239 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#include "TrafficHistory.h"
+
+#include <algorithm>
+#include <cctype>
+
+#include "fmt/format.h"
+
+namespace OpenWifi {
+
+	namespace {
+		std::string Trim(const std::string &S) {
+			auto B = S.find_first_not_of(" \t");
+			if (B == std::string::npos)
+				return {};
+			return S.substr(B, S.find_last_not_of(" \t") - B + 1);
+		}
+
+		bool ParseNumber(const std::string &S, uint64_t &Value) {
+			if (S.empty() || S.size() > 10 ||
+				!std::all_of(S.begin(), S.end(), [](unsigned char c) { return std::isdigit(c); }))
+				return false;
+			Value = std::stoull(S);
+			return true;
+		}
+
+		//	Rollup columns of counter C.
+		constexpr uint32_t MinColumn(uint32_t C) { return 2 + 3 * C; }
+		constexpr uint32_t MaxColumn(uint32_t C) { return 3 + 3 * C; }
+		constexpr uint32_t SumColumn(uint32_t C) { return 4 + 3 * C; }
+
+		//	State word of a saved history.
+		constexpr uint64_t HAS_BASE = 0x01;
+		constexpr uint64_t HAS_DATA = 0x02;
+	} // namespace
+
+	TrafficLayout::TrafficLayout(uint32_t RawSlots, const std::string &Rollups,
+								 std::string *Rejected) {
+		Tiers_.push_back({0, std::clamp<uint32_t>(RawSlots, 1, MaxSlots), 0});
+
+		std::string::size_type Start = 0;
+		while (Start <= Rollups.size()) {
+			auto End = Rollups.find(',', Start);
+			if (End == std::string::npos)
+				End = Rollups.size();
+			auto Entry = Trim(Rollups.substr(Start, End - Start));
+			Start = End + 1;
+			if (Entry.empty())
+				continue;
+
+			uint64_t Resolution = 0, Slots = 0;
+			auto Colon = Entry.find(':');
+			if (Colon == std::string::npos ||
+				!ParseNumber(Trim(Entry.substr(0, Colon)), Resolution) ||
+				!ParseNumber(Trim(Entry.substr(Colon + 1)), Slots) || Resolution == 0 ||
+				Slots == 0 || Slots > MaxSlots || Find(Resolution) != nullptr) {
+				if (Rejected)
+					*Rejected += (Rejected->empty() ? "" : ",") + Entry;
+				continue;
+			}
+			Tiers_.push_back({Resolution, static_cast<uint32_t>(Slots), 0});
+		}
+
+		std::sort(Tiers_.begin() + 1, Tiers_.end(),
+				  [](const Tier &L, const Tier &R) { return L.Resolution < R.Resolution; });
+		for (auto &T : Tiers_) {
+			T.Offset = Words_;
+			Words_ += 2 + (T.Resolution ? RollupColumns : RawColumns) * T.Slots;
+		}
+	}
+
+	const TrafficLayout::Tier *TrafficLayout::Find(uint64_t Resolution) const {
+		if (Resolution == 0)
+			return nullptr;
+		for (const auto &T : Tiers_)
+			if (T.Resolution == Resolution)
+				return &T;
+		return nullptr;
+	}
+
+	std::string TrafficLayout::ToString() const {
+		std::string Result = fmt::format("raw:{}", Tiers_[0].Slots);
+		for (auto T = Tiers_.begin() + 1; T != Tiers_.end(); ++T)
+			Result += fmt::format(",{}:{}", T->Resolution, T->Slots);
+		return Result;
+	}
+
+	uint32_t TrafficHistory::Append(const TrafficLayout::Tier &T) {
+		auto Slot = static_cast<uint32_t>(Next(T));
+		Next(T) = Slot + 1 == T.Slots ? 0 : Slot + 1;
+		if (Used(T) < T.Slots)
+			++Used(T);
+		return Slot;
+	}
+
+	void TrafficHistory::AddValue(const std::shared_ptr<const TrafficLayout> &Layout,
+								  uint64_t TimeStamp, uint64_t ExtTx, uint64_t ExtRx,
+								  uint64_t IntTx, uint64_t IntRx, uint64_t Now) {
+		const uint64_t Counters[4]{ExtTx, ExtRx, IntTx, IntRx};
+		if (Layout_ != Layout) {
+			Layout_ = Layout;
+			Data_.reset();
+			NoBase_ = true;
+		}
+		if (NoBase_) {
+			std::copy(std::begin(Counters), std::end(Counters), Base_);
+			NoBase_ = false;
+			return;
+		}
+
+		uint64_t Delta[4];
+		for (uint32_t C = 0; C < 4; ++C) {
+			//	A counter lower than the base means the device restarted counting.
+			Delta[C] = Counters[C] >= Base_[C] ? Counters[C] - Base_[C] : Counters[C];
+			Base_[C] = Counters[C];
+		}
+
+		if (!Data_)
+			Data_ = std::make_unique<uint64_t[]>(Layout_->Words());
+
+		const auto &Tiers = Layout_->Tiers();
+		const auto &Raw = Tiers[0];
+		auto Slot = Append(Raw);
+		Column(Raw, 0)[Slot] = TimeStamp;
+		for (uint32_t C = 0; C < 4; ++C)
+			Column(Raw, 1 + C)[Slot] = Delta[C];
+
+		for (auto T = Tiers.begin() + 1; T != Tiers.end(); ++T) {
+			const auto Period = TimeStamp - TimeStamp % T->Resolution;
+			if (Used(*T) > 0) {
+				const auto Last = Latest(*T);
+				const auto LastPeriod = Column(*T, 0)[Last];
+				if (LastPeriod > Period)
+					continue; //	the device clock went back: keep the rollup as it is
+				if (LastPeriod == Period) {
+					++Column(*T, 1)[Last];
+					for (uint32_t C = 0; C < 4; ++C) {
+						auto &Min = Column(*T, MinColumn(C))[Last];
+						auto &Max = Column(*T, MaxColumn(C))[Last];
+						Min = std::min(Min, Delta[C]);
+						Max = std::max(Max, Delta[C]);
+						Column(*T, SumColumn(C))[Last] += Delta[C];
+					}
+					continue;
+				}
+			}
+			Slot = Append(*T);
+			Column(*T, 0)[Slot] = Period;
+			Column(*T, 1)[Slot] = 1;
+			for (uint32_t C = 0; C < 4; ++C) {
+				Column(*T, MinColumn(C))[Slot] = Delta[C];
+				Column(*T, MaxColumn(C))[Slot] = Delta[C];
+				Column(*T, SumColumn(C))[Slot] = Delta[C];
+			}
+		}
+		LastUpdate_ = Now;
+	}
+
+	void TrafficHistory::Get(SubObjects::StatsBlock &Stats) const {
+		Stats.modified = LastUpdate_;
+		if (!Data_)
+			return;
+		const auto &T = Layout_->Tiers()[0];
+		const auto Count = static_cast<uint32_t>(Used(T));
+		const auto *TimeStamps = Column(T, 0);
+		const auto *ExtTx = Column(T, 1), *ExtRx = Column(T, 2);
+		const auto *IntTx = Column(T, 3), *IntRx = Column(T, 4);
+		Stats.external.reserve(Stats.external.size() + Count);
+		Stats.internal.reserve(Stats.internal.size() + Count);
+		for (uint32_t i = 0, Slot = Oldest(T); i < Count; ++i, Slot = (Slot + 1) % T.Slots) {
+			Stats.external.push_back({TimeStamps[Slot], ExtTx[Slot], ExtRx[Slot]});
+			Stats.internal.push_back({TimeStamps[Slot], IntTx[Slot], IntRx[Slot]});
+		}
+	}
+
+	bool TrafficHistory::GetRollup(uint64_t Resolution, SubObjects::StatsRollupBlock &Stats) const {
+		const auto *T = Layout_ ? Layout_->Find(Resolution) : nullptr;
+		if (T == nullptr)
+			return false;
+		Stats.modified = LastUpdate_;
+		Stats.resolution = Resolution;
+		if (!Data_)
+			return true;
+
+		auto Entry = [this, T](uint32_t Slot, uint32_t Tx, uint32_t Rx) {
+			return SubObjects::StatsRollupEntry{
+				Column(*T, 0)[Slot],		  Column(*T, 1)[Slot],
+				Column(*T, MinColumn(Tx))[Slot], Column(*T, MaxColumn(Tx))[Slot],
+				Column(*T, SumColumn(Tx))[Slot], Column(*T, MinColumn(Rx))[Slot],
+				Column(*T, MaxColumn(Rx))[Slot], Column(*T, SumColumn(Rx))[Slot]};
+		};
+		const auto Count = static_cast<uint32_t>(Used(*T));
+		Stats.external.reserve(Stats.external.size() + Count);
+		Stats.internal.reserve(Stats.internal.size() + Count);
+		for (uint32_t i = 0, Slot = Oldest(*T); i < Count; ++i, Slot = (Slot + 1) % T->Slots) {
+			Stats.external.push_back(Entry(Slot, 0, 1));
+			Stats.internal.push_back(Entry(Slot, 2, 3));
+		}
+		return true;
+	}
+
+	void TrafficHistory::Save(uint64_t *Record) const {
+		Record[0] = (NoBase_ ? 0 : HAS_BASE) | (Data_ ? HAS_DATA : 0);
+		Record[1] = LastUpdate_;
+		std::copy(std::begin(Base_), std::end(Base_), Record + 2);
+		if (Data_)
+			std::copy(Data_.get(), Data_.get() + Layout_->Words(), Record + RecordHeader);
+	}
+
+	bool TrafficHistory::Restore(const std::shared_ptr<const TrafficLayout> &Layout,
+								 const uint64_t *Record) {
+		if ((Record[0] & HAS_BASE) == 0 || (Record[0] & ~(HAS_BASE | HAS_DATA)) != 0)
+			return false;
+		const auto *Words = Record + RecordHeader;
+		if (Record[0] & HAS_DATA) {
+			//	Cursors index the rings: never trust them from a file.
+			for (const auto &T : Layout->Tiers())
+				if (Words[T.Offset] >= T.Slots || Words[T.Offset + 1] > T.Slots)
+					return false;
+		}
+
+		Layout_ = Layout;
+		NoBase_ = false;
+		LastUpdate_ = Record[1];
+		std::copy(Record + 2, Record + RecordHeader, Base_);
+		Data_.reset();
+		if (Record[0] & HAS_DATA) {
+			Data_ = std::make_unique<uint64_t[]>(Layout_->Words());
+			std::copy(Words, Words + Layout_->Words(), Data_.get());
+		}
+		return true;
+	}
+
+} // namespace OpenWifi
@@ -0,0 +1,110 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "RESTObjects/RESTAPI_SubObjects.h"
+
+namespace OpenWifi {
+
+	//
+	// Shape of the traffic history kept for every device: the last raw samples, then any
+	// number of rollup tiers, each holding a fixed number of periods. The layout fixes the
+	// memory held by a device (DeviceBytes), whatever its reporting rate.
+	//
+	class TrafficLayout {
+	  public:
+		struct Tier {
+			uint64_t Resolution = 0; // seconds per slot, 0 for raw samples
+			uint32_t Slots = 0;
+			uint32_t Offset = 0; // first word of the tier in a device block
+		};
+
+		// Raw samples: timestamp, then ext_tx, ext_rx, int_tx, int_rx.
+		static constexpr uint32_t RawColumns = 5;
+		// Rollups: period start and sample count, then min, max and sum for each counter.
+		static constexpr uint32_t RollupColumns = 2 + 3 * 4;
+		static constexpr uint32_t MaxSlots = 1 << 16;
+		// Rollups are opt-in: each tier adds 8 bytes x (2 + 14 x slots) to every device.
+		static constexpr const char *DefaultRollups = "";
+
+		// Rollups are "<seconds>:<slots>" pairs separated by commas. Malformed or duplicate
+		// entries are returned in Rejected and ignored.
+		TrafficLayout(uint32_t RawSlots = 20, const std::string &Rollups = DefaultRollups,
+					  std::string *Rejected = nullptr);
+
+		[[nodiscard]] inline const std::vector<Tier> &Tiers() const { return Tiers_; }
+		[[nodiscard]] inline uint32_t Words() const { return Words_; }
+		[[nodiscard]] inline uint64_t DeviceBytes() const { return Words_ * sizeof(uint64_t); }
+		[[nodiscard]] const Tier *Find(uint64_t Resolution) const;
+		[[nodiscard]] std::string ToString() const;
+
+	  private:
+		std::vector<Tier> Tiers_; // Tiers_[0] holds the raw samples
+		uint32_t Words_ = 0;
+	};
+
+	//
+	// Traffic history of a device. Devices report cumulative counters: the first report is
+	// the base and every following one adds the difference as a sample. Each tier is a ring
+	// in struct-of-arrays layout inside a single allocation, so a sample is O(1) per tier and
+	// readers copy out contiguous columns. Nothing is allocated until the first sample.
+	//
+	class TrafficHistory {
+	  public:
+		void AddValue(const std::shared_ptr<const TrafficLayout> &Layout, uint64_t TimeStamp,
+					  uint64_t ExtTx, uint64_t ExtRx, uint64_t IntTx, uint64_t IntRx,
+					  uint64_t Now);
+
+		// Raw samples, oldest first.
+		void Get(SubObjects::StatsBlock &Stats) const;
+		// Periods of one rollup tier, oldest first. False when no tier has that resolution.
+		bool GetRollup(uint64_t Resolution, SubObjects::StatsRollupBlock &Stats) const;
+
+		[[nodiscard]] inline uint64_t Bytes() const { return Data_ ? Layout_->DeviceBytes() : 0; }
+
+		// Fixed-size image of a history, for StatsSnapshot: a state word, the last update, the
+		// base counters, then the words of the layout.
+		static constexpr uint32_t RecordHeader = 6;
+		[[nodiscard]] static inline uint32_t RecordWords(const TrafficLayout &Layout) {
+			return RecordHeader + Layout.Words();
+		}
+		void Save(uint64_t *Record) const;
+		// False when the image is empty or does not fit the layout.
+		bool Restore(const std::shared_ptr<const TrafficLayout> &Layout, const uint64_t *Record);
+
+	  private:
+		std::shared_ptr<const TrafficLayout> Layout_;
+		std::unique_ptr<uint64_t[]> Data_;
+		uint64_t LastUpdate_ = 0;
+		uint64_t Base_[4]{};
+		bool NoBase_ = true;
+
+		[[nodiscard]] inline uint64_t *Column(const TrafficLayout::Tier &T, uint32_t C) const {
+			return &Data_[T.Offset + 2 + C * T.Slots];
+		}
+		//	Each tier starts with its cursor: the next slot to write and the slots in use.
+		[[nodiscard]] inline uint64_t &Next(const TrafficLayout::Tier &T) const {
+			return Data_[T.Offset];
+		}
+		[[nodiscard]] inline uint64_t &Used(const TrafficLayout::Tier &T) const {
+			return Data_[T.Offset + 1];
+		}
+		[[nodiscard]] inline uint32_t Oldest(const TrafficLayout::Tier &T) const {
+			return static_cast<uint32_t>((Next(T) + T.Slots - Used(T)) % T.Slots);
+		}
+		[[nodiscard]] inline uint32_t Latest(const TrafficLayout::Tier &T) const {
+			return static_cast<uint32_t>((Next(T) + T.Slots - 1) % T.Slots);
+		}
+		uint32_t Append(const TrafficLayout::Tier &T);
+	};
+
+} // namespace OpenWifi
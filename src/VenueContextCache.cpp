@@ -0,0 +1,198 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#include "VenueContextCache.h"
+
+#include <mutex>
+
+#include "Poco/JSON/Parser.h"
+
+#include "fmt/format.h"
+#include "framework/KafkaManager.h"
+#include "framework/KafkaTopics.h"
+#include "framework/MicroServiceFuncs.h"
+
+namespace OpenWifi {
+
+	namespace {
+		inline std::string GatewayKey(const std::string &SerialNumber) { return "gw:" + SerialNumber; }
+		inline std::string SubscriberKey(const std::string &SubscriberId) {
+			return "sub:" + SubscriberId;
+		}
+
+		//	Provisioning change messages do not share one schema: collect every string found at the
+		//	top level and in the "payload" object, and treat each as a possible id. Each costs an
+		//	index lookup.
+		void CollectIds(const Poco::JSON::Object::Ptr &Obj, std::set<std::string> &Ids) {
+			if (!Obj)
+				return;
+			for (const auto &[Name, Value] : *Obj) {
+				if (Value.isString())
+					Ids.insert(Value.toString());
+			}
+		}
+	} // namespace
+
+	int VenueContextCache::Start() {
+		MaxEntries_ = MicroServiceConfigGetInt("venuecache.size", 4096);
+		TTL_ = std::chrono::seconds(MicroServiceConfigGetInt("venuecache.ttl", 3600));
+		NegativeTTL_ = std::chrono::seconds(MicroServiceConfigGetInt("venuecache.negativettl", 60));
+		poco_information(Logger(), fmt::format("Starting: size={} ttl={}s negativettl={}s",
+											   MaxEntries_, TTL_.count(), NegativeTTL_.count()));
+
+		Types::TopicNotifyFunction F = [this](const std::string &Key, const std::string &Payload) {
+			this->ProvisioningChange(Key, Payload);
+		};
+		WatcherId_ = KafkaManager()->RegisterTopicWatcher(KafkaTopics::PROVISIONING_CHANGE, F);
+		return 0;
+	}
+
+	void VenueContextCache::Stop() {
+		poco_information(Logger(), "Stopping...");
+		KafkaManager()->UnregisterTopicWatcher(KafkaTopics::PROVISIONING_CHANGE, WatcherId_);
+		Clear();
+		poco_information(Logger(), "Stopped...");
+	}
+
+	VenueContextLookup VenueContextCache::GetByGateway(const std::string &SerialNumber,
+													   VenueContext &Context) {
+		return Get(GatewayKey(SerialNumber), Context);
+	}
+
+	VenueContextLookup VenueContextCache::GetBySubscriber(const std::string &SubscriberId,
+														  VenueContext &Context) {
+		return Get(SubscriberKey(SubscriberId), Context);
+	}
+
+	void VenueContextCache::UpdateByGateway(const std::string &SerialNumber,
+											const VenueContext &Context, bool NoTimezone) {
+		Update(GatewayKey(SerialNumber), Context, NoTimezone);
+	}
+
+	void VenueContextCache::UpdateBySubscriber(const std::string &SubscriberId,
+											   const VenueContext &Context, bool NoTimezone) {
+		Update(SubscriberKey(SubscriberId), Context, NoTimezone);
+	}
+
+	VenueContextLookup VenueContextCache::Get(const std::string &Key, VenueContext &Context) {
+		std::shared_lock G(CacheMutex_);
+		auto It = Entries_.find(Key);
+		if (It == Entries_.end() || It->second.Expires <= std::chrono::steady_clock::now())
+			return VenueContextLookup::Miss;
+		Context = It->second.Context;
+		return It->second.NoTimezone ? VenueContextLookup::NoTimezone : VenueContextLookup::Found;
+	}
+
+	void VenueContextCache::Update(const std::string &Key, const VenueContext &Context,
+								   bool NoTimezone) {
+		auto Now = std::chrono::steady_clock::now();
+		std::unique_lock G(CacheMutex_);
+		EraseKey(Key);
+		if (Entries_.size() >= MaxEntries_) {
+			for (auto It = Entries_.begin(); It != Entries_.end();) {
+				if (It->second.Expires <= Now)
+					It = Erase(It);
+				else
+					++It;
+			}
+			//	Still full of live entries: make room by dropping the one closest to expiry.
+			if (Entries_.size() >= MaxEntries_) {
+				auto Oldest = Entries_.begin();
+				for (auto It = Entries_.begin(); It != Entries_.end(); ++It) {
+					if (It->second.Expires < Oldest->second.Expires)
+						Oldest = It;
+				}
+				Erase(Oldest);
+			}
+		}
+		Entries_[Key] = Entry{Context, NoTimezone, Now + (NoTimezone ? NegativeTTL_ : TTL_)};
+		for (const auto *Id : {&Context.venueId, &Context.locationId}) {
+			if (!Id->empty())
+				Index_[*Id].insert(Key);
+		}
+	}
+
+	VenueContextCache::EntryMap::iterator VenueContextCache::Erase(EntryMap::iterator It) {
+		for (const auto *Id : {&It->second.Context.venueId, &It->second.Context.locationId}) {
+			auto Keys = Index_.find(*Id);
+			if (Keys == Index_.end())
+				continue;
+			Keys->second.erase(It->first);
+			if (Keys->second.empty())
+				Index_.erase(Keys);
+		}
+		return Entries_.erase(It);
+	}
+
+	void VenueContextCache::EraseKey(const std::string &Key) {
+		auto It = Entries_.find(Key);
+		if (It != Entries_.end())
+			Erase(It);
+	}
+
+	void VenueContextCache::InvalidateLocked(const std::string &Id) {
+		if (Id.empty())
+			return;
+		EraseKey(GatewayKey(Id));
+		EraseKey(SubscriberKey(Id));
+		auto Keys = Index_.find(Id);
+		if (Keys == Index_.end())
+			return;
+		//	Erasing the entries edits the index: work on a copy.
+		const auto Referencing = Keys->second;
+		for (const auto &Key : Referencing)
+			EraseKey(Key);
+	}
+
+	void VenueContextCache::Invalidate(const std::string &Id) {
+		std::unique_lock G(CacheMutex_);
+		InvalidateLocked(Id);
+	}
+
+	void VenueContextCache::Clear() {
+		std::unique_lock G(CacheMutex_);
+		Entries_.clear();
+		Index_.clear();
+	}
+
+	const date::time_zone *VenueContextCache::LocateZone(const std::string &Name) {
+		{
+			std::shared_lock G(ZoneMutex_);
+			auto It = Zones_.find(Name);
+			if (It != Zones_.end())
+				return It->second;
+		}
+		//	Zones live as long as the tz database: the pointer can be kept.
+		const auto *Zone = date::locate_zone(Name);
+		std::unique_lock G(ZoneMutex_);
+		Zones_.emplace(Name, Zone);
+		return Zone;
+	}
+
+	void VenueContextCache::ProvisioningChange(const std::string &Key, const std::string &Payload) {
+		std::set<std::string> Ids;
+		if (!Key.empty())
+			Ids.insert(Key);
+		try {
+			Poco::JSON::Parser P;
+			auto Msg = P.parse(Payload).extract<Poco::JSON::Object::Ptr>();
+			CollectIds(Msg, Ids);
+			if (Msg->isObject("payload"))
+				CollectIds(Msg->getObject("payload"), Ids);
+		} catch (...) {
+			//	Nothing to match against: forget everything rather than serve stale data.
+			if (Ids.empty()) {
+				poco_debug(Logger(), "Unparsable provisioning change, clearing cache.");
+				Clear();
+				return;
+			}
+		}
+		std::unique_lock G(CacheMutex_);
+		for (const auto &Id : Ids)
+			InvalidateLocked(Id);
+	}
+
+} // namespace OpenWifi
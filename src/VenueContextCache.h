@@ -0,0 +1,97 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <set>
+#include <shared_mutex>
+#include <string>
+
+#include <date/tz.h>
+
+#include "framework/SubSystemServer.h"
+
+namespace OpenWifi {
+
+	//	What OWProv knows about the venue a gateway (or a subscriber) belongs to.
+	struct VenueContext {
+		std::string venueId;
+		std::string locationId;
+		std::string boardId;
+		std::string timezone;
+		const date::time_zone *zone = nullptr;
+	};
+
+	enum class VenueContextLookup {
+		Miss,
+		Found,
+		NoTimezone // cached negative: the venue has no location, or the location no timezone
+	};
+
+	//
+	// Caches venue/location/timezone lookups keyed by gateway serial and by subscriber id.
+	// Entries expire after a TTL and are dropped early when a provisioning change mentions the
+	// gateway, subscriber, venue or location they were built from.
+	//
+	class VenueContextCache : public SubSystemServer {
+	  public:
+		static auto instance() {
+			static auto instance_ = new VenueContextCache;
+			return instance_;
+		}
+
+		int Start() override;
+		void Stop() override;
+
+		VenueContextLookup GetByGateway(const std::string &SerialNumber, VenueContext &Context);
+		VenueContextLookup GetBySubscriber(const std::string &SubscriberId, VenueContext &Context);
+		void UpdateByGateway(const std::string &SerialNumber, const VenueContext &Context,
+							 bool NoTimezone = false);
+		void UpdateBySubscriber(const std::string &SubscriberId, const VenueContext &Context,
+								bool NoTimezone = false);
+
+		void Invalidate(const std::string &Id);
+		void Clear();
+		void ProvisioningChange(const std::string &Key, const std::string &Payload);
+
+		//	date::locate_zone, remembered by name. Throws like it for an unknown zone.
+		const date::time_zone *LocateZone(const std::string &Name);
+
+	  private:
+		struct Entry {
+			VenueContext Context;
+			bool NoTimezone = false;
+			std::chrono::steady_clock::time_point Expires;
+		};
+		using EntryMap = std::map<std::string, Entry>;
+
+		std::shared_mutex CacheMutex_;
+		EntryMap Entries_;
+		//	Venue and location ids to the keys of the entries built from them.
+		std::map<std::string, std::set<std::string>> Index_;
+		std::shared_mutex ZoneMutex_;
+		std::map<std::string, const date::time_zone *> Zones_;
+		uint64_t WatcherId_ = 0;
+		uint64_t MaxEntries_ = 4096;
+		std::chrono::seconds TTL_{3600};
+		std::chrono::seconds NegativeTTL_{60};
+
+		VenueContextLookup Get(const std::string &Key, VenueContext &Context);
+		void Update(const std::string &Key, const VenueContext &Context, bool NoTimezone);
+		//	Called with CacheMutex_ held.
+		EntryMap::iterator Erase(EntryMap::iterator It);
+		void EraseKey(const std::string &Key);
+		void InvalidateLocked(const std::string &Id);
+
+		VenueContextCache() noexcept
+			: SubSystemServer("VenueContextCache", "VENUE-CACHE", "venuecache") {}
+	};
+
+	inline auto VenueContextCache() { return VenueContextCache::instance(); }
+
+} // namespace OpenWifi
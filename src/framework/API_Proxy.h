@@ -6,11 +6,11 @@
 
 #include "Poco/JSON/Parser.h"
 #include "Poco/Logger.h"
-#include "Poco/Net/HTTPSClientSession.h"
 #include "Poco/Net/HTTPServerRequest.h"
 #include "Poco/Net/HTTPServerResponse.h"
 #include "Poco/URI.h"
 
+#include "framework/HTTPSessionPool.h"
 #include "framework/MicroServiceFuncs.h"
 
 namespace OpenWifi {
@@ -28,10 +28,6 @@ namespace OpenWifi {
 				// std::cout << "     Source: " << SourceURI.toString() << std::endl;
 				// std::cout << "Destination: " << DestinationURI.toString() << std::endl;
 
-				Poco::Net::HTTPSClientSession Session(DestinationURI.getHost(),
-													  DestinationURI.getPort());
-				Session.setKeepAlive(true);
-				Session.setTimeout(Poco::Timespan(msTimeout_ / 1000, msTimeout_ % 1000));
 				Poco::Net::HTTPRequest ProxyRequest(Request->getMethod(),
 													DestinationURI.getPathAndQuery(),
 													Poco::Net::HTTPMessage::HTTP_1_1);
@@ -42,10 +38,11 @@ namespace OpenWifi {
 					ProxyRequest.add("X-INTERNAL-NAME", MicroServicePublicEndPoint());
 				}
 
+				Poco::Net::HTTPResponse ProxyResponse;
+				std::string RawResponseBody;
 				if (Request->getMethod() == Poco::Net::HTTPRequest::HTTP_DELETE) {
-					Session.sendRequest(ProxyRequest);
-					Poco::Net::HTTPResponse ProxyResponse;
-					Session.receiveResponse(ProxyResponse);
+					HTTPSessionPool()->Perform(DestinationURI, msTimeout_, ProxyRequest, "",
+											   ProxyResponse, RawResponseBody);
 					Response->setStatus(ProxyResponse.getStatus());
 					Response->send();
 					return;
@@ -60,22 +57,17 @@ namespace OpenWifi {
 						Logger.log(E);
 					}
 
-					if (SS.str().empty()) {
-						Session.sendRequest(ProxyRequest);
-					} else {
+					if (!SS.str().empty()) {
 						ProxyRequest.setContentType("application/json");
 						ProxyRequest.setContentLength(SS.str().size());
-						std::ostream &os = Session.sendRequest(ProxyRequest);
-						os << SS.str();
 					}
-
-					Poco::Net::HTTPResponse ProxyResponse;
 					std::stringstream SSR;
 					try {
-						std::istream &ProxyResponseStream = Session.receiveResponse(ProxyResponse);
+						HTTPSessionPool()->Perform(DestinationURI, msTimeout_, ProxyRequest,
+												   SS.str(), ProxyResponse, RawResponseBody);
 						Poco::JSON::Parser P2;
 						auto ProxyResponseBody =
-							P2.parse(ProxyResponseStream).extract<Poco::JSON::Object::Ptr>();
+							P2.parse(RawResponseBody).extract<Poco::JSON::Object::Ptr>();
 						Poco::JSON::Stringifier::condense(ProxyResponseBody, SSR);
 						Response->setContentType("application/json");
 						Response->setContentLength(SSR.str().size());
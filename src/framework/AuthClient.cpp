@@ -3,15 +3,265 @@
 //
 
 #include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/RunnableAdapter.h"
 
 #include "fmt/format.h"
 #include "framework/AuthClient.h"
+#include "framework/MicroServiceFuncs.h"
 #include "framework/MicroServiceNames.h"
 #include "framework/OpenAPIRequests.h"
 #include "framework/utils.h"
 
 namespace OpenWifi {
 
+	namespace {
+		//	The security service refused the token. Throttling, timeouts and server errors say
+		//	nothing about it: they are not remembered, and the next request asks again.
+		inline bool Refused(Poco::Net::HTTPServerResponse::HTTPStatus StatusCode) {
+			return StatusCode == Poco::Net::HTTPServerResponse::HTTP_UNAUTHORIZED ||
+				   StatusCode == Poco::Net::HTTPServerResponse::HTTP_FORBIDDEN ||
+				   StatusCode == Poco::Net::HTTPServerResponse::HTTP_NOT_FOUND;
+		}
+	} // namespace
+
+	void AuthClient::Configure() {
+		std::call_once(Configured_, [this]() {
+			Cache_.SetCapacity(MicroServiceConfigGetInt("authentication.cache.size", 100000));
+			ApiKeyCache_.SetCapacity(
+				MicroServiceConfigGetInt("authentication.cache.apikeys.size", 10000));
+			MaxAge_ = MicroServiceConfigGetInt("authentication.cache.maxage", 1200);
+			InvalidTTL_ = MicroServiceConfigGetInt("authentication.cache.invalid.ttl", 30);
+
+			LocalVerification_ = MicroServiceConfigGetBool("authentication.local.enable", false);
+			if (!LocalVerification_)
+				return;
+			KeysURI_ = MicroServiceConfigGetString("authentication.local.jwks.uri",
+												   "/.well-known/jwks.json");
+			KeysRefresh_ = std::max<uint64_t>(
+				60, MicroServiceConfigGetInt("authentication.local.refresh", 3600));
+			SubjectTTL_ = MicroServiceConfigGetInt("authentication.local.userinfo.ttl", 300);
+			SubjectStale_ = std::max(
+				SubjectTTL_, MicroServiceConfigGetInt("authentication.local.userinfo.stale", 3600));
+			Verifier_.SetIssuer(MicroServiceConfigGetString("authentication.local.issuer", ""));
+			const auto KeyFile = MicroServiceConfigPath("authentication.local.keys.file", "");
+			if (!KeyFile.empty() && !Verifier_.LoadKeyFile(KeyFile))
+				poco_error(Logger(), fmt::format("Cannot load the signing key in {}", KeyFile));
+			if (KeysURI_.empty())
+				return;
+			//	The first requests are validated remotely until the keys are in.
+			KeysRefresher_ = std::make_unique<Poco::RunnableAdapter<AuthClient>>(
+				*this, &AuthClient::RefreshKeys);
+			KeysRunning_ = true;
+			KeysThread_.start(*KeysRefresher_);
+		});
+	}
+
+	void AuthClient::RefreshKeys() {
+		Utils::SetThreadName("auth-keys");
+		while (KeysRunning_) {
+			const auto Loaded = LoadKeys();
+			KeysWake_.tryWait(static_cast<long>(1000 * (Loaded ? KeysRefresh_ : 30)));
+		}
+	}
+
+	bool AuthClient::LoadKeys() {
+		try {
+			OpenAPIRequestGet Req(uSERVICE_SECURITY, KeysURI_, {}, 10000);
+			Poco::JSON::Object::Ptr Response;
+			if (Req.Do(Response) == Poco::Net::HTTPServerResponse::HTTP_OK) {
+				const auto Keys = Verifier_.LoadKeys(Response);
+				if (Keys > 0) {
+					KeysLoaded_ = Utils::Now();
+					poco_debug(Logger(), fmt::format("Loaded {} signing keys", Keys));
+					return true;
+				}
+			}
+		} catch (...) {
+		}
+		poco_warning(Logger(), fmt::format("Cannot load the signing keys from {}", KeysURI_));
+		return false;
+	}
+
+	//	A token signed with a key not seen yet: the keys may have just been rotated.
+	void AuthClient::RequestKeys(uint64_t Now) {
+		auto Last = KeysRequested_.load();
+		if (!KeysRunning_ || Now < Last + 30 ||
+			!KeysRequested_.compare_exchange_strong(Last, Now))
+			return;
+		KeysWake_.set();
+	}
+
+	AuthClient::SubjectLookup AuthClient::FindSubject(const std::string &Id, bool Sub,
+													  uint64_t Now) {
+		const auto Key = (Sub ? "sub:" : "user:") + Id;
+		std::shared_ptr<const Subject> Cached;
+		if (Subjects_.Get(Key, Now, Cached) == TokenCache<Subject>::Lookup::Valid &&
+			Now < Cached->FetchedAt + SubjectTTL_)
+			return SubjectLookup{Cached, true};
+
+		bool Shared = false;
+		return SubjectLookups_.Do(
+			Key,
+			[&]() {
+				try {
+					OpenAPIRequestGet Req(uSERVICE_SECURITY,
+										  (Sub ? "/api/v1/subuser/" : "/api/v1/user/") + Id, {},
+										  5000);
+					Poco::JSON::Object::Ptr Response;
+					const auto StatusCode = Req.Do(Response);
+					if (StatusCode == Poco::Net::HTTPServerResponse::HTTP_OK) {
+						auto Info = std::make_shared<Subject>();
+						Info->User.from_json(Response);
+						Info->FetchedAt = Now;
+						Subjects_.Put(Key, Info, Now + SubjectStale_);
+						return SubjectLookup{std::move(Info), true};
+					}
+					if (StatusCode == Poco::Net::HTTPServerResponse::HTTP_NOT_FOUND) {
+						Subjects_.Remove(Key);
+						return SubjectLookup{nullptr, true};
+					}
+				} catch (...) {
+				}
+				//	The security service is not answering: keep what it said last, for a while.
+				return SubjectLookup{Cached, Cached != nullptr};
+			},
+			Shared);
+	}
+
+	void AuthClient::Revoke(const std::string &Token, uint64_t Expires, uint64_t Now) {
+		std::lock_guard G(RevokedMutex_);
+		auto &Expiry = Revoked_[Token];
+		Expiry = std::max(Expiry, Expires);
+		//	Expired tokens are refused anyway: forget them once a minute.
+		if (Now < RevokedPruned_ + 60)
+			return;
+		RevokedPruned_ = Now;
+		for (auto It = Revoked_.begin(); It != Revoked_.end();)
+			It = It->second <= Now ? Revoked_.erase(It) : std::next(It);
+	}
+
+	bool AuthClient::IsRevoked(const std::string &Token, uint64_t Now) {
+		std::lock_guard G(RevokedMutex_);
+		auto It = Revoked_.find(Token);
+		return It != Revoked_.end() && Now < It->second;
+	}
+
+	AuthClient::LocalAnswer AuthClient::VerifyLocally(const std::string &SessionToken,
+													  SecurityObjects::UserInfoAndPolicy &UInfo,
+													  bool &Expired, bool &Contacted, bool Sub) {
+		const auto Now = Utils::Now();
+		TokenVerifier::Claims Claims;
+		switch (Verifier_.Verify(SessionToken, Now, Claims)) {
+		case TokenVerifier::Result::Unsupported:
+			++LocalUnanswered_;
+			return LocalAnswer::Unanswered;
+		case TokenVerifier::Result::UnknownKey:
+			++LocalUnanswered_;
+			RequestKeys(Now);
+			return LocalAnswer::Unanswered;
+		case TokenVerifier::Result::Invalid:
+			++LocalRejected_;
+			Cache_.PutInvalid(SessionToken, Now + InvalidTTL_);
+			Expired = false;
+			Contacted = true;
+			return LocalAnswer::Rejected;
+		case TokenVerifier::Result::Expired:
+			++LocalRejected_;
+			Expired = true;
+			Contacted = true;
+			return LocalAnswer::Rejected;
+		case TokenVerifier::Result::Valid:
+			break;
+		}
+
+		if (IsRevoked(SessionToken, Now)) {
+			++LocalRejected_;
+			Expired = false;
+			Contacted = true;
+			return LocalAnswer::Rejected;
+		}
+
+		const auto Found = FindSubject(Claims.Subject, Sub, Now);
+		if (!Found.Known) {
+			++LocalUnanswered_;
+			return LocalAnswer::Unanswered;
+		}
+		if (!Found.Info || Found.Info->User.suspended || Found.Info->User.blackListed) {
+			++LocalRejected_;
+			Cache_.PutInvalid(SessionToken, Now + InvalidTTL_);
+			Expired = false;
+			Contacted = true;
+			return LocalAnswer::Rejected;
+		}
+
+		auto Info = std::make_shared<SecurityObjects::UserInfoAndPolicy>();
+		Info->userinfo = Found.Info->User;
+		auto &T = Info->webtoken;
+		T.access_token_ = SessionToken;
+		T.token_type_ = "Bearer";
+		T.username_ = Found.Info->User.email.empty() ? Claims.Email : Found.Info->User.email;
+		T.created_ = std::min(Claims.IssuedAt ? Claims.IssuedAt : Now, Now);
+		T.expires_in_ = Claims.Expires - T.created_;
+		Cache_.Put(SessionToken, Info, std::min(Claims.Expires, Now + MaxAge_));
+		//	Revoked while it was being verified: RemovedCachedToken may have run before the Put.
+		if (IsRevoked(SessionToken, Now)) {
+			Cache_.Remove(SessionToken);
+			++LocalRejected_;
+			Expired = false;
+			Contacted = true;
+			return LocalAnswer::Rejected;
+		}
+		UInfo = *Info;
+		++LocalAccepted_;
+		Expired = false;
+		Contacted = true;
+		return LocalAnswer::Accepted;
+	}
+
+	void AuthClient::RemovedCachedToken(const std::string &Token) {
+		Configure();
+		//	The signature stays good after a logout: refuse the token until it expires. This is
+		//	recorded before the caches are emptied, so a local verification running now cannot
+		//	cache the token again.
+		if (LocalVerification_) {
+			const auto Now = Utils::Now();
+			TokenVerifier::Claims Claims;
+			const auto Result = Verifier_.Verify(Token, Now, Claims);
+			if (Result == TokenVerifier::Result::Valid)
+				Revoke(Token, Claims.Expires, Now);
+			else if (Result == TokenVerifier::Result::UnknownKey)
+				Revoke(Token, Now + MaxAge_, Now);
+		}
+		Cache_.Remove(Token);
+		ApiKeyCache_.Remove(Token);
+	}
+
+	template <typename F>
+	bool AuthClient::Validate(const std::string &FlightKey,
+							  SecurityObjects::UserInfoAndPolicy &UInfo, bool &Expired,
+							  bool &Contacted, bool &Suspended, F &&Retrieve) {
+		bool Shared = false;
+		auto Result = Validations_.Do(
+			FlightKey,
+			[&Retrieve]() {
+				Validation V;
+				SecurityObjects::UserInfoAndPolicy Info;
+				V.Valid = Retrieve(Info, V.Expired, V.Contacted, V.Suspended);
+				if (V.Valid)
+					V.UserInfo =
+						std::make_shared<const SecurityObjects::UserInfoAndPolicy>(std::move(Info));
+				return V;
+			},
+			Shared);
+		Expired = Result.Expired;
+		Contacted = Result.Contacted;
+		Suspended = Result.Suspended;
+		if (!Result.Valid)
+			return false;
+		UInfo = *Result.UserInfo;
+		return true;
+	}
+
 	bool AuthClient::RetrieveTokenInformation(const std::string &SessionToken,
 											  SecurityObjects::UserInfoAndPolicy &UInfo,
 											  std::uint64_t TID, bool &Expired, bool &Contacted,
@@ -42,12 +292,20 @@ namespace OpenWifi {
 						return false;
 					}
 					Expired = false;
-					Cache_.update(SessionToken, UInfo);
+					//	Revalidated at least every MaxAge_ seconds, in case it was revoked.
+					const auto Now = Utils::Now();
+					Cache_.Put(SessionToken,
+							   std::make_shared<const SecurityObjects::UserInfoAndPolicy>(UInfo),
+							   std::min(UInfo.webtoken.created_ + UInfo.webtoken.expires_in_,
+										Now + MaxAge_));
 					return true;
-				} else {
-					return false;
 				}
 			}
+			//	Only the answers about the token itself are remembered, not the service failures.
+			Expired = false;
+			if (StatusCode == Poco::Net::HTTPServerResponse::HTTP_OK || Refused(StatusCode))
+				Cache_.PutInvalid(SessionToken, Utils::Now() + InvalidTTL_);
+			return false;
 		} catch (...) {
 			poco_error(Logger(), fmt::format("Failed to retrieve token={} for TID={}",
 											 Utils::SanitizeToken(SessionToken), TID));
@@ -59,18 +317,32 @@ namespace OpenWifi {
 	bool AuthClient::IsAuthorized(const std::string &SessionToken,
 								  SecurityObjects::UserInfoAndPolicy &UInfo, std::uint64_t TID,
 								  bool &Expired, bool &Contacted, bool Sub) {
-		auto User = Cache_.get(SessionToken);
-		if (!User.isNull()) {
-			if (IsTokenExpired(User->webtoken)) {
-				Expired = true;
-				Cache_.remove(SessionToken);
-				return false;
-			}
+		Configure();
+		std::shared_ptr<const SecurityObjects::UserInfoAndPolicy> User;
+		switch (Cache_.Get(SessionToken, Utils::Now(), User)) {
+		case TokenCache<SecurityObjects::UserInfoAndPolicy>::Lookup::Valid:
 			Expired = false;
 			UInfo = *User;
 			return true;
+		case TokenCache<SecurityObjects::UserInfoAndPolicy>::Lookup::Invalid:
+			Expired = false;
+			Contacted = true;
+			return false;
+		case TokenCache<SecurityObjects::UserInfoAndPolicy>::Lookup::Miss:
+			break;
 		}
-		return RetrieveTokenInformation(SessionToken, UInfo, TID, Expired, Contacted, Sub);
+		if (LocalVerification_) {
+			const auto Answer = VerifyLocally(SessionToken, UInfo, Expired, Contacted, Sub);
+			if (Answer != LocalAnswer::Unanswered)
+				return Answer == LocalAnswer::Accepted;
+		}
+		bool Suspended = false;
+		return Validate((Sub ? "sub:" : "token:") + SessionToken, UInfo, Expired, Contacted,
+						Suspended,
+						[&](SecurityObjects::UserInfoAndPolicy &Info, bool &E, bool &C,
+							[[maybe_unused]] bool &S) {
+							return RetrieveTokenInformation(SessionToken, Info, TID, E, C, Sub);
+						});
 	}
 
 	bool AuthClient::RetrieveApiKeyInformation(const std::string &SessionToken,
@@ -98,14 +370,17 @@ namespace OpenWifi {
 					Response->has("expiresOn")) {
 					UInfo.from_json(Response);
 					Expired = false;
-					ApiKeyCache_.update(SessionToken,
-										ApiKeyCacheEntry{.UserInfo = UInfo,
-														 .ExpiresOn = Response->get("expiresOn")});
+					const auto Now = Utils::Now();
+					ApiKeyCache_.Put(SessionToken,
+									 std::make_shared<const SecurityObjects::UserInfoAndPolicy>(UInfo),
+									 std::min<uint64_t>(Response->get("expiresOn"), Now + MaxAge_));
 					return true;
-				} else {
-					return false;
 				}
 			}
+			Expired = false;
+			if (StatusCode == Poco::Net::HTTPServerResponse::HTTP_OK || Refused(StatusCode))
+				ApiKeyCache_.PutInvalid(SessionToken, Utils::Now() + InvalidTTL_);
+			return false;
 		} catch (...) {
 			poco_error(Logger(), fmt::format("Failed to retrieve api key={} for TID={}",
 											 Utils::SanitizeToken(SessionToken), TID));
@@ -117,16 +392,106 @@ namespace OpenWifi {
 	bool AuthClient::IsValidApiKey(const std::string &SessionToken,
 								   SecurityObjects::UserInfoAndPolicy &UInfo, std::uint64_t TID,
 								   bool &Expired, bool &Contacted, bool &Suspended) {
-		auto User = ApiKeyCache_.get(SessionToken);
-		if (!User.isNull()) {
-			if (User->ExpiresOn < Utils::Now()) {
-				Expired = false;
-				UInfo = User->UserInfo;
-				return true;
-			}
-			ApiKeyCache_.remove(SessionToken);
+		Configure();
+		std::shared_ptr<const SecurityObjects::UserInfoAndPolicy> User;
+		switch (ApiKeyCache_.Get(SessionToken, Utils::Now(), User)) {
+		case TokenCache<SecurityObjects::UserInfoAndPolicy>::Lookup::Valid:
+			Expired = false;
+			UInfo = *User;
+			return true;
+		case TokenCache<SecurityObjects::UserInfoAndPolicy>::Lookup::Invalid:
+			Expired = false;
+			Contacted = true;
+			return false;
+		case TokenCache<SecurityObjects::UserInfoAndPolicy>::Lookup::Miss:
+			break;
+		}
+		//	Every request sharing the call gets the suspension the service reported.
+		return Validate("apikey:" + SessionToken, UInfo, Expired, Contacted, Suspended,
+						[&](SecurityObjects::UserInfoAndPolicy &Info, bool &E, bool &C, bool &S) {
+							return RetrieveApiKeyInformation(SessionToken, Info, TID, E, C, S);
+						});
+	}
+
+	void AuthClient::GetStats(Poco::JSON::Object &Answer) const {
+		auto Report = [](const TokenCache<SecurityObjects::UserInfoAndPolicy> &Cache) {
+			const auto S = Cache.GetStats();
+			const auto Lookups = S.Hits + S.InvalidHits + S.Misses;
+			Poco::JSON::Object O;
+			O.set("capacity", Cache.Capacity());
+			O.set("entries", S.Entries);
+			O.set("hits", S.Hits);
+			O.set("invalidHits", S.InvalidHits);
+			O.set("misses", S.Misses);
+			O.set("expired", S.Expired);
+			O.set("evictions", S.Evictions);
+			O.set("hitRatio",
+				  Lookups ? static_cast<double>(S.Hits + S.InvalidHits) / Lookups : 0.0);
+			return O;
+		};
+		Answer.set("tokens", Report(Cache_));
+		Answer.set("apiKeys", Report(ApiKeyCache_));
+		Answer.set("sharedValidations", Validations_.Shared());
+
+		Poco::JSON::Object Local;
+		Local.set("enabled", LocalVerification_);
+		Local.set("keys", Verifier_.Keys());
+		Local.set("keysLoaded", KeysLoaded_.load());
+		Local.set("accepted", LocalAccepted_.load());
+		Local.set("rejected", LocalRejected_.load());
+		Local.set("unanswered", LocalUnanswered_.load());
+		Local.set("users", Subjects_.GetStats().Entries);
+		{
+			std::lock_guard G(RevokedMutex_);
+			Local.set("revoked", Revoked_.size());
+		}
+		Answer.set("local", Local);
+	}
+
+	void AuthClient::GetMetrics(std::string &Text) const {
+		const std::pair<const char *, const TokenCache<SecurityObjects::UserInfoAndPolicy> *>
+			Caches[]{{"token", &Cache_}, {"apikey", &ApiKeyCache_}};
+		std::string Lookups, Entries, Evictions;
+		for (const auto &[Kind, Cache] : Caches) {
+			const auto S = Cache->GetStats();
+			Lookups += fmt::format(
+				"openwifi_auth_cache_lookups_total{{cache=\"{0}\",result=\"hit\"}} {1}\n"
+				"openwifi_auth_cache_lookups_total{{cache=\"{0}\",result=\"invalid\"}} {2}\n"
+				"openwifi_auth_cache_lookups_total{{cache=\"{0}\",result=\"miss\"}} {3}\n",
+				Kind, S.Hits, S.InvalidHits, S.Misses);
+			Entries += fmt::format("openwifi_auth_cache_entries{{cache=\"{}\"}} {}\n", Kind,
+								   S.Entries);
+			Evictions += fmt::format("openwifi_auth_cache_evictions_total{{cache=\"{}\"}} {}\n",
+									 Kind, S.Evictions);
 		}
-		return RetrieveApiKeyInformation(SessionToken, UInfo, TID, Expired, Contacted, Suspended);
+		Text += "# HELP openwifi_auth_cache_lookups_total Token cache lookups.\n"
+				"# TYPE openwifi_auth_cache_lookups_total counter\n" +
+				Lookups +
+				"# HELP openwifi_auth_cache_entries Tokens cached.\n"
+				"# TYPE openwifi_auth_cache_entries gauge\n" +
+				Entries +
+				"# HELP openwifi_auth_cache_evictions_total Tokens evicted to make room.\n"
+				"# TYPE openwifi_auth_cache_evictions_total counter\n" +
+				Evictions +
+				fmt::format("# HELP openwifi_auth_validations_shared_total Requests that waited "
+							"for a validation already running.\n"
+							"# TYPE openwifi_auth_validations_shared_total counter\n"
+							"openwifi_auth_validations_shared_total {}\n",
+							Validations_.Shared());
+		if (!LocalVerification_)
+			return;
+		Text += fmt::format(
+			"# HELP openwifi_auth_local_verifications_total Tokens verified with the signing "
+			"keys.\n"
+			"# TYPE openwifi_auth_local_verifications_total counter\n"
+			"openwifi_auth_local_verifications_total{{result=\"accepted\"}} {}\n"
+			"openwifi_auth_local_verifications_total{{result=\"rejected\"}} {}\n"
+			"openwifi_auth_local_verifications_total{{result=\"remote\"}} {}\n"
+			"# HELP openwifi_auth_signing_keys Signing keys loaded.\n"
+			"# TYPE openwifi_auth_signing_keys gauge\n"
+			"openwifi_auth_signing_keys {}\n",
+			LocalAccepted_.load(), LocalRejected_.load(), LocalUnanswered_.load(),
+			Verifier_.Keys());
 	}
 
 } // namespace OpenWifi
\ No newline at end of file
@@ -4,13 +4,36 @@
 
 #pragma once
 
-#include "Poco/ExpireLRUCache.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "Poco/Event.h"
+#include "Poco/JSON/Object.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
 #include "RESTObjects/RESTAPI_SecurityObjects.h"
 #include "framework/SubSystemServer.h"
+#include "framework/TokenCache.h"
+#include "framework/TokenVerifier.h"
 #include "framework/utils.h"
 
 namespace OpenWifi {
 
+	//
+	// Validates session tokens and API keys with the security service. Answers are cached
+	// until the token expires (at most authentication.cache.maxage seconds), and rejections
+	// (401, 403, 404, or an answer without the token's details) for
+	// authentication.cache.invalid.ttl seconds. Concurrent requests carrying the same
+	// unknown token share one validation call.
+	//
+	// With authentication.local.enable, session tokens that are JWTs are verified here against
+	// the security service's signing keys, refreshed in the background; the service is only
+	// asked for the user's details, cached by user. Other tokens are validated remotely.
+	// Logouts are only known from the token removals this instance receives: a removal missed
+	// or lost in a restart leaves the token accepted until it expires.
+	//
 	class AuthClient : public SubSystemServer {
 
 	  public:
@@ -22,24 +45,22 @@ namespace OpenWifi {
 			return instance_;
 		}
 
-		struct ApiKeyCacheEntry {
-			OpenWifi::SecurityObjects::UserInfoAndPolicy UserInfo;
-			std::uint64_t ExpiresOn;
-		};
-
 		inline int Start() override { return 0; }
 
 		inline void Stop() override {
 			poco_information(Logger(), "Stopping...");
+			if (KeysRunning_.exchange(false)) {
+				KeysWake_.set();
+				KeysThread_.join();
+			}
 			std::lock_guard G(Mutex_);
-			Cache_.clear();
+			Cache_.Clear();
+			ApiKeyCache_.Clear();
+			Subjects_.Clear();
 			poco_information(Logger(), "Stopped...");
 		}
 
-		inline void RemovedCachedToken(const std::string &Token) {
-			Cache_.remove(Token);
-			ApiKeyCache_.remove(Token);
-		}
+		void RemovedCachedToken(const std::string &Token);
 
 		inline static bool IsTokenExpired(const SecurityObjects::WebToken &T) {
 			return ((T.expires_in_ + T.created_) < Utils::Now());
@@ -61,10 +82,76 @@ namespace OpenWifi {
 						   SecurityObjects::UserInfoAndPolicy &UInfo, std::uint64_t TID,
 						   bool &Expired, bool &Contacted, bool &Suspended);
 
+		void GetStats(Poco::JSON::Object &Answer) const;
+		void GetMetrics(std::string &Text) const;
+
 	  private:
-		Poco::ExpireLRUCache<std::string, OpenWifi::SecurityObjects::UserInfoAndPolicy> Cache_{
-			512, 1200000};
-		Poco::ExpireLRUCache<std::string, ApiKeyCacheEntry> ApiKeyCache_{512, 1200000};
+		//	What a validation call returned, handed to the requests that waited for it.
+		struct Validation {
+			bool Valid = false;
+			bool Expired = false;
+			bool Contacted = false;
+			bool Suspended = false;
+			std::shared_ptr<const SecurityObjects::UserInfoAndPolicy> UserInfo;
+		};
+
+		//	A user's details, as last returned by the security service.
+		struct Subject {
+			SecurityObjects::UserInfo User;
+			uint64_t FetchedAt = 0;
+		};
+
+		//	Unknown: the security service could not say whether the user exists.
+		struct SubjectLookup {
+			std::shared_ptr<const Subject> Info;
+			bool Known = false;
+		};
+
+		enum class LocalAnswer { Accepted, Rejected, Unanswered };
+
+		std::once_flag Configured_;
+		uint64_t MaxAge_ = 1200;
+		uint64_t InvalidTTL_ = 30;
+		TokenCache<SecurityObjects::UserInfoAndPolicy> Cache_{100000};
+		TokenCache<SecurityObjects::UserInfoAndPolicy> ApiKeyCache_{10000};
+		SingleFlight<Validation> Validations_;
+
+		bool LocalVerification_ = false;
+		uint64_t KeysRefresh_ = 3600;
+		uint64_t SubjectTTL_ = 300;
+		uint64_t SubjectStale_ = 3600;
+		std::string KeysURI_;
+		TokenVerifier Verifier_;
+		TokenCache<Subject> Subjects_{10000};
+		SingleFlight<SubjectLookup> SubjectLookups_;
+		//	Tokens removed by the security service while their signature is still good, with
+		//	their expiry. Nothing is evicted before it expires.
+		mutable std::mutex RevokedMutex_;
+		std::unordered_map<std::string, uint64_t> Revoked_;
+		uint64_t RevokedPruned_ = 0;
+		std::unique_ptr<Poco::Runnable> KeysRefresher_;
+		Poco::Thread KeysThread_;
+		Poco::Event KeysWake_;
+		std::atomic_bool KeysRunning_ = false;
+		std::atomic_uint64_t KeysRequested_ = 0;
+		std::atomic_uint64_t KeysLoaded_ = 0;
+		std::atomic_uint64_t LocalAccepted_ = 0;
+		std::atomic_uint64_t LocalRejected_ = 0;
+		std::atomic_uint64_t LocalUnanswered_ = 0;
+
+		void Configure();
+		void RefreshKeys();
+		bool LoadKeys();
+		void RequestKeys(uint64_t Now);
+		LocalAnswer VerifyLocally(const std::string &SessionToken,
+								  SecurityObjects::UserInfoAndPolicy &UInfo, bool &Expired,
+								  bool &Contacted, bool Sub);
+		SubjectLookup FindSubject(const std::string &Id, bool Sub, uint64_t Now);
+		void Revoke(const std::string &Token, uint64_t Expires, uint64_t Now);
+		bool IsRevoked(const std::string &Token, uint64_t Now);
+		template <typename F>
+		bool Validate(const std::string &FlightKey, SecurityObjects::UserInfoAndPolicy &UInfo,
+					  bool &Expired, bool &Contacted, bool &Suspended, F &&Retrieve);
 	};
 
 	inline auto AuthClient() { return AuthClient::instance(); }
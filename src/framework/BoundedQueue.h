@@ -0,0 +1,102 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace OpenWifi {
+
+	//
+	// Fixed-capacity lock-free FIFO for any number of producers and consumers (bounded MPMC
+	// ring with per-cell sequence numbers). Push fails instead of blocking when the queue is
+	// full, so the caller decides between waiting and dropping.
+	//
+	template <typename T> class BoundedQueue {
+	  public:
+		// The capacity is rounded up to a power of two.
+		explicit BoundedQueue(std::size_t Capacity) {
+			std::size_t Size = 2;
+			while (Size < Capacity)
+				Size <<= 1;
+			Mask_ = Size - 1;
+			Cells_ = std::make_unique<Cell[]>(Size);
+			for (std::size_t i = 0; i < Size; ++i)
+				Cells_[i].Sequence.store(i, std::memory_order_relaxed);
+		}
+
+		BoundedQueue(const BoundedQueue &) = delete;
+		BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+		// Value is left untouched when the queue is full.
+		bool Push(T &&Value) {
+			auto Pos = Tail_.load(std::memory_order_relaxed);
+			Cell *C;
+			for (;;) {
+				C = &Cells_[Pos & Mask_];
+				auto Seq = C->Sequence.load(std::memory_order_acquire);
+				auto Diff = static_cast<std::intptr_t>(Seq) - static_cast<std::intptr_t>(Pos);
+				if (Diff == 0) {
+					if (Tail_.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+						break;
+				} else if (Diff < 0) {
+					return false;
+				} else {
+					Pos = Tail_.load(std::memory_order_relaxed);
+				}
+			}
+			C->Value = std::move(Value);
+			C->Sequence.store(Pos + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool Pop(T &Value) {
+			auto Pos = Head_.load(std::memory_order_relaxed);
+			Cell *C;
+			for (;;) {
+				C = &Cells_[Pos & Mask_];
+				auto Seq = C->Sequence.load(std::memory_order_acquire);
+				auto Diff = static_cast<std::intptr_t>(Seq) - static_cast<std::intptr_t>(Pos + 1);
+				if (Diff == 0) {
+					if (Head_.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+						break;
+				} else if (Diff < 0) {
+					return false;
+				} else {
+					Pos = Head_.load(std::memory_order_relaxed);
+				}
+			}
+			Value = std::move(C->Value);
+			C->Value = T{};
+			C->Sequence.store(Pos + Mask_ + 1, std::memory_order_release);
+			return true;
+		}
+
+		[[nodiscard]] inline std::size_t Capacity() const { return Mask_ + 1; }
+		// Approximate while producers or consumers are active.
+		[[nodiscard]] inline std::size_t Size() const {
+			auto Head = Head_.load(std::memory_order_relaxed);
+			auto Tail = Tail_.load(std::memory_order_relaxed);
+			return Tail > Head ? Tail - Head : 0;
+		}
+
+	  private:
+		struct Cell {
+			std::atomic<std::size_t> Sequence{0};
+			T Value{};
+		};
+
+		std::unique_ptr<Cell[]> Cells_;
+		std::size_t Mask_ = 0;
+		alignas(64) std::atomic<std::size_t> Head_{0};
+		alignas(64) std::atomic<std::size_t> Tail_{0};
+	};
+
+} // namespace OpenWifi
@@ -0,0 +1,192 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#include "framework/HTTPSessionPool.h"
+
+#include "Poco/Net/HTTPSClientSession.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Net/Socket.h"
+#include "Poco/StreamCopier.h"
+
+#include "fmt/format.h"
+#include "framework/MicroServiceFuncs.h"
+
+namespace OpenWifi {
+
+	void HTTPSessionPool::Lease::Release(bool KeepAlive) {
+		if (Session_)
+			HTTPSessionPool::instance()->Return(Key_, std::move(Session_), KeepAlive);
+	}
+
+	int HTTPSessionPool::Start() {
+		std::lock_guard G(Mutex_);
+		Enabled_ = MicroServiceConfigGetBool("openwifi.restapi.client.pool.enabled", true);
+		MaxIdlePerEndPoint_ =
+			MicroServiceConfigGetInt("openwifi.restapi.client.pool.maxidle", 8);
+		IdleTimeout_ = MicroServiceConfigGetInt("openwifi.restapi.client.pool.idletimeout", 30);
+		LastSweep_ = std::chrono::steady_clock::now();
+		poco_information(Logger(),
+						 fmt::format("Starting: enabled={} maxidle={} idletimeout={}s", Enabled_,
+									 MaxIdlePerEndPoint_, IdleTimeout_));
+		return 0;
+	}
+
+	void HTTPSessionPool::Stop() {
+		poco_information(Logger(), "Stopping...");
+		std::lock_guard G(Mutex_);
+		Enabled_ = false;
+		Idle_.clear();
+		poco_information(Logger(), "Stopped...");
+	}
+
+	bool HTTPSessionPool::Healthy(const IdleSession &S,
+								  std::chrono::steady_clock::time_point Now) const {
+		if (!S.Session->connected())
+			return false;
+		if (Now - S.LastUsed >= std::chrono::seconds(IdleTimeout_))
+			return false;
+		try {
+			//	An idle keep-alive socket must have nothing to read: readable means the peer
+			//	closed it (EOF) or sent something we did not ask for.
+			return !S.Session->socket().poll(Poco::Timespan(0),
+											  Poco::Net::Socket::SELECT_READ |
+												  Poco::Net::Socket::SELECT_ERROR);
+		} catch (...) {
+		}
+		return false;
+	}
+
+	void HTTPSessionPool::SweepIdle(std::chrono::steady_clock::time_point Now) {
+		if (Now - LastSweep_ < std::chrono::seconds(5))
+			return;
+		LastSweep_ = Now;
+		for (auto It = Idle_.begin(); It != Idle_.end();) {
+			auto &Sessions = It->second;
+			//	Oldest sessions are at the front.
+			while (!Sessions.empty() &&
+				   Now - Sessions.front().LastUsed >= std::chrono::seconds(IdleTimeout_)) {
+				Sessions.pop_front();
+				++Evicted_;
+			}
+			if (Sessions.empty())
+				It = Idle_.erase(It);
+			else
+				++It;
+		}
+	}
+
+	HTTPSessionPool::Lease HTTPSessionPool::Acquire(const Poco::URI &URI, uint64_t msTimeout,
+													bool Fresh) {
+		auto Key = fmt::format("{}://{}:{}", URI.getScheme(), URI.getHost(), URI.getPort());
+		SessionPtr Session;
+		bool Reused = false;
+		uint64_t IdleTimeout = 0;
+		{
+			std::lock_guard G(Mutex_);
+			auto Now = std::chrono::steady_clock::now();
+			IdleTimeout = IdleTimeout_;
+			SweepIdle(Now);
+			if (Enabled_ && !Fresh) {
+				auto It = Idle_.find(Key);
+				if (It != Idle_.end()) {
+					auto &Sessions = It->second;
+					while (!Sessions.empty()) {
+						//	Most recently used first: it is the least likely to have been
+						//	closed by the server.
+						auto Candidate = std::move(Sessions.back());
+						Sessions.pop_back();
+						if (Healthy(Candidate, Now)) {
+							Session = std::move(Candidate.Session);
+							Reused = true;
+							break;
+						}
+						++Unhealthy_;
+					}
+				}
+			}
+		}
+
+		if (Reused) {
+			++Hits_;
+		} else {
+			++Misses_;
+			if (URI.getScheme() == "https")
+				Session = std::make_unique<Poco::Net::HTTPSClientSession>(URI.getHost(),
+																		   URI.getPort());
+			else
+				Session =
+					std::make_unique<Poco::Net::HTTPClientSession>(URI.getHost(), URI.getPort());
+			Session->setKeepAlive(true);
+			Session->setKeepAliveTimeout(Poco::Timespan((long)IdleTimeout, 0));
+		}
+		Session->setTimeout(Poco::Timespan(msTimeout / 1000, (msTimeout % 1000) * 1000));
+		return Lease(std::move(Key), std::move(Session), Reused);
+	}
+
+	void HTTPSessionPool::Return(const std::string &Key, SessionPtr Session, bool KeepAlive) {
+		if (!KeepAlive || !Session->connected())
+			return;
+		std::lock_guard G(Mutex_);
+		if (!Enabled_)
+			return;
+		auto &Sessions = Idle_[Key];
+		if (Sessions.size() >= MaxIdlePerEndPoint_) {
+			++Overflow_;
+			return;
+		}
+		Sessions.push_back(IdleSession{std::move(Session), std::chrono::steady_clock::now()});
+	}
+
+	void HTTPSessionPool::Perform(const Poco::URI &URI, uint64_t msTimeout,
+								  Poco::Net::HTTPRequest &Request, const std::string &Body,
+								  Poco::Net::HTTPResponse &Response, std::string &ResponseBody) {
+		//	RFC 7230 6.3.1: only idempotent requests are retried once the peer may have them.
+		const auto &Method = Request.getMethod();
+		const bool Idempotent = Method == Poco::Net::HTTPRequest::HTTP_GET ||
+								Method == Poco::Net::HTTPRequest::HTTP_HEAD ||
+								Method == Poco::Net::HTTPRequest::HTTP_DELETE;
+		for (int Attempt = 0;; ++Attempt) {
+			auto Session = Acquire(URI, msTimeout, Attempt > 0);
+			bool Sent = false;
+			auto Retry = [&]() { return Session.Reused() && Attempt == 0 && (!Sent || Idempotent); };
+			try {
+				std::ostream &os = Session->sendRequest(Request);
+				Sent = true;
+				if (!Body.empty())
+					os << Body;
+				std::istream &is = Session->receiveResponse(Response);
+				//	Draining the whole body is what allows the connection to go back to the pool.
+				ResponseBody.clear();
+				Poco::StreamCopier::copyToString(is, ResponseBody);
+				Session.Release(Response.getKeepAlive());
+				return;
+			} catch (const Poco::Net::NoMessageException &) {
+				if (!Retry())
+					throw;
+			} catch (const Poco::Net::ConnectionResetException &) {
+				if (!Retry())
+					throw;
+			}
+		}
+	}
+
+	void HTTPSessionPool::GetStats(Poco::JSON::Object &Answer) {
+		uint64_t IdleCount = 0;
+		{
+			std::lock_guard G(Mutex_);
+			for (const auto &[Key, Sessions] : Idle_)
+				IdleCount += Sessions.size();
+			Answer.set("endpoints", Idle_.size());
+		}
+		Answer.set("idle", IdleCount);
+		Answer.set("hits", Hits_.load());
+		Answer.set("misses", Misses_.load());
+		Answer.set("evicted", Evicted_.load());
+		Answer.set("unhealthy", Unhealthy_.load());
+		Answer.set("overflow", Overflow_.load());
+	}
+
+} // namespace OpenWifi
@@ -0,0 +1,107 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "Poco/JSON/Object.h"
+#include "Poco/Net/HTTPClientSession.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/HTTPResponse.h"
+#include "Poco/URI.h"
+
+#include "framework/SubSystemServer.h"
+
+namespace OpenWifi {
+
+	//
+	// Keeps idle keep-alive HTTP(S) client sessions per endpoint (scheme://host:port) so that
+	// internal REST calls do not pay a TCP/TLS handshake on every request.
+	//
+	class HTTPSessionPool : public SubSystemServer {
+	  public:
+		using SessionPtr = std::unique_ptr<Poco::Net::HTTPClientSession>;
+
+		// A borrowed session. Call Release() once the response has been fully read; a lease that
+		// is destroyed without being released closes its connection instead of pooling it.
+		class Lease {
+		  public:
+			Lease() = default;
+			Lease(std::string Key, SessionPtr Session, bool Reused)
+				: Key_(std::move(Key)), Session_(std::move(Session)), Reused_(Reused) {}
+			Lease(Lease &&) noexcept = default;
+			Lease &operator=(Lease &&) noexcept = default;
+			Lease(const Lease &) = delete;
+			Lease &operator=(const Lease &) = delete;
+			~Lease() = default;
+
+			inline Poco::Net::HTTPClientSession *operator->() { return Session_.get(); }
+			inline Poco::Net::HTTPClientSession &operator*() { return *Session_; }
+			[[nodiscard]] inline bool Reused() const { return Reused_; }
+
+			void Release(bool KeepAlive);
+
+		  private:
+			std::string Key_;
+			SessionPtr Session_;
+			bool Reused_ = false;
+		};
+
+		static auto instance() {
+			static auto instance_ = new HTTPSessionPool;
+			return instance_;
+		}
+
+		int Start() override;
+		void Stop() override;
+
+		//	Fresh skips the idle sessions and always opens a new connection.
+		Lease Acquire(const Poco::URI &URI, uint64_t msTimeout, bool Fresh = false);
+		void Return(const std::string &Key, SessionPtr Session, bool KeepAlive);
+		//	Sends Request (and Body, if any) on a pooled session and reads the whole response
+		//	into ResponseBody. A reused connection the peer closed while it sat idle is retried
+		//	once on a new one, but only when the request is safe to send again: when sending it
+		//	failed, or for GET, HEAD and DELETE. A POST or PUT the peer may have handled is not.
+		void Perform(const Poco::URI &URI, uint64_t msTimeout, Poco::Net::HTTPRequest &Request,
+					 const std::string &Body, Poco::Net::HTTPResponse &Response,
+					 std::string &ResponseBody);
+		void GetStats(Poco::JSON::Object &Answer);
+
+	  private:
+		struct IdleSession {
+			SessionPtr Session;
+			std::chrono::steady_clock::time_point LastUsed;
+		};
+
+		std::map<std::string, std::deque<IdleSession>> Idle_;
+		std::chrono::steady_clock::time_point LastSweep_;
+		bool Enabled_ = true;
+		uint64_t MaxIdlePerEndPoint_ = 8;
+		uint64_t IdleTimeout_ = 30;
+
+		std::atomic_uint64_t Hits_{0};
+		std::atomic_uint64_t Misses_{0};
+		std::atomic_uint64_t Evicted_{0};
+		std::atomic_uint64_t Unhealthy_{0};
+		std::atomic_uint64_t Overflow_{0};
+
+		bool Healthy(const IdleSession &S, std::chrono::steady_clock::time_point Now) const;
+		void SweepIdle(std::chrono::steady_clock::time_point Now);
+
+		HTTPSessionPool() noexcept
+			: SubSystemServer("HTTPSessionPool", "HTTP-SESSION-POOL",
+							  "openwifi.restapi.client.pool") {}
+	};
+
+	inline auto HTTPSessionPool() { return HTTPSessionPool::instance(); }
+
+} // namespace OpenWifi
@@ -4,9 +4,21 @@
 
 #include "KafkaManager.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <set>
+#include <thread>
+#include <tuple>
+
+#include "Poco/Event.h"
+
 #include "fmt/format.h"
+#include "framework/BoundedQueue.h"
+#include "framework/KafkaRecording.h"
 #include "framework/MicroServiceFuncs.h"
-#include "cppkafka/utils/consumer_dispatcher.h"
 
 namespace OpenWifi {
 
@@ -66,6 +78,296 @@ namespace OpenWifi {
 			Config.set("ssl.key.password", Password);
 	}
 
+	namespace {
+		//	Upper bounds of the callback latency buckets, in microseconds. The last bucket has none.
+		constexpr std::array<uint64_t, 5> LatencyBounds{100, 1000, 10000, 100000, 1000000};
+		constexpr std::array<const char *, 6> LatencyNames{"100us", "1ms", "10ms",
+														   "100ms", "1s",  "more"};
+
+		//	Rate per second of a counter over the last sampling period.
+		inline uint64_t Rate(uint64_t Count, uint64_t &Last, double Seconds) {
+			const auto Delta = Count - Last;
+			Last = Count;
+			return Seconds > 0.0 ? static_cast<uint64_t>(static_cast<double>(Delta) / Seconds) : 0;
+		}
+
+		struct TopicCounters {
+			std::string Topic;
+			uint64_t Messages = 0;
+			uint64_t Bytes = 0;
+			uint64_t MessageRate = 0;
+			uint64_t ByteRate = 0;
+			uint64_t Processed = 0;
+			uint64_t Queued = 0;
+			uint64_t Capacity = 0;
+			uint64_t Pending = 0;
+			uint64_t Pauses = 0;
+			bool Paused = false;
+			bool Throttled = false;
+			std::array<uint64_t, LatencyBounds.size() + 1> Latency{};
+			uint64_t LatencySum = 0; //	microseconds
+		};
+
+		inline void MetricHeader(std::string &Text, const char *Name, const char *Type,
+								 const char *Help) {
+			Text += fmt::format("# HELP {0} {1}\n# TYPE {0} {2}\n", Name, Help, Type);
+		}
+	} // namespace
+
+	//
+	// A message for a topic worker: consumed from the broker, or replayed from a recording.
+	// A replayed message only has its record, and no partition or offset to commit. A consumed
+	// one gets its key and payload copied into the record when it is dispatched.
+	//
+	struct KafkaEntry {
+		cppkafka::Message Message;
+		KafkaRecord Record;
+		uint64_t Epoch = 0;
+
+		[[nodiscard]] inline std::string Topic() const {
+			return Message ? Message.get_topic() : Record.Topic;
+		}
+		[[nodiscard]] inline int Partition() const {
+			return Message ? Message.get_partition() : -1;
+		}
+		[[nodiscard]] inline uint64_t Size() const {
+			return Message ? Message.get_payload().get_size() + Message.get_key().get_size()
+						   : Record.Payload.size() + Record.Key.size();
+		}
+	};
+
+	//
+	// Runs the watchers of one topic. Messages are processed in the order they were consumed
+	// and the last offset processed on each partition is kept for the consumer to commit.
+	// Each queued message carries the epoch of its partition: revoking the partition moves
+	// to the next epoch, so what was queued before is skipped and never committed.
+	//
+	class KafkaTopicWorker : public Poco::Runnable {
+	  public:
+		KafkaTopicWorker(KafkaConsumer &Consumer, const std::string &Topic, std::size_t QueueSize)
+			: Consumer_(Consumer), Topic_(Topic), Queue_(QueueSize) {}
+
+		void Start() {
+			Running_ = true;
+			Thread_.start(*this);
+		}
+
+		//	Processes what is already queued, then stops.
+		void Stop() {
+			Running_ = false;
+			Wake_.set();
+			Thread_.join();
+		}
+
+		//	The message is left untouched when the queue is full.
+		bool Enqueue(KafkaEntry &&Entry) {
+			Entry.Epoch = Epoch(Entry.Partition());
+			if (!Queue_.Push(std::move(Entry)))
+				return false;
+			if (Sleeping_)
+				Wake_.set();
+			return true;
+		}
+
+		//	Drops what was consumed from partitions this consumer no longer owns: the messages
+		//	kept aside or queued, and the offsets processed but not committed yet. Only called
+		//	by the consumer thread.
+		void Revoke(const std::set<int> &Partitions) {
+			if (Partitions.empty())
+				return;
+			{
+				std::lock_guard G(ProcessedMutex_);
+				for (const auto Partition : Partitions) {
+					++Epochs_[Partition];
+					Processed_.erase(Partition);
+				}
+			}
+			Pending_.erase(std::remove_if(Pending_.begin(), Pending_.end(),
+										  [&](const KafkaEntry &E) {
+											  return Partitions.count(E.Partition()) > 0;
+										  }),
+						   Pending_.end());
+			PendingCount_ = Pending_.size();
+		}
+
+		//	Waits for the dispatches already started to finish, so that a watcher just removed
+		//	from the table is no longer running. A watcher removing itself does not wait.
+		void WaitForDispatches() {
+			if (Poco::Thread::current() == &Thread_)
+				return;
+			const uint64_t Target = Started_;
+			std::unique_lock L(DispatchMutex_);
+			++Waiters_;
+			Dispatched_.wait(L, [&] { return Finished_ >= Target; });
+			--Waiters_;
+		}
+
+		//	Keeps a message that did not fit aside, until the topic is resumed.
+		void SetAside(KafkaEntry &&Entry) {
+			Pending_.push_back(std::move(Entry));
+			PendingCount_ = Pending_.size();
+		}
+
+		//	Moves the messages kept aside while the topic was paused into the queue.
+		void FlushPending() {
+			while (!Pending_.empty() && Enqueue(std::move(Pending_.front())))
+				Pending_.pop_front();
+			PendingCount_ = Pending_.size();
+		}
+
+		//	Adds the next offset to commit for every partition processed since the last call.
+		//	Partitions not in Assigned are left out.
+		void TakeProcessed(const std::set<int> &Assigned, cppkafka::TopicPartitionList &Offsets) {
+			std::lock_guard G(ProcessedMutex_);
+			for (const auto &[Partition, Offset] : Processed_)
+				if (Assigned.count(Partition) > 0)
+					Offsets.emplace_back(Topic_, Partition, Offset + 1);
+			Processed_.clear();
+		}
+
+		//	Counts a consumed message. Only called by the consumer thread.
+		inline void Received(const KafkaEntry &Entry) {
+			++Messages_;
+			Bytes_ += Entry.Size();
+		}
+
+		void SampleRates(double Seconds) {
+			MessageRate_ = Rate(Messages_, LastMessages_, Seconds);
+			ByteRate_ = Rate(Bytes_, LastBytes_, Seconds);
+		}
+
+		[[nodiscard]] inline const std::string &Topic() const { return Topic_; }
+		[[nodiscard]] inline bool HasPending() const { return PendingCount_ > 0; }
+
+		[[nodiscard]] TopicCounters Counters() const {
+			TopicCounters C;
+			C.Topic = Topic_;
+			C.Messages = Messages_;
+			C.Bytes = Bytes_;
+			C.MessageRate = MessageRate_;
+			C.ByteRate = ByteRate_;
+			C.Processed = ProcessedCount_;
+			C.Queued = Queue_.Size();
+			C.Capacity = Queue_.Capacity();
+			C.Pending = PendingCount_;
+			C.Pauses = Pauses;
+			C.Paused = Paused;
+			C.Throttled = Throttled;
+			for (std::size_t i = 0; i < Latency_.size(); ++i)
+				C.Latency[i] = Latency_[i];
+			C.LatencySum = LatencySum_;
+			return C;
+		}
+
+		void run() override {
+			Utils::SetThreadName("Kafka:Topic");
+			KafkaEntry Message;
+			for (;;) {
+				if (!Queue_.Pop(Message)) {
+					if (!Running_)
+						break;
+					Sleeping_ = true;
+					if (Queue_.Size() == 0)
+						Wake_.tryWait(100);
+					Sleeping_ = false;
+					continue;
+				}
+				Dispatch(Message);
+				//	Release the message buffer before waiting for the next one.
+				Message = KafkaEntry();
+			}
+		}
+
+		//	Set by the consumer thread, read by GetStats.
+		std::atomic_bool Paused = false;
+		std::atomic_bool Throttled = false;
+		std::atomic_uint64_t Pauses = 0;
+
+	  private:
+		KafkaConsumer &Consumer_;
+		std::string Topic_;
+		BoundedQueue<KafkaEntry> Queue_;
+		Poco::Thread Thread_;
+		Poco::Event Wake_;
+		std::atomic_bool Running_ = false;
+		std::atomic_bool Sleeping_ = false;
+		std::mutex ProcessedMutex_;
+		std::map<int, int64_t> Processed_;
+		//	Written by the consumer thread under ProcessedMutex_, which reads it without.
+		std::map<int, uint64_t> Epochs_;
+		std::atomic_uint64_t Started_ = 0;
+		std::atomic_uint64_t Finished_ = 0;
+		std::atomic_uint64_t Waiters_ = 0;
+		std::mutex DispatchMutex_;
+		std::condition_variable Dispatched_;
+		std::deque<KafkaEntry> Pending_;
+		std::atomic_uint64_t PendingCount_ = 0;
+		std::atomic_uint64_t Messages_ = 0;
+		std::atomic_uint64_t Bytes_ = 0;
+		std::atomic_uint64_t MessageRate_ = 0;
+		std::atomic_uint64_t ByteRate_ = 0;
+		uint64_t LastMessages_ = 0;
+		uint64_t LastBytes_ = 0;
+		std::atomic_uint64_t ProcessedCount_ = 0;
+		std::array<std::atomic_uint64_t, LatencyBounds.size() + 1> Latency_{};
+		std::atomic_uint64_t LatencySum_ = 0;
+
+		[[nodiscard]] inline uint64_t Epoch(int Partition) const {
+			auto It = Epochs_.find(Partition);
+			return It == Epochs_.end() ? 0 : It->second;
+		}
+
+		void Dispatch(KafkaEntry &Queued) {
+			const auto Partition = Queued.Partition();
+			{
+				std::lock_guard G(ProcessedMutex_);
+				if (Queued.Epoch != Epoch(Partition))
+					return;
+			}
+			//	Counted before the table is read: see WaitForDispatches.
+			++Started_;
+			const auto Start = std::chrono::steady_clock::now();
+			auto Notifiers = Consumer_.Notifiers();
+			auto It = Notifiers->find(Topic_);
+			if (It != Notifiers->end() && !It->second.empty()) {
+				//	Watchers take strings: copy the key and payload once for all of them.
+				auto &Record = Queued.Record;
+				if (Queued.Message) {
+					Record.Key = std::string(Queued.Message.get_key());
+					Record.Payload = std::string(Queued.Message.get_payload());
+				}
+				for (const auto &[CallbackFunc, _] : It->second) {
+					try {
+						CallbackFunc(Record.Key, Record.Payload);
+					} catch (const Poco::Exception &E) {
+					} catch (...) {
+					}
+				}
+			}
+			const auto Elapsed = static_cast<uint64_t>(
+				std::chrono::duration_cast<std::chrono::microseconds>(
+					std::chrono::steady_clock::now() - Start)
+					.count());
+			std::size_t Bucket = 0;
+			while (Bucket < LatencyBounds.size() && Elapsed > LatencyBounds[Bucket])
+				++Bucket;
+			++Latency_[Bucket];
+			LatencySum_ += Elapsed;
+			++ProcessedCount_;
+
+			if (Queued.Message) {
+				std::lock_guard G(ProcessedMutex_);
+				if (Queued.Epoch == Epoch(Partition))
+					Processed_[Partition] = Queued.Message.get_offset();
+			}
+			++Finished_;
+			if (Waiters_ > 0) {
+				std::lock_guard L(DispatchMutex_);
+				Dispatched_.notify_all();
+			}
+		}
+	};
+
 	void KafkaManager::initialize(Poco::Util::Application &self) {
 		SubSystemServer::initialize(self);
 		KafkaEnabled_ = MicroServiceConfigGetBool("openwifi.kafka.enable", false);
@@ -80,12 +382,30 @@ namespace OpenWifi {
 		cppkafka::Configuration Config(
 			{{"client.id", MicroServiceConfigGetString("openwifi.kafka.client.id", "")},
 			 {"metadata.broker.list",
-			  MicroServiceConfigGetString("openwifi.kafka.brokerlist", "")}});
+			  MicroServiceConfigGetString("openwifi.kafka.brokerlist", "")},
+			 {"queue.buffering.max.ms",
+			  std::to_string(MicroServiceConfigGetInt("openwifi.kafka.queue.buffering.max.ms", 50))},
+			 {"batch.num.messages",
+			  std::to_string(MicroServiceConfigGetInt("openwifi.kafka.batch.num.messages", 1000))},
+			 {"partitioner",
+			  MicroServiceConfigGetString("openwifi.kafka.partitioner", "murmur2_random")},
+			 {"enable.idempotence",
+			  MicroServiceConfigGetBool("openwifi.kafka.producer.idempotence", true) ? "true"
+																						: "false"}});
 
 		AddKafkaSecurity(Config);
 
 		Config.set_log_callback(KafkaLoggerFun);
 		Config.set_error_callback(KafkaErrorFun);
+		Config.set_delivery_report_callback(
+			[this](cppkafka::Producer &Producer, const cppkafka::Message &Message) {
+				Delivered(Producer, Message);
+			});
+
+		BurstSize_ = std::max<uint64_t>(1, MicroServiceConfigGetInt("openwifi.kafka.producer.burst", 500));
+		MaxRetries_ = MicroServiceConfigGetInt("openwifi.kafka.producer.retries", 0);
+		const auto MetricsInterval = std::chrono::seconds(
+			std::max<uint64_t>(1, MicroServiceConfigGetInt("openwifi.kafka.metrics.interval", 10)));
 
 		KafkaManager()->SystemInfoWrapper_ =
 			R"lit({ "system" : { "id" : )lit" + std::to_string(MicroServiceID()) +
@@ -94,30 +414,298 @@ namespace OpenWifi {
 
 		cppkafka::Producer Producer(Config);
 		Running_ = true;
+		auto LastSample = std::chrono::steady_clock::now();
+		uint64_t LastMessages = Produced_, LastBytes = ProducedBytes_;
 
-		Poco::AutoPtr<Poco::Notification> Note(Queue_.waitDequeueNotification());
-		while (Note && Running_) {
-			try {
-				auto Msg = dynamic_cast<KafkaMessage *>(Note.get());
-				if (Msg != nullptr) {
-					auto NewMessage = cppkafka::MessageBuilder(Msg->Topic());
-					NewMessage.key(Msg->Key());
-					NewMessage.partition(0);
-					NewMessage.payload(Msg->Payload());
-					Producer.produce(NewMessage);
-					Producer.flush();
+		//	Drain what is queued in one burst, then serve the delivery reports. The wait is
+		//	bounded so reports keep flowing when nothing is produced.
+		while (Running_ || Queue_.size() > 0) {
+			Poco::AutoPtr<Poco::Notification> Note(
+				Running_ ? Queue_.waitDequeueNotification(100) : Queue_.dequeueNotification());
+			for (uint64_t Burst = 0; Note;) {
+				try {
+					auto Msg = dynamic_cast<KafkaMessage *>(Note.get());
+					if (Msg != nullptr) {
+						//	The partitioner picks the partition from the key: every message of a
+						//	key lands on the same partition, in order. Without a key it is random.
+						auto NewMessage = cppkafka::MessageBuilder(Msg->Topic());
+						if (!Msg->Key().empty())
+							NewMessage.key(Msg->Key());
+						NewMessage.payload(Msg->Payload());
+						Send(Producer, NewMessage);
+					}
+				} catch (const cppkafka::HandleException &E) {
+					poco_warning(Logger_,
+								 fmt::format("Caught a Kafka exception (producer): {}", E.what()));
+				} catch (const Poco::Exception &E) {
+					Logger_.log(E);
+				} catch (...) {
+					poco_error(Logger_, "std::exception");
 				}
+				if (++Burst == BurstSize_)
+					break;
+				Note = Queue_.dequeueNotification();
+			}
+			Producer.poll(std::chrono::milliseconds(0));
+
+			const auto Now = std::chrono::steady_clock::now();
+			if (Now - LastSample >= MetricsInterval) {
+				const auto Seconds = std::chrono::duration<double>(Now - LastSample).count();
+				MessageRate_ = Rate(Produced_, LastMessages, Seconds);
+				ByteRate_ = Rate(ProducedBytes_, LastBytes, Seconds);
+				LastSample = Now;
+			}
+		}
+
+		try {
+			Producer.flush(std::chrono::milliseconds(5000));
+		} catch (const cppkafka::HandleException &E) {
+			poco_warning(Logger_, fmt::format("Undelivered messages on shutdown: {}", E.what()));
+		}
+		poco_information(Logger_, fmt::format("Stopped: {} delivered, {} failed.",
+											  Delivered_.load(), Failed_.load()));
+	}
+
+	void KafkaProducer::Send(cppkafka::Producer &Producer, const cppkafka::MessageBuilder &Message) {
+		//	A full local queue only means the broker is behind: serve the delivery reports
+		//	to make room, for a few seconds at most and not at all when stopping.
+		for (int Attempt = 0;; ++Attempt) {
+			try {
+				Producer.produce(Message);
+				++Produced_;
+				ProducedBytes_ += Message.payload().get_size() + Message.key().get_size();
+				++InFlight_;
+				return;
 			} catch (const cppkafka::HandleException &E) {
-				poco_warning(Logger_,
-							 fmt::format("Caught a Kafka exception (producer): {}", E.what()));
-			} catch (const Poco::Exception &E) {
-				Logger_.log(E);
-			} catch (...) {
-				poco_error(Logger_, "std::exception");
+				if (E.get_error().get_error() != RD_KAFKA_RESP_ERR__QUEUE_FULL || Attempt == 50 ||
+					!Running_) {
+					++Failed_;
+					throw;
+				}
+				++QueueFull_;
+				Producer.poll(std::chrono::milliseconds(100));
 			}
-			Note = Queue_.waitDequeueNotification();
 		}
-		poco_information(Logger_, "Stopped...");
+	}
+
+	void KafkaProducer::Delivered(cppkafka::Producer &Producer, const cppkafka::Message &Message) {
+		--InFlight_;
+		if (!Message.get_error()) {
+			++Delivered_;
+			std::lock_guard G(StatsMutex_);
+			auto &Partitions = Partitions_[Message.get_topic()];
+			const auto Partition = static_cast<std::size_t>(std::max(0, Message.get_partition()));
+			if (Partitions.size() <= Partition)
+				Partitions.resize(Partition + 1, 0);
+			++Partitions[Partition];
+			return;
+		}
+
+		//	librdkafka already retried transient errors: the attempt count rides in user_data.
+		auto Attempt = reinterpret_cast<std::uintptr_t>(Message.get_user_data());
+		if (Attempt < MaxRetries_) {
+			cppkafka::MessageBuilder Retry(Message.get_topic());
+			Retry.partition(Message.get_partition());
+			Retry.key(Message.get_key());
+			Retry.payload(Message.get_payload());
+			Retry.user_data(reinterpret_cast<void *>(Attempt + 1));
+			try {
+				Producer.produce(Retry);
+				++Retried_;
+				++InFlight_;
+				return;
+			} catch (const cppkafka::HandleException &) {
+			}
+		}
+		if (++Failed_ % 100 == 1) {
+			poco_warning(KafkaManager()->Logger(),
+						 fmt::format("Kafka delivery to {} failed: {} ({} failures so far).",
+									 Message.get_topic(), Message.get_error().to_string(),
+									 Failed_.load()));
+		}
+	}
+
+	void KafkaProducer::GetStats(Poco::JSON::Object &Answer) const {
+		Answer.set("queued", Queue_.size());
+		Answer.set("inFlight", InFlight_.load());
+		Answer.set("produced", Produced_.load());
+		Answer.set("producedBytes", ProducedBytes_.load());
+		Answer.set("messagesPerSecond", MessageRate_.load());
+		Answer.set("bytesPerSecond", ByteRate_.load());
+		Answer.set("delivered", Delivered_.load());
+		Answer.set("retried", Retried_.load());
+		Answer.set("failed", Failed_.load());
+		Answer.set("queueFull", QueueFull_.load());
+
+		//	Messages delivered to each partition of each topic.
+		Poco::JSON::Object Topics;
+		std::lock_guard G(StatsMutex_);
+		for (const auto &[Topic, Partitions] : Partitions_) {
+			Poco::JSON::Array Counts;
+			for (const auto Count : Partitions)
+				Counts.add(Count);
+			Topics.set(Topic, Counts);
+		}
+		Answer.set("partitions", Topics);
+	}
+
+	void KafkaProducer::GetMetrics(std::string &Text) const {
+		const std::tuple<const char *, const char *, const char *, uint64_t> Values[]{
+			{"openwifi_kafka_producer_queue_depth", "gauge", "Messages waiting to be produced.",
+			 Queue_.size()},
+			{"openwifi_kafka_producer_in_flight", "gauge", "Messages waiting for a delivery report.",
+			 static_cast<uint64_t>(std::max<int64_t>(0, InFlight_))},
+			{"openwifi_kafka_producer_messages_total", "counter", "Messages produced.", Produced_},
+			{"openwifi_kafka_producer_bytes_total", "counter", "Key and payload bytes produced.",
+			 ProducedBytes_},
+			{"openwifi_kafka_producer_messages_per_second", "gauge", "Messages produced per second.",
+			 MessageRate_},
+			{"openwifi_kafka_producer_bytes_per_second", "gauge", "Bytes produced per second.",
+			 ByteRate_},
+			{"openwifi_kafka_producer_delivered_total", "counter", "Messages delivered.", Delivered_},
+			{"openwifi_kafka_producer_retried_total", "counter", "Deliveries retried.", Retried_},
+			{"openwifi_kafka_producer_failed_total", "counter", "Messages dropped.", Failed_},
+			{"openwifi_kafka_producer_queue_full_total", "counter",
+			 "Times the local librdkafka queue was full.", QueueFull_}};
+		for (const auto &[Name, Type, Help, Value] : Values) {
+			MetricHeader(Text, Name, Type, Help);
+			Text += fmt::format("{} {}\n", Name, Value);
+		}
+	}
+
+	Types::StringVec KafkaConsumer::StartWorkers(std::size_t QueueSize) {
+		Types::StringVec Topics;
+		std::lock_guard G(RegistrationMutex_);
+		for (const auto &Topic : Topics_) {
+			Topics.emplace_back(Topic);
+			auto Worker = std::make_shared<KafkaTopicWorker>(*this, Topic, QueueSize);
+			Worker->Start();
+			std::lock_guard W(WorkersMutex_);
+			Workers_[Topic] = std::move(Worker);
+		}
+		return Topics;
+	}
+
+	void KafkaConsumer::StopWorkers() {
+		for (auto &[Topic, Worker] : Workers_)
+			Worker->Stop();
+	}
+
+	void KafkaConsumer::ClearWorkers() {
+		{
+			std::lock_guard W(WorkersMutex_);
+			Workers_.clear();
+		}
+		std::lock_guard L(LagMutex_);
+		Lag_.clear();
+	}
+
+	//	Hand over what paused topics kept aside. A topic stays paused while something is kept
+	//	aside or while the queues downstream of its watchers are saturated.
+	void KafkaConsumer::Regulate(const KafkaPauseFunction &Pause) {
+		for (auto &[Topic, Worker] : Workers_) {
+			Worker->FlushPending();
+			Worker->Throttled = Saturated(Topic, Worker->Throttled);
+			const bool Hold = Worker->HasPending() || Worker->Throttled;
+			if (Hold == Worker->Paused)
+				continue;
+			Pause(Topic, Hold);
+			if (Hold)
+				++Worker->Pauses;
+			Worker->Paused = Hold;
+		}
+	}
+
+	bool KafkaConsumer::Hand(KafkaEntry &&Entry, const KafkaPauseFunction &Pause) {
+		auto It = Workers_.find(Entry.Topic());
+		if (It == Workers_.end())
+			return false;
+		auto &Worker = *It->second;
+		Worker.Received(Entry);
+		if (!Worker.HasPending() && Worker.Enqueue(std::move(Entry)))
+			return true;
+		Worker.SetAside(std::move(Entry));
+		if (!Worker.Paused) {
+			Pause(Worker.Topic(), true);
+			Worker.Paused = true;
+			++Worker.Pauses;
+		}
+		return true;
+	}
+
+	void KafkaConsumer::Replay(Poco::Logger &Logger, const std::string &FileName, double Speed,
+							   uint64_t BatchSize, std::size_t QueueSize,
+							   std::chrono::seconds MetricsInterval) {
+		Replaying_ = true;
+		ReplayDone_ = false;
+		ReplayTruncated_ = false;
+		Replayed_ = 0;
+		KafkaRecordReader Reader;
+		if (Reader.Open(FileName))
+			poco_information(Logger, fmt::format("Replaying {}.", FileName));
+		else
+			poco_warning(Logger, fmt::format("Cannot replay {}.", FileName));
+
+		StartWorkers(QueueSize);
+		//	A recording is a single stream: while one of its topics is paused, none is read.
+		const KafkaPauseFunction Pause = [](const std::string &, bool) {};
+		auto Paused = [this] {
+			return std::any_of(Workers_.begin(), Workers_.end(),
+							   [](const auto &W) { return W.second->Paused.load(); });
+		};
+
+		Running_ = true;
+		KafkaRecord Record;
+		bool HaveRecord = false;
+		uint64_t First = 0;
+		const auto Start = std::chrono::steady_clock::now();
+		auto LastSample = Start;
+		while (Running_) {
+			Regulate(Pause);
+			for (uint64_t Count = 0; !ReplayDone_ && !Paused() && Count < BatchSize; ++Count) {
+				if (!HaveRecord) {
+					if (!Reader.Next(Record)) {
+						ReplayTruncated_ = Reader.Truncated();
+						ReplayDone_ = true;
+						poco_information(Logger, fmt::format("Replayed {} messages{}.", Replayed_.load(),
+															 Reader.Truncated() ? ", truncated" : ""));
+						break;
+					}
+					if (Replayed_ == 0)
+						First = Record.TimeStamp;
+					HaveRecord = true;
+				}
+				if (Speed > 0.0 && Record.TimeStamp > First) {
+					const auto Due =
+						Start + std::chrono::microseconds(static_cast<int64_t>(
+									static_cast<double>(Record.TimeStamp - First) / Speed));
+					if (Due > std::chrono::steady_clock::now()) {
+						std::this_thread::sleep_until(
+							std::min(Due, std::chrono::steady_clock::now() + std::chrono::milliseconds(100)));
+						break;
+					}
+				}
+				HaveRecord = false;
+				++Replayed_;
+				KafkaEntry Entry;
+				Entry.Record = std::move(Record);
+				Hand(std::move(Entry), Pause);
+			}
+			if (ReplayDone_ || Paused())
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+			const auto Now = std::chrono::steady_clock::now();
+			if (Now - LastSample >= MetricsInterval) {
+				const auto Seconds = std::chrono::duration<double>(Now - LastSample).count();
+				for (auto &[Topic, Worker] : Workers_)
+					Worker->SampleRates(Seconds);
+				LastSample = Now;
+			}
+		}
+
+		StopWorkers();
+		ClearWorkers();
+		poco_information(Logger, "Stopped...");
 	}
 
 	inline void KafkaConsumer::run() {
@@ -128,11 +716,34 @@ namespace OpenWifi {
 
 		poco_information(Logger_, "Starting...");
 
+		const auto AutoCommit = MicroServiceConfigGetBool("openwifi.kafka.auto.commit", false);
+		const auto BatchSize =
+			std::max<uint64_t>(1, MicroServiceConfigGetInt("openwifi.kafka.consumer.batchsize", 100));
+		const auto QueueSize =
+			std::max<uint64_t>(2, MicroServiceConfigGetInt("openwifi.kafka.consumer.queue.size", 4096));
+		const auto CommitInterval = std::chrono::milliseconds(
+			MicroServiceConfigGetInt("openwifi.kafka.consumer.commit.interval", 1000));
+		const auto MetricsInterval = std::chrono::seconds(
+			std::max<uint64_t>(1, MicroServiceConfigGetInt("openwifi.kafka.metrics.interval", 10)));
+		PauseHigh_ =
+			std::min<uint64_t>(100, MicroServiceConfigGetInt("openwifi.kafka.consumer.pause.high", 0));
+		PauseLow_ = std::min<uint64_t>(
+			PauseHigh_, MicroServiceConfigGetInt("openwifi.kafka.consumer.pause.low", PauseHigh_ / 2));
+
+		//	A recording replaces the broker: same workers, same pauses, nothing to commit.
+		const auto ReplayFile = MicroServiceConfigPath("openwifi.kafka.replay.file", "");
+		if (!ReplayFile.empty()) {
+			const auto Speed =
+				static_cast<double>(MicroServiceConfigGetInt("openwifi.kafka.replay.speed", 0));
+			Replay(Logger_, ReplayFile, Speed, BatchSize, QueueSize, MetricsInterval);
+			return;
+		}
+
 		cppkafka::Configuration Config(
 			{{"client.id", MicroServiceConfigGetString("openwifi.kafka.client.id", "")},
 			 {"metadata.broker.list", MicroServiceConfigGetString("openwifi.kafka.brokerlist", "")},
 			 {"group.id", MicroServiceConfigGetString("openwifi.kafka.group.id", "")},
-			 {"enable.auto.commit", MicroServiceConfigGetBool("openwifi.kafka.auto.commit", false)},
+			 {"enable.auto.commit", AutoCommit},
 			 {"auto.offset.reset", "latest"},
 			 {"enable.partition.eof", false}});
 
@@ -146,67 +757,343 @@ namespace OpenWifi {
 		// Now configure it to be the default topic config
 		Config.set_default_topic_configuration(topic_config);
 
+		//	Consumed messages can be recorded, to be replayed without a broker.
+		KafkaRecordWriter Recorder;
+		const auto RecordFile = MicroServiceConfigPath("openwifi.kafka.record.file", "");
+		const auto RecordLimit =
+			MicroServiceConfigGetInt("openwifi.kafka.record.max.mb", 1024) * 1024 * 1024;
+		if (!RecordFile.empty()) {
+			if (Recorder.Open(RecordFile))
+				poco_information(Logger_, fmt::format("Recording consumed messages to {}.", RecordFile));
+			else
+				poco_warning(Logger_, fmt::format("Cannot record to {}.", RecordFile));
+		}
+		auto Record = [&](const cppkafka::Message &Msg) {
+			const auto Now = std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::system_clock::now().time_since_epoch());
+			if (!Recorder.Write(Now.count(), Msg.get_topic(), std::string(Msg.get_key()),
+								std::string(Msg.get_payload())) ||
+				Recorder.Bytes() >= RecordLimit) {
+				poco_information(Logger_, fmt::format("Recording stopped: {} messages, {} bytes.",
+													  Recorder.Records(), Recorder.Bytes()));
+				Recorder.Close();
+			}
+		};
+
 		cppkafka::Consumer Consumer(Config);
+
+		//	Partitions of each topic in a list.
+		auto ByTopic = [](const cppkafka::TopicPartitionList &Partitions) {
+			std::map<std::string, std::set<int>> Topics;
+			for (const auto &P : Partitions)
+				Topics[P.get_topic()].insert(P.get_partition());
+			return Topics;
+		};
+
+		//	Only offsets of partitions still assigned are committed: a revoked partition may
+		//	already be consumed elsewhere.
+		auto CommitProcessed = [&](bool Wait) {
+			if (AutoCommit)
+				return;
+			auto Assigned = ByTopic(Consumer.get_assignment());
+			cppkafka::TopicPartitionList Offsets;
+			for (const auto &[Topic, Worker] : Workers_)
+				Worker->TakeProcessed(Assigned[Topic], Offsets);
+			if (Offsets.empty())
+				return;
+			try {
+				if (Wait)
+					Consumer.commit(Offsets);
+				else
+					Consumer.async_commit(Offsets);
+			} catch (const cppkafka::HandleException &E) {
+				poco_warning(Logger_, fmt::format("Cannot commit offsets: {}", E.what()));
+			}
+		};
+		auto TopicPartitions = [&Consumer](const std::string &Topic) {
+			cppkafka::TopicPartitionList Partitions;
+			for (const auto &P : Consumer.get_assignment())
+				if (P.get_topic() == Topic)
+					Partitions.push_back(P);
+			return Partitions;
+		};
+
 		Consumer.set_assignment_callback([&](cppkafka::TopicPartitionList &partitions) {
+			//	A new assignment starts unpaused. Messages still kept aside belong to partitions
+			//	assigned again (the others were dropped on revocation), and keep the topic paused:
+			//	it is paused again before anything else is queued.
+			for (auto &[Topic, Worker] : Workers_)
+				Worker->Paused = false;
 			if (!partitions.empty()) {
 				poco_information(Logger_, fmt::format("Partition assigned: {}...",
 													  partitions.front().get_partition()));
 			}
 		});
 		Consumer.set_revocation_callback([&](const cppkafka::TopicPartitionList &partitions) {
+			//	The partitions are still ours until this returns: commit what was processed, then
+			//	drop what was consumed from them but not processed yet.
+			CommitProcessed(true);
+			auto Revoked = ByTopic(partitions);
+			for (auto &[Topic, Worker] : Workers_)
+				Worker->Revoke(Revoked[Topic]);
 			if (!partitions.empty()) {
 				poco_information(Logger_, fmt::format("Partition revocation: {}...",
 													  partitions.front().get_partition()));
 			}
 		});
 
-		// bool AutoCommit = MicroServiceConfigGetBool("openwifi.kafka.auto.commit", false);
-		// auto BatchSize = MicroServiceConfigGetInt("openwifi.kafka.consumer.batchsize", 100);
+		const KafkaPauseFunction Pause = [&](const std::string &Topic, bool Hold) {
+			if (Hold)
+				Consumer.pause_partitions(TopicPartitions(Topic));
+			else
+				Consumer.resume_partitions(TopicPartitions(Topic));
+		};
 
-		Types::StringVec Topics;
-		std::for_each(Topics_.begin(),Topics_.end(),
-					  [&](const std::string & T) { Topics.emplace_back(T); });
-		Consumer.subscribe(Topics);
+		Consumer.subscribe(StartWorkers(QueueSize));
 
 		Running_ = true;
-		std::vector<cppkafka::Message> MsgVec;
-
-		Dispatcher_ = std::make_unique<cppkafka::ConsumerDispatcher>(Consumer);
-
-		Dispatcher_->run(
-			// Callback executed whenever a new message is consumed
-			[&](cppkafka::Message msg) {
-				// Print the key (if any)
-				std::lock_guard G(ConsumerMutex_);
-				auto It = Notifiers_.find(msg.get_topic());
-				if (It != Notifiers_.end()) {
-					const auto &FL = It->second;
-					for (const auto &[CallbackFunc, _] : FL) {
-						try {
-							CallbackFunc(msg.get_key(), msg.get_payload());
-						} catch(const Poco::Exception &E) {
-
-						} catch(...) {
-
-						}
-					}
+		auto NextCommit = std::chrono::steady_clock::now() + CommitInterval;
+		auto LastSample = std::chrono::steady_clock::now();
+		while (Running_) {
+			Regulate(Pause);
+
+			auto Messages = Consumer.poll_batch(BatchSize, std::chrono::milliseconds(100));
+			for (auto &Msg : Messages) {
+				if (Msg.get_error()) {
+					if (!Msg.is_eof())
+						poco_warning(Logger_, fmt::format("Error: {}", Msg.get_error().to_string()));
+					continue;
 				}
-				Consumer.commit(msg);
-			},
-			// Whenever there's an error (other than the EOF soft error)
-			[&Logger_](cppkafka::Error error) {
-				poco_warning(Logger_,fmt::format("Error: {}", error.to_string()));
-			},
-			// Whenever EOF is reached on a partition, print this
-			[&Logger_](cppkafka::ConsumerDispatcher::EndOfFile, const cppkafka::TopicPartition& topic_partition) {
-				poco_debug(Logger_,fmt::format("Partition {} EOF", topic_partition.get_partition()));
+				if (Recorder.IsOpen())
+					Record(Msg);
+				KafkaEntry Entry;
+				Entry.Message = std::move(Msg);
+				Hand(std::move(Entry), Pause);
+			}
+
+			const auto Now = std::chrono::steady_clock::now();
+			if (Now >= NextCommit) {
+				CommitProcessed(false);
+				NextCommit = Now + CommitInterval;
 			}
-		);
+			if (Now - LastSample >= MetricsInterval) {
+				const auto Seconds = std::chrono::duration<double>(Now - LastSample).count();
+				for (auto &[Topic, Worker] : Workers_)
+					Worker->SampleRates(Seconds);
+				UpdateLag(Consumer);
+				LastSample = Now;
+			}
+		}
 
+		//	Messages still set aside are not committed: they are consumed again next time.
+		StopWorkers();
+		CommitProcessed(true);
+		ClearWorkers();
 		Consumer.unsubscribe();
 		poco_information(Logger_, "Stopped...");
 	}
 
+	void KafkaConsumer::UpdateLag(cppkafka::Consumer &Consumer) {
+		//	The high watermarks come from the statistics librdkafka keeps: no broker round trip.
+		std::vector<PartitionLag> Lag;
+		try {
+			for (const auto &P : Consumer.get_offsets_position(Consumer.get_assignment())) {
+				PartitionLag L;
+				L.Topic = P.get_topic();
+				L.Partition = P.get_partition();
+				L.Position = P.get_offset();
+				L.HighWatermark = std::get<1>(Consumer.get_offsets(P));
+				if (L.Position >= 0 && L.HighWatermark >= 0)
+					L.Lag = std::max<int64_t>(0, L.HighWatermark - L.Position);
+				Lag.push_back(std::move(L));
+			}
+		} catch (const cppkafka::HandleException &E) {
+			poco_debug(KafkaManager()->Logger(), fmt::format("Cannot compute lag: {}", E.what()));
+			return;
+		}
+		std::lock_guard G(LagMutex_);
+		Lag_ = std::move(Lag);
+	}
+
+	bool KafkaConsumer::Saturated(const std::string &Topic, bool Throttled) const {
+		if (PauseHigh_ == 0)
+			return false;
+		std::lock_guard G(GaugeMutex_);
+		auto It = Gauges_.find(Topic);
+		if (It == Gauges_.end())
+			return false;
+		uint64_t Fill = 0;
+		for (const auto &[Name, Gauge] : It->second) {
+			const auto Q = Gauge();
+			if (Q.Capacity > 0)
+				Fill = std::max(Fill, 100 * Q.Depth / Q.Capacity);
+		}
+		//	Hysteresis: once paused, wait for the queues to drain down to the low mark.
+		return Throttled ? Fill > PauseLow_ : Fill >= PauseHigh_;
+	}
+
+	void KafkaConsumer::GetStats(Poco::JSON::Object &Answer) const {
+		std::vector<TopicCounters> Topics;
+		{
+			std::lock_guard W(WorkersMutex_);
+			for (const auto &[Topic, Worker] : Workers_)
+				Topics.push_back(Worker->Counters());
+		}
+		std::vector<PartitionLag> Lag;
+		{
+			std::lock_guard L(LagMutex_);
+			Lag = Lag_;
+		}
+
+		Poco::JSON::Object TopicsObj;
+		for (const auto &T : Topics) {
+			Poco::JSON::Object O;
+			O.set("messages", T.Messages);
+			O.set("bytes", T.Bytes);
+			O.set("messagesPerSecond", T.MessageRate);
+			O.set("bytesPerSecond", T.ByteRate);
+			O.set("processed", T.Processed);
+			O.set("queued", T.Queued);
+			O.set("capacity", T.Capacity);
+			O.set("pending", T.Pending);
+			O.set("paused", T.Paused);
+			O.set("throttled", T.Throttled);
+			O.set("pauses", T.Pauses);
+			Poco::JSON::Object Latency;
+			for (std::size_t i = 0; i < T.Latency.size(); ++i)
+				Latency.set(LatencyNames[i], T.Latency[i]);
+			Latency.set("totalUs", T.LatencySum);
+			O.set("callbackLatency", Latency);
+
+			Poco::JSON::Array Partitions;
+			int64_t TopicLag = 0;
+			for (const auto &L : Lag) {
+				if (L.Topic != T.Topic)
+					continue;
+				Poco::JSON::Object P;
+				P.set("partition", L.Partition);
+				P.set("position", L.Position);
+				P.set("highWatermark", L.HighWatermark);
+				P.set("lag", L.Lag);
+				Partitions.add(P);
+				TopicLag += std::max<int64_t>(0, L.Lag);
+			}
+			O.set("lag", TopicLag);
+			O.set("partitions", Partitions);
+			TopicsObj.set(T.Topic, O);
+		}
+		Answer.set("topics", TopicsObj);
+
+		Poco::JSON::Array Queues;
+		std::lock_guard G(GaugeMutex_);
+		for (const auto &[Topic, Gauges] : Gauges_) {
+			for (const auto &[Name, Gauge] : Gauges) {
+				const auto Q = Gauge();
+				Poco::JSON::Object O;
+				O.set("topic", Topic);
+				O.set("name", Name);
+				O.set("depth", Q.Depth);
+				O.set("capacity", Q.Capacity);
+				O.set("dropped", Q.Dropped);
+				Queues.add(O);
+			}
+		}
+		Answer.set("queues", Queues);
+		Answer.set("pauseHigh", PauseHigh_);
+		Answer.set("pauseLow", PauseLow_);
+		if (Replaying_) {
+			Poco::JSON::Object Replay;
+			Replay.set("messages", Replayed_.load());
+			Replay.set("done", ReplayDone_.load());
+			Replay.set("truncated", ReplayTruncated_.load());
+			Answer.set("replay", Replay);
+		}
+	}
+
+	void KafkaConsumer::GetMetrics(std::string &Text) const {
+		std::vector<TopicCounters> Topics;
+		{
+			std::lock_guard W(WorkersMutex_);
+			for (const auto &[Topic, Worker] : Workers_)
+				Topics.push_back(Worker->Counters());
+		}
+
+		auto PerTopic = [&](const char *Name, const char *Type, const char *Help, auto Value) {
+			MetricHeader(Text, Name, Type, Help);
+			for (const auto &T : Topics)
+				Text += fmt::format("{}{{topic=\"{}\"}} {}\n", Name, T.Topic, Value(T));
+		};
+		PerTopic("openwifi_kafka_consumer_messages_total", "counter", "Messages consumed.",
+				 [](const TopicCounters &T) { return T.Messages; });
+		PerTopic("openwifi_kafka_consumer_bytes_total", "counter", "Key and payload bytes consumed.",
+				 [](const TopicCounters &T) { return T.Bytes; });
+		PerTopic("openwifi_kafka_consumer_messages_per_second", "gauge",
+				 "Messages consumed per second.", [](const TopicCounters &T) { return T.MessageRate; });
+		PerTopic("openwifi_kafka_consumer_bytes_per_second", "gauge", "Bytes consumed per second.",
+				 [](const TopicCounters &T) { return T.ByteRate; });
+		PerTopic("openwifi_kafka_consumer_processed_total", "counter",
+				 "Messages handed to the watchers.", [](const TopicCounters &T) { return T.Processed; });
+		PerTopic("openwifi_kafka_consumer_queue_depth", "gauge",
+				 "Messages waiting for the topic worker.", [](const TopicCounters &T) { return T.Queued; });
+		PerTopic("openwifi_kafka_consumer_queue_capacity", "gauge", "Size of the topic worker queue.",
+				 [](const TopicCounters &T) { return T.Capacity; });
+		PerTopic("openwifi_kafka_consumer_pending", "gauge",
+				 "Messages kept aside while the topic is paused.",
+				 [](const TopicCounters &T) { return T.Pending; });
+		PerTopic("openwifi_kafka_consumer_paused", "gauge", "1 while the topic is paused.",
+				 [](const TopicCounters &T) { return T.Paused ? 1 : 0; });
+		PerTopic("openwifi_kafka_consumer_pauses_total", "counter", "Times the topic was paused.",
+				 [](const TopicCounters &T) { return T.Pauses; });
+
+		MetricHeader(Text, "openwifi_kafka_consumer_callback_seconds", "histogram",
+					 "Time spent in the watchers of a message.");
+		for (const auto &T : Topics) {
+			uint64_t Count = 0;
+			for (std::size_t i = 0; i < LatencyBounds.size(); ++i) {
+				Count += T.Latency[i];
+				Text += fmt::format(
+					"openwifi_kafka_consumer_callback_seconds_bucket{{topic=\"{}\",le=\"{}\"}} {}\n",
+					T.Topic, static_cast<double>(LatencyBounds[i]) / 1e6, Count);
+			}
+			Count += T.Latency.back();
+			Text += fmt::format(
+				"openwifi_kafka_consumer_callback_seconds_bucket{{topic=\"{0}\",le=\"+Inf\"}} {1}\n"
+				"openwifi_kafka_consumer_callback_seconds_sum{{topic=\"{0}\"}} {2}\n"
+				"openwifi_kafka_consumer_callback_seconds_count{{topic=\"{0}\"}} {1}\n",
+				T.Topic, Count, static_cast<double>(T.LatencySum) / 1e6);
+		}
+
+		{
+			MetricHeader(Text, "openwifi_kafka_consumer_lag", "gauge",
+						 "Messages between the high watermark and the consumer position.");
+			std::lock_guard L(LagMutex_);
+			for (const auto &P : Lag_)
+				if (P.Lag >= 0)
+					Text += fmt::format(
+						"openwifi_kafka_consumer_lag{{topic=\"{}\",partition=\"{}\"}} {}\n",
+						P.Topic, P.Partition, P.Lag);
+		}
+
+		std::lock_guard G(GaugeMutex_);
+		std::vector<std::tuple<std::string, std::string, KafkaQueueGauge>> Queues;
+		for (const auto &[Topic, Gauges] : Gauges_)
+			for (const auto &[Name, Gauge] : Gauges)
+				Queues.emplace_back(Topic, Name, Gauge());
+		auto PerQueue = [&](const char *Name, const char *Type, const char *Help, auto Value) {
+			MetricHeader(Text, Name, Type, Help);
+			for (const auto &[Topic, Queue, Q] : Queues)
+				Text += fmt::format("{}{{topic=\"{}\",queue=\"{}\"}} {}\n", Name, Topic, Queue,
+									Value(Q));
+		};
+		PerQueue("openwifi_kafka_queue_depth", "gauge", "Messages waiting downstream of a topic.",
+				 [](const KafkaQueueGauge &Q) { return Q.Depth; });
+		PerQueue("openwifi_kafka_queue_capacity", "gauge", "Capacity of a queue downstream of a topic.",
+				 [](const KafkaQueueGauge &Q) { return Q.Capacity; });
+		PerQueue("openwifi_kafka_queue_dropped_total", "counter",
+				 "Messages dropped by a queue downstream of a topic.",
+				 [](const KafkaQueueGauge &Q) { return Q.Dropped; });
+	}
+
 	void KafkaProducer::Start() {
 		if (!Running_) {
 			Running_ = true;
@@ -237,39 +1124,48 @@ namespace OpenWifi {
 	void KafkaConsumer::Stop() {
 		if (Running_) {
 			Running_ = false;
-			if(Dispatcher_) {
-				Dispatcher_->stop();
-			}
 			Worker_.join();
 		}
 	}
 
 	std::uint64_t KafkaConsumer::RegisterTopicWatcher(const std::string &Topic,
 											   Types::TopicNotifyFunction &F) {
-		std::lock_guard G(ConsumerMutex_);
-		auto It = Notifiers_.find(Topic);
-		if (It == Notifiers_.end()) {
-			Types::TopicNotifyFunctionList L;
-			L.emplace(L.end(), std::make_pair(F, FunctionId_));
-			Notifiers_[Topic] = std::move(L);
-		} else {
-			It->second.emplace(It->second.end(), std::make_pair(F, FunctionId_));
-		}
+		std::lock_guard G(RegistrationMutex_);
+		auto Notifiers = std::make_shared<Types::NotifyTable>(*Notifiers_);
+		(*Notifiers)[Topic].emplace_back(F, FunctionId_);
+		std::atomic_store(&Notifiers_, std::shared_ptr<const Types::NotifyTable>(std::move(Notifiers)));
 		Topics_.insert(Topic);
 		return FunctionId_++;
 	}
 
 	void KafkaConsumer::UnregisterTopicWatcher(const std::string &Topic, int Id) {
-		std::lock_guard G(ConsumerMutex_);
-		auto It = Notifiers_.find(Topic);
-		if (It != Notifiers_.end()) {
-			Types::TopicNotifyFunctionList &L = It->second;
-			for (auto it = L.begin(); it != L.end(); it++)
-				if (it->second == Id) {
-					L.erase(it);
-					break;
-				}
+		{
+			std::lock_guard G(RegistrationMutex_);
+			auto Notifiers = std::make_shared<Types::NotifyTable>(*Notifiers_);
+			auto It = Notifiers->find(Topic);
+			if (It != Notifiers->end()) {
+				Types::TopicNotifyFunctionList &L = It->second;
+				for (auto it = L.begin(); it != L.end(); it++)
+					if (it->second == Id) {
+						L.erase(it);
+						break;
+					}
+			}
+			std::atomic_store(&Notifiers_,
+							  std::shared_ptr<const Types::NotifyTable>(std::move(Notifiers)));
 		}
+
+		//	A dispatch may have read the previous table: wait for it, so that the watcher's owner
+		//	can be torn down once this returns.
+		std::shared_ptr<KafkaTopicWorker> Worker;
+		{
+			std::lock_guard W(WorkersMutex_);
+			auto It = Workers_.find(Topic);
+			if (It != Workers_.end())
+				Worker = It->second;
+		}
+		if (Worker)
+			Worker->WaitForDispatches();
 	}
 
 	int KafkaManager::Start() {
@@ -311,6 +1207,25 @@ namespace OpenWifi {
 						   MicroServiceID(), MicroServicePrivateEndPoint(), PayLoad ) ;
 	}
 
+	void KafkaManager::GetStats(Poco::JSON::Object &Answer) const {
+		Answer.set("enabled", KafkaEnabled_);
+		Poco::JSON::Object Producer;
+		ProducerThr_.GetStats(Producer);
+		Answer.set("producer", Producer);
+		Poco::JSON::Object Consumer;
+		ConsumerThr_.GetStats(Consumer);
+		Answer.set("consumer", Consumer);
+	}
+
+	void KafkaManager::GetMetrics(std::string &Text) const {
+		MetricHeader(Text, "openwifi_kafka_enabled", "gauge", "1 when Kafka is enabled.");
+		Text += fmt::format("openwifi_kafka_enabled {}\n", KafkaEnabled_ ? 1 : 0);
+		if (!KafkaEnabled_)
+			return;
+		ProducerThr_.GetMetrics(Text);
+		ConsumerThr_.GetMetrics(Text);
+	}
+
 	void KafkaManager::PartitionAssignment(const cppkafka::TopicPartitionList &partitions) {
 		poco_information(
 			Logger(), fmt::format("Partition assigned: {}...", partitions.front().get_partition()));
@@ -31,38 +31,145 @@ namespace OpenWifi {
 		std::string Payload_;
 	};
 
+	//
+	// Messages are produced without waiting for the broker: the queue is drained in bursts
+	// and librdkafka batches them (queue.buffering.max.ms, batch.num.messages). Delivery
+	// reports come back through a callback, which keeps the counters reported by GetStats and,
+	// only when producer.retries is set, produces failed messages again. Partitions are chosen by the configured
+	// partitioner from the message key, so the messages of a key stay in order.
+	//
 	class KafkaProducer : public Poco::Runnable {
 	  public:
 		void run() override;
 		void Start();
 		void Stop();
 		void Produce(const char *Topic, const std::string &Key, const std::string & Payload);
+		void GetStats(Poco::JSON::Object &Answer) const;
+		void GetMetrics(std::string &Text) const;
 
 	  private:
 		std::mutex Mutex_;
 		Poco::Thread Worker_;
 		mutable std::atomic_bool Running_ = false;
 		Poco::NotificationQueue Queue_;
+		uint64_t BurstSize_ = 500;
+		uint64_t MaxRetries_ = 0;
+		std::atomic_uint64_t Produced_ = 0;
+		std::atomic_uint64_t ProducedBytes_ = 0;
+		std::atomic_uint64_t MessageRate_ = 0;
+		std::atomic_uint64_t ByteRate_ = 0;
+		std::atomic_uint64_t Delivered_ = 0;
+		std::atomic_uint64_t Retried_ = 0;
+		std::atomic_uint64_t Failed_ = 0;
+		std::atomic_uint64_t QueueFull_ = 0;
+		std::atomic_int64_t InFlight_ = 0;
+		mutable std::mutex StatsMutex_;
+		std::map<std::string, std::vector<uint64_t>> Partitions_;
+
+		void Send(cppkafka::Producer &Producer, const cppkafka::MessageBuilder &Message);
+		void Delivered(cppkafka::Producer &Producer, const cppkafka::Message &Message);
 	};
 
+	//
+	// Fill of a queue fed by a topic, reported by the service that drains it. With
+	// openwifi.kafka.consumer.pause.high set, the topic is paused while one of its queues is
+	// that full (in percent) and resumed once they are all down to pause.low.
+	//
+	struct KafkaQueueGauge {
+		uint64_t Depth = 0;
+		uint64_t Capacity = 0;
+		uint64_t Dropped = 0;
+	};
+	typedef std::function<KafkaQueueGauge()> KafkaQueueGaugeFunction;
+
+	class KafkaTopicWorker;
+	struct KafkaEntry;
+
+	//	Pauses (true) or resumes the partitions of a topic.
+	typedef std::function<void(const std::string &Topic, bool Pause)> KafkaPauseFunction;
+
+	//
+	// Polls the subscribed topics and hands each message to the worker of its topic, which
+	// runs the watchers on its own thread. Watchers are looked up in an immutable table that
+	// registration replaces, so dispatch never waits for a lock. A topic whose worker is full
+	// is paused until it catches up; the other topics keep flowing. Offsets are committed
+	// asynchronously, in batches, once the watchers have processed the messages. Partition lag
+	// and message rates are sampled every openwifi.kafka.metrics.interval seconds. With
+	// openwifi.kafka.replay.file set, the messages come from a recording instead of a broker,
+	// through the same workers and pauses.
+	//
 	class KafkaConsumer : public Poco::Runnable {
 	  public:
 		void Start();
 		void Stop();
+		void GetStats(Poco::JSON::Object &Answer) const;
+		void GetMetrics(std::string &Text) const;
+
+		//	The gauge is called from the consumer thread: it must be cheap and must not block.
+		inline void RegisterQueueGauge(const std::string &Topic, const std::string &Name,
+									   KafkaQueueGaugeFunction F) {
+			std::lock_guard G(GaugeMutex_);
+			Gauges_[Topic][Name] = std::move(F);
+		}
+		//	Once this returns, the gauge is no longer called.
+		inline void UnregisterQueueGauge(const std::string &Topic, const std::string &Name) {
+			std::lock_guard G(GaugeMutex_);
+			auto It = Gauges_.find(Topic);
+			if (It == Gauges_.end())
+				return;
+			It->second.erase(Name);
+			if (It->second.empty())
+				Gauges_.erase(It);
+		}
 
 	  private:
-		std::mutex 				ConsumerMutex_;
-		Types::NotifyTable 		Notifiers_;
+		struct PartitionLag {
+			std::string Topic;
+			int Partition = 0;
+			int64_t Position = -1;
+			int64_t HighWatermark = -1;
+			int64_t Lag = -1;
+		};
+
+		std::mutex 				RegistrationMutex_;
+		std::shared_ptr<const Types::NotifyTable> Notifiers_ =
+			std::make_shared<const Types::NotifyTable>();
 		Poco::Thread 			Worker_;
 		mutable std::atomic_bool Running_ = false;
 		uint64_t 				FunctionId_ = 1;
-		std::unique_ptr<cppkafka::ConsumerDispatcher> 	Dispatcher_;
 		std::set<std::string>	Topics_;
+		mutable std::mutex		WorkersMutex_;
+		std::map<std::string, std::shared_ptr<KafkaTopicWorker>> Workers_;
+		mutable std::mutex		GaugeMutex_;
+		std::map<std::string, std::map<std::string, KafkaQueueGaugeFunction>> Gauges_;
+		uint64_t				PauseHigh_ = 0;
+		uint64_t				PauseLow_ = 0;
+		mutable std::mutex		LagMutex_;
+		std::vector<PartitionLag> Lag_;
+		std::atomic_bool		Replaying_ = false;
+		std::atomic_bool		ReplayDone_ = false;
+		std::atomic_bool		ReplayTruncated_ = false;
+		std::atomic_uint64_t	Replayed_ = 0;
 
 		void run() override;
+		void Replay(Poco::Logger &Logger, const std::string &FileName, double Speed,
+					uint64_t BatchSize, std::size_t QueueSize, std::chrono::seconds MetricsInterval);
+		//	Starts a worker per registered topic, and returns the topics.
+		Types::StringVec StartWorkers(std::size_t QueueSize);
+		void StopWorkers();
+		void ClearWorkers();
+		void Regulate(const KafkaPauseFunction &Pause);
+		//	False when no worker takes the topic.
+		bool Hand(KafkaEntry &&Entry, const KafkaPauseFunction &Pause);
+		void UpdateLag(cppkafka::Consumer &Consumer);
+		bool Saturated(const std::string &Topic, bool Throttled) const;
 		friend class KafkaManager;
+		friend class KafkaTopicWorker;
 		std::uint64_t RegisterTopicWatcher(const std::string &Topic, Types::TopicNotifyFunction &F);
 		void UnregisterTopicWatcher(const std::string &Topic, int Id);
+		[[nodiscard]] inline std::shared_ptr<const Types::NotifyTable> Notifiers() const {
+			return std::atomic_load(&Notifiers_);
+		}
 	};
 
 	class KafkaManager : public SubSystemServer {
@@ -86,13 +193,24 @@ namespace OpenWifi {
 						 const Poco::JSON::Object &Object, bool WrapMessage = true);
 
 		[[nodiscard]] std::string WrapSystemId(const std::string & PayLoad);
+		void GetStats(Poco::JSON::Object &Answer) const;
+		//	Prometheus text exposition format.
+		void GetMetrics(std::string &Text) const;
 		[[nodiscard]] inline bool Enabled() const { return KafkaEnabled_; }
 		inline std::uint64_t RegisterTopicWatcher(const std::string &Topic, Types::TopicNotifyFunction &F) {
 			return ConsumerThr_.RegisterTopicWatcher(Topic,F);
 		}
+		//	Once this returns, the watcher is no longer called, unless it is the caller.
 		inline void UnregisterTopicWatcher(const std::string &Topic, uint64_t Id) {
 			return ConsumerThr_.UnregisterTopicWatcher(Topic,Id);
 		}
+		inline void RegisterQueueGauge(const std::string &Topic, const std::string &Name,
+									   KafkaQueueGaugeFunction F) {
+			ConsumerThr_.RegisterQueueGauge(Topic, Name, std::move(F));
+		}
+		inline void UnregisterQueueGauge(const std::string &Topic, const std::string &Name) {
+			ConsumerThr_.UnregisterQueueGauge(Topic, Name);
+		}
 
 	  private:
 		bool KafkaEnabled_ = false;
@@ -0,0 +1,181 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#include "KafkaRecording.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+namespace OpenWifi {
+
+	namespace {
+		constexpr char RECORDING_MAGIC[8] = {'O', 'W', 'K', 'R', 'E', 'C', '0', '1'};
+
+		//	Strings longer than this are taken for a corrupt file.
+		constexpr uint64_t MAX_STRING = 64 * 1024 * 1024;
+
+		inline void AppendNumber(std::string &Buffer, uint64_t Value) {
+			while (Value >= 0x80) {
+				Buffer.push_back(static_cast<char>((Value & 0x7f) | 0x80));
+				Value >>= 7;
+			}
+			Buffer.push_back(static_cast<char>(Value));
+		}
+
+		inline void AppendString(std::string &Buffer, const std::string &Value) {
+			AppendNumber(Buffer, Value.size());
+			Buffer += Value;
+		}
+
+		//	Time deltas are signed: zigzag keeps the small negative ones short.
+		inline uint64_t ZigZag(int64_t Value) {
+			return (static_cast<uint64_t>(Value) << 1) ^ static_cast<uint64_t>(Value >> 63);
+		}
+		inline int64_t UnZigZag(uint64_t Value) {
+			return static_cast<int64_t>(Value >> 1) ^ -static_cast<int64_t>(Value & 1);
+		}
+	} // namespace
+
+	bool KafkaRecordWriter::Open(const std::string &FileName) {
+		Close();
+		File_.open(FileName, std::ios::binary | std::ios::trunc);
+		if (!File_.is_open())
+			return false;
+		File_.write(RECORDING_MAGIC, sizeof(RECORDING_MAGIC));
+		Last_ = 0;
+		Records_ = 0;
+		Bytes_ = sizeof(RECORDING_MAGIC);
+		return File_.good();
+	}
+
+	void KafkaRecordWriter::Close() {
+		if (File_.is_open())
+			File_.close();
+	}
+
+	bool KafkaRecordWriter::Write(const KafkaRecord &Record) {
+		return Write(Record.TimeStamp, Record.Topic, Record.Key, Record.Payload);
+	}
+
+	bool KafkaRecordWriter::Write(uint64_t TimeStamp, const std::string &Topic,
+								  const std::string &Key, const std::string &Payload) {
+		if (!File_.is_open())
+			return false;
+		Buffer_.clear();
+		AppendNumber(Buffer_, ZigZag(static_cast<int64_t>(TimeStamp - Last_)));
+		AppendString(Buffer_, Topic);
+		AppendString(Buffer_, Key);
+		AppendNumber(Buffer_, Payload.size());
+		File_.write(Buffer_.data(), static_cast<std::streamsize>(Buffer_.size()));
+		File_.write(Payload.data(), static_cast<std::streamsize>(Payload.size()));
+		if (!File_.good())
+			return false;
+		Last_ = TimeStamp;
+		++Records_;
+		Bytes_ += Buffer_.size() + Payload.size();
+		return true;
+	}
+
+	bool KafkaRecordReader::Open(const std::string &FileName) {
+		File_.close();
+		File_.clear();
+		File_.open(FileName, std::ios::binary);
+		Last_ = 0;
+		Truncated_ = false;
+		char Magic[sizeof(RECORDING_MAGIC)];
+		return File_.read(Magic, sizeof(Magic)) &&
+			   std::memcmp(Magic, RECORDING_MAGIC, sizeof(Magic)) == 0;
+	}
+
+	bool KafkaRecordReader::ReadNumber(uint64_t &Value) {
+		Value = 0;
+		for (int Shift = 0; Shift < 64; Shift += 7) {
+			const auto C = File_.get();
+			if (C == std::char_traits<char>::eof())
+				return false;
+			Value |= static_cast<uint64_t>(C & 0x7f) << Shift;
+			if ((C & 0x80) == 0)
+				return true;
+		}
+		return false;
+	}
+
+	bool KafkaRecordReader::ReadString(std::string &Value) {
+		uint64_t Size = 0;
+		if (!ReadNumber(Size) || Size > MAX_STRING)
+			return false;
+		Value.resize(Size);
+		return Size == 0 || File_.read(Value.data(), static_cast<std::streamsize>(Size));
+	}
+
+	bool KafkaRecordReader::Next(KafkaRecord &Record) {
+		if (!File_.is_open() || Truncated_)
+			return false;
+		//	A clean end of file falls exactly between two records.
+		if (File_.peek() == std::char_traits<char>::eof())
+			return false;
+		uint64_t Delta = 0;
+		if (!ReadNumber(Delta) || !ReadString(Record.Topic) || !ReadString(Record.Key) ||
+			!ReadString(Record.Payload)) {
+			Truncated_ = true;
+			return false;
+		}
+		Last_ += static_cast<uint64_t>(UnZigZag(Delta));
+		Record.TimeStamp = Last_;
+		return true;
+	}
+
+	uint64_t KafkaReplay::Percentile(std::vector<uint32_t> &Values, double P) {
+		if (Values.empty())
+			return 0;
+		const auto Rank = static_cast<std::size_t>(
+			std::ceil(std::clamp(P, 0.0, 100.0) / 100.0 * static_cast<double>(Values.size())));
+		auto It = Values.begin() + static_cast<std::ptrdiff_t>(std::max<std::size_t>(1, Rank) - 1);
+		std::nth_element(Values.begin(), It, Values.end());
+		return *It;
+	}
+
+	KafkaReplay::Report KafkaReplay::Run(KafkaRecordReader &Reader, double Speed,
+										 const Watcher &W) {
+		Report R;
+		std::vector<uint32_t> Latencies;
+		KafkaRecord Record;
+		uint64_t First = 0;
+		const auto Start = std::chrono::steady_clock::now();
+		while (Reader.Next(Record)) {
+			if (R.Messages == 0)
+				First = Record.TimeStamp;
+			if (Speed > 0.0 && Record.TimeStamp > First) {
+				std::this_thread::sleep_until(
+					Start + std::chrono::microseconds(static_cast<int64_t>(
+								static_cast<double>(Record.TimeStamp - First) / Speed)));
+			}
+			const auto Before = std::chrono::steady_clock::now();
+			W(Record.Topic, Record.Key, Record.Payload);
+			const auto Elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+									 std::chrono::steady_clock::now() - Before)
+									 .count();
+			Latencies.push_back(static_cast<uint32_t>(
+				std::min<int64_t>(Elapsed, std::numeric_limits<uint32_t>::max())));
+			++R.Messages;
+			R.Bytes += Record.Key.size() + Record.Payload.size();
+		}
+		R.Seconds =
+			std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+		R.Truncated = Reader.Truncated();
+		R.P50 = Percentile(Latencies, 50);
+		R.P90 = Percentile(Latencies, 90);
+		R.P99 = Percentile(Latencies, 99);
+		R.P999 = Percentile(Latencies, 99.9);
+		R.Max = Percentile(Latencies, 100);
+		return R;
+	}
+
+} // namespace OpenWifi
@@ -0,0 +1,100 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace OpenWifi {
+
+	//
+	// Kafka messages as recorded by the consumer (openwifi.kafka.record.file), to be replayed
+	// without a broker. The file is a header followed by one record per message: the time
+	// since the previous record, then the topic, key and payload, each prefixed with its
+	// length. Numbers are LEB128 varints, so a record costs a few bytes over its content.
+	//
+	struct KafkaRecord {
+		uint64_t TimeStamp = 0; //	microseconds since the epoch
+		std::string Topic;
+		std::string Key;
+		std::string Payload;
+	};
+
+	class KafkaRecordWriter {
+	  public:
+		~KafkaRecordWriter() { Close(); }
+
+		// Truncates the file. False when it cannot be created.
+		bool Open(const std::string &FileName);
+		void Close();
+		bool Write(const KafkaRecord &Record);
+		bool Write(uint64_t TimeStamp, const std::string &Topic, const std::string &Key,
+				   const std::string &Payload);
+
+		[[nodiscard]] inline bool IsOpen() const { return File_.is_open(); }
+		[[nodiscard]] inline uint64_t Records() const { return Records_; }
+		[[nodiscard]] inline uint64_t Bytes() const { return Bytes_; }
+
+	  private:
+		std::ofstream File_;
+		std::string Buffer_;
+		uint64_t Last_ = 0;
+		uint64_t Records_ = 0;
+		uint64_t Bytes_ = 0;
+	};
+
+	class KafkaRecordReader {
+	  public:
+		// False when the file cannot be read or is not a recording.
+		bool Open(const std::string &FileName);
+		// False at the end of the file. A truncated last record also ends it, and sets Truncated.
+		bool Next(KafkaRecord &Record);
+
+		[[nodiscard]] inline bool Truncated() const { return Truncated_; }
+
+	  private:
+		std::ifstream File_;
+		uint64_t Last_ = 0;
+		bool Truncated_ = false;
+
+		bool ReadNumber(uint64_t &Value);
+		bool ReadString(std::string &Value);
+	};
+
+	//
+	// Feeds a recording to a watcher, on the calling thread. Speed 1 keeps the recorded pace,
+	// 10 plays it ten times faster, 0 as fast as possible. The time spent in the watcher is
+	// measured for every message.
+	//
+	class KafkaReplay {
+	  public:
+		typedef std::function<void(const std::string &Topic, const std::string &Key,
+								   const std::string &Payload)>
+			Watcher;
+
+		struct Report {
+			uint64_t Messages = 0;
+			uint64_t Bytes = 0;
+			double Seconds = 0.0;
+			bool Truncated = false;
+			// Time spent in the watcher, in microseconds.
+			uint64_t P50 = 0;
+			uint64_t P90 = 0;
+			uint64_t P99 = 0;
+			uint64_t P999 = 0;
+			uint64_t Max = 0;
+		};
+
+		static Report Run(KafkaRecordReader &Reader, double Speed, const Watcher &W);
+		// Percentile P (0-100) of the values, which are sorted in place.
+		static uint64_t Percentile(std::vector<uint32_t> &Values, double P);
+	};
+
+} // namespace OpenWifi
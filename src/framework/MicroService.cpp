@@ -18,10 +18,12 @@
 
 #include "framework/ALBserver.h"
 #include "framework/AuthClient.h"
+#include "framework/HTTPSessionPool.h"
 #include "framework/KafkaManager.h"
 #include "framework/MicroService.h"
 #include "framework/MicroServiceErrorHandler.h"
 #include "framework/MicroServiceNames.h"
+#include "framework/OpenAPIExecutor.h"
 #include "framework/RESTAPI_ExtServer.h"
 #include "framework/RESTAPI_GenericServerAccounting.h"
 #include "framework/RESTAPI_IntServer.h"
@@ -438,6 +440,8 @@ namespace OpenWifi {
         static bool InitializedBaseService=false;
         if(!InitializedBaseService) {
             InitializedBaseService = true;
+            SubSystems_.push_back(HTTPSessionPool());
+            SubSystems_.push_back(OpenAPIExecutor());
             SubSystems_.push_back(KafkaManager());
             SubSystems_.push_back(ALBHealthCheckServer());
             SubSystems_.push_back(RESTAPI_ExtServer());
@@ -101,6 +101,8 @@ namespace OpenWifi {
 		virtual void GetExtraConfiguration(Poco::JSON::Object &Cfg) {
 			Cfg.set("additionalConfiguration", false);
 		}
+		//	Service specific entries added to the "resources" system command.
+		virtual void GetExtraResources([[maybe_unused]] Poco::JSON::Object &Answer) {}
 		static MicroService &instance() { return *instance_; }
 
 		inline void Exit(int Reason) { std::exit(Reason); }
@@ -87,6 +87,10 @@ namespace OpenWifi {
 		MicroService::instance().GetExtraConfiguration(Answer);
 	}
 
+	void MicroServiceGetExtraResources(Poco::JSON::Object &Answer) {
+		MicroService::instance().GetExtraResources(Answer);
+	}
+
 	std::string MicroServiceVersion() { return MicroService::instance().Version(); }
 
 	std::uint64_t MicroServiceUptimeTotalSeconds() {
@@ -0,0 +1,83 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#include "framework/OpenAPIExecutor.h"
+
+#include "fmt/format.h"
+#include "framework/MicroServiceFuncs.h"
+#include "framework/utils.h"
+
+namespace OpenWifi {
+
+	int OpenAPIExecutor::Start() {
+		auto Threads = MicroServiceConfigGetInt("openwifi.restapi.client.executor.threads", 8);
+		MaxQueue_ = MicroServiceConfigGetInt("openwifi.restapi.client.executor.queue", 256);
+		if (Threads < 1)
+			Threads = 1;
+		Threads_ = Threads;
+		poco_information(Logger(),
+						 fmt::format("Starting: threads={} queue={}", Threads, MaxQueue_));
+		{
+			std::lock_guard G(QueueMutex_);
+			Running_ = true;
+		}
+		for (uint64_t i = 0; i < Threads; ++i) {
+			auto Worker = std::make_unique<Poco::Thread>();
+			Worker->start(*this);
+			Workers_.push_back(std::move(Worker));
+		}
+		return 0;
+	}
+
+	void OpenAPIExecutor::Stop() {
+		poco_information(Logger(), "Stopping...");
+		std::deque<Task> Pending;
+		{
+			std::lock_guard G(QueueMutex_);
+			Running_ = false;
+			Pending.swap(Queue_);
+		}
+		QueueCV_.notify_all();
+		for (auto &Worker : Workers_)
+			Worker->join();
+		Workers_.clear();
+		for (auto &T : Pending)
+			T(false);
+		poco_information(Logger(), "Stopped...");
+	}
+
+	bool OpenAPIExecutor::Submit(const Task &T) {
+		{
+			std::lock_guard G(QueueMutex_);
+			if (!Running_ || Queue_.size() >= MaxQueue_)
+				return false;
+			Queue_.push_back(T);
+		}
+		QueueCV_.notify_one();
+		return true;
+	}
+
+	void OpenAPIExecutor::run() {
+		Utils::SetThreadName("openapi:exec");
+		while (true) {
+			Task T;
+			{
+				std::unique_lock Lock(QueueMutex_);
+				QueueCV_.wait(Lock, [this] { return !Running_ || !Queue_.empty(); });
+				if (!Running_)
+					return;
+				T = std::move(Queue_.front());
+				Queue_.pop_front();
+			}
+			try {
+				T(true);
+			} catch (...) {
+				poco_error(Logger(), "Unhandled exception in asynchronous request.");
+			}
+		}
+	}
+
+} // namespace OpenWifi
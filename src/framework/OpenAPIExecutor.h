@@ -0,0 +1,77 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+
+#include "framework/SubSystemServer.h"
+
+namespace OpenWifi {
+
+	//
+	// Bounded pool of I/O threads used by the OpenAPIRequest*::DoAsync() calls so a REST handler
+	// can issue independent downstream calls in parallel and join them.
+	//
+	class OpenAPIExecutor : public SubSystemServer, Poco::Runnable {
+	  public:
+		// A task is called with Run=true from a worker thread, or with Run=false when the
+		// executor shuts down before the task could start. It must complete its result either way.
+		using Task = std::function<void(bool Run)>;
+
+		static auto instance() {
+			static auto instance_ = new OpenAPIExecutor;
+			return instance_;
+		}
+
+		int Start() override;
+		void Stop() override;
+		void run() final;
+
+		// Returns false when the executor is not running or its queue is full. The caller is then
+		// expected to run the task itself.
+		bool Submit(const Task &T);
+
+		[[nodiscard]] inline uint64_t Threads() const { return Threads_; }
+
+		// Runs Fn on a worker and returns its result as a future. Fn always runs: on the calling
+		// thread when the queue is full, or on the stopping thread during shutdown.
+		template <typename F> auto Async(F &&Fn) -> std::future<std::invoke_result_t<F>> {
+			using Result = std::invoke_result_t<F>;
+			auto Job = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(Fn));
+			auto Future = Job->get_future();
+			if (!Submit([Job](bool) { (*Job)(); }))
+				(*Job)();
+			return Future;
+		}
+
+	  private:
+		std::mutex QueueMutex_;
+		std::condition_variable QueueCV_;
+		std::deque<Task> Queue_;
+		std::vector<std::unique_ptr<Poco::Thread>> Workers_;
+		bool Running_ = false;
+		uint64_t MaxQueue_ = 256;
+		uint64_t Threads_ = 0;
+
+		OpenAPIExecutor() noexcept
+			: SubSystemServer("OpenAPIExecutor", "OPENAPI-EXEC",
+							  "openwifi.restapi.client.executor") {}
+	};
+
+	inline auto OpenAPIExecutor() { return OpenAPIExecutor::instance(); }
+
+} // namespace OpenWifi
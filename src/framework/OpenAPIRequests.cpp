@@ -12,39 +12,82 @@
 #include "Poco/JSON/Parser.h"
 #include "Poco/Logger.h"
 #include "Poco/Net/HTTPRequest.h"
-#include "Poco/Net/HTTPSClientSession.h"
 #include "Poco/URI.h"
 
 #include <sstream>
 
 #include "fmt/format.h"
+#include "framework/HTTPSessionPool.h"
+#include "framework/OpenAPIExecutor.h"
 #include "framework/MicroServiceFuncs.h"
 
 namespace OpenWifi {
 	namespace {
-		// Reads the raw HTTP response stream into a string.
-		// Placed in an anonymous namespace to give it internal linkage,
-		// ensuring it's only visible within this file and preventing naming 
-		// collisions with other files during compilation.
-		// This is specifically needed to extract the raw `config-raw` snapshot 
-		// from DELETE responses before attempting to parse the body.
-		std::string ReadResponseBody(std::istream &is) {
-			std::ostringstream os;
-			os << is.rdbuf();
-			return os.str();
+		// Sends Request (and Body, if any) on a pooled keep-alive session and reads the whole
+		// response. See HTTPSessionPool::Perform for when a stale connection is retried.
+		Poco::Net::HTTPResponse::HTTPStatus PerformRequest(const Poco::URI &URI,
+														   uint64_t msTimeout,
+														   Poco::Net::HTTPRequest &Request,
+														   const std::string &Body,
+														   std::string &ResponseBody) {
+			Poco::Net::HTTPResponse Response;
+			HTTPSessionPool()->Perform(URI, msTimeout, Request, Body, Response, ResponseBody);
+			return Response.getStatus();
+		}
+
+		// Queues Call on the OpenAPIExecutor with a deadline of msTimeout from now. Call receives
+		// the time left so the socket timeout never runs past the deadline. When the executor is
+		// saturated or stopped, the request runs on the calling thread instead.
+		std::future<OpenAPIResponse>
+		RunAsync(uint64_t msTimeout, const OpenAPICancellation &Cancel,
+				 std::function<void(uint64_t msRemaining, OpenAPIResponse &Result)> Call) {
+			auto Promise = std::make_shared<std::promise<OpenAPIResponse>>();
+			auto Future = Promise->get_future();
+			auto Deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(msTimeout);
+			OpenAPIExecutor::Task T = [Promise, Deadline, Cancel, Call = std::move(Call)](bool Run) {
+				OpenAPIResponse Result;
+				auto Now = std::chrono::steady_clock::now();
+				if (Run && !Cancel.Cancelled() && Now < Deadline) {
+					auto msRemaining =
+						std::chrono::duration_cast<std::chrono::milliseconds>(Deadline - Now).count();
+					//	Less than a millisecond left counts as timed out: a zero socket timeout
+					//	would mean no timeout at all.
+					if (msRemaining > 0) {
+						try {
+							Call(msRemaining, Result);
+						} catch (...) {
+							Result = OpenAPIResponse{};
+						}
+					}
+				}
+				Promise->set_value(std::move(Result));
+			};
+			if (!OpenAPIExecutor()->Submit(T))
+				T(true);
+			return Future;
 		}
 	} // namespace
 
 	Poco::Net::HTTPServerResponse::HTTPStatus
 	OpenAPIRequestGet::Do(Poco::JSON::Object::Ptr &ResponseObject, const std::string &BearerToken) {
+		std::string RawResponseBody;
+		auto Status = Do(RawResponseBody, BearerToken);
+		try {
+			Poco::JSON::Parser P;
+			ResponseObject = P.parse(RawResponseBody).extract<Poco::JSON::Object::Ptr>();
+		} catch (...) {
+		}
+		return Status;
+	}
+
+	Poco::Net::HTTPServerResponse::HTTPStatus
+	OpenAPIRequestGet::Do(std::string &RawResponseBody, const std::string &BearerToken) {
 		try {
 
 			auto Services = MicroServiceGetServices(Type_);
 			for (auto const &Svc : Services) {
 				Poco::URI URI(Svc.PrivateEndPoint);
 
-				auto Secure = (URI.getScheme() == "https");
-
 				URI.setPath(EndPoint_);
 				for (const auto &qp : QueryData_)
 					URI.addQueryParameter(qp.first, qp.second);
@@ -64,35 +107,7 @@ namespace OpenWifi {
 					Request.add("Authorization", "Bearer " + BearerToken);
 				}
 
-				if (Secure) {
-					Poco::Net::HTTPSClientSession Session(URI.getHost(), URI.getPort());
-					Session.setTimeout(Poco::Timespan(msTimeout_ / 1000, msTimeout_ % 1000));
-
-					Session.sendRequest(Request);
-
-					Poco::Net::HTTPResponse Response;
-					std::istream &is = Session.receiveResponse(Response);
-					try {
-						Poco::JSON::Parser P;
-						ResponseObject = P.parse(is).extract<Poco::JSON::Object::Ptr>();
-					} catch (...) {
-					}
-					return Response.getStatus();
-				} else {
-					Poco::Net::HTTPClientSession Session(URI.getHost(), URI.getPort());
-					Session.setTimeout(Poco::Timespan(msTimeout_ / 1000, msTimeout_ % 1000));
-
-					Session.sendRequest(Request);
-
-					Poco::Net::HTTPResponse Response;
-					std::istream &is = Session.receiveResponse(Response);
-					try {
-						Poco::JSON::Parser P;
-						ResponseObject = P.parse(is).extract<Poco::JSON::Object::Ptr>();
-					} catch (...) {
-					}
-					return Response.getStatus();
-				}
+				return PerformRequest(URI, msTimeout_, Request, "", RawResponseBody);
 			}
 		} catch (const Poco::Exception &E) {
 			Poco::Logger::get("REST-CALLER-GET").log(E);
@@ -107,8 +122,6 @@ namespace OpenWifi {
 			for (auto const &Svc : Services) {
 				Poco::URI URI(Svc.PrivateEndPoint);
 
-				auto Secure = (URI.getScheme() == "https");
-
 				URI.setPath(EndPoint_);
 				for (const auto &qp : QueryData_)
 					URI.addQueryParameter(qp.first, qp.second);
@@ -134,41 +147,11 @@ namespace OpenWifi {
 					Request.add("Authorization", "Bearer " + BearerToken);
 				}
 
-				if (Secure) {
-					Poco::Net::HTTPSClientSession Session(URI.getHost(), URI.getPort());
-					Session.setTimeout(Poco::Timespan(msTimeout_ / 1000, msTimeout_ % 1000));
-
-					std::ostream &os = Session.sendRequest(Request);
-					os << obody.str();
-
-					Poco::Net::HTTPResponse Response;
-					std::istream &is = Session.receiveResponse(Response);
-					if (Response.getStatus() == Poco::Net::HTTPResponse::HTTP_OK) {
-						Poco::JSON::Parser P;
-						ResponseObject = P.parse(is).extract<Poco::JSON::Object::Ptr>();
-					} else {
-						Poco::JSON::Parser P;
-						ResponseObject = P.parse(is).extract<Poco::JSON::Object::Ptr>();
-					}
-					return Response.getStatus();
-				} else {
-					Poco::Net::HTTPClientSession Session(URI.getHost(), URI.getPort());
-					Session.setTimeout(Poco::Timespan(msTimeout_ / 1000, msTimeout_ % 1000));
-
-					std::ostream &os = Session.sendRequest(Request);
-					os << obody.str();
-
-					Poco::Net::HTTPResponse Response;
-					std::istream &is = Session.receiveResponse(Response);
-					if (Response.getStatus() == Poco::Net::HTTPResponse::HTTP_OK) {
-						Poco::JSON::Parser P;
-						ResponseObject = P.parse(is).extract<Poco::JSON::Object::Ptr>();
-					} else {
-						Poco::JSON::Parser P;
-						ResponseObject = P.parse(is).extract<Poco::JSON::Object::Ptr>();
-					}
-					return Response.getStatus();
-				}
+				std::string RawResponseBody;
+				auto Status = PerformRequest(URI, msTimeout_, Request, obody.str(), RawResponseBody);
+				Poco::JSON::Parser P;
+				ResponseObject = P.parse(RawResponseBody).extract<Poco::JSON::Object::Ptr>();
+				return Status;
 			}
 		} catch (const Poco::Exception &E) {
 			Poco::Logger::get("REST-CALLER-PUT").log(E);
@@ -185,8 +168,6 @@ namespace OpenWifi {
 			for (auto const &Svc : Services) {
 				Poco::URI URI(Svc.PrivateEndPoint);
 
-				auto Secure = (URI.getScheme() == "https");
-
 				URI.setPath(EndPoint_);
 				for (const auto &qp : QueryData_)
 					URI.addQueryParameter(qp.first, qp.second);
@@ -212,39 +193,11 @@ namespace OpenWifi {
 					Request.add("Authorization", "Bearer " + BearerToken);
 				}
 
-				if (Secure) {
-					Poco::Net::HTTPSClientSession Session(URI.getHost(), URI.getPort());
-					Session.setTimeout(Poco::Timespan(msTimeout_ / 1000, msTimeout_ % 1000));
-					std::ostream &os = Session.sendRequest(Request);
-					os << obody.str();
-
-					Poco::Net::HTTPResponse Response;
-					std::istream &is = Session.receiveResponse(Response);
-					if (Response.getStatus() == Poco::Net::HTTPResponse::HTTP_OK) {
-						Poco::JSON::Parser P;
-						ResponseObject = P.parse(is).extract<Poco::JSON::Object::Ptr>();
-					} else {
-						Poco::JSON::Parser P;
-						ResponseObject = P.parse(is).extract<Poco::JSON::Object::Ptr>();
-					}
-					return Response.getStatus();
-				} else {
-					Poco::Net::HTTPClientSession Session(URI.getHost(), URI.getPort());
-					Session.setTimeout(Poco::Timespan(msTimeout_ / 1000, msTimeout_ % 1000));
-					std::ostream &os = Session.sendRequest(Request);
-					os << obody.str();
-
-					Poco::Net::HTTPResponse Response;
-					std::istream &is = Session.receiveResponse(Response);
-					if (Response.getStatus() == Poco::Net::HTTPResponse::HTTP_OK) {
-						Poco::JSON::Parser P;
-						ResponseObject = P.parse(is).extract<Poco::JSON::Object::Ptr>();
-					} else {
-						Poco::JSON::Parser P;
-						ResponseObject = P.parse(is).extract<Poco::JSON::Object::Ptr>();
-					}
-					return Response.getStatus();
-				}
+				std::string RawResponseBody;
+				auto Status = PerformRequest(URI, msTimeout_, Request, obody.str(), RawResponseBody);
+				Poco::JSON::Parser P;
+				ResponseObject = P.parse(RawResponseBody).extract<Poco::JSON::Object::Ptr>();
+				return Status;
 			}
 		} catch (const Poco::Exception &E) {
 			Poco::Logger::get("REST-CALLER-POST").log(E);
@@ -267,8 +220,6 @@ namespace OpenWifi {
 			for (auto const &Svc : Services) {
 				Poco::URI URI(Svc.PrivateEndPoint);
 
-				auto Secure = (URI.getScheme() == "https");
-
 				URI.setPath(EndPoint_);
 				for (const auto &qp : QueryData_)
 					URI.addQueryParameter(qp.first, qp.second);
@@ -288,33 +239,13 @@ namespace OpenWifi {
 					Request.add("Authorization", "Bearer " + BearerToken);
 				}
 
-				if (Secure) {
-					Poco::Net::HTTPSClientSession Session(URI.getHost(), URI.getPort());
-					Session.setTimeout(Poco::Timespan(msTimeout_ / 1000, msTimeout_ % 1000));
-					Session.sendRequest(Request);
-					Poco::Net::HTTPResponse Response;
-					std::istream &is = Session.receiveResponse(Response);
-					RawResponseBody = ReadResponseBody(is);
-					try {
-						Poco::JSON::Parser P;
-						ResponseObject = P.parse(RawResponseBody).extract<Poco::JSON::Object::Ptr>();
-					} catch (...) {
-					}
-					return Response.getStatus();
-				} else {
-					Poco::Net::HTTPClientSession Session(URI.getHost(), URI.getPort());
-					Session.setTimeout(Poco::Timespan(msTimeout_ / 1000, msTimeout_ % 1000));
-					Session.sendRequest(Request);
-					Poco::Net::HTTPResponse Response;
-					std::istream &is = Session.receiveResponse(Response);
-					RawResponseBody = ReadResponseBody(is);
-					try {
-						Poco::JSON::Parser P;
-						ResponseObject = P.parse(RawResponseBody).extract<Poco::JSON::Object::Ptr>();
-					} catch (...) {
-					}
-					return Response.getStatus();
+				auto Status = PerformRequest(URI, msTimeout_, Request, "", RawResponseBody);
+				try {
+					Poco::JSON::Parser P;
+					ResponseObject = P.parse(RawResponseBody).extract<Poco::JSON::Object::Ptr>();
+				} catch (...) {
 				}
+				return Status;
 			}
 		} catch (const Poco::Exception &E) {
 			Poco::Logger::get("REST-CALLER-DELETE").log(E);
@@ -332,8 +263,6 @@ namespace OpenWifi {
 			for (auto const &Svc : Services) {
 				Poco::URI URI(Svc.PrivateEndPoint);
 
-				auto Secure = (URI.getScheme() == "https");
-
 				URI.setPath(EndPoint_);
 				for (const auto &qp : QueryData_)
 					URI.addQueryParameter(qp.first, qp.second);
@@ -352,45 +281,19 @@ namespace OpenWifi {
 					Request.add("Authorization", "Bearer " + BearerToken);
 				}
 
-				if (Secure) {
-					Poco::Net::HTTPSClientSession Session(URI.getHost(), URI.getPort());
-					Session.setTimeout(Poco::Timespan(msTimeout_ / 1000, msTimeout_ % 1000));
-
-					Session.sendRequest(Request);
-
-					Poco::Net::HTTPResponse Response;
-					std::istream &is = Session.receiveResponse(Response);
-					try {
-						Poco::JSON::Parser P;
-						auto parsed = P.parse(is);
-						if (parsed.type() == typeid(Poco::JSON::Array::Ptr)) {
-							ResponseArray = parsed.extract<Poco::JSON::Array::Ptr>();
-						} else {
-							ResponseObject = parsed.extract<Poco::JSON::Object::Ptr>();
-						}
-					} catch (...) {
-					}
-					return Response.getStatus();
-				} else {
-					Poco::Net::HTTPClientSession Session(URI.getHost(), URI.getPort());
-					Session.setTimeout(Poco::Timespan(msTimeout_ / 1000, msTimeout_ % 1000));
-
-					Session.sendRequest(Request);
-
-					Poco::Net::HTTPResponse Response;
-					std::istream &is = Session.receiveResponse(Response);
-					try {
-						Poco::JSON::Parser P;
-						auto parsed = P.parse(is);
-						if (parsed.type() == typeid(Poco::JSON::Array::Ptr)) {
-							ResponseArray = parsed.extract<Poco::JSON::Array::Ptr>();
-						} else {
-							ResponseObject = parsed.extract<Poco::JSON::Object::Ptr>();
-						}
-					} catch (...) {
+				std::string RawResponseBody;
+				auto Status = PerformRequest(URI, msTimeout_, Request, "", RawResponseBody);
+				try {
+					Poco::JSON::Parser P;
+					auto parsed = P.parse(RawResponseBody);
+					if (parsed.type() == typeid(Poco::JSON::Array::Ptr)) {
+						ResponseArray = parsed.extract<Poco::JSON::Array::Ptr>();
+					} else {
+						ResponseObject = parsed.extract<Poco::JSON::Object::Ptr>();
 					}
-					return Response.getStatus();
+				} catch (...) {
 				}
+				return Status;
 			}
 		} catch (const Poco::Exception &E) {
 			Poco::Logger::get("REST-CALLER-GET").log(E);
@@ -398,4 +301,44 @@ namespace OpenWifi {
 		return Poco::Net::HTTPServerResponse::HTTP_GATEWAY_TIMEOUT;
 	}
 
+	std::future<OpenAPIResponse> OpenAPIRequestGet::DoAsync(const std::string &BearerToken,
+															 const OpenAPICancellation &Cancel) {
+		return RunAsync(msTimeout_, Cancel,
+						[Request = *this, BearerToken](uint64_t msRemaining,
+													   OpenAPIResponse &Result) mutable {
+							Request.msTimeout_ = msRemaining;
+							Result.Status = Request.Do(Result.Array, Result.Object, BearerToken);
+						});
+	}
+
+	std::future<OpenAPIResponse> OpenAPIRequestPut::DoAsync(const std::string &BearerToken,
+															 const OpenAPICancellation &Cancel) {
+		return RunAsync(msTimeout_, Cancel,
+						[Request = *this, BearerToken](uint64_t msRemaining,
+													   OpenAPIResponse &Result) mutable {
+							Request.msTimeout_ = msRemaining;
+							Result.Status = Request.Do(Result.Object, BearerToken);
+						});
+	}
+
+	std::future<OpenAPIResponse> OpenAPIRequestPost::DoAsync(const std::string &BearerToken,
+															  const OpenAPICancellation &Cancel) {
+		return RunAsync(msTimeout_, Cancel,
+						[Request = *this, BearerToken](uint64_t msRemaining,
+													   OpenAPIResponse &Result) mutable {
+							Request.msTimeout_ = msRemaining;
+							Result.Status = Request.Do(Result.Object, BearerToken);
+						});
+	}
+
+	std::future<OpenAPIResponse> OpenAPIRequestDelete::DoAsync(const std::string &BearerToken,
+																const OpenAPICancellation &Cancel) {
+		return RunAsync(msTimeout_, Cancel,
+						[Request = *this, BearerToken](uint64_t msRemaining,
+													   OpenAPIResponse &Result) mutable {
+							Request.msTimeout_ = msRemaining;
+							Result.Status = Request.Do(Result.Object, Result.RawBody, BearerToken);
+						});
+	}
+
 } // namespace OpenWifi
@@ -4,6 +4,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
 #include <string>
 
 #include "Poco/JSON/Array.h"
@@ -14,6 +18,40 @@
 
 namespace OpenWifi {
 
+	//	Result of an asynchronous request. Array is only set by OpenAPIRequestGet when the
+	//	response body is a JSON array, RawBody only by OpenAPIRequestDelete.
+	struct OpenAPIResponse {
+		Poco::Net::HTTPServerResponse::HTTPStatus Status =
+			Poco::Net::HTTPServerResponse::HTTP_GATEWAY_TIMEOUT;
+		Poco::JSON::Object::Ptr Object;
+		Poco::JSON::Array::Ptr Array;
+		std::string RawBody;
+	};
+
+	//	Shared flag used to abandon an asynchronous request. A request cancelled before it starts
+	//	completes with HTTP_GATEWAY_TIMEOUT without touching the network. One already sent is not
+	//	aborted: it runs until its own timeout and its result is discarded.
+	class OpenAPICancellation {
+	  public:
+		inline void Cancel() const { *Flag_ = true; }
+		[[nodiscard]] inline bool Cancelled() const { return *Flag_; }
+
+	  private:
+		std::shared_ptr<std::atomic_bool> Flag_ = std::make_shared<std::atomic_bool>(false);
+	};
+
+	//	Waits for an asynchronous request until Deadline. When the deadline passes first, the
+	//	request is abandoned (not sent if still queued) and HTTP_GATEWAY_TIMEOUT is returned so
+	//	the caller never blocks on a slow downstream service.
+	inline OpenAPIResponse OpenAPIAwait(std::future<OpenAPIResponse> &Future,
+										std::chrono::steady_clock::time_point Deadline,
+										const OpenAPICancellation &Cancel) {
+		if (Future.wait_until(Deadline) == std::future_status::ready)
+			return Future.get();
+		Cancel.Cancel();
+		return OpenAPIResponse{};
+	}
+
 	class OpenAPIRequestGet {
 	  public:
 		explicit OpenAPIRequestGet(const std::string &Type, const std::string &EndPoint,
@@ -26,6 +64,13 @@ namespace OpenWifi {
 		Poco::Net::HTTPServerResponse::HTTPStatus Do(Poco::JSON::Array::Ptr &ResponseArray,
 													 Poco::JSON::Object::Ptr &ResponseObject,
 													 const std::string &BearerToken = "");
+		//	Returns the response body unparsed, for callers that decode it themselves.
+		Poco::Net::HTTPServerResponse::HTTPStatus Do(std::string &RawResponseBody,
+													 const std::string &BearerToken = "");
+		//	Runs the request on the OpenAPIExecutor. The request's own timeout is also its deadline:
+		//	a request still queued when it expires, or cancelled, is not sent.
+		std::future<OpenAPIResponse> DoAsync(const std::string &BearerToken = "",
+											 const OpenAPICancellation &Cancel = {});
 
 	  private:
 		std::string Type_;
@@ -46,6 +91,8 @@ namespace OpenWifi {
 
 		Poco::Net::HTTPServerResponse::HTTPStatus Do(Poco::JSON::Object::Ptr &ResponseObject,
 													 const std::string &BearerToken = "");
+		std::future<OpenAPIResponse> DoAsync(const std::string &BearerToken = "",
+											 const OpenAPICancellation &Cancel = {});
 
 	  private:
 		std::string Type_;
@@ -66,6 +113,8 @@ namespace OpenWifi {
 			  Body_(Body), LoggingStr_(LoggingStr){};
 		Poco::Net::HTTPServerResponse::HTTPStatus Do(Poco::JSON::Object::Ptr &ResponseObject,
 													 const std::string &BearerToken = "");
+		std::future<OpenAPIResponse> DoAsync(const std::string &BearerToken = "",
+											 const OpenAPICancellation &Cancel = {});
 
 	  private:
 		std::string Type_;
@@ -87,6 +136,8 @@ namespace OpenWifi {
 		Poco::Net::HTTPServerResponse::HTTPStatus Do(Poco::JSON::Object::Ptr &ResponseObject,
 													 std::string &RawResponseBody,
 													 const std::string &BearerToken);
+		std::future<OpenAPIResponse> DoAsync(const std::string &BearerToken = "",
+											 const OpenAPICancellation &Cancel = {});
 
 	  private:
 		std::string Type_;
@@ -639,6 +639,14 @@ namespace OpenWifi {
 			Answer << json_doc;
 		}
 
+		inline void ReturnRawText(const std::string &Text, const std::string &ContentType) {
+			PrepareResponse();
+			Response->setContentType(ContentType);
+			Response->setContentLength(Text.size());
+			std::ostream &Answer = Response->send();
+			Answer << Text;
+		}
+
 		inline void ReturnCountOnly(uint64_t Count) {
 			Poco::JSON::Object Answer;
 			Answer.set("count", Count);
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "framework/HTTPSessionPool.h"
+#include "framework/KafkaManager.h"
 #include "framework/RESTAPI_Handler.h"
 
 #include "Poco/Environment.h"
@@ -79,8 +81,26 @@ namespace OpenWifi {
 					Answer.set("peakRealMem", peakRealMem);
 					Answer.set("currVirtMem", currVirtMem);
 					Answer.set("peakVirtMem", peakVirtMem);
+					Poco::JSON::Object SessionPool;
+					HTTPSessionPool()->GetStats(SessionPool);
+					Answer.set("httpSessionPool", SessionPool);
+					MicroServiceGetExtraResources(Answer);
 					return ReturnObject(Answer);
 				}
+				if (Arg == "kafka") {
+					Poco::JSON::Object Answer;
+					KafkaManager()->GetStats(Answer);
+					return ReturnObject(Answer);
+				}
+				if (Arg == "metrics") {
+					//	For scrapers: Prometheus text exposition format.
+					std::string Text;
+					KafkaManager()->GetMetrics(Text);
+#ifndef TIP_SECURITY_SERVICE
+					AuthClient()->GetMetrics(Text);
+#endif
+					return ReturnRawText(Text, "text/plain; version=0.0.4; charset=utf-8");
+				}
 			}
 			BadRequest(RESTAPI::Errors::InvalidCommand);
 		}
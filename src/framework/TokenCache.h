@@ -0,0 +1,218 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace OpenWifi {
+
+	//
+	// Validated tokens, sharded by key so concurrent requests rarely share a lock. Each entry
+	// carries its own expiry (the token's, or a short one for a token known to be invalid);
+	// each shard evicts its least recently used entry when it is full.
+	//
+	template <typename V> class TokenCache {
+	  public:
+		static constexpr std::size_t ShardCount = 64;
+
+		enum class Lookup { Miss, Valid, Invalid };
+
+		struct Stats {
+			uint64_t Hits = 0;
+			uint64_t InvalidHits = 0;
+			uint64_t Misses = 0;
+			uint64_t Expired = 0;
+			uint64_t Evictions = 0;
+			uint64_t Entries = 0;
+		};
+
+		explicit TokenCache(std::size_t Capacity) { SetCapacity(Capacity); }
+
+		//	Drops every entry.
+		void SetCapacity(std::size_t Capacity) {
+			const auto PerShard = std::max<std::size_t>(1, (Capacity + ShardCount - 1) / ShardCount);
+			for (auto &S : Shards_) {
+				std::lock_guard G(S.Mutex);
+				S.Index.clear();
+				S.Lru.clear();
+				S.Capacity = PerShard;
+			}
+		}
+
+		[[nodiscard]] std::size_t Capacity() const { return Shards_[0].Capacity * ShardCount; }
+
+		//	Now and the expiry times are in seconds since the epoch.
+		Lookup Get(const std::string &Key, uint64_t Now, std::shared_ptr<const V> &Value) {
+			auto &S = ShardOf(Key);
+			std::lock_guard G(S.Mutex);
+			auto It = S.Index.find(Key);
+			if (It == S.Index.end()) {
+				++S.Misses;
+				return Lookup::Miss;
+			}
+			auto Entry = It->second;
+			if (Entry->ExpiresAt <= Now) {
+				++S.Expired;
+				++S.Misses;
+				S.Index.erase(It);
+				S.Lru.erase(Entry);
+				return Lookup::Miss;
+			}
+			S.Lru.splice(S.Lru.begin(), S.Lru, Entry);
+			if (!Entry->Value) {
+				++S.InvalidHits;
+				return Lookup::Invalid;
+			}
+			++S.Hits;
+			Value = Entry->Value;
+			return Lookup::Valid;
+		}
+
+		void Put(const std::string &Key, std::shared_ptr<const V> Value, uint64_t ExpiresAt) {
+			auto &S = ShardOf(Key);
+			std::lock_guard G(S.Mutex);
+			auto It = S.Index.find(Key);
+			if (It != S.Index.end()) {
+				It->second->Value = std::move(Value);
+				It->second->ExpiresAt = ExpiresAt;
+				S.Lru.splice(S.Lru.begin(), S.Lru, It->second);
+				return;
+			}
+			if (S.Lru.size() >= S.Capacity) {
+				S.Index.erase(S.Lru.back().Key);
+				S.Lru.pop_back();
+				++S.Evictions;
+			}
+			S.Lru.push_front(Entry{Key, std::move(Value), ExpiresAt});
+			S.Index.emplace(S.Lru.front().Key, S.Lru.begin());
+		}
+
+		//	Remembers that the token is not valid, until ExpiresAt.
+		inline void PutInvalid(const std::string &Key, uint64_t ExpiresAt) {
+			Put(Key, nullptr, ExpiresAt);
+		}
+
+		void Remove(const std::string &Key) {
+			auto &S = ShardOf(Key);
+			std::lock_guard G(S.Mutex);
+			auto It = S.Index.find(Key);
+			if (It == S.Index.end())
+				return;
+			auto Entry = It->second;
+			S.Index.erase(It);
+			S.Lru.erase(Entry);
+		}
+
+		void Clear() {
+			for (auto &S : Shards_) {
+				std::lock_guard G(S.Mutex);
+				S.Index.clear();
+				S.Lru.clear();
+			}
+		}
+
+		[[nodiscard]] Stats GetStats() const {
+			Stats Result;
+			for (const auto &S : Shards_) {
+				std::lock_guard G(S.Mutex);
+				Result.Hits += S.Hits;
+				Result.InvalidHits += S.InvalidHits;
+				Result.Misses += S.Misses;
+				Result.Expired += S.Expired;
+				Result.Evictions += S.Evictions;
+				Result.Entries += S.Lru.size();
+			}
+			return Result;
+		}
+
+	  private:
+		struct Entry {
+			std::string Key;
+			std::shared_ptr<const V> Value; //	null for an invalid token
+			uint64_t ExpiresAt = 0;
+		};
+
+		struct Shard {
+			mutable std::mutex Mutex;
+			//	Most recently used first. The index keys point into the entries.
+			std::list<Entry> Lru;
+			std::unordered_map<std::string_view, typename std::list<Entry>::iterator> Index;
+			std::size_t Capacity = 1;
+			uint64_t Hits = 0;
+			uint64_t InvalidHits = 0;
+			uint64_t Misses = 0;
+			uint64_t Expired = 0;
+			uint64_t Evictions = 0;
+		};
+
+		std::array<Shard, ShardCount> Shards_;
+
+		inline Shard &ShardOf(const std::string &Key) {
+			return Shards_[std::hash<std::string>{}(Key) % ShardCount];
+		}
+	};
+
+	//
+	// Runs one call per key at a time: callers that ask for a key while its call is running
+	// wait for that call's result instead of making their own.
+	//
+	template <typename R> class SingleFlight {
+	  public:
+		template <typename F> R Do(const std::string &Key, F &&Fetch, bool &Shared) {
+			std::promise<R> Promise;
+			std::shared_future<R> Running;
+			{
+				std::lock_guard G(Mutex_);
+				auto [It, Inserted] = Flights_.try_emplace(Key);
+				if (Inserted)
+					It->second = Promise.get_future().share();
+				else
+					Running = It->second;
+			}
+			Shared = Running.valid();
+			if (Shared) {
+				++Shared_;
+				return Running.get();
+			}
+
+			try {
+				R Result = Fetch();
+				Promise.set_value(Result);
+				Land(Key);
+				return Result;
+			} catch (...) {
+				Promise.set_exception(std::current_exception());
+				Land(Key);
+				throw;
+			}
+		}
+
+		[[nodiscard]] inline uint64_t Shared() const { return Shared_; }
+
+	  private:
+		std::mutex Mutex_;
+		std::unordered_map<std::string, std::shared_future<R>> Flights_;
+		std::atomic_uint64_t Shared_ = 0;
+
+		inline void Land(const std::string &Key) {
+			std::lock_guard G(Mutex_);
+			Flights_.erase(Key);
+		}
+	};
+
+} // namespace OpenWifi
@@ -0,0 +1,239 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#include "TokenVerifier.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+
+#include "Poco/Base64Decoder.h"
+#include "Poco/Base64Encoder.h"
+#include "Poco/Crypto/RSAKey.h"
+#include "Poco/Crypto/X509Certificate.h"
+#include "Poco/JSON/Array.h"
+#include "Poco/JWT/Token.h"
+
+namespace OpenWifi {
+
+	namespace {
+		const std::set<std::string> ALGORITHMS{"RS256", "RS384", "RS512"};
+
+		//	Seconds of clock difference tolerated with the security service for "nbf".
+		constexpr uint64_t CLOCK_SKEW = 60;
+
+		std::shared_ptr<const Poco::JWT::Signer> MakeSigner(std::istream &PublicKey) {
+			Poco::SharedPtr<Poco::Crypto::RSAKey> Key(new Poco::Crypto::RSAKey(&PublicKey));
+			auto Signer = std::make_shared<Poco::JWT::Signer>(Key);
+			for (const auto &Algorithm : ALGORITHMS)
+				Signer->addAlgorithm(Algorithm);
+			return Signer;
+		}
+
+		std::shared_ptr<const Poco::JWT::Signer>
+		MakeSigner(const Poco::Crypto::X509Certificate &C) {
+			Poco::SharedPtr<Poco::Crypto::RSAKey> Key(new Poco::Crypto::RSAKey(C));
+			auto Signer = std::make_shared<Poco::JWT::Signer>(Key);
+			for (const auto &Algorithm : ALGORITHMS)
+				Signer->addAlgorithm(Algorithm);
+			return Signer;
+		}
+
+		std::string PEM(const std::string &Label, const std::string &Der) {
+			std::ostringstream OS;
+			OS << "-----BEGIN " << Label << "-----\n";
+			{
+				Poco::Base64Encoder Encoder(OS);
+				Encoder.rdbuf()->setLineLength(64);
+				Encoder << Der;
+				Encoder.close();
+			}
+			OS << "\n-----END " << Label << "-----\n";
+			return OS.str();
+		}
+
+		void DerLength(std::string &Out, std::size_t Length) {
+			if (Length < 0x80) {
+				Out.push_back(static_cast<char>(Length));
+				return;
+			}
+			std::string Bytes;
+			for (; Length > 0; Length >>= 8)
+				Bytes.insert(Bytes.begin(), static_cast<char>(Length & 0xff));
+			Out.push_back(static_cast<char>(0x80 | Bytes.size()));
+			Out += Bytes;
+		}
+
+		std::string Der(uint8_t Tag, const std::string &Content) {
+			std::string Out(1, static_cast<char>(Tag));
+			DerLength(Out, Content.size());
+			return Out + Content;
+		}
+
+		//	A positive INTEGER: no leading zeros, but one when the high bit is set.
+		std::string DerInteger(const std::string &BigEndian) {
+			const auto First = BigEndian.find_first_not_of('\0');
+			std::string Bytes =
+				First == std::string::npos ? std::string(1, '\0') : BigEndian.substr(First);
+			if (static_cast<uint8_t>(Bytes[0]) & 0x80)
+				Bytes.insert(Bytes.begin(), '\0');
+			return Der(0x02, Bytes);
+		}
+	} // namespace
+
+	std::string TokenVerifier::DecodeBase64Url(const std::string &Value) {
+		try {
+			std::istringstream IS(Value);
+			Poco::Base64Decoder Decoder(IS,
+										Poco::BASE64_URL_ENCODING | Poco::BASE64_NO_PADDING);
+			return std::string(std::istreambuf_iterator<char>(Decoder),
+							   std::istreambuf_iterator<char>());
+		} catch (...) {
+			return {};
+		}
+	}
+
+	std::string TokenVerifier::RSAPublicKeyPEM(const std::string &Modulus,
+												const std::string &Exponent) {
+		//	SubjectPublicKeyInfo { AlgorithmIdentifier { rsaEncryption, NULL },
+		//	BIT STRING { RSAPublicKey { modulus, publicExponent } } }
+		static const std::string RSA_ENCRYPTION{
+			"\x30\x0d\x06\x09\x2a\x86\x48\x86\xf7\x0d\x01\x01\x01\x05\x00", 15};
+		const auto Key = Der(0x30, DerInteger(Modulus) + DerInteger(Exponent));
+		return PEM("PUBLIC KEY",
+				   Der(0x30, RSA_ENCRYPTION + Der(0x03, std::string(1, '\0') + Key)));
+	}
+
+	std::size_t TokenVerifier::LoadKeys(const Poco::JSON::Object::Ptr &JWKS) {
+		auto Keys = std::make_shared<Signers>();
+		Poco::JSON::Array::Ptr Entries;
+		if (!JWKS.isNull())
+			Entries = JWKS->getArray("keys");
+		if (!Entries.isNull()) {
+			for (const auto &Entry : *Entries) {
+				try {
+					const auto &Key = Entry.extract<Poco::JSON::Object::Ptr>();
+					if (Key->optValue<std::string>("kty", "") != "RSA" ||
+						Key->optValue<std::string>("use", "sig") != "sig")
+						continue;
+					const auto KeyId = Key->optValue<std::string>("kid", "");
+					if (Key->has("n") && Key->has("e")) {
+						const auto N = DecodeBase64Url(Key->getValue<std::string>("n"));
+						const auto E = DecodeBase64Url(Key->getValue<std::string>("e"));
+						if (N.empty() || E.empty())
+							continue;
+						std::istringstream IS(RSAPublicKeyPEM(N, E));
+						(*Keys)[KeyId] = MakeSigner(IS);
+					} else if (auto Chain = Key->getArray("x5c");
+							   !Chain.isNull() && Chain->size() > 0) {
+						//	Standard (not url) base64 of the DER certificate.
+						std::istringstream IS(
+							"-----BEGIN CERTIFICATE-----\n" + Chain->getElement<std::string>(0) +
+							"\n-----END CERTIFICATE-----\n");
+						(*Keys)[KeyId] = MakeSigner(Poco::Crypto::X509Certificate(IS));
+					}
+				} catch (...) {
+				}
+			}
+		}
+		if (Keys->empty())
+			return 0;
+		std::lock_guard G(Mutex_);
+		Keys_ = std::move(Keys);
+		return Keys_->size();
+	}
+
+	bool TokenVerifier::LoadKeyFile(const std::string &FileName) {
+		try {
+			std::ifstream IS(FileName);
+			if (!IS.good())
+				return false;
+			auto Signer = MakeSigner(IS);
+			std::lock_guard G(Mutex_);
+			FileKey_ = std::move(Signer);
+			return true;
+		} catch (...) {
+			return false;
+		}
+	}
+
+	void TokenVerifier::SetIssuer(const std::string &Issuer) {
+		std::lock_guard G(Mutex_);
+		Issuer_ = Issuer;
+	}
+
+	std::size_t TokenVerifier::Keys() const {
+		std::lock_guard G(Mutex_);
+		return Keys_->size() + (FileKey_ ? 1 : 0);
+	}
+
+	std::shared_ptr<const Poco::JWT::Signer>
+	TokenVerifier::SignerFor(const std::string &KeyId) const {
+		std::lock_guard G(Mutex_);
+		auto It = Keys_->find(KeyId);
+		if (It != Keys_->end())
+			return It->second;
+		if (!KeyId.empty())
+			return nullptr;
+		//	A token without a key id is checked with the key file, or the only key there is.
+		if (FileKey_)
+			return FileKey_;
+		return Keys_->size() == 1 ? Keys_->begin()->second : nullptr;
+	}
+
+	TokenVerifier::Result TokenVerifier::Verify(const std::string &Token, uint64_t Now,
+												Claims &C) const {
+		if (std::count(Token.begin(), Token.end(), '.') != 2)
+			return Result::Unsupported;
+
+		std::string KeyId;
+		try {
+			const Poco::JWT::Token Unverified(Token);
+			if (ALGORITHMS.count(Unverified.getAlgorithm()) == 0)
+				return Result::Unsupported;
+			KeyId = Unverified.header().optValue<std::string>("kid", "");
+		} catch (...) {
+			return Result::Unsupported;
+		}
+
+		const auto Signer = SignerFor(KeyId);
+		if (!Signer)
+			return Result::UnknownKey;
+
+		Poco::JWT::Token Verified;
+		try {
+			if (!Signer->tryVerify(Token, Verified))
+				return Result::Invalid;
+		} catch (...) {
+			return Result::Invalid;
+		}
+
+		const auto &Payload = Verified.payload();
+		C.Subject = Verified.getSubject();
+		C.Issuer = Verified.getIssuer();
+		C.Email = Payload.optValue<std::string>("email", "");
+		if (C.Subject.empty() || !Payload.has("exp"))
+			return Result::Unsupported;
+		C.Expires = static_cast<uint64_t>(Verified.getExpiration().epochTime());
+		C.IssuedAt =
+			Payload.has("iat") ? static_cast<uint64_t>(Verified.getIssuedAt().epochTime()) : 0;
+
+		{
+			std::lock_guard G(Mutex_);
+			if (!Issuer_.empty() && C.Issuer != Issuer_)
+				return Result::Invalid;
+		}
+		if (Payload.has("nbf") &&
+			static_cast<uint64_t>(Verified.getNotBefore().epochTime()) > Now + CLOCK_SKEW)
+			return Result::Invalid;
+		if (C.Expires <= Now)
+			return Result::Expired;
+		return Result::Valid;
+	}
+
+} // namespace OpenWifi
@@ -0,0 +1,75 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "Poco/JSON/Object.h"
+#include "Poco/JWT/Signer.h"
+
+namespace OpenWifi {
+
+	//
+	// Checks the signature, expiry and subject of a JWT against the security service's public
+	// keys, without calling it. Keys come from a JWKS document (RSA keys given by modulus and
+	// exponent, or by certificate) selected by the token's "kid", and from a PEM file for
+	// tokens without one. Loading a new JWKS replaces the keys at once: tokens being
+	// verified keep the set they started with.
+	//
+	class TokenVerifier {
+	  public:
+		enum class Result {
+			Valid,
+			Expired,
+			Invalid,	//	bad signature, wrong issuer, or not valid yet
+			UnknownKey, //	signed with a key not loaded (yet)
+			Unsupported //	not a JWT, or without the claims needed to trust it here
+		};
+
+		struct Claims {
+			std::string Subject;
+			std::string Issuer;
+			std::string Email;
+			uint64_t IssuedAt = 0;
+			uint64_t Expires = 0;
+		};
+
+		//	Replaces the JWKS keys. Entries that are not RSA signing keys are skipped. Returns
+		//	the number of keys loaded; the previous keys are kept when there are none.
+		std::size_t LoadKeys(const Poco::JSON::Object::Ptr &JWKS);
+		//	A PEM public key, used for tokens without a key id.
+		bool LoadKeyFile(const std::string &FileName);
+		//	Tokens from another issuer are rejected. Empty accepts any. Set before verifying.
+		void SetIssuer(const std::string &Issuer);
+
+		//	Now is in seconds since the epoch. The claims are set when the token is valid or
+		//	expired.
+		Result Verify(const std::string &Token, uint64_t Now, Claims &C) const;
+
+		[[nodiscard]] std::size_t Keys() const;
+
+		//	Base64url (RFC 7515) without padding. Empty when malformed.
+		static std::string DecodeBase64Url(const std::string &Value);
+		//	The PEM public key of an RSA modulus and exponent, big-endian.
+		static std::string RSAPublicKeyPEM(const std::string &Modulus, const std::string &Exponent);
+
+	  private:
+		using Signers = std::map<std::string, std::shared_ptr<const Poco::JWT::Signer>>;
+
+		mutable std::mutex Mutex_;
+		std::shared_ptr<const Signers> Keys_ = std::make_shared<const Signers>();
+		std::shared_ptr<const Poco::JWT::Signer> FileKey_;
+		std::string Issuer_;
+
+		std::shared_ptr<const Poco::JWT::Signer> SignerFor(const std::string &KeyId) const;
+	};
+
+} // namespace OpenWifi
@@ -14,14 +14,21 @@
 #include <Poco/Timespan.h>
 #include <chrono>
 #include <algorithm>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <future>
 #include <regex>
 #include <sstream>
 #include "framework/RESTAPI_Handler.h"
 #include "RESTAPI/RESTAPI_topology_handler.h"
 
 #include "ConfigMaker.h"
+#include "GatewayConfigCache.h"
 #include "SDK_gw.h"
+#include "framework/MicroServiceFuncs.h"
 #include "framework/MicroServiceNames.h"
+#include "framework/OpenAPIExecutor.h"
 #include "framework/OpenAPIRequests.h"
 #include "framework/utils.h"
 
@@ -93,42 +100,63 @@ namespace OpenWifi::SDK::GW {
 			return ExecuteGatewayCommand(client, EndPoint, ObjRequest, ResponseStatus, Response);
 		}
 
-		bool GetLastStats(RESTAPIHandler *client, const std::string &Mac,
-						  Poco::JSON::Object::Ptr &Response) {
+		bool GetLastStats(RESTAPIHandler *client, const std::string &Mac, std::string &Response) {
 			// "https://${OWGW}/api/v1/device/$1/statistics?lastOnly=true"
 			std::string EndPoint = "/api/v1/device/" + Mac + "/statistics";
 			auto API = OpenAPIRequestGet(uSERVICE_GATEWAY, EndPoint, {{"lastOnly", "true"}}, 60000);
 			auto ResponseStatus =
 				API.Do(Response, client == nullptr ? "" : client->UserInfo_.webtoken.access_token_);
-			if (ResponseStatus == Poco::Net::HTTPServerResponse::HTTP_OK) {
-				try {
-					return true;
-				} catch (...) {
+			return ResponseStatus == Poco::Net::HTTPServerResponse::HTTP_OK;
+		}
+
+		namespace {
+			//	Fetches the device object from the controller and refreshes the cache with it.
+			bool FetchConfig(RESTAPIHandler *client, const std::string &Mac,
+							 Poco::Net::HTTPResponse::HTTPStatus &ResponseStatus,
+							 Poco::JSON::Object::Ptr &Response) {
+				const auto Generation = GatewayConfigCache()->Generation();
+				std::string EndPoint = "/api/v1/device/" + Mac;
+				auto API = OpenAPIRequestGet(uSERVICE_GATEWAY, EndPoint, {}, 1000);
+				ResponseStatus = API.Do(Response, client == nullptr
+													  ? ""
+													  : client->UserInfo_.webtoken.access_token_);
+				if (ResponseStatus != Poco::Net::HTTPServerResponse::HTTP_OK) {
+					Poco::Logger::get("SDK_gw").error(fmt::format(
+						"GetConfig: Could not get configuration from controller for device id {}. "
+						"Status={}",
+						Mac, int(ResponseStatus)));
 					return false;
 				}
+				if (!Response || !Response->has("configuration")) {
+					Poco::Logger::get("SDK_gw").error(fmt::format(
+						"GetConfig: Could not get configuration from controller for device id {}.",
+						Mac));
+					return false;
+				}
+				GatewayConfigCache()->Update(Mac, Response, Generation);
+				return true;
 			}
-			return false;
+		} // namespace
+
+		bool GetConfigSnapshot(RESTAPIHandler *client, const std::string &Mac,
+							   Poco::Net::HTTPResponse::HTTPStatus &ResponseStatus,
+							   Poco::JSON::Object::Ptr &Response) {
+			if (GatewayConfigCache()->Get(Mac, Response)) {
+				ResponseStatus = Poco::Net::HTTPServerResponse::HTTP_OK;
+				return true;
+			}
+			return FetchConfig(client, Mac, ResponseStatus, Response);
 		}
 
 		bool GetConfig(RESTAPIHandler *client, const std::string &Mac,
 					   Poco::Net::HTTPResponse::HTTPStatus &ResponseStatus,
 					   Poco::JSON::Object::Ptr &Response) {
-			std::string EndPoint = "/api/v1/device/" + Mac;
-			auto API = OpenAPIRequestGet(uSERVICE_GATEWAY, EndPoint, {}, 1000);
-			ResponseStatus =
-				API.Do(Response, client == nullptr ? "" : client->UserInfo_.webtoken.access_token_);
-			if (ResponseStatus != Poco::Net::HTTPServerResponse::HTTP_OK) {
-				Poco::Logger::get("SDK_gw").error(fmt::format(
-					"GetConfig: Could not get configuration from controller for device id {}. "
-					"Status={}",
-					Mac, int(ResponseStatus)));
-				return false;
-			}
-			if (!Response || !Response->has("configuration")) {
-				Poco::Logger::get("SDK_gw").error(fmt::format(
-					"GetConfig: Could not get configuration from controller for device id {}.", Mac));
+			//	Callers modify the configuration and push it back: start from the controller's
+			//	current one, not from a cached copy that may predate another change.
+			if (!FetchConfig(client, Mac, ResponseStatus, Response)) {
 				return false;
 			}
+			Response = GatewayConfigCache::Clone(Response);
 			return true;
 		}
 
@@ -235,13 +263,13 @@ namespace OpenWifi::SDK::GW {
 										   "/api/v1/device/" + Mac + "/configure", {}, Body, 90000);
 
 			ResponseStatus = R.Do(Response, client ? client->UserInfo_.webtoken.access_token_ : "");
-			if (ResponseStatus == Poco::Net::HTTPResponse::HTTP_OK) {
-				std::ostringstream os;
-				Poco::JSON::Stringifier::stringify(Response, os);
-				return true;
+			//	Even a failed or timed out request may have reached the device.
+			GatewayConfigCache()->Invalidate(Mac);
+			//	The controller may answer without a body.
+			if (!Response) {
+				Response = Poco::makeShared<Poco::JSON::Object>();
 			}
-
-			return false;
+			return ResponseStatus == Poco::Net::HTTPResponse::HTTP_OK;
 		}
 
 		/*
@@ -674,7 +702,8 @@ namespace OpenWifi::SDK::GW {
 			3. Apply requested SSID updates (if "ssid" is present in the request body).
 			4. Apply requested client block/unblock updates (if "client" is present in the request body).
 			5. Send the updated config to the gateway device.
-			6. If mesh devices exist and SSID changes were requested, build mesh config and push it to each mesh device.
+			6. If mesh devices exist and SSID changes were requested, build mesh config and push it to all mesh
+			   devices in parallel (at most mesh.configure.concurrency at a time) and report each node's result.
 		*/
 		static bool IsSameSerial(const std::string &lhs, const std::string &rhs) {
 			std::string normalizedLhs = lhs;
@@ -685,6 +714,79 @@ namespace OpenWifi::SDK::GW {
 			return lhs == rhs;
 		}
 
+		struct MeshConfigureResult {
+			std::string serialNumber;
+			Poco::Net::HTTPResponse::HTTPStatus status =
+				Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR;
+			Poco::JSON::Object::Ptr response;
+			bool success = false;
+		};
+
+		//	A configure that failed or timed out may still have reached the node, so it is not
+		//	retried: the next SSID change pushes the configuration again.
+		static MeshConfigureResult ConfigureMeshNode(RESTAPIHandler *client, const std::string &serialNumber,
+													 Poco::JSON::Object::Ptr configuration) {
+			MeshConfigureResult result;
+			result.serialNumber = serialNumber;
+			result.success = Configure(client, serialNumber, configuration, result.status, result.response);
+			return result;
+		}
+
+		//	Mesh configure calls can each take up to 90 s. Across all requests they hold at most half
+		//	of the OpenAPI executor's workers, so the short calls sharing it (gateway configuration
+		//	fetches for the topology, ...) are not starved. Calls over that limit run on the request
+		//	thread.
+		static std::atomic_uint64_t MeshCallsOnExecutor{0};
+
+		static bool AcquireMeshExecutorSlot() {
+			const auto limit = std::max<uint64_t>(1, OpenAPIExecutor()->Threads() / 2);
+			auto current = MeshCallsOnExecutor.load();
+			while (current < limit) {
+				if (MeshCallsOnExecutor.compare_exchange_weak(current, current + 1)) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/*
+			ConfigureMeshNodes():
+			Pushes meshConfig to every mesh serial, keeping at most mesh.configure.concurrency calls in
+			flight. Every node gets its own copy of the configuration because Configure() stamps a new
+			uuid into it. Results are returned in the order of meshSerials.
+		*/
+		static std::vector<MeshConfigureResult> ConfigureMeshNodes(RESTAPIHandler *client,
+																   const std::vector<std::string> &meshSerials,
+																   const Poco::JSON::Object::Ptr &meshConfig) {
+			const auto maxInFlight =
+				std::max<uint64_t>(1, MicroServiceConfigGetInt("mesh.configure.concurrency", 4));
+
+			std::vector<MeshConfigureResult> results(meshSerials.size());
+			std::deque<std::pair<std::size_t, std::future<MeshConfigureResult>>> inFlight;
+			for (std::size_t i = 0; i < meshSerials.size(); ++i) {
+				if (inFlight.size() >= maxInFlight) {
+					results[inFlight.front().first] = inFlight.front().second.get();
+					inFlight.pop_front();
+				}
+				auto configuration = GatewayConfigCache::Clone(meshConfig);
+				if (!AcquireMeshExecutorSlot()) {
+					results[i] = ConfigureMeshNode(client, meshSerials[i], configuration);
+					continue;
+				}
+				inFlight.emplace_back(
+					i, OpenAPIExecutor()->Async([client, serialNumber = meshSerials[i], configuration]() {
+						struct Release {
+							~Release() { --MeshCallsOnExecutor; }
+						} release;
+						return ConfigureMeshNode(client, serialNumber, configuration);
+					}));
+			}
+			for (auto &[index, future] : inFlight) {
+				results[index] = future.get();
+			}
+			return results;
+		}
+
 		bool SetConfig(RESTAPIHandler *client, const Poco::JSON::Object::Ptr &Body,
 					   const ProvObjects::SubscriberDeviceList &SubscriberDevices,
 					   const std::string &GatewaySerial, const std::string &SubscriberId,
@@ -769,25 +871,47 @@ namespace OpenWifi::SDK::GW {
 										RESTAPI::Errors::InternalError, ResponseStatus, Response);
 			}
 
+			std::vector<std::string> meshSerials;
 			for (const auto &subscriberDevice : SubscriberDevices.subscriberDevices) {
 				const auto &meshSerial = subscriberDevice.serialNumber;
 				if (meshSerial.empty() || IsSameSerial(meshSerial, GatewaySerial)) {
 					continue;
 				}
+				meshSerials.push_back(meshSerial);
+			}
+			if (meshSerials.empty()) {
+				return true;
+			}
 
-				Poco::JSON::Object::Ptr meshResponse;
-				Poco::Net::HTTPResponse::HTTPStatus meshStatus =
-					Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR;
-				if (!Configure(client, meshSerial, meshConfig, meshStatus, meshResponse)) {
-					ResponseStatus = meshStatus;
-					if (ResponseStatus == Poco::Net::HTTPResponse::HTTP_OK) {
-						ResponseStatus = Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR;
+			const auto results = ConfigureMeshNodes(client, meshSerials, meshConfig);
+			Poco::JSON::Array::Ptr meshResults = Poco::makeShared<Poco::JSON::Array>();
+			const MeshConfigureResult *firstFailure = nullptr;
+			for (const auto &result : results) {
+				Poco::JSON::Object::Ptr nodeResult = Poco::makeShared<Poco::JSON::Object>();
+				nodeResult->set("serialNumber", result.serialNumber);
+				nodeResult->set("success", result.success);
+				nodeResult->set("status", static_cast<int>(result.status));
+				meshResults->add(nodeResult);
+				if (!result.success) {
+					Poco::Logger::get("SDK_gw").error(
+						fmt::format("Mesh configure failed for {} (gateway {}): status={}",
+									result.serialNumber, GatewaySerial, static_cast<int>(result.status)));
+					if (!firstFailure) {
+						firstFailure = &result;
 					}
-					Response = meshResponse ? meshResponse : Poco::makeShared<Poco::JSON::Object>();
-					return false;
 				}
 			}
-			return true;
+
+			if (firstFailure) {
+				ResponseStatus = firstFailure->status;
+				if (ResponseStatus == Poco::Net::HTTPResponse::HTTP_OK) {
+					ResponseStatus = Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR;
+				}
+				Response = firstFailure->response ? firstFailure->response
+												  : Poco::makeShared<Poco::JSON::Object>();
+			}
+			Response->set("mesh", meshResults);
+			return firstFailure == nullptr;
 		}
 
 		struct Tag {
@@ -834,10 +958,16 @@ namespace OpenWifi::SDK::GW {
 				try {
 					TagList TL;
 					TL.from_json(Response);
+					//	The same MAC may be listed more than once.
+					std::map<std::string, std::vector<std::size_t>> Positions;
+					for (std::size_t i = 0; i < MacListPair.size(); ++i)
+						Positions[MacListPair[i].first].push_back(i);
 					for (const auto &i : TL.tagList) {
-						for (auto &j : MacListPair)
-							if (j.first == i.tag)
-								j.second = i.value;
+						auto It = Positions.find(i.tag);
+						if (It == Positions.end())
+							continue;
+						for (auto Position : It->second)
+							MacListPair[Position].second = i.value;
 					}
 					return true;
 				} catch (...) {
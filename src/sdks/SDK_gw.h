@@ -36,17 +36,23 @@ namespace OpenWifi::SDK::GW {
 					   Poco::JSON::Object::Ptr &Configuration,
 					   Poco::Net::HTTPResponse::HTTPStatus &ResponseStatus,
 					   Poco::JSON::Object::Ptr &Response);
+		// Returns a private copy of the device object that the caller may modify, always
+		// fetched from the controller (and refreshing the cache).
 		bool GetConfig(RESTAPIHandler *client, const std::string &Mac,
 					   Poco::Net::HTTPResponse::HTTPStatus &ResponseStatus,
 					   Poco::JSON::Object::Ptr &Response);
+		// Returns the shared, cached device object. It must not be modified.
+		bool GetConfigSnapshot(RESTAPIHandler *client, const std::string &Mac,
+							   Poco::Net::HTTPResponse::HTTPStatus &ResponseStatus,
+							   Poco::JSON::Object::Ptr &Response);
 		bool SetConfig(RESTAPIHandler *client, const Poco::JSON::Object::Ptr &Body,
 					   const ProvObjects::SubscriberDeviceList &SubscriberDevices,
 					   const std::string &GatewaySerial,
 					   const std::string &SubscriberId,
 					   Poco::Net::HTTPResponse::HTTPStatus &ResponseStatus,
 					   Poco::JSON::Object::Ptr &Response);
-		bool GetLastStats(RESTAPIHandler *client, const std::string &Mac,
-						  Poco::JSON::Object::Ptr &Response);
+		// Returns the raw statistics report, to be read with StatsDecoder.
+		bool GetLastStats(RESTAPIHandler *client, const std::string &Mac, std::string &Response);
 		bool GetOUIs(RESTAPIHandler *client, Types::StringPairVec &MacList);
 	} // namespace Device
 } // namespace OpenWifi::SDK::GW
@@ -0,0 +1,272 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+//
+// Load test of StatsSvr without a broker: the Kafka consumer replays a recording of the
+// topics (see openwifi.kafka.record.file and openwifi.kafka.replay.file) through its topic
+// workers and pauses, then this reports ingest throughput, callback latency and memory
+// growth. A synthetic fleet can be recorded from the stats_samples fixtures.
+//
+//	bench_kafka_replay synth <file> [devices] [reports] [sample]
+//	bench_kafka_replay replay <file> [speed] [workers]
+//
+// speed: 1 replays at the recorded pace, 10 ten times faster, 0 (the default) as fast as
+// possible.
+//
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "Poco/AutoPtr.h"
+#include "Poco/Util/Application.h"
+
+#include "StatsSvr.h"
+#include "framework/KafkaManager.h"
+#include "framework/KafkaRecording.h"
+#include "sdks/SDK_gw.h"
+
+#ifndef STATS_SAMPLES_DIR
+#define STATS_SAMPLES_DIR "stats_samples"
+#endif
+
+namespace {
+
+std::map<std::string, uint64_t> g_config;
+std::map<std::string, std::string> g_paths;
+
+std::string LoadSample(const std::string &Path) {
+    std::ifstream in(Path);
+    if (!in.good())
+        return {};
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+uint64_t ResidentBytes() {
+    std::ifstream in("/proc/self/statm");
+    uint64_t Size = 0, Resident = 0;
+    in >> Size >> Resident;
+    return Resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+// Every device reports once per minute, spread over the minute, like a fleet on the gateway.
+int Synthesize(const std::string &File, uint64_t Devices, uint64_t Reports, const std::string &Sample) {
+    auto State = LoadSample(std::string(STATS_SAMPLES_DIR) + "/" + Sample);
+    const auto LocalTime = State.find("\"localtime\":");
+    if (State.empty() || LocalTime == std::string::npos) {
+        std::cerr << "cannot use " << STATS_SAMPLES_DIR << "/" << Sample << std::endl;
+        return 1;
+    }
+    const auto ValueStart = State.find_first_of("0123456789", LocalTime);
+    const auto ValueEnd = State.find_first_not_of("0123456789", ValueStart);
+    const auto Prefix = State.substr(0, ValueStart), Suffix = State.substr(ValueEnd);
+
+    OpenWifi::KafkaRecordWriter Writer;
+    if (!Writer.Open(File)) {
+        std::cerr << "cannot create " << File << std::endl;
+        return 1;
+    }
+    const uint64_t Start = 1700000000;
+    for (uint64_t Report = 0; Report < Reports; ++Report) {
+        for (uint64_t Device = 0; Device < Devices; ++Device) {
+            std::ostringstream Serial;
+            Serial << std::hex << std::setw(12) << std::setfill('0') << (0x24f5a2000000ull + Device);
+            const auto Offset = Report * 60000000 + Device * 60000000 / Devices;
+            const auto Message = R"({"payload":{"serial":")" + Serial.str() + R"(","state":)" + Prefix +
+                                 std::to_string(Start + Offset / 1000000) + Suffix + "}}";
+            if (!Writer.Write(Start * 1000000 + Offset, OpenWifi::KafkaTopics::STATE, Serial.str(), Message)) {
+                std::cerr << "cannot write " << File << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << Writer.Records() << " messages, " << Writer.Bytes() / (1024 * 1024) << " MB written to " << File
+              << std::endl;
+    return 0;
+}
+
+Poco::JSON::Object::Ptr ConsumerStats() {
+    Poco::JSON::Object Stats;
+    OpenWifi::KafkaManager()->GetStats(Stats);
+    return Stats.getObject("consumer");
+}
+
+int Replay(const std::string &File) {
+    OpenWifi::KafkaRecordReader Reader;
+    if (!Reader.Open(File)) {
+        std::cerr << "cannot read " << File << std::endl;
+        return 1;
+    }
+    g_paths["openwifi.kafka.replay.file"] = File;
+    g_config["openwifi.kafka.enable"] = 1;
+
+    // The watchers are registered before the consumer starts, as in the service.
+    Poco::AutoPtr<Poco::Util::Application> App(new Poco::Util::Application);
+    OpenWifi::KafkaManager()->initialize(*App);
+    const auto MemoryBefore = ResidentBytes();
+    OpenWifi::StatsSvr()->Start();
+    const auto Start = std::chrono::steady_clock::now();
+    OpenWifi::KafkaManager()->Start();
+
+    // Wait for the whole recording to be read and handed to the watchers, then for the
+    // ingest workers to catch up.
+    Poco::JSON::Object::Ptr Consumer, Topic;
+    for (;;) {
+        Consumer = ConsumerStats();
+        auto Replay = Consumer->getObject("replay");
+        auto Topics = Consumer->getObject("topics");
+        Topic = Topics->getObject(OpenWifi::KafkaTopics::STATE);
+        if (!Replay.isNull() && Replay->getValue<bool>("done") &&
+            (Topic.isNull() || Topic->getValue<uint64_t>("processed") == Topic->getValue<uint64_t>("messages")))
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    const auto Replayed = std::chrono::steady_clock::now();
+    uint64_t Processed = 0, Dropped = 0, Received = 0;
+    for (;;) {
+        Poco::JSON::Object Stats;
+        OpenWifi::StatsSvr()->GetStats(Stats);
+        auto Ingest = Stats.getObject("ingest");
+        Received = Ingest->getValue<uint64_t>("received");
+        Processed = Ingest->getValue<uint64_t>("processed");
+        Dropped = Ingest->getValue<uint64_t>("dropped");
+        if (Processed + Dropped >= Received)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    const auto Now = std::chrono::steady_clock::now();
+    const auto ReplaySeconds = std::chrono::duration<double>(Replayed - Start).count();
+    const auto Seconds = std::chrono::duration<double>(Now - Start).count();
+
+    Poco::JSON::Object Stats;
+    OpenWifi::StatsSvr()->GetStats(Stats);
+    const auto MemoryAfter = ResidentBytes();
+
+    const auto Messages = Consumer->getObject("replay")->getValue<uint64_t>("messages");
+    const auto Truncated = Consumer->getObject("replay")->getValue<bool>("truncated");
+    uint64_t Watched = 0, Bytes = 0, Pauses = 0;
+    if (!Topic.isNull()) {
+        Watched = Topic->getValue<uint64_t>("messages");
+        Bytes = Topic->getValue<uint64_t>("bytes");
+        Pauses = Topic->getValue<uint64_t>("pauses");
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "messages        " << Messages << (Truncated ? " (truncated recording)" : "") << std::endl;
+    std::cout << "unwatched       " << Messages - Watched << std::endl;
+    std::cout << "replay          " << ReplaySeconds << " s, " << Pauses << " pauses" << std::endl;
+    std::cout << "ingest          " << Seconds << " s, " << Processed / std::max(Seconds, 1e-9) << " msg/s, "
+              << Bytes / std::max(Seconds, 1e-9) / (1024 * 1024) << " MB/s" << std::endl;
+    std::cout << "dropped         " << Dropped << std::endl;
+    if (!Topic.isNull()) {
+        // The consumer keeps a histogram of the time spent in the watchers of each message.
+        auto Latency = Topic->getObject("callbackLatency");
+        std::string Buckets;
+        for (const auto *Bucket : {"100us", "1ms", "10ms", "100ms", "1s", "more"})
+            Buckets += (Buckets.empty() ? "" : ", ") + std::string(Bucket) + " " +
+                       std::to_string(Latency->getValue<uint64_t>(Bucket));
+        std::cout << "callback        " << Buckets << std::endl;
+    }
+    std::cout << "devices         " << Stats.getValue<uint64_t>("devices") << std::endl;
+    std::cout << "store           " << Stats.getValue<uint64_t>("memory") / (1024 * 1024) << " MB" << std::endl;
+    std::cout << "resident growth " << (static_cast<double>(MemoryAfter) - static_cast<double>(MemoryBefore)) /
+                                           (1024 * 1024)
+              << " MB" << std::endl;
+
+    OpenWifi::StatsSvr()->Stop();
+    OpenWifi::KafkaManager()->Stop();
+    return Truncated ? 1 : 0;
+}
+
+} // namespace
+
+namespace OpenWifi::SDK::GW::Device {
+bool GetLastStats(RESTAPIHandler *, const std::string &, std::string &) { return false; }
+} // namespace OpenWifi::SDK::GW::Device
+
+#include "../../src/StatsDecoder.cpp"
+#include "../../src/StatsSnapshot.cpp"
+#include "../../src/StatsSvr.cpp"
+#include "../../src/TrafficHistory.cpp"
+#include "../../src/framework/KafkaManager.cpp"
+#include "../../src/framework/KafkaRecording.cpp"
+
+namespace OpenWifi {
+    SubSystemServer::SubSystemServer(const std::string &Name, const std::string &LoggingPrefix,
+                                     const std::string &SubSystemConfigPrefix)
+        : Name_(Name), LoggerPrefix_(LoggingPrefix), SubSystemConfigPrefix_(SubSystemConfigPrefix),
+          Logger_(std::make_unique<LoggerWrapper>(Poco::Logger::get(LoggingPrefix))) {}
+
+    void SubSystemServer::initialize(Poco::Util::Application &) {}
+
+    std::uint64_t MicroServiceConfigGetInt(const std::string &Key, std::uint64_t DefaultValue) {
+        auto it = g_config.find(Key);
+        return it == g_config.end() ? DefaultValue : it->second;
+    }
+
+    std::string MicroServiceConfigGetString(const std::string &, const std::string &DefaultValue) {
+        return DefaultValue;
+    }
+
+    bool MicroServiceConfigGetBool(const std::string &Key, bool DefaultValue) {
+        auto it = g_config.find(Key);
+        return it == g_config.end() ? DefaultValue : it->second != 0;
+    }
+
+    std::string MicroServiceConfigPath(const std::string &Key, const std::string &DefaultValue) {
+        auto it = g_paths.find(Key);
+        return it == g_paths.end() ? DefaultValue : it->second;
+    }
+
+    std::uint64_t MicroServiceID() { return 1; }
+    std::string MicroServicePrivateEndPoint() { return "bench_kafka_replay"; }
+
+    const std::string &MicroServiceDataDirectory() {
+        static const std::string directory = std::filesystem::temp_directory_path().string();
+        return directory;
+    }
+}
+
+namespace OpenWifi::Utils {
+    bool ValidSerialNumber(const std::string &Serial) {
+        return Serial.size() == 12 &&
+               std::all_of(Serial.begin(), Serial.end(), [](unsigned char c) { return std::isxdigit(c) != 0; });
+    }
+    uint64_t SerialNumberToInt(const std::string &S) { return std::stoull(S, nullptr, 16); }
+}
+
+int main(int argc, char **argv) {
+    const std::string Mode = argc > 2 ? argv[1] : "";
+    if (Mode == "synth") {
+        return Synthesize(argv[2], argc > 3 ? std::max(1L, std::atol(argv[3])) : 100000,
+                          argc > 4 ? std::max(1L, std::atol(argv[4])) : 2, argc > 5 ? argv[5] : "nat_stats.json");
+    }
+    if (Mode == "replay") {
+        // Traffic histories are not checkpointed: the snapshot would measure the disk.
+        g_config["statscache.snapshot.interval"] = 0;
+        if (argc > 4)
+            g_config["statscache.workers"] = std::max(1L, std::atol(argv[4]));
+        g_config["openwifi.kafka.replay.speed"] = argc > 3 ? std::max(0L, std::atol(argv[3])) : 0;
+        return Replay(argv[2]);
+    }
+    std::cerr << "usage: " << argv[0] << " synth <file> [devices] [reports] [sample]" << std::endl
+              << "       " << argv[0] << " replay <file> [speed] [workers]" << std::endl;
+    return 2;
+}
@@ -0,0 +1,165 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+//
+// Compares the state message decoder with the nlohmann document path it replaced, on the
+// stats_samples fixtures wrapped as state topic messages.
+//
+//	bench_stats_decoder [iterations] [samples directory]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+#include "../../src/StatsDecoder.cpp"
+
+#ifndef STATS_SAMPLES_DIR
+#define STATS_SAMPLES_DIR "stats_samples"
+#endif
+
+namespace {
+
+struct Traffic {
+    std::string Serial;
+    uint64_t LocalTime = 0;
+    uint64_t ExtRx = 0, ExtTx = 0, IntRx = 0, IntTx = 0;
+
+    bool operator==(const Traffic &O) const {
+        return Serial == O.Serial && LocalTime == O.LocalTime && ExtRx == O.ExtRx && ExtTx == O.ExtTx &&
+               IntRx == O.IntRx && IntTx == O.IntTx;
+    }
+};
+
+// The original StatsSvr ingest: full document, subtrees copied by value.
+bool DocumentPath(const std::string &Payload, Traffic &T) {
+    try {
+        nlohmann::json msg = nlohmann::json::parse(Payload);
+        if (!msg.contains("payload"))
+            return false;
+        auto payload = msg["payload"];
+        if (!payload.contains("state") || !payload.contains("serial"))
+            return false;
+        T.Serial = payload["serial"].get<std::string>();
+        auto state = payload["state"];
+        if (!state.contains("version") || !state.contains("unit"))
+            return false;
+        auto unit = state["unit"];
+        if (!unit.contains("localtime"))
+            return false;
+        T.LocalTime = unit["localtime"];
+        if (!state.contains("interfaces") || !state["interfaces"].is_array())
+            return false;
+        auto interfaces = state["interfaces"];
+        T.ExtRx = T.ExtTx = T.IntRx = T.IntTx = 0;
+        for (const auto &cur_int : interfaces) {
+            bool external_stats = true;
+            if (cur_int.contains("location")) {
+                auto location = cur_int["location"].get<std::string>();
+                if (std::count(location.begin(), location.end(), '/') == 2)
+                    external_stats = location.substr(location.rfind('/') + 1) == "0";
+            }
+            if (cur_int.contains("counters") && cur_int["counters"].contains("rx_bytes") &&
+                cur_int["counters"].contains("tx_bytes")) {
+                auto &rx = external_stats ? T.ExtRx : T.IntRx;
+                auto &tx = external_stats ? T.ExtTx : T.IntTx;
+                rx = cur_int["counters"]["rx_bytes"].get<uint64_t>();
+                tx = cur_int["counters"]["tx_bytes"].get<uint64_t>();
+            }
+        }
+        return true;
+    } catch (...) {
+    }
+    return false;
+}
+
+// The current StatsSvr ingest. The decoder also keeps the client snapshot served by the
+// client list handlers, so that work is part of the measurement.
+bool DecoderPath(const std::string &Payload, Traffic &T) {
+    OpenWifi::DeviceStatistics Stats;
+    if (!OpenWifi::StatsDecoder::DecodeStateMessage(Payload, Stats) || Stats.Serial.empty() ||
+        !Stats.HasInterfaces || !Stats.HasVersion || !Stats.HasLocalTime)
+        return false;
+    T.Serial = Stats.Serial;
+    T.LocalTime = Stats.LocalTime;
+    T.ExtRx = T.ExtTx = T.IntRx = T.IntTx = 0;
+    for (const auto &I : Stats.Interfaces) {
+        if (!I.HasCounters())
+            continue;
+        (I.External() ? T.ExtRx : T.IntRx) = I.RxBytes;
+        (I.External() ? T.ExtTx : T.IntTx) = I.TxBytes;
+    }
+    return true;
+}
+
+template <typename Path> double NanosPerMessage(Path P, const std::string &Payload, int Iterations) {
+    Traffic T;
+    auto Start = std::chrono::steady_clock::now();
+    for (int i = 0; i < Iterations; ++i) {
+        if (!P(Payload, T))
+            std::abort();
+    }
+    auto Elapsed = std::chrono::steady_clock::now() - Start;
+    return std::chrono::duration<double, std::nano>(Elapsed).count() / Iterations;
+}
+
+std::string LoadSample(const std::string &Path) {
+    std::ifstream in(Path);
+    if (!in.good())
+        return {};
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int Iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 2000;
+    std::string Dir = argc > 2 ? argv[2] : STATS_SAMPLES_DIR;
+
+    std::cout << std::left << std::setw(20) << "sample" << std::right << std::setw(10) << "bytes"
+              << std::setw(14) << "document us" << std::setw(14) << "decoder us" << std::setw(14)
+              << "decoder MB/s" << std::setw(10) << "speedup" << std::endl;
+
+    int Failures = 0;
+    for (const auto &Name : {"bridge_stats.json", "nat_stats.json"}) {
+        auto State = LoadSample(Dir + "/" + Name);
+        if (State.empty()) {
+            std::cerr << "cannot open " << Dir << "/" << Name << std::endl;
+            return 1;
+        }
+        auto Message = R"({"payload":{"serial":"24f5a2aabbcc","state":)" + State + "}}";
+
+        Traffic Expected, Actual;
+        if (!DocumentPath(Message, Expected) || !DecoderPath(Message, Actual) || !(Expected == Actual)) {
+            std::cerr << Name << ": decoder and document path disagree" << std::endl;
+            ++Failures;
+            continue;
+        }
+
+        // Warm up both paths before timing.
+        NanosPerMessage(DocumentPath, Message, std::max(1, Iterations / 10));
+        NanosPerMessage(DecoderPath, Message, std::max(1, Iterations / 10));
+        auto Document = NanosPerMessage(DocumentPath, Message, Iterations);
+        auto Decoder = NanosPerMessage(DecoderPath, Message, Iterations);
+
+        std::cout << std::left << std::setw(20) << Name << std::right << std::setw(10) << Message.size()
+                  << std::fixed << std::setprecision(1) << std::setw(14) << Document / 1000.0 << std::setw(14)
+                  << Decoder / 1000.0 << std::setw(14) << Message.size() * 1000.0 / Decoder << std::setw(9)
+                  << Document / Decoder << "x" << std::endl;
+    }
+    return Failures == 0 ? 0 : 1;
+}
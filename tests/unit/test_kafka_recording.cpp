@@ -0,0 +1,180 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../../src/framework/KafkaRecording.cpp"
+
+namespace {
+
+class TestFailure : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+void Expect(bool condition, const std::string &message) {
+    if (!condition) {
+        throw TestFailure(message);
+    }
+}
+
+template <typename T, typename U> void ExpectEq(const T &actual, const U &expected, const std::string &message) {
+    if (!(actual == expected)) {
+        std::ostringstream os;
+        os << message << " expected=" << expected << " actual=" << actual;
+        throw TestFailure(os.str());
+    }
+}
+
+std::string TempFile(const std::string &name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+const std::vector<OpenWifi::KafkaRecord> kRecords = {
+    {1700000000000000, "state", "112233445566", R"({"payload":{"serial":"112233445566"}})"},
+    {1700000000000250, "service_events", "", ""},
+    {1699999999999000, "state", "223344556677", std::string(100000, 'x')},
+};
+
+void WriteRecords(const std::string &file) {
+    OpenWifi::KafkaRecordWriter writer;
+    Expect(writer.Open(file), "recording created");
+    for (const auto &record : kRecords) {
+        Expect(writer.Write(record), "record written");
+    }
+    ExpectEq(writer.Records(), kRecords.size(), "records written");
+    writer.Close();
+    ExpectEq(static_cast<uint64_t>(std::filesystem::file_size(file)), writer.Bytes(), "bytes written");
+}
+
+void TestRoundTrip() {
+    const auto file = TempFile("test_kafka_recording.bin");
+    WriteRecords(file);
+
+    OpenWifi::KafkaRecordReader reader;
+    Expect(reader.Open(file), "recording opened");
+    OpenWifi::KafkaRecord record;
+    for (const auto &expected : kRecords) {
+        Expect(reader.Next(record), "record read");
+        ExpectEq(record.TimeStamp, expected.TimeStamp, "timestamp, even going back");
+        ExpectEq(record.Topic, expected.Topic, "topic");
+        ExpectEq(record.Key, expected.Key, "key");
+        Expect(record.Payload == expected.Payload, "payload");
+    }
+    Expect(!reader.Next(record), "end of the recording");
+    Expect(!reader.Truncated(), "complete recording");
+
+    const auto overhead = std::filesystem::file_size(file) - 8;
+    std::size_t content = 0;
+    for (const auto &r : kRecords) {
+        content += r.Topic.size() + r.Key.size() + r.Payload.size();
+    }
+    Expect(overhead - content <= 6 * kRecords.size() + 6, "a few bytes per record");
+    std::filesystem::remove(file);
+}
+
+void TestTruncatedRecording() {
+    const auto file = TempFile("test_kafka_recording_truncated.bin");
+    WriteRecords(file);
+    std::filesystem::resize_file(file, std::filesystem::file_size(file) - 10);
+
+    OpenWifi::KafkaRecordReader reader;
+    Expect(reader.Open(file), "recording opened");
+    OpenWifi::KafkaRecord record;
+    Expect(reader.Next(record) && reader.Next(record), "complete records read");
+    Expect(!reader.Next(record), "truncated record not returned");
+    Expect(reader.Truncated(), "truncation reported");
+    std::filesystem::remove(file);
+
+    Expect(!reader.Open(file), "missing file");
+    {
+        std::ofstream other(file);
+        other << "not a recording";
+    }
+    Expect(!reader.Open(file), "other files rejected");
+    std::filesystem::remove(file);
+}
+
+void TestReplayPacing() {
+    const auto file = TempFile("test_kafka_recording_replay.bin");
+    {
+        OpenWifi::KafkaRecordWriter writer;
+        Expect(writer.Open(file), "recording created");
+        for (uint64_t i = 0; i < 5; ++i) {
+            writer.Write(1000000 + i * 100000, "state", std::to_string(i), "payload");
+        }
+    }
+
+    std::vector<std::string> keys;
+    auto watcher = [&keys](const std::string &topic, const std::string &key, const std::string &payload) {
+        Expect(topic == "state" && payload == "payload", "record content");
+        keys.push_back(key);
+    };
+
+    OpenWifi::KafkaRecordReader reader;
+    Expect(reader.Open(file), "recording opened");
+    auto paced = OpenWifi::KafkaReplay::Run(reader, 10.0, watcher);
+    ExpectEq(paced.Messages, 5u, "every message replayed");
+    ExpectEq(paced.Bytes, 5u * (1 + 7), "key and payload bytes");
+    Expect(paced.Seconds >= 0.04, "400ms recorded, replayed ten times faster");
+    ExpectEq(keys.front() + keys.back(), std::string("04"), "recorded order");
+
+    Expect(reader.Open(file), "recording reopened");
+    auto fast = OpenWifi::KafkaReplay::Run(reader, 0.0, watcher);
+    ExpectEq(fast.Messages, 5u, "every message replayed again");
+    Expect(fast.Seconds < paced.Seconds, "as fast as possible");
+    Expect(fast.P50 <= fast.P99 && fast.P99 <= fast.Max, "ordered percentiles");
+    std::filesystem::remove(file);
+}
+
+void TestPercentiles() {
+    std::vector<uint32_t> values;
+    for (uint32_t i = 100; i >= 1; --i) {
+        values.push_back(i);
+    }
+    ExpectEq(OpenWifi::KafkaReplay::Percentile(values, 50), 50u, "median");
+    ExpectEq(OpenWifi::KafkaReplay::Percentile(values, 99), 99u, "99th percentile");
+    ExpectEq(OpenWifi::KafkaReplay::Percentile(values, 100), 100u, "maximum");
+    ExpectEq(OpenWifi::KafkaReplay::Percentile(values, 0), 1u, "minimum");
+    values.clear();
+    ExpectEq(OpenWifi::KafkaReplay::Percentile(values, 50), 0u, "no values");
+}
+
+const std::vector<std::pair<std::string, std::function<void()>>> kTests = {
+    {"RoundTrip", TestRoundTrip},
+    {"TruncatedRecording", TestTruncatedRecording},
+    {"ReplayPacing", TestReplayPacing},
+    {"Percentiles", TestPercentiles},
+};
+
+} // namespace
+
+int main() {
+    int failures = 0;
+    for (const auto &test : kTests) {
+        try {
+            test.second();
+            std::cout << "[PASS] " << test.first << std::endl;
+        } catch (const std::exception &e) {
+            ++failures;
+            std::cerr << "[FAIL] " << test.first << ": " << e.what() << std::endl;
+        }
+    }
+
+    if (failures != 0) {
+        std::cerr << failures << " test(s) failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << kTests.size() << " test(s) passed." << std::endl;
+    return 0;
+}
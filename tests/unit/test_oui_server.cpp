@@ -0,0 +1,268 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Poco/File.h"
+#include "Poco/Path.h"
+#include "Poco/TemporaryFile.h"
+
+#include "OUIServer.h"
+#include "sdks/SDK_gw.h"
+
+namespace {
+
+class TestFailure : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+void Expect(bool condition, const std::string &message) {
+    if (!condition) {
+        throw TestFailure(message);
+    }
+}
+
+template <typename T, typename U> void ExpectEq(const T &actual, const U &expected, const std::string &message) {
+    if (!(actual == expected)) {
+        std::ostringstream os;
+        os << message << " expected=" << expected << " actual=" << actual;
+        throw TestFailure(os.str());
+    }
+}
+
+struct GatewayStubState {
+    // Vendor returned by the gateway service for each prefix.
+    std::map<uint32_t, std::string> vendors;
+    bool fail = false;
+    std::vector<std::size_t> requestSizes;
+};
+
+GatewayStubState g_state;
+
+void ResetState() { g_state = GatewayStubState{}; }
+
+std::string Lookup(const std::shared_ptr<const OpenWifi::OUIIndex> &index, uint32_t prefix) {
+    std::string_view vendor;
+    if (!index->Lookup(prefix, vendor)) {
+        return "<missing>";
+    }
+    return std::string(vendor);
+}
+
+void WriteFile(const std::string &name, const std::string &content) {
+    std::ofstream out(name, std::ios::binary | std::ios::trunc);
+    out.write(content.data(), static_cast<std::streamsize>(content.size()));
+}
+
+} // namespace
+
+namespace OpenWifi::SDK::GW::Device {
+
+bool GetOUIs(RESTAPIHandler *, Types::StringPairVec &MacList) {
+    g_state.requestSizes.push_back(MacList.size());
+    if (g_state.fail) {
+        return false;
+    }
+    for (auto &[mac, vendor] : MacList) {
+        uint32_t prefix = 0;
+        if (OUIIndex::MacToPrefix(mac, prefix)) {
+            auto it = g_state.vendors.find(prefix);
+            vendor = it == g_state.vendors.end() ? "" : it->second;
+        }
+    }
+    return true;
+}
+
+} // namespace OpenWifi::SDK::GW::Device
+
+#include "../../src/OUIServer.cpp"
+
+namespace {
+
+void TestIndexLookupAndInterning() {
+    std::map<uint32_t, std::string> entries{
+        {0x001122, "Acme"}, {0x334455, "Acme"}, {0xa4b1c2, "Globex"}, {0xffffff, ""}};
+    auto image = OpenWifi::OUIIndex::Serialize(entries);
+    auto index = OpenWifi::OUIIndex::FromImage(image);
+    Expect(index != nullptr, "serialized image should load");
+    ExpectEq(index->Size(), 4u, "every prefix should be stored");
+    ExpectEq(Lookup(index, 0x001122), std::string("Acme"), "first prefix");
+    ExpectEq(Lookup(index, 0x334455), std::string("Acme"), "second prefix sharing a vendor");
+    ExpectEq(Lookup(index, 0xa4b1c2), std::string("Globex"), "third prefix");
+    ExpectEq(Lookup(index, 0xffffff), std::string(""), "known prefix without vendor");
+    ExpectEq(Lookup(index, 0x000000), std::string("<missing>"), "unknown prefix");
+    Expect(image.find("AcmeAcme") == std::string::npos, "vendor strings should be interned");
+
+    std::map<uint32_t, std::string> roundTrip;
+    index->Entries(roundTrip);
+    Expect(roundTrip == entries, "entries should round-trip");
+
+    auto empty = OpenWifi::OUIIndex::FromImage(OpenWifi::OUIIndex::Serialize({}));
+    Expect(empty != nullptr, "empty table should load");
+    ExpectEq(Lookup(empty, 0x001122), std::string("<missing>"), "empty table has no prefixes");
+}
+
+void TestFileRoundTripAndCorruptionRejected() {
+    Poco::TemporaryFile file;
+    std::map<uint32_t, std::string> entries;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        entries[i * 4099] = "Vendor " + std::to_string(i % 37);
+    }
+    auto image = OpenWifi::OUIIndex::Serialize(entries);
+
+    WriteFile(file.path(), image);
+    auto mapped = OpenWifi::OUIIndex::FromFile(file.path());
+    Expect(mapped != nullptr, "written table should map");
+    ExpectEq(mapped->Size(), 1000u, "mapped table size");
+    ExpectEq(Lookup(mapped, 999 * 4099), std::string("Vendor 0"), "mapped lookup");
+
+    WriteFile(file.path(), image.substr(0, image.size() - 1));
+    Expect(OpenWifi::OUIIndex::FromFile(file.path()) == nullptr, "truncated table should be rejected");
+
+    auto badMagic = image;
+    badMagic[0] = 'X';
+    WriteFile(file.path(), badMagic);
+    Expect(OpenWifi::OUIIndex::FromFile(file.path()) == nullptr, "foreign file should be rejected");
+
+    Expect(OpenWifi::OUIIndex::FromFile(file.path() + ".missing") == nullptr, "missing file should be ignored");
+}
+
+void TestMacToPrefix() {
+    uint32_t prefix = 0;
+    Expect(OpenWifi::OUIIndex::MacToPrefix("a4:B1:c2:00:11:22", prefix), "colon notation");
+    ExpectEq(prefix, 0xa4b1c2u, "colon notation prefix");
+    Expect(OpenWifi::OUIIndex::MacToPrefix("A4-B1-C2-00-11-22", prefix), "dash notation");
+    ExpectEq(prefix, 0xa4b1c2u, "dash notation prefix");
+    Expect(OpenWifi::OUIIndex::MacToPrefix("a4b1.c200.1122", prefix), "dotted notation");
+    ExpectEq(prefix, 0xa4b1c2u, "dotted notation prefix");
+    Expect(!OpenWifi::OUIIndex::MacToPrefix("a4:b1", prefix), "short MAC");
+    Expect(!OpenWifi::OUIIndex::MacToPrefix("zz:b1:c2:00:11:22", prefix), "non hex MAC");
+}
+
+void TestSetManufacturersAsksOnlyForMisses() {
+    g_state.vendors = {{0x101010, "Initech"}, {0x202020, "Hooli"}};
+    std::vector<std::string> macs{"10:10:10:00:00:01", "10:10:10:00:00:02", "20:20:20:00:00:01", "bad"};
+    std::vector<std::string> manufacturers(macs.size());
+    std::vector<std::pair<const std::string *, std::string *>> clients;
+    for (std::size_t i = 0; i < macs.size(); ++i) {
+        clients.emplace_back(&macs[i], &manufacturers[i]);
+    }
+
+    OpenWifi::OUIServer()->SetManufacturers(clients);
+    Expect(g_state.requestSizes.empty(), "client lists should not wait for the gateway");
+    for (const auto &manufacturer : manufacturers) {
+        ExpectEq(manufacturer, std::string(""), "unknown prefixes are left empty");
+    }
+
+    Expect(OpenWifi::OUIServer()->ResolveUnknown(), "misses should be resolved in the background");
+    ExpectEq(g_state.requestSizes.size(), static_cast<std::size_t>(1), "misses should be asked in one request");
+    ExpectEq(g_state.requestSizes[0], static_cast<std::size_t>(2), "one MAC per unknown prefix");
+    Expect(OpenWifi::OUIServer()->ApplyLearned(), "learned prefixes should be added");
+    Expect(!OpenWifi::OUIServer()->ApplyLearned(), "nothing left to add");
+
+    OpenWifi::OUIServer()->SetManufacturers(clients);
+    Expect(OpenWifi::OUIServer()->ResolveUnknown(), "nothing to resolve");
+    ExpectEq(g_state.requestSizes.size(), static_cast<std::size_t>(1), "known prefixes should not reach the gateway");
+    ExpectEq(manufacturers[0], std::string("Initech"), "first client");
+    ExpectEq(manufacturers[1], std::string("Initech"), "client sharing a prefix");
+    ExpectEq(manufacturers[2], std::string("Hooli"), "third client");
+    ExpectEq(manufacturers[3], std::string(""), "invalid MAC is left alone");
+}
+
+void TestFailedLookupLeavesTableUnchanged() {
+    g_state.fail = true;
+    std::string mac = "30:30:30:00:00:01";
+    std::string manufacturer;
+    OpenWifi::OUIServer()->SetManufacturers({{&mac, &manufacturer}});
+    Expect(!OpenWifi::OUIServer()->ResolveUnknown(), "lookup should fail");
+    ExpectEq(manufacturer, std::string(""), "no manufacturer when the gateway cannot answer");
+    Expect(!OpenWifi::OUIServer()->ApplyLearned(), "nothing should be learned from a failed request");
+    ExpectEq(Lookup(OpenWifi::OUIServer()->Index(), 0x303030), std::string("<missing>"), "prefix stays unknown");
+}
+
+void TestRefreshAllUpdatesVendors() {
+    g_state.vendors = {{0x404040, "Old Name"}};
+    OpenWifi::OUIServer()->Learn({{"40:40:40:00:00:01", "Old Name"}});
+    OpenWifi::OUIServer()->ApplyLearned();
+    const auto known = OpenWifi::OUIServer()->Index()->Size();
+
+    g_state.fail = true;
+    Expect(!OpenWifi::OUIServer()->RefreshAll(), "failed refresh should keep the table");
+    ExpectEq(Lookup(OpenWifi::OUIServer()->Index(), 0x404040), std::string("Old Name"), "table kept");
+
+    g_state.fail = false;
+    g_state.requestSizes.clear();
+    g_state.vendors[0x404040] = "New Name";
+    g_state.vendors[0x101010] = "Initech";
+    g_state.vendors[0x202020] = "Hooli";
+    Expect(OpenWifi::OUIServer()->RefreshAll(), "refresh should pick up the new vendor");
+    ExpectEq(Lookup(OpenWifi::OUIServer()->Index(), 0x404040), std::string("New Name"), "vendor refreshed");
+    ExpectEq(OpenWifi::OUIServer()->Index()->Size(), known, "refresh should not add prefixes");
+    std::size_t asked = 0;
+    for (auto size : g_state.requestSizes) {
+        Expect(size <= 100, "refresh requests should be batched");
+        asked += size;
+    }
+    ExpectEq(asked, static_cast<std::size_t>(known), "every known prefix should be asked");
+}
+
+const std::vector<std::pair<std::string, std::function<void()>>> kTests = {
+    {"IndexLookupAndInterning", TestIndexLookupAndInterning},
+    {"FileRoundTripAndCorruptionRejected", TestFileRoundTripAndCorruptionRejected},
+    {"MacToPrefix", TestMacToPrefix},
+    {"SetManufacturersAsksOnlyForMisses", TestSetManufacturersAsksOnlyForMisses},
+    {"FailedLookupLeavesTableUnchanged", TestFailedLookupLeavesTableUnchanged},
+    {"RefreshAllUpdatesVendors", TestRefreshAllUpdatesVendors},
+};
+
+} // namespace
+
+namespace OpenWifi {
+    SubSystemServer::SubSystemServer(const std::string &Name, const std::string &LoggingPrefix,
+                                     const std::string &SubSystemConfigPrefix)
+        : Name_(Name), LoggerPrefix_(LoggingPrefix), SubSystemConfigPrefix_(SubSystemConfigPrefix),
+          Logger_(std::make_unique<LoggerWrapper>(Poco::Logger::get(LoggingPrefix))) {}
+
+    void SubSystemServer::initialize(Poco::Util::Application &) {}
+
+    const std::string &MicroServiceDataDirectory() {
+        static const std::string directory = Poco::Path::temp();
+        return directory;
+    }
+    std::string MicroServiceConfigPath(const std::string &, const std::string &DefaultValue) { return DefaultValue; }
+    std::uint64_t MicroServiceConfigGetInt(const std::string &, std::uint64_t DefaultValue) { return DefaultValue; }
+}
+
+int main() {
+    int failures = 0;
+    for (const auto &test : kTests) {
+        try {
+            ResetState();
+            test.second();
+
+            std::cout << "[PASS] " << test.first << std::endl;
+        } catch (const std::exception &e) {
+            ++failures;
+            std::cerr << "[FAIL] " << test.first << ": " << e.what() << std::endl;
+        }
+    }
+
+    if (failures != 0) {
+        std::cerr << failures << " test(s) failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << kTests.size() << " test(s) passed." << std::endl;
+    return 0;
+}
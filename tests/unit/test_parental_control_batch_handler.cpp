@@ -0,0 +1,640 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#include "test_parental_control_test_helpers.h"
+#include "RESTAPI/RESTAPI_parental_control_batch_handler.h"
+
+namespace {
+
+const std::string kValidGroupId = "11111111-1111-4111-8111-111111111111";
+const std::string kValidScheduleId = "22222222-2222-4222-8222-222222222222";
+const std::string kAnotherScheduleId = "33333333-3333-4333-8333-333333333333";
+const std::string kValidMac = "aa:bb:cc:dd:ee:ff";
+const std::string kAnotherMac = "11:22:33:44:55:66";
+
+std::string StripMac(const std::string &value) {
+    std::string result;
+    for (char c : value) {
+        if (c == ':' || c == '-' || c == '.') {
+            continue;
+        }
+        result.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+    }
+    return result;
+}
+
+bool IsNormalizedMac(const std::string &value) {
+    if (value.size() != 12) {
+        return false;
+    }
+    return std::all_of(value.begin(), value.end(), [](unsigned char c) { return std::isxdigit(c) != 0; });
+}
+
+std::string MacWithColons(const std::string &value) {
+    std::ostringstream os;
+    for (std::size_t i = 0; i < value.size(); i += 2) {
+        if (i != 0) {
+            os << ':';
+        }
+        os << value.substr(i, 2);
+    }
+    return os.str();
+}
+
+struct SdkOutcome {
+    bool ok = true;
+    Poco::Net::HTTPResponse::HTTPStatus status = Poco::Net::HTTPResponse::HTTP_OK;
+    Poco::JSON::Object::Ptr response;
+};
+
+struct BatchHandlerState {
+    // Outcome of the N-th SDK call; calls past the end succeed with an empty object.
+    std::vector<SdkOutcome> outcomes;
+    std::vector<std::string> calls;
+
+    bool parseScheduleOk = true;
+    bool resolveTimezoneOk = true;
+    std::size_t resolveTimezoneCallCount = 0;
+    std::size_t convertCallCount = 0;
+    std::size_t normalizeScheduleResponseCallCount = 0;
+
+    OpenWifi::RESTAPI::ParentalControl::ApplyConfigRawResult applyResult =
+        OpenWifi::RESTAPI::ParentalControl::ApplyConfigRawResult::Applied;
+    std::size_t applyCallCount = 0;
+    Poco::JSON::Array::Ptr appliedConfigRaw;
+    std::string lastOperatorId;
+};
+
+BatchHandlerState g_state;
+
+void ResetState() { g_state = BatchHandlerState{}; }
+
+// Downstream response carrying a config-raw snapshot identified by marker.
+Poco::JSON::Object::Ptr ResponseWithConfigRaw(const std::string &marker) {
+    auto cmd = Poco::JSON::Array::Ptr(new Poco::JSON::Array());
+    cmd->add("set");
+    cmd->add("firewall.marker");
+    cmd->add(marker);
+    auto configRaw = Poco::JSON::Array::Ptr(new Poco::JSON::Array());
+    configRaw->add(cmd);
+    auto response = Poco::JSON::Object::Ptr(new Poco::JSON::Object());
+    response->set("id", marker);
+    response->set("config-raw", configRaw);
+    return response;
+}
+
+bool NextOutcome(const std::string &call, Poco::Net::HTTPResponse::HTTPStatus &callStatus,
+                 Poco::JSON::Object::Ptr &callResponse) {
+    const auto index = g_state.calls.size();
+    g_state.calls.push_back(call);
+    if (index >= g_state.outcomes.size()) {
+        callStatus = Poco::Net::HTTPResponse::HTTP_OK;
+        callResponse = Poco::JSON::Object::Ptr(new Poco::JSON::Object());
+        return true;
+    }
+    const auto &outcome = g_state.outcomes[index];
+    callStatus = outcome.status;
+    callResponse = outcome.response;
+    return outcome.ok;
+}
+
+Poco::JSON::Object::Ptr Operation(const std::string &op, const std::map<std::string, std::string> &fields) {
+    auto entry = Poco::JSON::Object::Ptr(new Poco::JSON::Object());
+    entry->set("op", op);
+    for (const auto &[name, value] : fields) {
+        entry->set(name, value);
+    }
+    return entry;
+}
+
+Poco::JSON::Object::Ptr ScheduleOperation(const std::string &op, const std::string &scheduleId) {
+    auto schedule = Poco::JSON::Object::Ptr(new Poco::JSON::Object());
+    schedule->set("name", "Homework");
+    auto entry = Operation(op, {});
+    if (!scheduleId.empty()) {
+        entry->set("schedule_id", scheduleId);
+    }
+    entry->set("schedule", schedule);
+    return entry;
+}
+
+Poco::JSON::Object::Ptr Batch(const std::vector<Poco::JSON::Object::Ptr> &operations) {
+    auto array = Poco::JSON::Array::Ptr(new Poco::JSON::Array());
+    for (const auto &operation : operations) {
+        array->add(operation);
+    }
+    auto body = Poco::JSON::Object::Ptr(new Poco::JSON::Object());
+    body->set("operations", array);
+    return body;
+}
+
+class TestBatchHandler final : public OpenWifi::RESTAPI_parental_control_batch_handler {
+  public:
+    using OpenWifi::RESTAPI_parental_control_batch_handler::RESTAPI_parental_control_batch_handler;
+
+    void setParsedBody(const Poco::JSON::Object::Ptr &body) { ParsedBody_ = body; }
+};
+
+} // namespace
+
+
+namespace OpenWifi::RESTAPI::ParentalControl {
+
+bool ValidateAuthPreconditions(RESTAPIHandler &handler, const std::string &subscriberId, const std::string &operatorId, bool requireOperatorId) {
+    if (subscriberId.empty()) {
+        handler.UnAuthorized(RESTAPI::Errors::InvalidSubscriberId);
+        return false;
+    }
+    if (requireOperatorId && operatorId.empty()) {
+        handler.UnAuthorized(RESTAPI::Errors::OperatorIdMustExist);
+        return false;
+    }
+    return true;
+}
+
+bool ParseScheduleRequest(const Poco::JSON::Object::Ptr &body, bool enabledRequired, ParsedScheduleRequest &out, std::string &error) {
+    if (!g_state.parseScheduleOk || !body->has("name")) {
+        error = "name is required";
+        return false;
+    }
+    out.name = body->getValue<std::string>("name");
+    out.enabled = !enabledRequired || out.enabled;
+    return true;
+}
+
+Poco::JSON::Object BuildScheduleRequestBody(const ParsedScheduleRequest &req) {
+    Poco::JSON::Object body;
+    body.set("name", req.name);
+    return body;
+}
+
+bool ResolveSubscriberTimezone(RESTAPIHandler &handler, const std::string &, std::string &timezone) {
+    g_state.resolveTimezoneCallCount++;
+    if (!g_state.resolveTimezoneOk) {
+        handler.BadRequest(RESTAPI::Errors::TimezoneRequired);
+        return false;
+    }
+    timezone = "UTC";
+    return true;
+}
+
+bool ConvertScheduleTimesToUtc(const std::string &, ParsedScheduleRequest &) {
+    g_state.convertCallCount++;
+    return true;
+}
+
+bool NormalizeScheduleResponse(Poco::JSON::Object::Ptr schedule, const std::string &) {
+    g_state.normalizeScheduleResponseCallCount++;
+    if (!schedule) {
+        return false;
+    }
+    schedule->set("start_time", "08:00");
+    return true;
+}
+
+bool ExtractConfigRawSnapshot(const Poco::JSON::Object::Ptr &callResponse, Poco::JSON::Array::Ptr &configRaw, bool required) {
+    configRaw.reset();
+    if (!callResponse || !callResponse->has("config-raw")) {
+        return !required;
+    }
+    if (!callResponse->isArray("config-raw")) {
+        return false;
+    }
+    configRaw = callResponse->getArray("config-raw");
+    return true;
+}
+
+ApplyConfigRawResult ApplyConfigRaw(RESTAPIHandler &, Poco::Logger &, const std::string &, const std::string &operatorId,
+                                    const std::string &, const Poco::JSON::Array::Ptr &configRaw, const std::string &,
+                                    const std::string &, const std::string &) {
+    g_state.applyCallCount++;
+    g_state.appliedConfigRaw = configRaw;
+    g_state.lastOperatorId = operatorId;
+    return g_state.applyResult;
+}
+
+bool ApplyConfigRawError(ApplyConfigRawResult result, Poco::Net::HTTPResponse::HTTPStatus &status,
+                         RESTAPI::Errors::msg &error) {
+    status = Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR;
+    error = RESTAPI::Errors::InternalError;
+    return result != ApplyConfigRawResult::Applied && result != ApplyConfigRawResult::NoConfigApplyNeeded;
+}
+
+bool HandleApplyConfigRawResult(RESTAPIHandler &handler, ApplyConfigRawResult result) {
+    if (result == ApplyConfigRawResult::Applied || result == ApplyConfigRawResult::NoConfigApplyNeeded) {
+        return true;
+    }
+    handler.InternalError(RESTAPI::Errors::InternalError);
+    return false;
+}
+
+void StripConfigRawFromMutationResponse(Poco::JSON::Object::Ptr mutationResponse) {
+    if (mutationResponse && mutationResponse->has("config-raw")) {
+        mutationResponse->remove("config-raw");
+    }
+}
+
+Poco::JSON::Object::Ptr ParentalControlErrorBody(Poco::Net::HTTPResponse::HTTPStatus status,
+                                                 const Poco::JSON::Object::Ptr &downstreamResponse) {
+    auto body = Poco::JSON::Object::Ptr(new Poco::JSON::Object());
+    body->set("ErrorCode", static_cast<int>(status));
+    if (downstreamResponse && downstreamResponse->has("message")) {
+        body->set("ErrorDescription", downstreamResponse->getValue<std::string>("message"));
+    }
+    return body;
+}
+
+} // namespace OpenWifi::RESTAPI::ParentalControl
+
+namespace OpenWifi::SDK::ParentalControl {
+
+bool CreateGroupDevice(RESTAPIHandler *, const std::string &, const std::string &groupId, const Poco::JSON::Object &body,
+                       Poco::Net::HTTPResponse::HTTPStatus &callStatus, Poco::JSON::Object::Ptr &callResponse) {
+    return NextOutcome("CreateGroupDevice " + groupId + " " + body.getValue<std::string>("client_mac"), callStatus, callResponse);
+}
+
+bool DeleteGroupDevice(RESTAPIHandler *, const std::string &, const std::string &groupId, const std::string &clientMac,
+                       Poco::Net::HTTPResponse::HTTPStatus &callStatus, Poco::JSON::Object::Ptr &callResponse, std::string &) {
+    return NextOutcome("DeleteGroupDevice " + groupId + " " + clientMac, callStatus, callResponse);
+}
+
+bool CreateGroupSchedule(RESTAPIHandler *, const std::string &, const std::string &groupId, const Poco::JSON::Object &body,
+                         Poco::Net::HTTPResponse::HTTPStatus &callStatus, Poco::JSON::Object::Ptr &callResponse) {
+    return NextOutcome("CreateGroupSchedule " + groupId + " " + body.getValue<std::string>("schedule_id"), callStatus, callResponse);
+}
+
+bool DeleteGroupSchedule(RESTAPIHandler *, const std::string &, const std::string &groupId, const std::string &scheduleId,
+                         Poco::Net::HTTPResponse::HTTPStatus &callStatus, Poco::JSON::Object::Ptr &callResponse, std::string &) {
+    return NextOutcome("DeleteGroupSchedule " + groupId + " " + scheduleId, callStatus, callResponse);
+}
+
+bool ReplaceGroupSchedules(RESTAPIHandler *, const std::string &, const std::string &groupId, const Poco::JSON::Object &body,
+                           Poco::Net::HTTPResponse::HTTPStatus &callStatus, Poco::JSON::Object::Ptr &callResponse) {
+    return NextOutcome("ReplaceGroupSchedules " + groupId + " " + std::to_string(body.getArray("schedule_ids")->size()),
+                       callStatus, callResponse);
+}
+
+bool CreateSchedule(RESTAPIHandler *, const std::string &, const Poco::JSON::Object &body,
+                    Poco::Net::HTTPResponse::HTTPStatus &callStatus, Poco::JSON::Object::Ptr &callResponse) {
+    return NextOutcome("CreateSchedule " + body.getValue<std::string>("name"), callStatus, callResponse);
+}
+
+bool UpdateSchedule(RESTAPIHandler *, const std::string &, const std::string &scheduleId, const Poco::JSON::Object &,
+                    Poco::Net::HTTPResponse::HTTPStatus &callStatus, Poco::JSON::Object::Ptr &callResponse) {
+    return NextOutcome("UpdateSchedule " + scheduleId, callStatus, callResponse);
+}
+
+bool DeleteSchedule(RESTAPIHandler *, const std::string &, const std::string &scheduleId,
+                    Poco::Net::HTTPResponse::HTTPStatus &callStatus, Poco::JSON::Object::Ptr &callResponse, std::string &) {
+    return NextOutcome("DeleteSchedule " + scheduleId, callStatus, callResponse);
+}
+
+bool DeleteGroup(RESTAPIHandler *, const std::string &, const std::string &groupId,
+                 Poco::Net::HTTPResponse::HTTPStatus &callStatus, Poco::JSON::Object::Ptr &callResponse, std::string &) {
+    return NextOutcome("DeleteGroup " + groupId, callStatus, callResponse);
+}
+
+} // namespace OpenWifi::SDK::ParentalControl
+
+#include "../../src/RESTAPI/RESTAPI_parental_control_batch_handler.cpp"
+
+namespace {
+
+void TestRejectsMissingOwner() {
+    RunHandlerRequest<TestBatchHandler>(
+        Poco::Net::HTTPRequest::HTTP_POST,
+        "/api/v1/parental-control/batch",
+        "{}",
+        {},
+        "subscriber-1",
+        "",
+        Poco::Net::HTTPResponse::HTTP_FORBIDDEN,
+        [](TestBatchHandler &handler) {
+            handler.setParsedBody(Batch({Operation("delete_group", {{"group_id", kValidGroupId}})}));
+        }
+    );
+}
+
+void TestRejectsEmptyOperations() {
+    RunHandlerRequest<TestBatchHandler>(
+        Poco::Net::HTTPRequest::HTTP_POST,
+        "/api/v1/parental-control/batch",
+        "{}",
+        {},
+        "subscriber-1",
+        "operator-1",
+        Poco::Net::HTTPResponse::HTTP_BAD_REQUEST,
+        [](TestBatchHandler &handler) { handler.setParsedBody(Batch({})); }
+    );
+}
+
+void TestRejectsInvalidEntryBeforeAnyCall() {
+    RunHandlerRequest<TestBatchHandler>(
+        Poco::Net::HTTPRequest::HTTP_POST,
+        "/api/v1/parental-control/batch",
+        "{}",
+        {},
+        "subscriber-1",
+        "operator-1",
+        Poco::Net::HTTPResponse::HTTP_BAD_REQUEST,
+        [](TestBatchHandler &handler) {
+            handler.setParsedBody(Batch({
+                Operation("add_group_device", {{"group_id", kValidGroupId}, {"client_mac", kValidMac}}),
+                Operation("add_group_device", {{"group_id", kValidGroupId}, {"client_mac", "not-a-mac"}}),
+            }));
+        },
+        [](const FakeResponse &response) {
+            auto parsed = ParseObject(response.body());
+            Expect(parsed->getValue<std::string>("ErrorDescription").find("operations[1]") != std::string::npos,
+                   "error should name the offending entry");
+            ExpectEq(g_state.calls.size(), static_cast<std::size_t>(0), "no downstream call should be made");
+            ExpectEq(g_state.applyCallCount, static_cast<std::size_t>(0), "nothing should be applied");
+        }
+    );
+}
+
+void TestRejectsUnknownFieldAndOp() {
+    RunHandlerRequest<TestBatchHandler>(
+        Poco::Net::HTTPRequest::HTTP_POST,
+        "/api/v1/parental-control/batch",
+        "{}",
+        {},
+        "subscriber-1",
+        "operator-1",
+        Poco::Net::HTTPResponse::HTTP_BAD_REQUEST,
+        [](TestBatchHandler &handler) {
+            handler.setParsedBody(Batch({Operation("delete_group", {{"group_id", kValidGroupId}, {"client_mac", kValidMac}})}));
+        }
+    );
+    RunHandlerRequest<TestBatchHandler>(
+        Poco::Net::HTTPRequest::HTTP_POST,
+        "/api/v1/parental-control/batch",
+        "{}",
+        {},
+        "subscriber-1",
+        "operator-1",
+        Poco::Net::HTTPResponse::HTTP_BAD_REQUEST,
+        [](TestBatchHandler &handler) {
+            handler.setParsedBody(Batch({Operation("rename_group", {{"group_id", kValidGroupId}})}));
+        }
+    );
+    ExpectEq(g_state.calls.size(), static_cast<std::size_t>(0), "no downstream call should be made");
+}
+
+void TestAppliesOnlyLatestConfigRawOnce() {
+    g_state.outcomes = {
+        {true, Poco::Net::HTTPResponse::HTTP_OK, ResponseWithConfigRaw("first")},
+        {true, Poco::Net::HTTPResponse::HTTP_OK, ResponseWithConfigRaw("second")},
+        {true, Poco::Net::HTTPResponse::HTTP_OK, ResponseWithConfigRaw("third")},
+    };
+
+    RunHandlerRequest<TestBatchHandler>(
+        Poco::Net::HTTPRequest::HTTP_POST,
+        "/api/v1/parental-control/batch",
+        "{}",
+        {},
+        "subscriber-1",
+        "operator-1",
+        Poco::Net::HTTPResponse::HTTP_OK,
+        [](TestBatchHandler &handler) {
+            auto ids = Poco::JSON::Array::Ptr(new Poco::JSON::Array());
+            ids->add(kValidScheduleId);
+            ids->add(kAnotherScheduleId);
+            auto replace = Operation("replace_group_schedules", {{"group_id", kValidGroupId}});
+            replace->set("schedule_ids", ids);
+            handler.setParsedBody(Batch({
+                Operation("add_group_device", {{"group_id", kValidGroupId}, {"client_mac", kValidMac}}),
+                Operation("remove_group_device", {{"group_id", kValidGroupId}, {"client_mac", kAnotherMac}}),
+                replace,
+            }));
+        },
+        [](const FakeResponse &response) {
+            auto parsed = ParseObject(response.body());
+            ExpectEq(parsed->getValue<bool>("success"), true, "batch should succeed");
+            auto results = parsed->getArray("results");
+            ExpectEq(results->size(), static_cast<std::size_t>(3), "one result per operation");
+            for (std::size_t i = 0; i < results->size(); ++i) {
+                auto result = results->getObject(i);
+                ExpectEq(result->getValue<std::size_t>("index"), i, "results should keep request order");
+                ExpectEq(result->getValue<bool>("success"), true, "operation should succeed");
+                Expect(!result->getObject("response")->has("config-raw"), "results should not expose config-raw");
+            }
+            ExpectEq(results->getObject(0)->getValue<std::string>("op"), std::string("add_group_device"), "op should be echoed");
+            ExpectEq(g_state.calls[0], "CreateGroupDevice " + kValidGroupId + " AA:BB:CC:DD:EE:FF", "MAC should be normalized");
+            ExpectEq(g_state.calls[1], "DeleteGroupDevice " + kValidGroupId + " 11:22:33:44:55:66", "remove should delete the device");
+            ExpectEq(g_state.calls[2], "ReplaceGroupSchedules " + kValidGroupId + " 2", "schedule ids should be forwarded");
+            ExpectEq(g_state.applyCallCount, static_cast<std::size_t>(1), "config-raw should be applied once");
+            ExpectEq(g_state.appliedConfigRaw->getArray(0)->getElement<std::string>(2), std::string("third"),
+                     "the last snapshot should be applied");
+            ExpectEq(g_state.lastOperatorId, std::string("operator-1"), "operator id should be forwarded");
+            ExpectEq(g_state.resolveTimezoneCallCount, static_cast<std::size_t>(0), "no timezone needed without schedules");
+        }
+    );
+}
+
+void TestStopsAtFirstFailureAndAppliesPriorSnapshot() {
+    auto error = Poco::JSON::Object::Ptr(new Poco::JSON::Object());
+    error->set("message", "group not found");
+    g_state.outcomes = {
+        {true, Poco::Net::HTTPResponse::HTTP_OK, ResponseWithConfigRaw("first")},
+        {false, Poco::Net::HTTPResponse::HTTP_NOT_FOUND, error},
+    };
+
+    RunHandlerRequest<TestBatchHandler>(
+        Poco::Net::HTTPRequest::HTTP_POST,
+        "/api/v1/parental-control/batch",
+        "{}",
+        {},
+        "subscriber-1",
+        "operator-1",
+        Poco::Net::HTTPResponse::HTTP_OK,
+        [](TestBatchHandler &handler) {
+            handler.setParsedBody(Batch({
+                Operation("add_group_schedule", {{"group_id", kValidGroupId}, {"schedule_id", kValidScheduleId}}),
+                Operation("remove_group_schedule", {{"group_id", kValidGroupId}, {"schedule_id", kAnotherScheduleId}}),
+                Operation("delete_group", {{"group_id", kValidGroupId}}),
+            }));
+        },
+        [](const FakeResponse &response) {
+            auto parsed = ParseObject(response.body());
+            ExpectEq(parsed->getValue<bool>("success"), false, "batch should report the failure");
+            auto results = parsed->getArray("results");
+            ExpectEq(results->getObject(0)->getValue<bool>("success"), true, "first operation should succeed");
+            auto failed = results->getObject(1);
+            ExpectEq(failed->getValue<bool>("success"), false, "second operation should fail");
+            ExpectEq(failed->getValue<int>("status"), 404, "downstream status should be reported");
+            ExpectEq(failed->getObject("error")->getValue<std::string>("ErrorDescription"), std::string("group not found"),
+                     "downstream error should be reported");
+            ExpectEq(results->getObject(2)->getValue<bool>("skipped"), true, "remaining operations should be skipped");
+            ExpectEq(g_state.calls.size(), static_cast<std::size_t>(2), "skipped operations should not be sent");
+            ExpectEq(g_state.applyCallCount, static_cast<std::size_t>(1), "completed changes should still be applied");
+            ExpectEq(g_state.appliedConfigRaw->getArray(0)->getElement<std::string>(2), std::string("first"),
+                     "snapshot of the last successful operation should be applied");
+        }
+    );
+}
+
+void TestMissingRequiredConfigRawFailsOperation() {
+    g_state.outcomes = {{true, Poco::Net::HTTPResponse::HTTP_OK, Poco::JSON::Object::Ptr(new Poco::JSON::Object())}};
+
+    RunHandlerRequest<TestBatchHandler>(
+        Poco::Net::HTTPRequest::HTTP_POST,
+        "/api/v1/parental-control/batch",
+        "{}",
+        {},
+        "subscriber-1",
+        "operator-1",
+        Poco::Net::HTTPResponse::HTTP_OK,
+        [](TestBatchHandler &handler) {
+            handler.setParsedBody(Batch({
+                Operation("add_group_device", {{"group_id", kValidGroupId}, {"client_mac", kValidMac}}),
+                Operation("delete_group", {{"group_id", kValidGroupId}}),
+            }));
+        },
+        [](const FakeResponse &response) {
+            auto parsed = ParseObject(response.body());
+            auto failed = parsed->getArray("results")->getObject(0);
+            ExpectEq(failed->getValue<bool>("success"), false, "operation without config-raw should fail");
+            ExpectEq(failed->getValue<int>("status"), 500, "invalid payload should be reported as 500");
+            ExpectEq(g_state.calls.size(), static_cast<std::size_t>(1), "batch should stop after the failure");
+            ExpectEq(g_state.applyCallCount, static_cast<std::size_t>(0), "nothing should be applied");
+        }
+    );
+}
+
+void TestSchedulesResolveTimezoneOnce() {
+    auto created = Poco::JSON::Object::Ptr(new Poco::JSON::Object());
+    created->set("id", kValidScheduleId);
+    g_state.outcomes = {
+        {true, Poco::Net::HTTPResponse::HTTP_OK, created},
+        {true, Poco::Net::HTTPResponse::HTTP_OK, ResponseWithConfigRaw("updated")},
+    };
+
+    RunHandlerRequest<TestBatchHandler>(
+        Poco::Net::HTTPRequest::HTTP_POST,
+        "/api/v1/parental-control/batch",
+        "{}",
+        {},
+        "subscriber-1",
+        "operator-1",
+        Poco::Net::HTTPResponse::HTTP_OK,
+        [](TestBatchHandler &handler) {
+            handler.setParsedBody(Batch({
+                ScheduleOperation("create_schedule", ""),
+                ScheduleOperation("update_schedule", kAnotherScheduleId),
+            }));
+        },
+        [](const FakeResponse &response) {
+            auto parsed = ParseObject(response.body());
+            auto results = parsed->getArray("results");
+            ExpectEq(results->getObject(0)->getObject("response")->getValue<std::string>("start_time"), std::string("08:00"),
+                     "schedule responses should be normalized");
+            Expect(!results->getObject(1)->getObject("response")->has("config-raw"), "results should not expose config-raw");
+            ExpectEq(g_state.resolveTimezoneCallCount, static_cast<std::size_t>(1), "timezone should be resolved once");
+            ExpectEq(g_state.convertCallCount, static_cast<std::size_t>(2), "both schedules should be converted");
+            ExpectEq(g_state.normalizeScheduleResponseCallCount, static_cast<std::size_t>(2), "both responses should be normalized");
+            ExpectEq(g_state.calls[0], std::string("CreateSchedule Homework"), "schedule body should be forwarded");
+            ExpectEq(g_state.applyCallCount, static_cast<std::size_t>(1), "update snapshot should be applied");
+        }
+    );
+}
+
+void TestNoApplyWithoutSnapshot() {
+    RunHandlerRequest<TestBatchHandler>(
+        Poco::Net::HTTPRequest::HTTP_POST,
+        "/api/v1/parental-control/batch",
+        "{}",
+        {},
+        "subscriber-1",
+        "operator-1",
+        Poco::Net::HTTPResponse::HTTP_OK,
+        [](TestBatchHandler &handler) {
+            handler.setParsedBody(Batch({Operation("delete_schedule", {{"schedule_id", kValidScheduleId}})}));
+        },
+        [](const FakeResponse &) {
+            ExpectEq(g_state.calls.size(), static_cast<std::size_t>(1), "delete should be sent");
+            ExpectEq(g_state.applyCallCount, static_cast<std::size_t>(0), "nothing to apply without config-raw");
+        }
+    );
+}
+
+void TestApplyFailureReturnsInternalError() {
+    g_state.outcomes = {{true, Poco::Net::HTTPResponse::HTTP_OK, ResponseWithConfigRaw("first")},
+                        {true, Poco::Net::HTTPResponse::HTTP_OK, ResponseWithConfigRaw("second")}};
+    g_state.applyResult = OpenWifi::RESTAPI::ParentalControl::ApplyConfigRawResult::GatewayConfigureFailed;
+
+    RunHandlerRequest<TestBatchHandler>(
+        Poco::Net::HTTPRequest::HTTP_POST,
+        "/api/v1/parental-control/batch",
+        "{}",
+        {},
+        "subscriber-1",
+        "operator-1",
+        Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR,
+        [](TestBatchHandler &handler) {
+            handler.setParsedBody(Batch({Operation("add_group_device", {{"group_id", kValidGroupId}, {"client_mac", kValidMac}}),
+                                         Operation("delete_schedule", {{"schedule_id", kValidScheduleId}})}));
+        },
+        [](const FakeResponse &response) {
+            auto body = ParseObject(response.body());
+            ExpectEq(body->getValue<int>("ErrorCode"), 500, "apply failure reported");
+            Expect(!body->getValue<bool>("success"), "batch reported as failed");
+            auto results = body->getArray("results");
+            ExpectEq(results->size(), static_cast<std::size_t>(2), "committed operations still reported");
+            Expect(results->getObject(0)->getValue<bool>("success"), "first operation committed");
+            Expect(results->getObject(1)->getValue<bool>("success"), "second operation committed");
+        }
+    );
+}
+
+const std::vector<std::pair<std::string, std::function<void()>>> kTests = {
+    {"RejectsMissingOwner", TestRejectsMissingOwner},
+    {"RejectsEmptyOperations", TestRejectsEmptyOperations},
+    {"RejectsInvalidEntryBeforeAnyCall", TestRejectsInvalidEntryBeforeAnyCall},
+    {"RejectsUnknownFieldAndOp", TestRejectsUnknownFieldAndOp},
+    {"AppliesOnlyLatestConfigRawOnce", TestAppliesOnlyLatestConfigRawOnce},
+    {"StopsAtFirstFailureAndAppliesPriorSnapshot", TestStopsAtFirstFailureAndAppliesPriorSnapshot},
+    {"MissingRequiredConfigRawFailsOperation", TestMissingRequiredConfigRawFailsOperation},
+    {"SchedulesResolveTimezoneOnce", TestSchedulesResolveTimezoneOnce},
+    {"NoApplyWithoutSnapshot", TestNoApplyWithoutSnapshot},
+    {"ApplyFailureReturnsInternalError", TestApplyFailureReturnsInternalError},
+};
+
+} // namespace
+
+int main() {
+    int failures = 0;
+    for (const auto &test : kTests) {
+        try {
+            ResetState();
+            test.second();
+
+            std::cout << "[PASS] " << test.first << std::endl;
+        } catch (const std::exception &e) {
+            ++failures;
+            std::cerr << "[FAIL] " << test.first << ": " << e.what() << std::endl;
+        }
+    }
+
+    if (failures != 0) {
+        std::cerr << failures << " test(s) failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << kTests.size() << " test(s) passed." << std::endl;
+    return 0;
+}
+namespace OpenWifi::Utils {
+    bool NormalizeMac(std::string &mac) {
+        std::string normalized = StripMac(mac);
+        if (!IsNormalizedMac(normalized)) {
+            return false;
+        }
+        mac = normalized;
+        return true;
+    }
+    std::string SerialToMAC(const std::string &serial) { return MacWithColons(StripMac(serial)); }
+}
@@ -11,6 +11,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "Poco/JSON/Array.h"
@@ -22,6 +23,7 @@
 #include "Poco/Net/HTTPServerParams.h"
 #include "Poco/Net/SocketAddress.h"
 #include "RESTAPI/RESTAPI_parental_control_utils.h"
+#include "VenueContextCache.h"
 #include "framework/RESTAPI_GenericServerAccounting.h"
 #include "sdks/SDK_gw.h"
 #include "sdks/SDK_nw_topology.h"
@@ -219,6 +221,7 @@ struct StubState {
     OpenWifi::ProvObjects::Venue venue;
 
     bool venuesOk = true;
+    int venuesCalls = 0;
     Poco::Net::HTTPResponse::HTTPStatus venuesStatus = Poco::Net::HTTPResponse::HTTP_OK;
     Poco::JSON::Object::Ptr venuesResponse = Poco::JSON::Object::Ptr(new Poco::JSON::Object());
     OpenWifi::ProvObjects::VenueList venueList;
@@ -242,12 +245,15 @@ struct StubState {
     Poco::JSON::Object::Ptr gatewayConfigureResponse = Poco::JSON::Object::Ptr(new Poco::JSON::Object());
     std::string configuredSerial;
     Poco::JSON::Object::Ptr configuredObject;
+    int configureCalls = 0;
+    int configureDelayMs = 0;
 };
 
 StubState g_state;
 
 void ResetStubs() {
     g_state = StubState{};
+    OpenWifi::VenueContextCache()->Clear();
     g_state.inventory.venue = "venue-1";
     g_state.venue.boards = {"board-1"};
     g_state.venue.location = "loc-1";
@@ -308,6 +314,7 @@ bool Get(RESTAPIHandler *, const std::string &, ProvObjects::Venue &venue,
 
 bool GetVenues(RESTAPIHandler *, const std::string &, ProvObjects::VenueList &venueList,
                Poco::Net::HTTPServerResponse::HTTPStatus &callStatus, Poco::JSON::Object::Ptr &callResponse) {
+    ++g_state.venuesCalls;
     venueList = g_state.venueList;
     callStatus = g_state.venuesStatus;
     callResponse = g_state.venuesResponse;
@@ -339,6 +346,8 @@ bool GetConfig(RESTAPIHandler *, const std::string &, Poco::Net::HTTPResponse::H
 
 bool Configure(RESTAPIHandler *, const std::string &mac, Poco::JSON::Object::Ptr &configuration,
                Poco::Net::HTTPResponse::HTTPStatus &responseStatus, Poco::JSON::Object::Ptr &response) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(g_state.configureDelayMs));
+    ++g_state.configureCalls;
     g_state.configuredSerial = mac;
     g_state.configuredObject = configuration;
     responseStatus = g_state.gatewayConfigureStatus;
@@ -361,6 +370,7 @@ bool Get(RESTAPIHandler *, const std::string &boardId, Poco::Net::HTTPServerResp
 } // namespace OpenWifi::SDK::Topology
 
 #include "../../src/RESTAPI/RESTAPI_parental_control_utils.cpp"
+#include "../../src/VenueContextCache.cpp"
 
 namespace {
 
@@ -535,6 +545,85 @@ void TestResolveSubscriberTimezoneAsiaKolkata() {
     ExpectEq(tz, "Asia/Kolkata", "timezone should be Asia/Kolkata");
 }
 
+void TestResolveSubscriberTimezoneServedFromCache() {
+    ResetStubs();
+    g_state.location.timezone = "Asia/Kolkata";
+    auto &logger = Poco::Logger::get("test_utils");
+    FakeResponse response;
+    FakeRequest request("GET", "/test", "", response);
+    FakeRESTAPIHandler handler(logger, &request, &response);
+
+    std::string tz;
+    Expect(OpenWifi::RESTAPI::ParentalControl::ResolveSubscriberTimezone(handler, "sub1", tz),
+           "first lookup should succeed");
+    g_state.venuesOk = false;
+    g_state.venuesStatus = Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR;
+    tz.clear();
+    Expect(OpenWifi::RESTAPI::ParentalControl::ResolveSubscriberTimezone(handler, "sub1", tz),
+           "second lookup should be served from the cache");
+    ExpectEq(tz, "Asia/Kolkata", "cached timezone");
+    ExpectEq(g_state.venuesCalls, 1, "OWProv should only be called once");
+}
+
+void TestResolveSubscriberTimezoneNegativeCachedUntilProvisioningChange() {
+    ResetStubs();
+    g_state.location.timezone.clear();
+    auto &logger = Poco::Logger::get("test_utils");
+
+    {
+        FakeResponse response;
+        FakeRequest request("GET", "/test", "", response);
+        FakeRESTAPIHandler handler(logger, &request, &response);
+        std::string tz;
+        Expect(!OpenWifi::RESTAPI::ParentalControl::ResolveSubscriberTimezone(handler, "sub1", tz),
+               "missing timezone should fail");
+    }
+
+    g_state.location.timezone = "UTC";
+    {
+        FakeResponse response;
+        FakeRequest request("GET", "/test", "", response);
+        FakeRESTAPIHandler handler(logger, &request, &response);
+        std::string tz;
+        Expect(!OpenWifi::RESTAPI::ParentalControl::ResolveSubscriberTimezone(handler, "sub1", tz),
+               "negative result should be cached");
+        ExpectEq(static_cast<int>(response.getStatus()), static_cast<int>(Poco::Net::HTTPResponse::HTTP_BAD_REQUEST),
+                 "cached negative result should return 400");
+        ExpectEq(g_state.venuesCalls, 1, "negative result should not call OWProv again");
+    }
+
+    OpenWifi::VenueContextCache()->ProvisioningChange("", R"({"payload":{"location":"loc-1"}})");
+    {
+        FakeResponse response;
+        FakeRequest request("GET", "/test", "", response);
+        FakeRESTAPIHandler handler(logger, &request, &response);
+        std::string tz;
+        Expect(OpenWifi::RESTAPI::ParentalControl::ResolveSubscriberTimezone(handler, "sub1", tz),
+               "lookup after a location change should refetch");
+        ExpectEq(tz, "UTC", "refetched timezone");
+        ExpectEq(g_state.venuesCalls, 2, "OWProv should be called after invalidation");
+    }
+}
+
+void TestResolveSubscriberTimezoneUpstreamErrorsNotCached() {
+    ResetStubs();
+    g_state.locationOk = false;
+    g_state.locationStatus = Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR;
+    auto &logger = Poco::Logger::get("test_utils");
+    FakeResponse response;
+    FakeRequest request("GET", "/test", "", response);
+    FakeRESTAPIHandler handler(logger, &request, &response);
+
+    std::string tz;
+    Expect(!OpenWifi::RESTAPI::ParentalControl::ResolveSubscriberTimezone(handler, "sub1", tz),
+           "location 500 should fail");
+    g_state.locationOk = true;
+    g_state.locationStatus = Poco::Net::HTTPResponse::HTTP_OK;
+    Expect(OpenWifi::RESTAPI::ParentalControl::ResolveSubscriberTimezone(handler, "sub1", tz),
+           "upstream errors must not be cached");
+    ExpectEq(g_state.venuesCalls, 2, "OWProv should be called again after an upstream error");
+}
+
 void TestNormalizeScheduleResponseConvertsMinuteFields() {
     auto schedule = Poco::JSON::Object::Ptr(new Poco::JSON::Object());
     schedule->set("start_minute", 60);
@@ -1163,6 +1252,91 @@ void TestGetBlockedClientsIncompleteRuleMissingMacs() {
     Expect(blockedMacs.empty(), "Rule without valid MACs should be ignored");
 }
 
+void TestEvaluateBlockRulesOvernightSchedule() {
+    auto configRaw = Poco::JSON::Array::Ptr(new Poco::JSON::Array());
+    configRaw->add(MakeStringArray({"set", "firewall.pc_rule_g1_s1_5a_f8_57_ca_a5_3e", "rule"}));
+    configRaw->add(MakeStringArray({"set", "firewall.pc_rule_g1_s1_5a_f8_57_ca_a5_3e.enabled", "1"}));
+    configRaw->add(MakeStringArray({"set", "firewall.pc_rule_g1_s1_5a_f8_57_ca_a5_3e.weekdays", "'Mon'"}));
+    configRaw->add(MakeStringArray({"set", "firewall.pc_rule_g1_s1_5a_f8_57_ca_a5_3e.start_time", "22:00:00"}));
+    configRaw->add(MakeStringArray({"set", "firewall.pc_rule_g1_s1_5a_f8_57_ca_a5_3e.stop_time", "06:00:00"}));
+    configRaw->add(MakeStringArray({"add_list", "firewall.pc_rule_g1_s1_5a_f8_57_ca_a5_3e.src_mac", "5a:f8:57:ca:a5:3e"}));
+
+    auto rules = OpenWifi::RESTAPI::ParentalControl::CompileBlockRules(configRaw);
+    ExpectEq(rules->rules.size(), static_cast<std::size_t>(1), "schedule rule should compile");
+    ExpectEq(rules->macs.front(), static_cast<std::uint64_t>(0x5af857caa53e), "MAC should be packed");
+
+    const std::int64_t tuesday = 1784592000; // 2026-07-21 00:00:00 UTC
+    const std::int64_t hour = 3600;
+    auto evaluate = [&](std::int64_t now) {
+        std::map<std::uint64_t, std::int64_t> blocked;
+        OpenWifi::RESTAPI::ParentalControl::EvaluateBlockRules(*rules, now, blocked);
+        return blocked;
+    };
+
+    auto blocked = evaluate(tuesday - hour);
+    ExpectEq(blocked.size(), static_cast<std::size_t>(1), "Monday 23:00 should be blocked");
+    ExpectEq(blocked.begin()->second, tuesday + 6 * hour, "block should end Tuesday 06:00");
+
+    blocked = evaluate(tuesday + 3 * hour);
+    ExpectEq(blocked.size(), static_cast<std::size_t>(1), "Tuesday 03:00 should still be blocked");
+    ExpectEq(blocked.begin()->second, tuesday + 6 * hour, "block should end Tuesday 06:00");
+
+    Expect(evaluate(tuesday + 6 * hour).empty(), "stop time is exclusive");
+    Expect(evaluate(tuesday + 23 * hour).empty(), "Tuesday is not a scheduled day");
+}
+
+void TestBlockTimelineAdvancesAtTransitions() {
+    auto configRaw = Poco::JSON::Array::Ptr(new Poco::JSON::Array());
+    configRaw->add(MakeStringArray({"set", "firewall.pc_rule_g1_s1_5a_f8_57_ca_a5_3e", "rule"}));
+    configRaw->add(MakeStringArray({"set", "firewall.pc_rule_g1_s1_5a_f8_57_ca_a5_3e.enabled", "1"}));
+    configRaw->add(MakeStringArray({"set", "firewall.pc_rule_g1_s1_5a_f8_57_ca_a5_3e.weekdays", "'Mon'"}));
+    configRaw->add(MakeStringArray({"set", "firewall.pc_rule_g1_s1_5a_f8_57_ca_a5_3e.start_time", "22:00:00"}));
+    configRaw->add(MakeStringArray({"set", "firewall.pc_rule_g1_s1_5a_f8_57_ca_a5_3e.stop_time", "06:00:00"}));
+    configRaw->add(MakeStringArray({"add_list", "firewall.pc_rule_g1_s1_5a_f8_57_ca_a5_3e.src_mac", "5a:f8:57:ca:a5:3e"}));
+
+    OpenWifi::RESTAPI::ParentalControl::BlockTimeline timeline(
+        OpenWifi::RESTAPI::ParentalControl::CompileBlockRules(configRaw));
+    const std::int64_t tuesday = 1784592000; // 2026-07-21 00:00:00 UTC
+    const std::int64_t hour = 3600;
+    std::map<std::uint64_t, std::int64_t> blocked;
+
+    timeline.BlockedAt(tuesday - 12 * hour, blocked);
+    Expect(blocked.empty(), "Monday noon should not be blocked");
+    ExpectEq(timeline.NextTransition(), tuesday - 2 * hour, "next transition is Monday 22:00");
+
+    timeline.BlockedAt(tuesday - hour, blocked);
+    ExpectEq(blocked.size(), static_cast<std::size_t>(1), "Monday 23:00 should be blocked");
+    ExpectEq(timeline.NextTransition(), tuesday + 6 * hour, "next transition is Tuesday 06:00");
+
+    timeline.BlockedAt(tuesday + 7 * hour, blocked);
+    Expect(blocked.empty(), "Tuesday 07:00 should not be blocked");
+    ExpectEq(timeline.NextTransition(), tuesday + 7 * 24 * hour - 2 * hour, "next transition is the following Monday 22:00");
+}
+
+void TestGetBlockedClientsCompiledRulesFollowConfigUuid() {
+    auto makeConfig = [](std::uint64_t uuid, const std::string &enabled) {
+        auto config = Poco::JSON::Object::Ptr(new Poco::JSON::Object());
+        auto configRaw = Poco::JSON::Array::Ptr(new Poco::JSON::Array());
+        configRaw->add(MakeStringArray({"set", "firewall.pc_client_access_10_F1_F2_86_11_DC", "rule"}));
+        configRaw->add(MakeStringArray({"set", "firewall.pc_client_access_10_F1_F2_86_11_DC.enabled", enabled}));
+        configRaw->add(MakeStringArray({"add_list", "firewall.pc_client_access_10_F1_F2_86_11_DC.src_mac", "10:f1:f2:86:11:dc"}));
+        config->set("uuid", uuid);
+        config->set("config-raw", configRaw);
+        return config;
+    };
+
+    std::map<std::string, std::string> blocked;
+    Expect(OpenWifi::RESTAPI::ParentalControl::GetBlockedClients(makeConfig(100, "1"), blocked, "", "GW-UUID-TEST"), "GetBlockedClients should return true");
+    ExpectEq(blocked.size(), static_cast<std::size_t>(1), "permanent client-access rule should block");
+    ExpectEq(blocked["10f1f28611dc"], std::string("indefinite"), "permanent block has no end");
+
+    Expect(OpenWifi::RESTAPI::ParentalControl::GetBlockedClients(makeConfig(100, "0"), blocked, "", "GW-UUID-TEST"), "GetBlockedClients should return true");
+    ExpectEq(blocked.size(), static_cast<std::size_t>(1), "same configuration UUID should reuse the compiled rules");
+
+    Expect(OpenWifi::RESTAPI::ParentalControl::GetBlockedClients(makeConfig(101, "0"), blocked, "", "GW-UUID-TEST"), "GetBlockedClients should return true");
+    Expect(blocked.empty(), "new configuration UUID should recompile the rules");
+}
+
 void TestValidateAuthPreconditions() {
     auto &logger = Poco::Logger::get("test");
     FakeResponse response;
@@ -1553,10 +1727,68 @@ void TestHandleParentalControlMutationResultFailureForwarding() {
     ExpectEq(resObj->getValue<std::string>("ErrorDetails"), "schedule_not_found", "Mutation failure ErrorDetails mapped");
 }
 
+void TestApplyConfigRawPushesAtOnceWhenIdle() {
+    auto &logger = Poco::Logger::get("test");
+    auto configRaw = Poco::JSON::Array::Ptr(new Poco::JSON::Array());
+    configRaw->add(MakeStringArray({"set", "firewall.pc_rule_g1", "rule"}));
+
+    FakeResponse response;
+    FakeRequest request("POST", "/api/v1/group", "", response);
+    FakeRESTAPIHandler handler(logger, &request, &response);
+    const auto start = std::chrono::steady_clock::now();
+    auto result = OpenWifi::RESTAPI::ParentalControl::ApplyConfigRaw(
+        handler, logger, "sub-1", "op-1", "group-1", configRaw, "DoPost", "group", "AABBCCDDEEFF");
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    Expect(result == OpenWifi::RESTAPI::ParentalControl::ApplyConfigRawResult::Applied, "request should be applied");
+    ExpectEq(g_state.configureCalls, 1, "the gateway should be configured once");
+    Expect(elapsed < std::chrono::milliseconds(250), "a lone request should not wait for other changes");
+}
+
+void TestApplyConfigRawCoalescesOverlappingRequests() {
+    auto &logger = Poco::Logger::get("test");
+    g_state.configureDelayMs = 300;
+    std::vector<Poco::JSON::Array::Ptr> snapshots;
+    for (const auto &rule : {"firewall.pc_rule_g1", "firewall.pc_rule_g2", "firewall.pc_rule_g3"}) {
+        auto configRaw = Poco::JSON::Array::Ptr(new Poco::JSON::Array());
+        configRaw->add(MakeStringArray({"set", rule, "rule"}));
+        snapshots.push_back(configRaw);
+    }
+
+    std::vector<OpenWifi::RESTAPI::ParentalControl::ApplyConfigRawResult> results(
+        snapshots.size(), OpenWifi::RESTAPI::ParentalControl::ApplyConfigRawResult::GatewayConfigureFailed);
+    std::vector<std::thread> requests;
+    for (std::size_t i = 0; i < snapshots.size(); ++i) {
+        requests.emplace_back([&, i]() {
+            FakeResponse response;
+            FakeRequest request("POST", "/api/v1/group", "", response);
+            FakeRESTAPIHandler handler(logger, &request, &response);
+            results[i] = OpenWifi::RESTAPI::ParentalControl::ApplyConfigRaw(
+                handler, logger, "sub-1", "op-1", "group-1", snapshots[i], "DoPost", "group", "AABBCCDDEEFF");
+        });
+        // The first request is pushing when the others arrive, one after the other.
+        std::this_thread::sleep_for(std::chrono::milliseconds(i == 0 ? 100 : 50));
+    }
+    for (auto &request : requests) {
+        request.join();
+    }
+
+    for (const auto &result : results) {
+        Expect(result == OpenWifi::RESTAPI::ParentalControl::ApplyConfigRawResult::Applied,
+               "every request should complete with a push");
+    }
+    ExpectEq(g_state.configureCalls, 2, "requests overlapping a push should share the next one");
+    ExpectEq(g_state.configuredSerial, std::string("AABBCCDDEEFF"), "configured serial");
+    Expect(g_state.configuredObject && g_state.configuredObject->getArray("config-raw") == snapshots.back(),
+           "the latest config-raw snapshot should be pushed");
+}
+
 const std::vector<std::pair<std::string, std::function<void()>>> kTests = {
     {"ValidateAuthPreconditions", TestValidateAuthPreconditions},
     {"StripConfigRawFromMutationResponse", TestStripConfigRawFromMutationResponse},
     {"HandleParentalControlMutationResultOk", TestHandleParentalControlMutationResultOk},
+    {"ApplyConfigRawPushesAtOnceWhenIdle", TestApplyConfigRawPushesAtOnceWhenIdle},
+    {"ApplyConfigRawCoalescesOverlappingRequests", TestApplyConfigRawCoalescesOverlappingRequests},
     {"HandleParentalControlMutationResultNullResponseGuard", TestHandleParentalControlMutationResultNullResponseGuard},
     {"HandleParentalControlMutationResultBehaviorPreservation", TestHandleParentalControlMutationResultBehaviorPreservation},
     {"ForwardParentalControlErrorResponseStandardMapping", TestForwardParentalControlErrorResponseStandardMapping},
@@ -1595,6 +1827,9 @@ const std::vector<std::pair<std::string, std::function<void()>>> kTests = {
     {"ResolveSubscriberTimezoneEmptyTimezone", TestResolveSubscriberTimezoneEmptyTimezone},
     {"ResolveSubscriberTimezoneInvalidIanaTimezone", TestResolveSubscriberTimezoneInvalidIanaTimezone},
     {"ResolveSubscriberTimezoneAsiaKolkata", TestResolveSubscriberTimezoneAsiaKolkata},
+    {"ResolveSubscriberTimezoneServedFromCache", TestResolveSubscriberTimezoneServedFromCache},
+    {"ResolveSubscriberTimezoneNegativeCachedUntilProvisioningChange", TestResolveSubscriberTimezoneNegativeCachedUntilProvisioningChange},
+    {"ResolveSubscriberTimezoneUpstreamErrorsNotCached", TestResolveSubscriberTimezoneUpstreamErrorsNotCached},
     {"NormalizeScheduleResponseConvertsMinuteFields", TestNormalizeScheduleResponseConvertsMinuteFields},
     {"NormalizeScheduleResponseConvertsAsiaKolkata", TestNormalizeScheduleResponseConvertsAsiaKolkata},
     {"ScheduleConversionUtcSundayToKolkataMonday", TestScheduleConversionUtcSundayToKolkataMonday},
@@ -1620,6 +1855,9 @@ const std::vector<std::pair<std::string, std::function<void()>>> kTests = {
     {"GetBlockedClientsClientAccessOvernightWindowActive", TestGetBlockedClientsClientAccessOvernightWindowActive},
     {"GetBlockedClientsClientAccessOvernightFutureWindowInactive", TestGetBlockedClientsClientAccessOvernightFutureWindowInactive},
     {"GetBlockedClientsClientAccessOvernightExpiredWindowInactive", TestGetBlockedClientsClientAccessOvernightExpiredWindowInactive},
+    {"EvaluateBlockRulesOvernightSchedule", TestEvaluateBlockRulesOvernightSchedule},
+    {"BlockTimelineAdvancesAtTransitions", TestBlockTimelineAdvancesAtTransitions},
+    {"GetBlockedClientsCompiledRulesFollowConfigUuid", TestGetBlockedClientsCompiledRulesFollowConfigUuid},
 };
 
 } // namespace
@@ -1665,6 +1903,16 @@ namespace OpenWifi {
 
     void SubSystemServer::initialize(Poco::Util::Application &) {}
 
+    std::uint64_t MicroServiceConfigGetInt(const std::string &, std::uint64_t DefaultValue) { return DefaultValue; }
+
+    void KafkaManager::initialize(Poco::Util::Application &) {}
+    int KafkaManager::Start() { return 0; }
+    void KafkaManager::Stop() {}
+    void KafkaProducer::run() {}
+    void KafkaConsumer::run() {}
+    std::uint64_t KafkaConsumer::RegisterTopicWatcher(const std::string &, Types::TopicNotifyFunction &) { return 1; }
+    void KafkaConsumer::UnregisterTopicWatcher(const std::string &, int) {}
+
     bool AllowExternalMicroServices() { return false; }
     bool MicroServiceIsValidAPIKEY(const Poco::Net::HTTPServerRequest &) { return false; }
     bool AuthClient::IsValidApiKey(const std::string &, SecurityObjects::UserInfoAndPolicy &, unsigned long, bool &, bool &, bool &) { return false; }
@@ -4,8 +4,10 @@
  * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
  */
 
+#include <algorithm>
 #include <functional>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -66,12 +68,14 @@ struct RequestStubState {
     Poco::JSON::Object::Ptr nextObject = Poco::JSON::Object::Ptr(new Poco::JSON::Object());
     Poco::JSON::Array::Ptr nextArray = Poco::JSON::Array::Ptr(new Poco::JSON::Array());
     std::string nextRawBody;
+    std::map<std::string, std::vector<Poco::Net::HTTPResponse::HTTPStatus>> postStatusByEndpoint;
 
     std::string lastMethod;
     std::string lastType;
     std::string lastEndpoint;
     std::string lastBearerToken;
     std::string lastBodyJson;
+    std::vector<std::string> postEndpoints;
 };
 
 RequestStubState g_state;
@@ -116,7 +120,15 @@ OpenAPIRequestPost::Do(Poco::JSON::Object::Ptr &responseObject, const std::strin
     g_state.lastEndpoint = EndPoint_;
     g_state.lastBearerToken = bearerToken;
     g_state.lastBodyJson = ToJSONString(Body_);
+    g_state.postEndpoints.push_back(EndPoint_);
     responseObject = g_state.nextObject;
+    auto scripted = g_state.postStatusByEndpoint.find(EndPoint_);
+    if (scripted != g_state.postStatusByEndpoint.end() && !scripted->second.empty()) {
+        auto status = scripted->second.front();
+        scripted->second.erase(scripted->second.begin());
+        responseObject = Poco::makeShared<Poco::JSON::Object>();
+        return status;
+    }
     return g_state.nextStatus;
 }
 
@@ -153,6 +165,7 @@ OpenAPIRequestDelete::Do(Poco::JSON::Object::Ptr &responseObject, std::string &r
 
 #include "../../src/sdks/SDK_parental_control.cpp"
 #include "../../src/sdks/SDK_gw.cpp"
+#include "../../src/GatewayConfigCache.cpp"
 
 namespace {
 
@@ -694,6 +707,133 @@ void TestSetConfigTwoPassValidation() {
     }
 }
 
+void TestGatewayConfigCacheSharesSnapshotAndClonesForWriters() {
+    OpenWifi::GatewayConfigCache()->Start();
+
+    auto deviceObj = Poco::makeShared<Poco::JSON::Object>();
+    auto configObj = Poco::makeShared<Poco::JSON::Object>();
+    configObj->set("uuid", 5);
+    configObj->set("interfaces", Poco::makeShared<Poco::JSON::Array>());
+    deviceObj->set("configuration", configObj);
+    g_state.nextObject = deviceObj;
+
+    Poco::Net::HTTPResponse::HTTPStatus status = Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR;
+    Poco::JSON::Object::Ptr snapshot;
+    Expect(OpenWifi::SDK::GW::Device::GetConfigSnapshot(nullptr, "112233445566", status, snapshot), "first fetch should succeed");
+    ExpectEq(g_state.lastEndpoint, std::string("/api/v1/device/112233445566"), "first fetch should reach the controller");
+
+    g_state.lastEndpoint.clear();
+    Poco::JSON::Object::Ptr cached;
+    Expect(OpenWifi::SDK::GW::Device::GetConfigSnapshot(nullptr, "112233445566", status, cached), "cached fetch should succeed");
+    Expect(g_state.lastEndpoint.empty(), "cached fetch should not reach the controller");
+    Expect(cached.get() == snapshot.get(), "readers should share the snapshot");
+
+    Poco::JSON::Object::Ptr writable;
+    Expect(OpenWifi::SDK::GW::Device::GetConfig(nullptr, "112233445566", status, writable), "writer fetch should succeed");
+    ExpectEq(g_state.lastEndpoint, std::string("/api/v1/device/112233445566"), "writers should revalidate with the controller");
+    Expect(OpenWifi::SDK::GW::Device::GetConfigSnapshot(nullptr, "112233445566", status, snapshot), "cached fetch should succeed");
+    g_state.lastEndpoint.clear();
+    Expect(writable.get() != snapshot.get(), "writers should get their own copy");
+    writable->getObject("configuration")->set("config-raw", Poco::makeShared<Poco::JSON::Array>());
+    writable->getObject("configuration")->getArray("interfaces")->add(1);
+    Expect(!snapshot->getObject("configuration")->has("config-raw"), "writer changes must not leak into the snapshot");
+    ExpectEq(snapshot->getObject("configuration")->getArray("interfaces")->size(), static_cast<std::size_t>(0),
+             "nested writer changes must not leak into the snapshot");
+
+    OpenWifi::GatewayConfigCache()->StateEvent("112233445566", R"({"payload":{"serial":"112233445566","uuid":5}})");
+    Expect(OpenWifi::SDK::GW::Device::GetConfigSnapshot(nullptr, "112233445566", status, snapshot), "cached fetch should succeed");
+    Expect(g_state.lastEndpoint.empty(), "same configuration uuid should keep the entry");
+
+    OpenWifi::GatewayConfigCache()->StateEvent("112233445566",
+        R"({"payload":{"serial":"112233445566","state":{"interfaces":[{"uuid":7}]},"uuid":5}})");
+    Expect(OpenWifi::SDK::GW::Device::GetConfigSnapshot(nullptr, "112233445566", status, snapshot), "cached fetch should succeed");
+    Expect(g_state.lastEndpoint.empty(), "nested uuid keys should be ignored");
+
+    OpenWifi::GatewayConfigCache()->StateEvent("112233445566", R"({"payload":{"serial":"112233445566","uuid":6}})");
+    Expect(OpenWifi::SDK::GW::Device::GetConfigSnapshot(nullptr, "112233445566", status, snapshot), "refetch should succeed");
+    ExpectEq(g_state.lastEndpoint, std::string("/api/v1/device/112233445566"), "new configuration uuid should force a refetch");
+
+    Poco::JSON::Object::Ptr configureResponse;
+    auto newConfig = OpenWifi::GatewayConfigCache::Clone(snapshot->getObject("configuration"));
+    OpenWifi::SDK::GW::Device::Configure(nullptr, "112233445566", newConfig, status, configureResponse);
+    g_state.lastEndpoint.clear();
+    Expect(OpenWifi::SDK::GW::Device::GetConfigSnapshot(nullptr, "112233445566", status, snapshot), "refetch should succeed");
+    ExpectEq(g_state.lastEndpoint, std::string("/api/v1/device/112233445566"), "Configure should drop the cached configuration");
+
+    OpenWifi::GatewayConfigCache()->Stop();
+}
+
+void TestSetConfigConfiguresMeshNodesIndependently() {
+    auto deviceObj = Poco::makeShared<Poco::JSON::Object>();
+    auto configObj = Poco::makeShared<Poco::JSON::Object>();
+    auto interfaces = Poco::makeShared<Poco::JSON::Array>();
+    auto iface = Poco::makeShared<Poco::JSON::Object>();
+    auto ssids = Poco::makeShared<Poco::JSON::Array>();
+    auto ssid = Poco::makeShared<Poco::JSON::Object>();
+    ssid->set("name", "Old-SSID");
+    ssid->set("encryption", Poco::makeShared<Poco::JSON::Object>());
+    ssids->add(ssid);
+    iface->set("ssids", ssids);
+    interfaces->add(iface);
+    configObj->set("interfaces", interfaces);
+    deviceObj->set("configuration", configObj);
+    g_state.nextObject = deviceObj;
+
+    OpenWifi::ProvObjects::SubscriberDeviceList subDevices;
+    for (const auto &serial : {"112233445566", "aabbccddee01", "aabbccddee02", "aabbccddee03"}) {
+        OpenWifi::ProvObjects::SubscriberDevice dev;
+        dev.serialNumber = serial;
+        subDevices.subscriberDevices.push_back(dev);
+    }
+
+    // Node 01 times out and node 02 is rejected: neither is retried, and neither stops node 03.
+    g_state.postStatusByEndpoint["/api/v1/device/aabbccddee01/configure"] = {Poco::Net::HTTPResponse::HTTP_GATEWAY_TIMEOUT};
+    g_state.postStatusByEndpoint["/api/v1/device/aabbccddee02/configure"] = {Poco::Net::HTTPResponse::HTTP_BAD_REQUEST};
+
+    auto body = Poco::makeShared<Poco::JSON::Object>();
+    auto ssidBody = Poco::makeShared<Poco::JSON::Object>();
+    ssidBody->set("name", "New-SSID");
+    ssidBody->set("password", "ExamplePassword1");
+    body->set("ssid", ssidBody);
+
+    Poco::Net::HTTPResponse::HTTPStatus status = Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR;
+    Poco::JSON::Object::Ptr response;
+    bool success = OpenWifi::SDK::GW::Device::SetConfig(nullptr, body, subDevices, "112233445566", "sub-123", status, response);
+
+    Expect(!success, "SetConfig should report the failed mesh node");
+    ExpectEq(status, Poco::Net::HTTPResponse::HTTP_GATEWAY_TIMEOUT, "status should come from the first failed mesh node");
+    Expect(response && response->isArray("mesh"), "response must list the mesh nodes");
+    auto mesh = response->getArray("mesh");
+    ExpectEq(mesh->size(), static_cast<std::size_t>(3), "every mesh node should be reported");
+    ExpectEq(mesh->getObject(0)->getValue<std::string>("serialNumber"), std::string("aabbccddee01"), "results keep device order");
+    Expect(!mesh->getObject(0)->getValue<bool>("success"), "node 01 should fail");
+    Expect(!mesh->getObject(1)->getValue<bool>("success"), "node 02 should fail");
+    Expect(mesh->getObject(2)->getValue<bool>("success"), "node 03 should still be configured");
+
+    for (const auto &node : {"aabbccddee01", "aabbccddee02", "aabbccddee03"}) {
+        const auto endpoint = std::string("/api/v1/device/") + node + "/configure";
+        ExpectEq(static_cast<std::size_t>(std::count(g_state.postEndpoints.begin(), g_state.postEndpoints.end(), endpoint)),
+                 static_cast<std::size_t>(1), endpoint + " should be called once");
+    }
+}
+
+void TestGetOUIsFillsDuplicateMacs() {
+    auto tag = Poco::makeShared<Poco::JSON::Object>();
+    tag->set("tag", "aa:bb:cc:00:00:01");
+    tag->set("value", "Acme");
+    auto tags = Poco::makeShared<Poco::JSON::Array>();
+    tags->add(tag);
+    auto response = Poco::makeShared<Poco::JSON::Object>();
+    response->set("tagList", tags);
+    g_state.nextObject = response;
+
+    OpenWifi::Types::StringPairVec macList{{"aa:bb:cc:00:00:01", ""}, {"dd:ee:ff:00:00:01", ""}, {"aa:bb:cc:00:00:01", ""}};
+    Expect(OpenWifi::SDK::GW::Device::GetOUIs(nullptr, macList), "lookup should succeed");
+    ExpectEq(macList[0].second, std::string("Acme"), "first occurrence");
+    ExpectEq(macList[1].second, std::string(""), "MAC without a vendor");
+    ExpectEq(macList[2].second, std::string("Acme"), "repeated MAC");
+}
+
 const std::vector<std::pair<std::string, std::function<void()>>> kTests = {
     {"GetGroupDevicesSuccess", TestGetGroupDevicesSuccess},
     {"CreateGroupDeviceSuccess", TestCreateGroupDeviceSuccess},
@@ -710,6 +850,9 @@ const std::vector<std::pair<std::string, std::function<void()>>> kTests = {
     {"BearerTokenIsNotForwardedFromClient", TestBearerTokenIsNotForwardedFromClient},
     {"SetConfigDurationValidation", TestSetConfigDurationValidation},
     {"SetConfigTwoPassValidation", TestSetConfigTwoPassValidation},
+    {"GatewayConfigCacheSharesSnapshotAndClonesForWriters", TestGatewayConfigCacheSharesSnapshotAndClonesForWriters},
+    {"SetConfigConfiguresMeshNodesIndependently", TestSetConfigConfiguresMeshNodesIndependently},
+    {"GetOUIsFillsDuplicateMacs", TestGetOUIsFillsDuplicateMacs},
 };
 
 
@@ -756,6 +899,19 @@ namespace OpenWifi {
 
     void SubSystemServer::initialize(Poco::Util::Application &) {}
 
+    std::uint64_t MicroServiceConfigGetInt(const std::string &, std::uint64_t DefaultValue) { return DefaultValue; }
+
+    // No executor threads in this test: DoAsync/Async run every task on the calling thread.
+    bool OpenAPIExecutor::Submit(const Task &) { return false; }
+
+    void KafkaManager::initialize(Poco::Util::Application &) {}
+    int KafkaManager::Start() { return 0; }
+    void KafkaManager::Stop() {}
+    void KafkaProducer::run() {}
+    void KafkaConsumer::run() {}
+    std::uint64_t KafkaConsumer::RegisterTopicWatcher(const std::string &, Types::TopicNotifyFunction &) { return 1; }
+    void KafkaConsumer::UnregisterTopicWatcher(const std::string &, int) {}
+
     bool AllowExternalMicroServices() { return false; }
     bool MicroServiceIsValidAPIKEY(const Poco::Net::HTTPServerRequest &) { return false; }
     bool AuthClient::IsValidApiKey(const std::string &, SecurityObjects::UserInfoAndPolicy &, unsigned long, bool &, bool &, bool &) { return false; }
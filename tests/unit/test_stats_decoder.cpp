@@ -0,0 +1,220 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../../src/StatsDecoder.cpp"
+
+#ifndef STATS_SAMPLES_DIR
+#define STATS_SAMPLES_DIR "stats_samples"
+#endif
+
+namespace {
+
+class TestFailure : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+void Expect(bool condition, const std::string &message) {
+    if (!condition) {
+        throw TestFailure(message);
+    }
+}
+
+template <typename T, typename U> void ExpectEq(const T &actual, const U &expected, const std::string &message) {
+    if (!(actual == expected)) {
+        std::ostringstream os;
+        os << message << " expected=" << expected << " actual=" << actual;
+        throw TestFailure(os.str());
+    }
+}
+
+std::string LoadSample(const std::string &name) {
+    std::ifstream in(std::string(STATS_SAMPLES_DIR) + "/" + name);
+    Expect(in.good(), "cannot open sample " + name);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+void ResetState() {}
+
+void TestBridgeSample() {
+    OpenWifi::DeviceStatistics stats;
+    Expect(OpenWifi::StatsDecoder::DecodeState(LoadSample("bridge_stats.json"), stats), "sample should decode");
+    Expect(stats.HasVersion, "version");
+    Expect(stats.HasLocalTime, "unit.localtime");
+    ExpectEq(stats.LocalTime, 1646893048u, "localtime value");
+    ExpectEq(stats.Interfaces.size(), 1u, "interfaces");
+    ExpectEq(stats.Interfaces[0].Name, std::string("up0v100"), "interface name");
+    Expect(stats.Interfaces[0].HasCounters(), "interface counters");
+    ExpectEq(stats.Interfaces[0].RxBytes, 1027147259u, "interface rx_bytes");
+    ExpectEq(stats.Interfaces[0].TxBytes, 386397108u, "interface tx_bytes");
+    ExpectEq(stats.Clients.size(), 10u, "clients");
+    ExpectEq(stats.SSIDs.size(), 2u, "ssids");
+    ExpectEq(stats.Associations.size(), 10u, "associations");
+
+    const auto &client = stats.Clients[3];
+    ExpectEq(client.Mac, std::string("44:00:49:3d:66:7b"), "client mac");
+    ExpectEq(client.IPv4, std::string("10.100.34.123"), "client ipv4");
+    ExpectEq(client.IPv6, std::string("fe80:0:0:0:4600:49ff:fe3d:667b"), "client ipv6");
+
+    // Association counters must not be taken from the nested "deltas" object.
+    const auto &assoc = stats.Associations[0];
+    ExpectEq(assoc.Station, std::string("36:3b:d9:f3:bd:bb"), "station");
+    ExpectEq(stats.SSIDs[assoc.SSID].Name, std::string("petunia"), "ssid, declared after the associations");
+    ExpectEq(assoc.RSSI, -64, "rssi");
+    ExpectEq(assoc.RxBytes, 10109437u, "association rx_bytes");
+    ExpectEq(assoc.TxBytes, 31546941u, "association tx_bytes");
+}
+
+void TestNatSampleLocations() {
+    OpenWifi::DeviceStatistics stats;
+    Expect(OpenWifi::StatsDecoder::DecodeState(LoadSample("nat_stats.json"), stats), "sample should decode");
+    ExpectEq(stats.Interfaces.size(), 2u, "interfaces");
+    Expect(stats.Interfaces[0].External(), "/interfaces/0 is external");
+    Expect(!stats.Interfaces[1].External(), "/interfaces/1 is internal");
+    ExpectEq(stats.Clients.size(), 2u, "clients");
+    ExpectEq(stats.Clients[0].Interface, 0u, "clients belong to the first interface");
+    ExpectEq(stats.SSIDs.size(), 2u, "ssids");
+    ExpectEq(stats.SSIDs[0].Interface, 1u, "ssids belong to the second interface");
+    Expect(stats.Associations.empty(), "no associations");
+}
+
+void TestStateMessage() {
+    const std::string message =
+        R"({"payload":{"state":{"version":1,"unit":{"localtime":42},)"
+        R"("interfaces":[{"location":"/interfaces/1","counters":{"rx_bytes":5,"tx_bytes":6}}]},)"
+        R"("serial":"112233445566"}})";
+    OpenWifi::DeviceStatistics stats;
+    Expect(OpenWifi::StatsDecoder::DecodeStateMessage(message, stats), "message should decode");
+    ExpectEq(stats.Serial, std::string("112233445566"), "serial after the state");
+    Expect(stats.HasVersion && stats.HasLocalTime && stats.HasInterfaces, "state markers");
+    ExpectEq(stats.LocalTime, 42u, "localtime");
+    ExpectEq(stats.Interfaces.size(), 1u, "interfaces");
+    Expect(!stats.Interfaces[0].External(), "internal interface");
+    ExpectEq(stats.Interfaces[0].TxBytes, 6u, "tx_bytes");
+
+    Expect(OpenWifi::StatsDecoder::DecodeState(message, stats), "report decoder accepts any object");
+    Expect(stats.Interfaces.empty() && stats.Serial.empty(), "report decoder ignores the message envelope");
+}
+
+void TestMalformedInput() {
+    OpenWifi::DeviceStatistics stats;
+    const auto sample = LoadSample("bridge_stats.json");
+    Expect(!OpenWifi::StatsDecoder::DecodeState(sample.substr(0, sample.size() / 2), stats), "truncated report");
+    Expect(!OpenWifi::StatsDecoder::DecodeState("", stats), "empty report");
+    Expect(OpenWifi::StatsDecoder::DecodeState(R"({"interfaces":{"clients":[]}})", stats), "unexpected shapes are skipped");
+    Expect(!stats.HasInterfaces && stats.Interfaces.empty(), "interfaces must be an array");
+    Expect(OpenWifi::StatsDecoder::DecodeState(R"({"version":{"major":4}})", stats), "object version");
+    Expect(stats.HasVersion, "any version value marks the report");
+}
+
+void TestEscapedStrings() {
+    const std::string report =
+        R"({"ver\u0073ion":1,"interfaces":[{"name":"wan\t0","loc\"ation":"x",)"
+        R"("location":"\/interfaces\/1","clients":[{"mac":"aa","ipv4_addresses":["\u00e9\ud83d\ude00"]}]}]})";
+    OpenWifi::DeviceStatistics stats;
+    Expect(OpenWifi::StatsDecoder::DecodeState(report, stats), "report should decode");
+    Expect(stats.HasVersion, "escaped key");
+    ExpectEq(stats.Interfaces.size(), 1u, "interfaces");
+    ExpectEq(stats.Interfaces[0].Name, std::string("wan\t0"), "escaped value");
+    ExpectEq(stats.Interfaces[0].Location, std::string("/interfaces/1"), "escaped slashes");
+    Expect(!stats.Interfaces[0].External(), "internal interface");
+    ExpectEq(stats.Clients.size(), 1u, "clients");
+    ExpectEq(stats.Clients[0].IPv4, std::string("\xc3\xa9\xf0\x9f\x98\x80"), "unicode escapes");
+}
+
+void TestSeveralAddresses() {
+    OpenWifi::DeviceStatistics stats;
+    Expect(OpenWifi::StatsDecoder::DecodeState(
+               R"({"interfaces":[{"clients":[{"mac":"aa","ipv4_addresses":["10.0.0.1"]},)"
+               R"({"mac":"bb","ipv4_addresses":["10.0.0.2","10.0.0.3","10.0.0.4"]}]}]})",
+               stats),
+           "report should decode");
+    ExpectEq(stats.Clients.size(), 2u, "clients");
+    ExpectEq(stats.Clients[0].IPv4, std::string("10.0.0.1"), "single address");
+    Expect(stats.Clients[0].LastIPv4.empty(), "no last address for a single one");
+    ExpectEq(stats.Clients[1].IPv4, std::string("10.0.0.2"), "first address");
+    ExpectEq(stats.Clients[1].LastIPv4, std::string("10.0.0.4"), "last address");
+}
+
+void TestNumbers() {
+    OpenWifi::DeviceStatistics stats;
+    Expect(OpenWifi::StatsDecoder::DecodeState(
+               R"({"unit":{"localtime":1.7e9},"interfaces":[{"counters":{"rx_bytes":18446744073709551615,)"
+               R"("tx_bytes":0}}],"skipped":[-0.5e-3,-12,true,false,null]})",
+               stats),
+           "numbers should decode");
+    ExpectEq(stats.LocalTime, 1700000000u, "exponent");
+    ExpectEq(stats.Interfaces[0].RxBytes, UINT64_MAX, "largest counter");
+    Expect(stats.Interfaces[0].HasCounters(), "zero counter is present");
+}
+
+void TestRejectsInvalidJson() {
+    const std::vector<std::string> invalid = {
+        R"({"version":1} x)",      R"({"version":1,})",       R"({"version" 1})",
+        R"({"version":01})",       R"({"version":1.})",       R"({"version":-})",
+        R"({"version":tru})",      R"({"version":"a)",        "{\"version\":\"a\nb\"}",
+        R"({"version":"\x"})",     R"({"version":"\ud800"})", R"({"version":"\u12"})",
+        R"([1,2)",                 R"({"a":[1,2}})",          R"({version:1})",
+        std::string(100, '[') + std::string(100, ']'),
+    };
+    for (const auto &json : invalid) {
+        OpenWifi::DeviceStatistics stats;
+        Expect(!OpenWifi::StatsDecoder::DecodeState(json, stats), "should reject " + json);
+    }
+
+    OpenWifi::DeviceStatistics stats;
+    const auto sample = LoadSample("bridge_stats.json");
+    for (std::size_t length = 0; length < sample.size(); length += 97) {
+        Expect(!OpenWifi::StatsDecoder::DecodeState(std::string_view(sample.data(), length), stats),
+               "prefix of length " + std::to_string(length));
+    }
+}
+
+const std::vector<std::pair<std::string, std::function<void()>>> kTests = {
+    {"BridgeSample", TestBridgeSample},
+    {"NatSampleLocations", TestNatSampleLocations},
+    {"StateMessage", TestStateMessage},
+    {"MalformedInput", TestMalformedInput},
+    {"EscapedStrings", TestEscapedStrings},
+    {"SeveralAddresses", TestSeveralAddresses},
+    {"Numbers", TestNumbers},
+    {"RejectsInvalidJson", TestRejectsInvalidJson},
+};
+
+} // namespace
+
+int main() {
+    int failures = 0;
+    for (const auto &test : kTests) {
+        try {
+            ResetState();
+            test.second();
+
+            std::cout << "[PASS] " << test.first << std::endl;
+        } catch (const std::exception &e) {
+            ++failures;
+            std::cerr << "[FAIL] " << test.first << ": " << e.what() << std::endl;
+        }
+    }
+
+    if (failures != 0) {
+        std::cerr << failures << " test(s) failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << kTests.size() << " test(s) passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,520 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "StatsSvr.h"
+#include "framework/BoundedQueue.h"
+#include "framework/KafkaManager.h"
+#include "sdks/SDK_gw.h"
+
+namespace {
+
+class TestFailure : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+void Expect(bool condition, const std::string &message) {
+    if (!condition) {
+        throw TestFailure(message);
+    }
+}
+
+template <typename T, typename U> void ExpectEq(const T &actual, const U &expected, const std::string &message) {
+    if (!(actual == expected)) {
+        std::ostringstream os;
+        os << message << " expected=" << expected << " actual=" << actual;
+        throw TestFailure(os.str());
+    }
+}
+
+struct GatewayStubState {
+    bool available = true;
+    std::string report;
+    std::vector<std::string> requests;
+    std::map<std::string, std::uint64_t> config;
+};
+
+GatewayStubState g_state;
+
+void ResetState() { g_state = GatewayStubState{}; }
+
+std::string Report(const std::string &station, uint64_t rxBytes, uint64_t localtime = 1000) {
+    return R"({"version":1,"unit":{"localtime":)" + std::to_string(localtime) +
+           R"(},"interfaces":[{"location":"/interfaces/0","counters":{"rx_bytes":)" +
+           std::to_string(rxBytes) + R"(,"tx_bytes":10},)" +
+           R"("clients":[{"mac":")" + station + R"(","ipv4_addresses":["10.0.0.2"]}],)" +
+           R"("ssids":[{"ssid":"home","associations":[{"station":")" + station +
+           R"(","rssi":-50,"rx_bytes":)" + std::to_string(rxBytes) + R"(,"tx_bytes":7}]}]}]})";
+}
+
+std::string StateMessage(const std::string &serial, const std::string &state) {
+    return R"({"payload":{"serial":")" + serial + R"(","state":)" + state + "}}";
+}
+
+} // namespace
+
+namespace OpenWifi::SDK::GW::Device {
+bool GetLastStats(RESTAPIHandler *, const std::string &Mac, std::string &Response) {
+    g_state.requests.push_back(Mac);
+    if (!g_state.available) {
+        return false;
+    }
+    Response = g_state.report;
+    return true;
+}
+} // namespace OpenWifi::SDK::GW::Device
+
+#include "../../src/StatsDecoder.cpp"
+#include "../../src/StatsSvr.cpp"
+#include "../../src/StatsSnapshot.cpp"
+#include "../../src/TrafficHistory.cpp"
+
+namespace {
+
+void TestStateReportServedWithoutGateway() {
+    OpenWifi::StatsSvr()->ProcessState(StateMessage("112233445566", Report("aa:aa:aa:00:00:01", 100)));
+    auto stats = OpenWifi::StatsSvr()->ClientStatistics("112233445566");
+    Expect(stats != nullptr, "snapshot should be served");
+    Expect(g_state.requests.empty(), "gateway should not be asked");
+    ExpectEq(stats->Associations.size(), 1u, "associations");
+    ExpectEq(stats->Associations[0].Station, std::string("aa:aa:aa:00:00:01"), "station");
+    ExpectEq(stats->SSIDs[stats->Associations[0].SSID].Name, std::string("home"), "ssid");
+    ExpectEq(stats->Associations[0].RSSI, -50, "rssi");
+    ExpectEq(stats->Clients.size(), 1u, "clients");
+    ExpectEq(stats->Clients[0].IPv4, std::string("10.0.0.2"), "client ipv4");
+}
+
+void TestLatestReportReplacesSnapshot() {
+    OpenWifi::StatsSvr()->ProcessState(StateMessage("223344556677", Report("bb:bb:bb:00:00:01", 100, 1000)));
+    auto first = OpenWifi::StatsSvr()->ClientStatistics("223344556677");
+    OpenWifi::StatsSvr()->ProcessState(StateMessage("223344556677", Report("bb:bb:bb:00:00:02", 300, 1060)));
+    auto second = OpenWifi::StatsSvr()->ClientStatistics("223344556677");
+    Expect(first != nullptr && second != nullptr, "snapshots should be served");
+    ExpectEq(first->Associations[0].Station, std::string("bb:bb:bb:00:00:01"), "earlier snapshot is unchanged");
+    ExpectEq(second->Associations[0].Station, std::string("bb:bb:bb:00:00:02"), "latest snapshot");
+    Expect(g_state.requests.empty(), "gateway should not be asked");
+
+    OpenWifi::SubObjects::StatsBlock block;
+    OpenWifi::StatsSvr()->Get("223344556677", block);
+    ExpectEq(block.external.size(), 1u, "traffic history still kept");
+    ExpectEq(block.external[0].rx, 200u, "traffic delta");
+}
+
+void TestUnknownDeviceAsksGateway() {
+    g_state.report = Report("cc:cc:cc:00:00:01", 5);
+    auto stats = OpenWifi::StatsSvr()->ClientStatistics("334455667788");
+    ExpectEq(g_state.requests.size(), 1u, "gateway should be asked once");
+    ExpectEq(g_state.requests[0], std::string("334455667788"), "gateway asked for the device");
+    Expect(stats != nullptr, "gateway statistics should be decoded");
+    ExpectEq(stats->Associations[0].Station, std::string("cc:cc:cc:00:00:01"), "station from the gateway");
+
+    g_state.available = false;
+    Expect(OpenWifi::StatsSvr()->ClientStatistics("334455667788") == nullptr, "no statistics anywhere");
+
+    g_state.available = true;
+    g_state.report = "{";
+    Expect(OpenWifi::StatsSvr()->ClientStatistics("334455667788") == nullptr, "malformed gateway statistics");
+}
+
+void TestIncompleteMessagesIgnored() {
+    OpenWifi::StatsSvr()->ProcessState(R"({"payload":{"serial":"445566778899","state":{"unit":{}}}})");
+    OpenWifi::StatsSvr()->ProcessState(StateMessage("", Report("dd:dd:dd:00:00:01", 1)));
+    OpenWifi::StatsSvr()->ProcessState("not json");
+    g_state.available = false;
+    Expect(OpenWifi::StatsSvr()->ClientStatistics("445566778899") == nullptr, "no snapshot without interfaces");
+    ExpectEq(g_state.requests.size(), 1u, "gateway should be asked");
+}
+
+void TestStoreCountsDevicesAndMemory() {
+    OpenWifi::DeviceStatsStore store;
+    ExpectEq(store.Devices(), 0u, "empty store");
+    const auto empty = store.MemoryUse();
+
+    auto small = std::make_shared<OpenWifi::DeviceStatistics>();
+    small->Clients.resize(1);
+    for (uint64_t serial = 1; serial <= 100; ++serial) {
+        store.SetClients(serial, small, 1);
+        store.AddTraffic(serial, 10, 1, 1, 1, 1);
+    }
+    ExpectEq(store.Devices(), 100u, "one entry per device");
+    const auto filled = store.MemoryUse();
+    Expect(filled > empty, "entries should be accounted");
+
+    auto large = std::make_shared<OpenWifi::DeviceStatistics>();
+    large->Clients.resize(50);
+    large->Clients[0].Mac = std::string(64, 'a');
+    store.SetClients(7, large, 2);
+    ExpectEq(store.Devices(), 100u, "replacing a snapshot keeps the count");
+    ExpectEq(store.MemoryUse() - filled,
+             OpenWifi::DeviceStatsStore::Footprint(*large) - OpenWifi::DeviceStatsStore::Footprint(*small),
+             "replaced snapshot accounting");
+
+    uint64_t received = 0;
+    ExpectEq(store.GetClients(7, received), std::shared_ptr<const OpenWifi::DeviceStatistics>(large), "latest snapshot");
+    ExpectEq(received, 2u, "snapshot time");
+    Expect(store.GetClients(1000, received) == nullptr, "unknown device");
+}
+
+void TestConcurrentIngestAndReads() {
+    OpenWifi::DeviceStatsStore store;
+    auto snapshot = std::make_shared<const OpenWifi::DeviceStatistics>();
+    std::vector<std::thread> threads;
+    for (uint64_t writer = 0; writer < 4; ++writer) {
+        threads.emplace_back([&store, &snapshot, writer] {
+            for (uint64_t i = 0; i < 2000; ++i) {
+                const auto serial = writer * 100000 + i % 500;
+                store.AddTraffic(serial, i, i, i, i, i);
+                store.SetClients(serial, snapshot, i);
+            }
+        });
+    }
+    for (int reader = 0; reader < 4; ++reader) {
+        threads.emplace_back([&store] {
+            for (uint64_t i = 0; i < 2000; ++i) {
+                OpenWifi::SubObjects::StatsBlock block;
+                store.GetTraffic(i % 500, block);
+                uint64_t received = 0;
+                store.GetClients(i % 500, received);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    ExpectEq(store.Devices(), 2000u, "every device stored once");
+
+    OpenWifi::SubObjects::StatsBlock block;
+    store.GetTraffic(100000 + 499, block);
+    ExpectEq(block.external.size(), 3u, "four updates after the base value");
+}
+
+void TestBoundedQueueLimits() {
+    OpenWifi::BoundedQueue<std::string> queue(3);
+    ExpectEq(queue.Capacity(), 4u, "capacity rounded to a power of two");
+    for (int i = 0; i < 4; ++i) {
+        Expect(queue.Push(std::to_string(i)), "push below capacity");
+    }
+    std::string rejected = "kept";
+    Expect(!queue.Push(std::move(rejected)), "push on a full queue");
+    ExpectEq(rejected, std::string("kept"), "rejected value is not consumed");
+    ExpectEq(queue.Size(), 4u, "size when full");
+
+    std::string value;
+    for (int i = 0; i < 4; ++i) {
+        Expect(queue.Pop(value), "pop");
+        ExpectEq(value, std::to_string(i), "FIFO order");
+    }
+    Expect(!queue.Pop(value), "pop on an empty queue");
+    Expect(queue.Push(std::move(rejected)), "push after draining");
+}
+
+void TestBoundedQueueConcurrentProducers() {
+    OpenWifi::BoundedQueue<std::uint64_t> queue(64);
+    constexpr std::uint64_t kPerProducer = 20000;
+    std::atomic<std::uint64_t> sum{0}, count{0};
+    std::vector<std::thread> threads;
+    for (std::uint64_t p = 0; p < 4; ++p) {
+        threads.emplace_back([&queue, p] {
+            for (std::uint64_t i = 1; i <= kPerProducer; ++i) {
+                std::uint64_t value = p * kPerProducer + i;
+                while (!queue.Push(std::move(value))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < 4; ++c) {
+        threads.emplace_back([&] {
+            std::uint64_t value = 0;
+            while (count.load() < 4 * kPerProducer) {
+                if (queue.Pop(value)) {
+                    sum += value;
+                    ++count;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    const std::uint64_t n = 4 * kPerProducer;
+    ExpectEq(count.load(), n, "every value popped once");
+    ExpectEq(sum.load(), n * (n + 1) / 2, "no value lost or duplicated");
+}
+
+void TestIngestKeepsDeviceOrder() {
+    g_state.config["statscache.workers"] = 3;
+    g_state.config["statscache.queue.size"] = 16;
+    g_state.config["statscache.snapshot.interval"] = 0;
+    g_state.available = false;
+    const std::vector<std::string> serials{"5566778899a0", "5566778899a1", "5566778899a2", "5566778899a3"};
+    OpenWifi::StatsSvr()->Start();
+    for (int i = 0; i < 300; ++i) {
+        for (const auto &serial : serials) {
+            OpenWifi::StatsSvr()->StatsReceived(
+                serial, StateMessage(serial, Report("ee:ee:ee:00:" + std::to_string(1000 + i), 10 * i, 1000 + i)));
+        }
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    std::size_t done = 0;
+    while (done < serials.size() && std::chrono::steady_clock::now() < deadline) {
+        done = 0;
+        for (const auto &serial : serials) {
+            auto stats = OpenWifi::StatsSvr()->ClientStatistics(serial);
+            if (stats && stats->Associations[0].Station == "ee:ee:ee:00:1299") {
+                ++done;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    OpenWifi::StatsSvr()->Stop();
+    ExpectEq(done, serials.size(), "last report of every device applied");
+
+    for (const auto &serial : serials) {
+        OpenWifi::SubObjects::StatsBlock block;
+        OpenWifi::StatsSvr()->Get(serial, block);
+        ExpectEq(block.external.size(), 20u, "traffic history is full");
+        Expect(std::all_of(block.external.begin(), block.external.end(),
+                           [](const auto &entry) { return entry.rx == 10; }),
+               "reports applied in order");
+    }
+}
+
+void TestTrafficLayoutParsing() {
+    std::string rejected;
+    OpenWifi::TrafficLayout layout(4, " 3600:24, 60:10,bad,60:5,0:3,900:0,86400:7", &rejected);
+    ExpectEq(layout.Tiers().size(), 4u, "raw tier and three rollups");
+    ExpectEq(layout.Tiers()[1].Resolution, 60u, "rollups sorted by resolution");
+    ExpectEq(layout.Tiers()[3].Resolution, 86400u, "coarsest rollup last");
+    ExpectEq(rejected, std::string("bad,60:5,0:3,900:0"), "rejected entries");
+    ExpectEq(layout.ToString(), std::string("raw:4,60:10,3600:24,86400:7"), "layout description");
+    ExpectEq(layout.Words(), 2u + 5 * 4 + 3 * 2 + 14 * (10 + 24 + 7), "words per device");
+    ExpectEq(layout.DeviceBytes(), layout.Words() * sizeof(uint64_t), "bytes per device");
+    Expect(layout.Find(0) == nullptr && layout.Find(900) == nullptr, "unknown tiers");
+    Expect(layout.Find(3600) != nullptr, "known tier");
+}
+
+void TestTrafficHistoryRing() {
+    auto layout = std::make_shared<const OpenWifi::TrafficLayout>(3, "");
+    OpenWifi::TrafficHistory history;
+    history.AddValue(layout, 100, 1000, 2000, 3000, 4000, 1);
+    ExpectEq(history.Bytes(), 0u, "nothing allocated for the base value");
+    for (uint64_t i = 1; i <= 5; ++i) {
+        history.AddValue(layout, 100 + i, 1000 + i * i, 2000 + i, 3000 + i, 4000 + i, 1 + i);
+    }
+    ExpectEq(history.Bytes(), layout->DeviceBytes(), "fixed allocation");
+
+    OpenWifi::SubObjects::StatsBlock block;
+    history.Get(block);
+    ExpectEq(block.modified, 6u, "last update");
+    ExpectEq(block.external.size(), 3u, "ring keeps the last samples");
+    ExpectEq(block.external[0].timestamp, 103u, "oldest sample first");
+    ExpectEq(block.external[2].timestamp, 105u, "latest sample last");
+    ExpectEq(block.external[2].tx, 9u, "tx delta");
+    ExpectEq(block.internal[1].rx, 1u, "rx delta");
+
+    history.AddValue(layout, 106, 10, 2006, 3006, 4006, 7);
+    block = {};
+    history.Get(block);
+    ExpectEq(block.external[2].tx, 10u, "counter restart counts from zero");
+}
+
+void TestTrafficHistoryRollups() {
+    auto layout = std::make_shared<const OpenWifi::TrafficLayout>(2, "60:2,3600:4");
+    OpenWifi::TrafficHistory history;
+    history.AddValue(layout, 0, 0, 0, 0, 0, 1);
+    uint64_t total = 0;
+    const std::vector<std::pair<uint64_t, uint64_t>> samples{{10, 5}, {50, 1}, {70, 7}, {130, 2}, {3700, 4}};
+    for (const auto &[ts, rx] : samples) {
+        total += rx;
+        history.AddValue(layout, ts, 0, total, 0, 0, 1);
+    }
+
+    OpenWifi::SubObjects::StatsRollupBlock minutes;
+    Expect(history.GetRollup(60, minutes), "minute tier");
+    ExpectEq(minutes.resolution, 60u, "resolution");
+    ExpectEq(minutes.external.size(), 2u, "minute ring keeps two periods");
+    ExpectEq(minutes.external[0].timestamp, 120u, "period start");
+    ExpectEq(minutes.external[1].timestamp, 3660u, "gaps are not filled");
+
+    OpenWifi::SubObjects::StatsRollupBlock hours;
+    Expect(history.GetRollup(3600, hours), "hour tier");
+    ExpectEq(hours.external.size(), 2u, "two hours seen");
+    ExpectEq(hours.external[0].samples, 4u, "samples in the first hour");
+    ExpectEq(hours.external[0].rxMin, 1u, "min");
+    ExpectEq(hours.external[0].rxMax, 7u, "max");
+    ExpectEq(hours.external[0].rxSum, 15u, "sum");
+    ExpectEq(hours.external[1].rxSum, 4u, "second hour");
+
+    history.AddValue(layout, 30, 0, total + 9, 0, 0, 1);
+    hours = {};
+    history.GetRollup(3600, hours);
+    ExpectEq(hours.external.size(), 2u, "a clock going back does not reopen a period");
+    ExpectEq(hours.external[1].rxSum, 4u, "latest period unchanged");
+
+    OpenWifi::SubObjects::StatsRollupBlock none;
+    Expect(!history.GetRollup(900, none), "no such tier");
+}
+
+void TestSnapshotRestoresHistory() {
+    const auto file = (std::filesystem::temp_directory_path() / "test_stats_svr_snapshot.bin").string();
+    std::filesystem::remove(file);
+
+    OpenWifi::DeviceStatsStore first;
+    first.SetLayout(std::make_shared<const OpenWifi::TrafficLayout>(4, "60:3"));
+    for (uint64_t i = 0; i < 3; ++i) {
+        for (uint64_t serial = 1; serial <= 100; ++serial) {
+            first.AddTraffic(serial, 1000 + 60 * i, serial * i, 2 * i, 3 * i, 4 * i);
+        }
+    }
+    first.SetClients(500, nullptr, 1);
+    {
+        OpenWifi::StatsSnapshot snapshot;
+        Expect(snapshot.Open(file, first.Layout(), 8), "snapshot created");
+        ExpectEq(first.Checkpoint(snapshot), 100u, "every device with traffic written");
+        ExpectEq(first.Checkpoint(snapshot), 0u, "nothing changed since");
+        first.AddTraffic(7, 1180, 21, 6, 9, 12);
+        ExpectEq(first.Checkpoint(snapshot), 1u, "only the changed device written");
+        ExpectEq(snapshot.Count(), 100u, "one record per device");
+        ExpectEq(snapshot.FileBytes(), 64u + 128 * snapshot.RecordWords() * sizeof(uint64_t), "file doubled");
+    }
+
+    OpenWifi::DeviceStatsStore second;
+    second.SetLayout(std::make_shared<const OpenWifi::TrafficLayout>(4, "60:3"));
+    OpenWifi::StatsSnapshot snapshot;
+    Expect(snapshot.Open(file, second.Layout()), "snapshot reopened");
+    ExpectEq(second.Restore(snapshot), 100u, "devices restored");
+    ExpectEq(second.Devices(), 100u, "restored devices stored");
+    for (uint64_t serial : {1u, 7u, 100u}) {
+        OpenWifi::SubObjects::StatsBlock before, after;
+        first.GetTraffic(serial, before);
+        second.GetTraffic(serial, after);
+        ExpectEq(after.external.size(), before.external.size(), "same samples");
+        ExpectEq(after.modified, before.modified, "same update time");
+        for (std::size_t i = 0; i < before.external.size(); ++i) {
+            ExpectEq(after.external[i].tx, before.external[i].tx, "same tx");
+            ExpectEq(after.internal[i].rx, before.internal[i].rx, "same rx");
+        }
+        OpenWifi::SubObjects::StatsRollupBlock rollup;
+        Expect(second.GetTrafficRollup(serial, 60, rollup), "rollup restored");
+        ExpectEq(rollup.external.size(), serial == 7 ? 3u : 2u, "rollup periods");
+    }
+
+    second.AddTraffic(1, 1240, 10, 10, 10, 10);
+    OpenWifi::SubObjects::StatsBlock block;
+    second.GetTraffic(1, block);
+    ExpectEq(block.external.back().tx, 8u, "restored base counters");
+    Expect(second.MemoryUse() > 100 * second.Layout().DeviceBytes(), "restored histories accounted");
+    snapshot.Close();
+
+    OpenWifi::DeviceStatsStore other;
+    other.SetLayout(std::make_shared<const OpenWifi::TrafficLayout>(5, "60:3"));
+    Expect(snapshot.Open(file, other.Layout()), "snapshot of another layout replaced");
+    ExpectEq(snapshot.Count(), 0u, "histories of another layout discarded");
+    snapshot.Close();
+    std::filesystem::remove(file);
+}
+
+const std::vector<std::pair<std::string, std::function<void()>>> kTests = {
+    {"StateReportServedWithoutGateway", TestStateReportServedWithoutGateway},
+    {"LatestReportReplacesSnapshot", TestLatestReportReplacesSnapshot},
+    {"UnknownDeviceAsksGateway", TestUnknownDeviceAsksGateway},
+    {"IncompleteMessagesIgnored", TestIncompleteMessagesIgnored},
+    {"StoreCountsDevicesAndMemory", TestStoreCountsDevicesAndMemory},
+    {"ConcurrentIngestAndReads", TestConcurrentIngestAndReads},
+    {"BoundedQueueLimits", TestBoundedQueueLimits},
+    {"BoundedQueueConcurrentProducers", TestBoundedQueueConcurrentProducers},
+    {"IngestKeepsDeviceOrder", TestIngestKeepsDeviceOrder},
+    {"TrafficLayoutParsing", TestTrafficLayoutParsing},
+    {"TrafficHistoryRing", TestTrafficHistoryRing},
+    {"TrafficHistoryRollups", TestTrafficHistoryRollups},
+    {"SnapshotRestoresHistory", TestSnapshotRestoresHistory},
+};
+
+} // namespace
+
+namespace OpenWifi {
+    SubSystemServer::SubSystemServer(const std::string &Name, const std::string &LoggingPrefix,
+                                     const std::string &SubSystemConfigPrefix)
+        : Name_(Name), LoggerPrefix_(LoggingPrefix), SubSystemConfigPrefix_(SubSystemConfigPrefix),
+          Logger_(std::make_unique<LoggerWrapper>(Poco::Logger::get(LoggingPrefix))) {}
+
+    void SubSystemServer::initialize(Poco::Util::Application &) {}
+
+    std::uint64_t MicroServiceConfigGetInt(const std::string &Key, std::uint64_t DefaultValue) {
+        auto it = g_state.config.find(Key);
+        return it == g_state.config.end() ? DefaultValue : it->second;
+    }
+
+    std::string MicroServiceConfigGetString(const std::string &, const std::string &DefaultValue) {
+        return DefaultValue;
+    }
+
+    std::string MicroServiceConfigPath(const std::string &, const std::string &DefaultValue) {
+        return DefaultValue;
+    }
+
+    const std::string &MicroServiceDataDirectory() {
+        static const std::string directory = std::filesystem::temp_directory_path().string();
+        return directory;
+    }
+
+    void KafkaManager::initialize(Poco::Util::Application &) {}
+    int KafkaManager::Start() { return 0; }
+    void KafkaManager::Stop() {}
+    void KafkaProducer::run() {}
+    void KafkaConsumer::run() {}
+    std::uint64_t KafkaConsumer::RegisterTopicWatcher(const std::string &, Types::TopicNotifyFunction &) { return 1; }
+    void KafkaConsumer::UnregisterTopicWatcher(const std::string &, int) {}
+}
+
+namespace OpenWifi::Utils {
+    bool ValidSerialNumber(const std::string &Serial) {
+        return Serial.size() == 12 &&
+               std::all_of(Serial.begin(), Serial.end(), [](unsigned char c) { return std::isxdigit(c) != 0; });
+    }
+    uint64_t SerialNumberToInt(const std::string &S) { return std::stoull(S, nullptr, 16); }
+}
+
+int main() {
+    int failures = 0;
+    for (const auto &test : kTests) {
+        try {
+            ResetState();
+            test.second();
+
+            std::cout << "[PASS] " << test.first << std::endl;
+        } catch (const std::exception &e) {
+            ++failures;
+            std::cerr << "[FAIL] " << test.first << ": " << e.what() << std::endl;
+        }
+    }
+
+    if (failures != 0) {
+        std::cerr << failures << " test(s) failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << kTests.size() << " test(s) passed." << std::endl;
+    return 0;
+}
@@ -7,6 +7,9 @@
 #include "test_parental_control_test_helpers.h"
 #include "RESTObjects/RESTAPI_ProvObjects.h"
 #include "RESTAPI/RESTAPI_subscriber_location_handler.h"
+#include "VenueContextCache.h"
+#include "framework/KafkaManager.h"
+#include "framework/MicroServiceFuncs.h"
 
 namespace {
 
@@ -30,7 +33,11 @@ struct State {
     std::string capturedTz, capturedVenueId, capturedLocId;
 } g;
 
-void Reset() { g = State{}; g.locResponse = Poco::JSON::Object::Ptr(new Poco::JSON::Object()); }
+void Reset() {
+    g = State{};
+    g.locResponse = Poco::JSON::Object::Ptr(new Poco::JSON::Object());
+    OpenWifi::VenueContextCache()->Clear();
+}
 
 class Handler final : public OpenWifi::RESTAPI_subscriber_location_handler {
   public:
@@ -121,7 +128,20 @@ bool Delete(RESTAPIHandler *, const std::string &lid,
 }
 } // namespace OpenWifi::SDK::Prov::Location
 
+namespace OpenWifi {
+std::uint64_t MicroServiceConfigGetInt(const std::string &, std::uint64_t DefaultValue) { return DefaultValue; }
+
+void KafkaManager::initialize(Poco::Util::Application &) {}
+int KafkaManager::Start() { return 0; }
+void KafkaManager::Stop() {}
+void KafkaProducer::run() {}
+void KafkaConsumer::run() {}
+std::uint64_t KafkaConsumer::RegisterTopicWatcher(const std::string &, Types::TopicNotifyFunction &) { return 1; }
+void KafkaConsumer::UnregisterTopicWatcher(const std::string &, int) {}
+} // namespace OpenWifi
+
 #include "../../src/RESTAPI/RESTAPI_subscriber_location_handler.cpp"
+#include "../../src/VenueContextCache.cpp"
 
 namespace {
 
@@ -174,6 +194,16 @@ void TestPostOk() { Run("POST",kSubscriber, HTTP::HTTP_OK,
         ExpectEq(g.capturedVenueId,kVenueId,"venue id");
         ExpectEq(g.capturedTz,kGoodTz,"tz forwarded"); }); }
 
+void TestPostInvalidatesCachedContext() {
+    OpenWifi::VenueContext venue; venue.venueId = kVenueId;
+    OpenWifi::VenueContextCache()->UpdateBySubscriber(kSubscriber, venue, true);
+    Run("POST",kSubscriber, HTTP::HTTP_OK,
+    [](Handler &h){ h.setBody(Body({{"timezone",kGoodTz}})); },
+    [](const FakeResponse&){
+        OpenWifi::VenueContext cached;
+        Expect(OpenWifi::VenueContextCache()->GetBySubscriber(kSubscriber, cached) == OpenWifi::VenueContextLookup::Miss,
+               "no timezone entry dropped"); }); }
+
 // ---- PUT ------------------------------------------------------------------
 void TestPutNoAuth()    { Run("PUT","", HTTP::HTTP_FORBIDDEN); }
 void TestPutEmptyBody() { g.venueLocId=kLocationId; Run("PUT",kSubscriber, HTTP::HTTP_BAD_REQUEST,
@@ -198,6 +228,17 @@ void TestPutOk()        { g.venueLocId=kLocationId; Run("PUT",kSubscriber, HTTP:
         ExpectEq(g.putCalls,1,"put called"); ExpectEq(g.capturedLocId,kLocationId,"loc id");
         ExpectEq(g.capturedTz,kGoodTz,"tz forwarded"); }); }
 
+void TestPutInvalidatesCachedContext() {
+    g.venueLocId = kLocationId;
+    OpenWifi::VenueContext venue; venue.venueId = kVenueId; venue.locationId = kLocationId; venue.timezone = kGoodTz;
+    OpenWifi::VenueContextCache()->UpdateByGateway("gateway-1", venue);
+    Run("PUT",kSubscriber, HTTP::HTTP_OK,
+    [](Handler &h){ h.setBody(Body({{"timezone","Asia/Kolkata"}})); },
+    [](const FakeResponse&){
+        OpenWifi::VenueContext cached;
+        Expect(OpenWifi::VenueContextCache()->GetByGateway("gateway-1", cached) == OpenWifi::VenueContextLookup::Miss,
+               "entry built from the location dropped"); }); }
+
 // ---- DELETE ---------------------------------------------------------------
 void TestDeleteNoAuth()    { Run("DELETE","", HTTP::HTTP_FORBIDDEN); }
 void TestDeleteNoLocation(){ Run("DELETE",kSubscriber, HTTP::HTTP_NOT_FOUND, nullptr,
@@ -243,12 +284,14 @@ const std::vector<std::pair<std::string,std::function<void()>>> kTests = {
     {"PostDuplicate",       TestPostDuplicate},
     {"PostUnallowedField",  TestPostUnallowedField},
     {"PostOk",              TestPostOk},
+    {"PostInvalidatesCachedContext", TestPostInvalidatesCachedContext},
     {"PutNoAuth",           TestPutNoAuth},
     {"PutEmptyBody",        TestPutEmptyBody},
     {"PutForbiddenFields",  TestPutForbiddenFields},
     {"PutBadTz",            TestPutBadTz},
     {"PutNoLocation",       TestPutNoLocation},
     {"PutOk",               TestPutOk},
+    {"PutInvalidatesCachedContext", TestPutInvalidatesCachedContext},
     {"DeleteNoAuth",        TestDeleteNoAuth},
     {"DeleteNoLocation",    TestDeleteNoLocation},
     {"DeleteOk",            TestDeleteOk},
@@ -0,0 +1,203 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "framework/TokenCache.h"
+
+namespace {
+
+class TestFailure : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+void Expect(bool condition, const std::string &message) {
+    if (!condition) {
+        throw TestFailure(message);
+    }
+}
+
+template <typename T, typename U> void ExpectEq(const T &actual, const U &expected, const std::string &message) {
+    if (!(actual == expected)) {
+        std::ostringstream os;
+        os << message << " expected=" << expected << " actual=" << actual;
+        throw TestFailure(os.str());
+    }
+}
+
+using Cache = OpenWifi::TokenCache<std::string>;
+
+void TestExpiry() {
+    Cache cache(1000);
+    std::shared_ptr<const std::string> value;
+    Expect(cache.Get("a", 100, value) == Cache::Lookup::Miss, "unknown token");
+    cache.Put("a", std::make_shared<const std::string>("alice"), 200);
+    Expect(cache.Get("a", 199, value) == Cache::Lookup::Valid, "valid until it expires");
+    ExpectEq(*value, std::string("alice"), "cached value");
+    Expect(cache.Get("a", 200, value) == Cache::Lookup::Miss, "expired");
+    Expect(cache.Get("a", 100, value) == Cache::Lookup::Miss, "expired entries are dropped");
+
+    cache.PutInvalid("b", 130);
+    Expect(cache.Get("b", 120, value) == Cache::Lookup::Invalid, "invalid token remembered");
+    Expect(cache.Get("b", 130, value) == Cache::Lookup::Miss, "for a short time");
+
+    cache.Put("c", std::make_shared<const std::string>("carol"), 300);
+    cache.Remove("c");
+    Expect(cache.Get("c", 100, value) == Cache::Lookup::Miss, "removed token");
+
+    const auto stats = cache.GetStats();
+    ExpectEq(stats.Hits, 1u, "hits");
+    ExpectEq(stats.InvalidHits, 1u, "invalid hits");
+    ExpectEq(stats.Misses, 5u, "misses");
+    ExpectEq(stats.Expired, 2u, "expired");
+    ExpectEq(stats.Entries, 0u, "entries");
+}
+
+void TestLeastRecentlyUsedEvicted() {
+    Cache cache(Cache::ShardCount * 2);
+    ExpectEq(cache.Capacity(), Cache::ShardCount * 2, "capacity");
+    // Find three keys of the same shard.
+    std::vector<std::string> keys;
+    const auto shard = std::hash<std::string>{}("key0") % Cache::ShardCount;
+    for (int i = 0; keys.size() < 3; ++i) {
+        auto key = "key" + std::to_string(i);
+        if (std::hash<std::string>{}(key) % Cache::ShardCount == shard) {
+            keys.push_back(key);
+        }
+    }
+
+    std::shared_ptr<const std::string> value;
+    cache.Put(keys[0], std::make_shared<const std::string>("0"), 1000);
+    cache.Put(keys[1], std::make_shared<const std::string>("1"), 1000);
+    Expect(cache.Get(keys[0], 1, value) == Cache::Lookup::Valid, "first key used again");
+    cache.Put(keys[2], std::make_shared<const std::string>("2"), 1000);
+    Expect(cache.Get(keys[1], 1, value) == Cache::Lookup::Miss, "least recently used evicted");
+    Expect(cache.Get(keys[0], 1, value) == Cache::Lookup::Valid, "recently used kept");
+    Expect(cache.Get(keys[2], 1, value) == Cache::Lookup::Valid, "new entry kept");
+    ExpectEq(cache.GetStats().Evictions, 1u, "evictions");
+
+    cache.Put(keys[0], std::make_shared<const std::string>("updated"), 1000);
+    Expect(cache.Get(keys[0], 1, value) == Cache::Lookup::Valid && *value == "updated", "entry replaced");
+    ExpectEq(cache.GetStats().Entries, 2u, "replacing keeps one entry");
+
+    cache.SetCapacity(10);
+    ExpectEq(cache.GetStats().Entries, 0u, "resizing drops the entries");
+}
+
+void TestConcurrentLookups() {
+    Cache cache(100000);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&cache, t] {
+            std::shared_ptr<const std::string> value;
+            for (int i = 0; i < 20000; ++i) {
+                const auto key = "token" + std::to_string((i * 7 + t) % 5000);
+                if (cache.Get(key, 1, value) == Cache::Lookup::Miss) {
+                    cache.Put(key, std::make_shared<const std::string>(key), 1000);
+                } else if (*value != key) {
+                    throw TestFailure("wrong value for " + key);
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    const auto stats = cache.GetStats();
+    ExpectEq(stats.Entries, 5000u, "one entry per token");
+    ExpectEq(stats.Hits + stats.Misses, 8u * 20000, "every lookup counted");
+}
+
+void TestSingleFlight() {
+    OpenWifi::SingleFlight<int> flights;
+    std::atomic<int> calls{0}, shared{0};
+    std::atomic<bool> release{false};
+    std::vector<std::thread> threads;
+    std::vector<int> results(8, 0);
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t] {
+            bool wasShared = false;
+            results[t] = flights.Do(
+                "token",
+                [&] {
+                    ++calls;
+                    while (!release) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                    return 42;
+                },
+                wasShared);
+            if (wasShared) {
+                ++shared;
+            }
+        });
+    }
+    // Let every thread reach the flight before the call returns.
+    while (flights.Shared() + calls.load() < 8) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    release = true;
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    ExpectEq(calls.load(), 1, "one call for concurrent requests");
+    ExpectEq(shared.load(), 7, "the others waited for it");
+    for (auto result : results) {
+        ExpectEq(result, 42, "every caller gets the result");
+    }
+
+    bool wasShared = true;
+    ExpectEq(flights.Do("token", [] { return 7; }, wasShared), 7, "a later call runs again");
+    Expect(!wasShared, "not shared");
+
+    bool threw = false;
+    try {
+        flights.Do("other", []() -> int { throw std::runtime_error("down"); }, wasShared);
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    Expect(threw, "failures reach the caller");
+    ExpectEq(flights.Do("other", [] { return 1; }, wasShared), 1, "a failed call is not remembered");
+}
+
+const std::vector<std::pair<std::string, std::function<void()>>> kTests = {
+    {"Expiry", TestExpiry},
+    {"LeastRecentlyUsedEvicted", TestLeastRecentlyUsedEvicted},
+    {"ConcurrentLookups", TestConcurrentLookups},
+    {"SingleFlight", TestSingleFlight},
+};
+
+} // namespace
+
+int main() {
+    int failures = 0;
+    for (const auto &test : kTests) {
+        try {
+            test.second();
+            std::cout << "[PASS] " << test.first << std::endl;
+        } catch (const std::exception &e) {
+            ++failures;
+            std::cerr << "[FAIL] " << test.first << ": " << e.what() << std::endl;
+        }
+    }
+
+    if (failures != 0) {
+        std::cerr << failures << " test(s) failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << kTests.size() << " test(s) passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,257 @@
+/*
+ * SPDX-License-Identifier: AGPL-3.0 OR LicenseRef-Commercial
+ * Copyright (c) 2025 Infernet Systems Pvt Ltd
+ * Portions copyright (c) Telecom Infra Project (TIP), BSD-3-Clause
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Poco/Base64Encoder.h"
+#include "Poco/Crypto/RSAKey.h"
+#include "Poco/JSON/Array.h"
+#include "Poco/JWT/Token.h"
+
+#include "../../src/framework/TokenVerifier.cpp"
+
+namespace {
+
+class TestFailure : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+void Expect(bool condition, const std::string &message) {
+    if (!condition) {
+        throw TestFailure(message);
+    }
+}
+
+template <typename T, typename U> void ExpectEq(const T &actual, const U &expected, const std::string &message) {
+    if (!(actual == expected)) {
+        std::ostringstream os;
+        os << message << " expected=" << expected << " actual=" << actual;
+        throw TestFailure(os.str());
+    }
+}
+
+using Result = OpenWifi::TokenVerifier::Result;
+
+constexpr uint64_t kNow = 1700000000;
+
+Poco::SharedPtr<Poco::Crypto::RSAKey> NewKey() {
+    return new Poco::Crypto::RSAKey(Poco::Crypto::RSAKey::KL_2048, Poco::Crypto::RSAKey::EXP_LARGE);
+}
+
+std::string Base64Url(const Poco::Crypto::RSAKey::ByteVec &bytes) {
+    std::ostringstream os;
+    Poco::Base64Encoder encoder(os, Poco::BASE64_URL_ENCODING | Poco::BASE64_NO_PADDING);
+    encoder.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    encoder.close();
+    return os.str();
+}
+
+Poco::JSON::Object::Ptr JWKS(const std::vector<std::pair<std::string, Poco::SharedPtr<Poco::Crypto::RSAKey>>> &keys) {
+    Poco::JSON::Array::Ptr entries = new Poco::JSON::Array;
+    for (const auto &[kid, key] : keys) {
+        Poco::JSON::Object::Ptr entry = new Poco::JSON::Object;
+        entry->set("kty", "RSA");
+        entry->set("use", "sig");
+        entry->set("alg", "RS256");
+        entry->set("kid", kid);
+        entry->set("n", Base64Url(key->modulus()));
+        entry->set("e", Base64Url(key->encryptionExponent()));
+        entries->add(entry);
+    }
+    Poco::JSON::Object::Ptr encryption = new Poco::JSON::Object;
+    encryption->set("kty", "RSA");
+    encryption->set("use", "enc");
+    encryption->set("kid", "enc");
+    entries->add(encryption);
+    Poco::JSON::Object::Ptr document = new Poco::JSON::Object;
+    document->set("keys", entries);
+    return document;
+}
+
+struct TokenSpec {
+    std::string kid = "k1";
+    std::string subject = "subscriber-1";
+    std::string issuer = "owsec";
+    uint64_t issuedAt = kNow - 60;
+    uint64_t expires = kNow + 3600;
+    uint64_t notBefore = 0;
+    std::string algorithm = "RS256";
+};
+
+std::string Sign(const Poco::SharedPtr<Poco::Crypto::RSAKey> &key, const TokenSpec &spec) {
+    Poco::JWT::Token token;
+    token.setType("JWT");
+    if (!spec.kid.empty()) {
+        token.header().set("kid", spec.kid);
+    }
+    if (!spec.subject.empty()) {
+        token.setSubject(spec.subject);
+    }
+    token.setIssuer(spec.issuer);
+    token.setIssuedAt(Poco::Timestamp::fromEpochTime(static_cast<std::time_t>(spec.issuedAt)));
+    if (spec.expires) {
+        token.setExpiration(Poco::Timestamp::fromEpochTime(static_cast<std::time_t>(spec.expires)));
+    }
+    if (spec.notBefore) {
+        token.setNotBefore(Poco::Timestamp::fromEpochTime(static_cast<std::time_t>(spec.notBefore)));
+    }
+    token.payload().set("email", "subscriber@example.com");
+    if (spec.algorithm == "HS256") {
+        return Poco::JWT::Signer("shared secret").sign(token, spec.algorithm);
+    }
+    return Poco::JWT::Signer(key).sign(token, spec.algorithm);
+}
+
+void TestVerify() {
+    const auto key = NewKey(), other = NewKey();
+    OpenWifi::TokenVerifier verifier;
+    OpenWifi::TokenVerifier::Claims claims;
+    Expect(verifier.Verify(Sign(key, {}), kNow, claims) == Result::UnknownKey, "no keys yet");
+    ExpectEq(verifier.LoadKeys(JWKS({{"k1", key}})), 1u, "encryption keys skipped");
+
+    Expect(verifier.Verify(Sign(key, {}), kNow, claims) == Result::Valid, "valid token");
+    ExpectEq(claims.Subject, std::string("subscriber-1"), "subject");
+    ExpectEq(claims.Issuer, std::string("owsec"), "issuer");
+    ExpectEq(claims.Email, std::string("subscriber@example.com"), "email");
+    ExpectEq(claims.IssuedAt, kNow - 60, "issued at");
+    ExpectEq(claims.Expires, kNow + 3600, "expires");
+
+    TokenSpec spec;
+    spec.algorithm = "RS512";
+    Expect(verifier.Verify(Sign(key, spec), kNow, claims) == Result::Valid, "other RSA algorithm");
+    spec = {};
+    spec.expires = kNow;
+    Expect(verifier.Verify(Sign(key, spec), kNow, claims) == Result::Expired, "expired token");
+    Expect(verifier.Verify(Sign(other, {}), kNow, claims) == Result::Invalid, "signed with another key");
+    spec = {};
+    spec.kid = "k2";
+    Expect(verifier.Verify(Sign(key, spec), kNow, claims) == Result::UnknownKey, "unknown key id");
+    spec = {};
+    spec.notBefore = kNow + 600;
+    Expect(verifier.Verify(Sign(key, spec), kNow, claims) == Result::Invalid, "not valid yet");
+    spec.notBefore = kNow + 30;
+    Expect(verifier.Verify(Sign(key, spec), kNow, claims) == Result::Valid, "clock skew tolerated");
+
+    spec = {};
+    spec.expires = 0;
+    Expect(verifier.Verify(Sign(key, spec), kNow, claims) == Result::Unsupported, "no expiry");
+    spec = {};
+    spec.subject.clear();
+    Expect(verifier.Verify(Sign(key, spec), kNow, claims) == Result::Unsupported, "no subject");
+    spec = {};
+    spec.algorithm = "HS256";
+    Expect(verifier.Verify(Sign(key, spec), kNow, claims) == Result::Unsupported, "shared secret");
+    Expect(verifier.Verify("6f0c2ab1e3d94d5f", kNow, claims) == Result::Unsupported, "opaque token");
+    Expect(verifier.Verify("a.b.c", kNow, claims) == Result::Unsupported, "malformed token");
+
+    auto token = Sign(key, {});
+    token[token.rfind('.') + 5] ^= 1;
+    Expect(verifier.Verify(token, kNow, claims) == Result::Invalid, "tampered signature");
+
+    verifier.SetIssuer("owsec");
+    Expect(verifier.Verify(Sign(key, {}), kNow, claims) == Result::Valid, "expected issuer");
+    spec = {};
+    spec.issuer = "elsewhere";
+    Expect(verifier.Verify(Sign(key, spec), kNow, claims) == Result::Invalid, "other issuer");
+}
+
+void TestKeyRotation() {
+    const auto first = NewKey(), second = NewKey();
+    OpenWifi::TokenVerifier verifier;
+    OpenWifi::TokenVerifier::Claims claims;
+    TokenSpec rotated;
+    rotated.kid = "k2";
+
+    verifier.LoadKeys(JWKS({{"k1", first}}));
+    ExpectEq(verifier.LoadKeys(JWKS({{"k1", first}, {"k2", second}})), 2u, "both keys while rotating");
+    Expect(verifier.Verify(Sign(first, {}), kNow, claims) == Result::Valid, "old key");
+    Expect(verifier.Verify(Sign(second, rotated), kNow, claims) == Result::Valid, "new key");
+
+    verifier.LoadKeys(JWKS({{"k2", second}}));
+    Expect(verifier.Verify(Sign(first, {}), kNow, claims) == Result::UnknownKey, "old key retired");
+    Expect(verifier.Verify(Sign(second, rotated), kNow, claims) == Result::Valid, "new key kept");
+
+    ExpectEq(verifier.LoadKeys(new Poco::JSON::Object), 0u, "empty document");
+    ExpectEq(verifier.LoadKeys(Poco::JSON::Object::Ptr()), 0u, "no document");
+    ExpectEq(verifier.Keys(), 1u, "keys kept when the document has none");
+
+    TokenSpec anonymous;
+    anonymous.kid.clear();
+    Expect(verifier.Verify(Sign(second, anonymous), kNow, claims) == Result::Valid, "only key used without a key id");
+}
+
+void TestKeyFile() {
+    const auto key = NewKey();
+    const auto file = (std::filesystem::temp_directory_path() / "test_token_verifier.pem").string();
+    {
+        std::ofstream out(file);
+        key->save(&out);
+    }
+
+    OpenWifi::TokenVerifier verifier;
+    OpenWifi::TokenVerifier::Claims claims;
+    Expect(!verifier.LoadKeyFile(file + ".missing"), "missing file");
+    Expect(verifier.LoadKeyFile(file), "key file loaded");
+    std::filesystem::remove(file);
+
+    TokenSpec anonymous;
+    anonymous.kid.clear();
+    Expect(verifier.Verify(Sign(key, anonymous), kNow, claims) == Result::Valid, "token without key id");
+    Expect(verifier.Verify(Sign(key, {}), kNow, claims) == Result::UnknownKey, "key id not in the key set");
+}
+
+void TestEncodings() {
+    ExpectEq(OpenWifi::TokenVerifier::DecodeBase64Url("AQAB"), std::string("\x01\x00\x01", 3), "exponent");
+    ExpectEq(OpenWifi::TokenVerifier::DecodeBase64Url("-_8"), std::string("\xfb\xff", 2), "url alphabet");
+    Expect(OpenWifi::TokenVerifier::DecodeBase64Url("*").empty(), "malformed");
+
+    const auto key = NewKey();
+    const auto &modulus = key->modulus();
+    const auto &exponent = key->encryptionExponent();
+    std::istringstream pem(OpenWifi::TokenVerifier::RSAPublicKeyPEM(std::string(modulus.begin(), modulus.end()),
+                                                                    std::string(exponent.begin(), exponent.end())));
+    Poco::Crypto::RSAKey rebuilt(&pem);
+    Expect(rebuilt.modulus() == modulus, "same modulus");
+    Expect(rebuilt.encryptionExponent() == exponent, "same exponent");
+}
+
+const std::vector<std::pair<std::string, std::function<void()>>> kTests = {
+    {"Verify", TestVerify},
+    {"KeyRotation", TestKeyRotation},
+    {"KeyFile", TestKeyFile},
+    {"Encodings", TestEncodings},
+};
+
+} // namespace
+
+int main() {
+    int failures = 0;
+    for (const auto &test : kTests) {
+        try {
+            test.second();
+            std::cout << "[PASS] " << test.first << std::endl;
+        } catch (const std::exception &e) {
+            ++failures;
+            std::cerr << "[FAIL] " << test.first << ": " << e.what() << std::endl;
+        }
+    }
+
+    if (failures != 0) {
+        std::cerr << failures << " test(s) failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << kTests.size() << " test(s) passed." << std::endl;
+    return 0;
+}